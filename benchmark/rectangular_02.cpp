@@ -0,0 +1,79 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <optional>
+
+#include <tbb/global_control.h>
+
+#include <mp++/integer.hpp>
+
+#include <obake/config.hpp>
+#include <obake/math/pow.hpp>
+#include <obake/polynomials/packed_monomial.hpp>
+#include <obake/polynomials/polynomial.hpp>
+
+#include "simple_timer.hpp"
+#include "sparse_dense_options.hpp"
+
+using namespace obake;
+using namespace obake_benchmark;
+
+// Sweep the size ratio in rectangular multiplications: a large
+// polynomial is multiplied by polynomials of increasing size. For each
+// multiplication, the estimated and the actual size of the product
+// are printed, together with the timing.
+int main(int argc, char **argv)
+{
+    try {
+        const auto [nthreads, power] = sparse_dense_options(argc, argv, 30);
+
+        std::optional<tbb::global_control> c;
+        if (nthreads > 0) {
+            c.emplace(tbb::global_control::max_allowed_parallelism, nthreads);
+        }
+
+        using p_type = polynomial<packed_monomial<
+#if defined(OBAKE_PACKABLE_INT64)
+                                      std::int64_t
+#else
+                                      std::int32_t
+#endif
+                                      >,
+                                  mppp::integer<1>>;
+
+        auto [x, y, z, t] = make_polynomials<p_type>("x", "y", "z", "t");
+
+        const auto g = obake::pow(1 + x + y + z + t, power);
+
+        for (auto k = 1; k <= 8; ++k) {
+            const auto f = obake::pow(1 - 2 * x + y * z - 3 * t, k);
+
+            const auto est = estimate_mul(f, g);
+
+            std::cout << "Sizes: " << f.size() << ", " << g.size() << " (ratio " << g.size() / f.size() << ")\n";
+            std::cout << "Estimated product size: " << est.n_terms << '\n';
+
+            p_type ret;
+            {
+                simple_timer st;
+                ret = f * g;
+            }
+
+            std::cout << "Actual product size: " << ret.size() << "\n\n";
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,57 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OBAKE_DETAIL_DEFAULT_INIT_ALLOCATOR_HPP
+#define OBAKE_DETAIL_DEFAULT_INIT_ALLOCATOR_HPP
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace obake::detail
+{
+
+// Allocator adaptor which default-initialises (rather than
+// value-initialises) the objects constructed without
+// arguments. When used in a std::vector, this means that resize()
+// will not zero out trivial types (e.g., the elements of vectors
+// of indices which are going to be overwritten anyway).
+template <typename T, typename A = ::std::allocator<T>>
+class default_init_allocator : public A
+{
+    using a_t = ::std::allocator_traits<A>;
+
+public:
+    template <typename U>
+    struct rebind {
+        using other = default_init_allocator<U, typename a_t::template rebind_alloc<U>>;
+    };
+
+    using A::A;
+
+    template <typename U>
+    void construct(U *ptr) noexcept(::std::is_nothrow_default_constructible_v<U>)
+    {
+        ::new (static_cast<void *>(ptr)) U;
+    }
+    template <typename U, typename... Args>
+    void construct(U *ptr, Args &&...args)
+    {
+        a_t::construct(static_cast<A &>(*this), ptr, ::std::forward<Args>(args)...);
+    }
+};
+
+// Vector type using default_init_allocator.
+template <typename T>
+using dinit_vector = ::std::vector<T, default_init_allocator<T>>;
+
+} // namespace obake::detail
+
+#endif
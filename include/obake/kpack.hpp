@@ -11,12 +11,15 @@
 
 #include <obake/config.hpp>
 
+#include <array>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <iterator>
 #include <stdexcept>
 #include <tuple>
 #include <type_traits>
+#include <utility>
 
 #if defined(OBAKE_PACKABLE_INT64) && defined(_MSC_VER)
 
@@ -26,25 +29,23 @@
 
 #include <fmt/core.h>
 
-#include <obake/detail/visibility.hpp>
+#include <obake/detail/limits.hpp>
 #include <obake/exceptions.hpp>
 #include <obake/type_name.hpp>
 #include <obake/type_traits.hpp>
 
-#if defined(_MSC_VER) && !defined(__clang__)
-
-#pragma warning(push)
-#pragma warning(disable : 4251)
-
-#endif
-
 namespace obake
 {
 
 // Only allow a closed set of types to be kpackable. Currently,
-// 32-bit integers are always supported and 64-bit are supported
+// 16 and 32-bit integers are always supported and 64-bit are supported
 // if a mulhi() primitive for std::uint64_t is available (which
-// is generally the case on 64-bit archs).
+// is generally the case on 64-bit archs). 128-bit integers are
+// supported if the compiler provides them.
+// NOTE: the kpack data for a kpackable type is generated
+// at compile time (see below), thus additional integral
+// types can be made kpackable by specialising is_kpackable_impl
+// and mulhi() for their unsigned counterparts.
 namespace detail
 {
 
@@ -52,10 +53,6 @@ template <typename>
 struct is_kpackable_impl : ::std::false_type {
 };
 
-template <typename>
-struct kpack_data {
-};
-
 // Helper to return the high half of the product
 // of two unsigned integers. The default implementation
 // causes a compile-time error.
@@ -65,37 +62,28 @@ inline T mulhi(T, T)
     static_assert(always_false_v<T>);
 }
 
-// Specialisations for 32-bit integers.
+// Specialisations for 16-bit integers.
 template <>
-struct is_kpackable_impl<::std::int32_t> : ::std::true_type {
+struct is_kpackable_impl<::std::int16_t> : ::std::true_type {
 };
 
 template <>
-struct is_kpackable_impl<::std::uint32_t> : ::std::true_type {
+struct is_kpackable_impl<::std::uint16_t> : ::std::true_type {
 };
 
 template <>
-struct OBAKE_DLL_PUBLIC kpack_data<::std::int32_t> {
-    // The list of deltas, one of each size starting from 1.
-    static const ::std::int32_t deltas[10];
-    // The components' limits in absolute value, one for each size.
-    static const ::std::int32_t lims[10];
-    // The coded value limits in absolute value, one for each size.
-    static const ::std::int32_t klims[10];
-    // The data necessary to divide by constants.
-    // NOTE: it seems like the first shift value we produce
-    // in divcnst is always 1. If we can prove that this is always
-    // ensured, perhaps we can reduce the tuple size and hard-code
-    // 1 in the unpacking code.
-    static const ::std::tuple<std::uint32_t, unsigned, unsigned> divcnst[10][11];
+inline ::std::uint16_t mulhi(::std::uint16_t a, ::std::uint16_t b)
+{
+    return static_cast<::std::uint16_t>((::std::uint32_t(a) * b) >> 16);
+}
+
+// Specialisations for 32-bit integers.
+template <>
+struct is_kpackable_impl<::std::int32_t> : ::std::true_type {
 };
 
 template <>
-struct OBAKE_DLL_PUBLIC kpack_data<::std::uint32_t> {
-    static const ::std::uint32_t deltas[10];
-    static const ::std::uint32_t lims[10];
-    static const ::std::uint32_t klims[10];
-    static const ::std::tuple<std::uint32_t, unsigned, unsigned> divcnst[10][11];
+struct is_kpackable_impl<::std::uint32_t> : ::std::true_type {
 };
 
 template <>
@@ -115,33 +103,400 @@ struct is_kpackable_impl<::std::uint64_t> : ::std::true_type {
 };
 
 template <>
-struct OBAKE_DLL_PUBLIC kpack_data<::std::int64_t> {
-    static const ::std::int64_t deltas[21];
-    static const ::std::int64_t lims[21];
-    static const ::std::int64_t klims[21];
-    static const ::std::tuple<std::uint64_t, unsigned, unsigned> divcnst[21][22];
+inline ::std::uint64_t mulhi(::std::uint64_t a, ::std::uint64_t b)
+{
+    return
+#if defined(OBAKE_HAVE_GCC_INT128)
+        static_cast<::std::uint64_t>((__uint128_t(a) * b) >> 64);
+#else
+        __umulh(a, b);
+#endif
+}
+
+#endif
+
+#if defined(OBAKE_PACKABLE_INT128)
+
+template <>
+struct is_kpackable_impl<__int128_t> : ::std::true_type {
 };
 
 template <>
-struct OBAKE_DLL_PUBLIC kpack_data<::std::uint64_t> {
-    static const ::std::uint64_t deltas[21];
-    static const ::std::uint64_t lims[21];
-    static const ::std::uint64_t klims[21];
-    static const ::std::tuple<std::uint64_t, unsigned, unsigned> divcnst[21][22];
+struct is_kpackable_impl<__uint128_t> : ::std::true_type {
 };
 
+#endif
+
+// Compile-time computation of the full product
+// of two unsigned integers. The return value
+// contains the high and low halves of the product.
+template <typename U>
+constexpr ::std::pair<U, U> kpack_ct_mul_wide(U a, U b)
+{
+    constexpr auto half = static_cast<unsigned>(limits_digits<U>) / 2u;
+    constexpr auto mask = (U(1) << half) - 1u;
+
+    const auto a_lo = a & mask, a_hi = a >> half, b_lo = b & mask, b_hi = b >> half;
+    const auto ll = a_lo * b_lo, lh = a_lo * b_hi, hl = a_hi * b_lo, hh = a_hi * b_hi;
+    // NOTE: the middle sum cannot overflow, as it
+    // is the sum of three half-width values.
+    const auto mid = (ll >> half) + (lh & mask) + (hl & mask);
+
+    return {hh + (lh >> half) + (hl >> half) + (mid >> half), (mid << half) | (ll & mask)};
+}
+
+#if defined(OBAKE_PACKABLE_INT128)
+
+// NOTE: there is no 256-bit integral type, thus compute
+// the high half of the product via the schoolbook
+// multiplication of the 64-bit limbs. Each partial
+// product is a single 64x64->128 bit multiplication.
 template <>
-inline ::std::uint64_t mulhi(::std::uint64_t a, ::std::uint64_t b)
+inline __uint128_t mulhi(__uint128_t a, __uint128_t b)
 {
-    return
+    const auto a_lo = static_cast<::std::uint64_t>(a), a_hi = static_cast<::std::uint64_t>(a >> 64),
+               b_lo = static_cast<::std::uint64_t>(b), b_hi = static_cast<::std::uint64_t>(b >> 64);
+
+    const auto ll = __uint128_t(a_lo) * b_lo, lh = __uint128_t(a_lo) * b_hi, hl = __uint128_t(a_hi) * b_lo,
+               hh = __uint128_t(a_hi) * b_hi;
+    // NOTE: the middle sum cannot overflow, as it
+    // is the sum of three 64-bit values.
+    const auto mid = (ll >> 64) + static_cast<::std::uint64_t>(lh) + static_cast<::std::uint64_t>(hl);
+
+    return hh + (lh >> 64) + (hl >> 64) + (mid >> 64);
+}
+
+#endif
+
+// Compile-time computation of the quotient and remainder
+// of the division of the double-width value u1 * 2**N + u0
+// by v, where N is the bit width of the unsigned integral type U.
+// u1 must be less than v. This is the algorithm 'divlu' from
+// Hacker's Delight (2nd edition, figure 9-3).
+template <typename U>
+constexpr ::std::pair<U, U> kpack_ct_divlu(U u1, U u0, U v)
+{
+    constexpr auto nbits = static_cast<unsigned>(limits_digits<U>);
+    constexpr auto half = nbits / 2u;
+    constexpr auto b = U(1) << half;
+
+    assert(u1 < v);
+
+    // Normalise the divisor, so that its most
+    // significant bit is set.
+    unsigned s = 0;
+    for (auto w = half; w > 0u; w /= 2u) {
+        if ((v >> (nbits - w)) == 0u) {
+            v <<= w;
+            s += w;
+        }
+    }
+
+    const auto vn1 = v >> half, vn0 = v & (b - 1u);
+    const auto un32 = s == 0u ? u1 : static_cast<U>((u1 << s) | (u0 >> (nbits - s)));
+    const auto un10 = static_cast<U>(u0 << s);
+    const auto un1 = un10 >> half, un0 = un10 & (b - 1u);
+
+    // Compute the first quotient digit.
+    auto q1 = un32 / vn1;
+    auto rhat = un32 - q1 * vn1;
+    while (q1 >= b || q1 * vn0 > b * rhat + un1) {
+        --q1;
+        rhat += vn1;
+        if (rhat >= b) {
+            break;
+        }
+    }
+
+    // Multiply and subtract, then compute
+    // the second quotient digit.
+    const auto un21 = static_cast<U>(un32 * b + un1 - q1 * v);
+    auto q0 = un21 / vn1;
+    rhat = un21 - q0 * vn1;
+    while (q0 >= b || q0 * vn0 > b * rhat + un0) {
+        --q0;
+        rhat += vn1;
+        if (rhat >= b) {
+            break;
+        }
+    }
+
+    return {q1 * b + q0, static_cast<U>(un21 * b + un0 - q0 * v) >> s};
+}
+
+// Compile-time primality test for 64-bit integers. This is
+// a Miller-Rabin test whose set of bases makes it deterministic
+// for all n less than 2**64.
+constexpr bool kpack_ct_is_prime(::std::uint64_t n)
+{
+    constexpr ::std::uint64_t bases[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+
+    if (n < 2u) {
+        return false;
+    }
+
+    for (const auto p : bases) {
+        if (n % p == 0u) {
+            return n == p;
+        }
+    }
+
+    // NOTE: if n fits in 32 bits, the modular
+    // multiplication can be done directly.
+    const auto mulmod = [n](::std::uint64_t a, ::std::uint64_t b) {
+        if ((n >> 32) == 0u) {
+            return a * b % n;
+        }
+
 #if defined(OBAKE_HAVE_GCC_INT128)
-        static_cast<::std::uint64_t>((__uint128_t(a) * b) >> 64);
+        return static_cast<::std::uint64_t>(__uint128_t(a) * b % n);
 #else
-        __umulh(a, b);
+        const auto [hi, lo] = detail::kpack_ct_mul_wide(a, b);
+        return detail::kpack_ct_divlu(hi, lo, n).second;
 #endif
+    };
+
+    // Write n - 1 as d * 2**s, with d odd.
+    auto d = n - 1u;
+    auto s = 0u;
+    for (; d % 2u == 0u; d /= 2u, ++s) {
+    }
+
+    for (const auto a : bases) {
+        // Compute a**d mod n.
+        ::std::uint64_t x = 1, p = a;
+        for (auto e = d; e != 0u; e /= 2u) {
+            if (e % 2u == 1u) {
+                x = mulmod(x, p);
+            }
+            p = mulmod(p, p);
+        }
+
+        if (x == 1u || x == n - 1u) {
+            continue;
+        }
+
+        auto i = 1u;
+        for (; i < s; ++i) {
+            x = mulmod(x, x);
+            if (x == n - 1u) {
+                break;
+            }
+        }
+
+        if (i == s) {
+            return false;
+        }
+    }
+
+    return true;
 }
 
-#endif
+// The unsigned integral type used in the compile-time
+// generation of the kpack data for the type T. It is the
+// unsigned counterpart of T, widened to at least 64 bits.
+template <typename T>
+using kpack_ct_work_t = ::std::conditional_t<(limits_digits<make_unsigned_t<T>> < 64), ::std::uint64_t,
+                                             make_unsigned_t<T>>;
+
+// Compile-time computation of the max packable size for the type T.
+// Given the number of value bits nbits of T, the size s is supported
+// if nbits / s is at least 3.
+template <typename T>
+consteval unsigned kpack_ct_max_size()
+{
+    return static_cast<unsigned>(limits_digits<T>) / 3u;
+}
+
+// Compile-time computation of the deltas for the type T. Given the
+// number of value bits nbits of T, the delta for a size of 1
+// is 2**nbits - 1, while the delta for a size s > 1 is the largest prime p
+// such that p < r, where r is the integral part of the s-th root of 2**nbits.
+template <typename T>
+consteval auto kpack_ct_deltas()
+{
+    using w_t = kpack_ct_work_t<T>;
+
+    constexpr auto nbits = static_cast<unsigned>(limits_digits<T>);
+    // NOTE: this is 2**nbits - 1.
+    constexpr auto max_val = static_cast<w_t>(limits_max<make_unsigned_t<T>>
+                                              >> (static_cast<unsigned>(limits_digits<make_unsigned_t<T>>) - nbits));
+
+    ::std::array<T, detail::kpack_ct_max_size<T>()> retval{};
+    retval[0] = static_cast<T>(max_val);
+
+    for (auto s = 2u; s <= retval.size(); ++s) {
+        // Check if r**s <= max_val.
+        const auto pow_le_max = [s](w_t r) {
+            w_t acc = 1;
+            for (auto i = 0u; i < s; ++i) {
+                if (r != 0u && acc > max_val / r) {
+                    return false;
+                }
+                acc *= r;
+            }
+            return true;
+        };
+
+        // Determine via bisection the largest r
+        // such that r**s <= max_val.
+        w_t lo = 0, hi = w_t(1) << (nbits / s + 1u);
+        while (lo < hi) {
+            const auto mid = lo + (hi - lo + 1u) / 2u;
+            if (pow_le_max(mid)) {
+                lo = mid;
+            } else {
+                hi = mid - 1u;
+            }
+        }
+
+        // NOTE: r**s can be exactly 2**nbits only if
+        // s divides nbits and r is 2**(nbits / s).
+        const auto r = (nbits % s == 0u && lo + 1u == w_t(1) << (nbits / s)) ? lo + 1u : lo;
+
+        // NOTE: because s >= 2, the candidates
+        // always fit in 64 bits.
+        auto cand = static_cast<::std::uint64_t>(r - 1u);
+        while (!detail::kpack_ct_is_prime(cand)) {
+            --cand;
+        }
+
+        retval[s - 1u] = static_cast<T>(cand);
+    }
+
+    return retval;
+}
+
+// Compile-time computation of the components' limits in absolute
+// value from the deltas.
+template <typename T, ::std::size_t N>
+consteval auto kpack_ct_lims(const ::std::array<T, N> &deltas)
+{
+    ::std::array<T, N> retval{};
+
+    for (::std::size_t i = 0; i < N; ++i) {
+        // NOTE: all deltas are odd.
+        if constexpr (is_signed_v<T>) {
+            retval[i] = static_cast<T>((deltas[i] - 1) / 2);
+        } else {
+            retval[i] = static_cast<T>(deltas[i] - 1u);
+        }
+    }
+
+    return retval;
+}
+
+// Compile-time computation of the coded values' limits in absolute
+// value from the deltas and the components' limits.
+template <typename T, ::std::size_t N>
+consteval auto kpack_ct_klims(const ::std::array<T, N> &deltas, const ::std::array<T, N> &lims)
+{
+    using w_t = kpack_ct_work_t<T>;
+
+    ::std::array<T, N> retval{};
+
+    for (::std::size_t i = 0; i < N; ++i) {
+        w_t acc = 0, cur_prod = 1;
+        for (::std::size_t j = 0; j <= i; ++j) {
+            acc += static_cast<w_t>(lims[i]) * cur_prod;
+            cur_prod *= static_cast<w_t>(deltas[i]);
+        }
+        retval[i] = static_cast<T>(acc);
+    }
+
+    return retval;
+}
+
+// Compile-time computation of the data necessary to divide
+// an unsigned integral of the same width as T by d via a
+// multiplication and two shifts. This is the algorithm
+// in Figure 4.1 in:
+// https://gmplib.org/~tege/divcnst-pldi94.pdf
+template <typename T>
+consteval auto kpack_ct_divcnst_entry(kpack_ct_work_t<T> d)
+{
+    using u_t = make_unsigned_t<T>;
+    using w_t = kpack_ct_work_t<T>;
+
+    constexpr auto nbits = static_cast<unsigned>(limits_digits<u_t>);
+
+    // Compute l = ceil(log2(d)), that is, the
+    // bit length of d - 1, via bisection.
+    auto l = 0u;
+    auto tmp = static_cast<w_t>(d - 1u);
+    for (auto w = nbits / 2u; w > 0u; w /= 2u) {
+        if ((tmp >> w) != 0u) {
+            tmp >>= w;
+            l += w;
+        }
+    }
+    l += static_cast<unsigned>(tmp != 0u);
+
+    // Compute mp = floor(2**nbits * (2**l - d) / d) + 1.
+    w_t mp;
+    if constexpr (nbits < 64u) {
+        // NOTE: in this case the 64-bit working
+        // type can hold the double-width numerator.
+        mp = (((w_t(1) << l) - d) << nbits) / d + 1u;
+    } else {
+        // NOTE: 2**l overflows if l == nbits, but
+        // the wrapped-around difference is correct.
+        const auto x = l == nbits ? static_cast<w_t>(w_t(0) - d) : static_cast<w_t>((w_t(1) << l) - d);
+        mp = detail::kpack_ct_divlu(x, w_t(0), d).first + 1u;
+    }
+
+    return ::std::tuple<u_t, unsigned, unsigned>{static_cast<u_t>(mp), l == 0u ? 0u : 1u, l == 0u ? 0u : l - 1u};
+}
+
+// Compile-time computation of the division data for the type T.
+// For each size s, the data for the divisions by delta**j,
+// with j in the [0, s] range, is stored. The remaining
+// elements are zero.
+template <typename T, ::std::size_t N>
+consteval auto kpack_ct_divcnst(const ::std::array<T, N> &deltas)
+{
+    using w_t = kpack_ct_work_t<T>;
+
+    // NOTE: the tuples are value-initialised by their default
+    // constructor. Avoid the aggregate initialisation of the
+    // array, which triggers an internal compiler error in GCC 12.
+    ::std::array<::std::array<::std::tuple<make_unsigned_t<T>, unsigned, unsigned>, N + 1u>, N> retval;
+
+    for (::std::size_t i = 0; i < N; ++i) {
+        w_t cur_prod = 1;
+        for (::std::size_t j = 0; j <= i + 1u; ++j) {
+            retval[i][j] = detail::kpack_ct_divcnst_entry<T>(cur_prod);
+            // NOTE: avoid computing delta**(s + 1),
+            // which could overflow.
+            if (j <= i) {
+                cur_prod *= static_cast<w_t>(deltas[i]);
+            }
+        }
+    }
+
+    return retval;
+}
+
+template <typename>
+struct kpack_data {
+};
+
+template <typename T>
+    requires is_kpackable_impl<T>::value
+struct kpack_data<T> {
+    // The list of deltas, one of each size starting from 1.
+    static constexpr auto deltas = detail::kpack_ct_deltas<T>();
+    // The components' limits in absolute value, one for each size.
+    static constexpr auto lims = detail::kpack_ct_lims(deltas);
+    // The coded value limits in absolute value, one for each size.
+    static constexpr auto klims = detail::kpack_ct_klims(deltas, lims);
+    // The data necessary to divide by constants.
+    // NOTE: it seems like the first shift value we produce
+    // in divcnst is always 1. If we can prove that this is always
+    // ensured, perhaps we can reduce the tuple size and hard-code
+    // 1 in the unpacking code.
+    static constexpr auto divcnst = detail::kpack_ct_divcnst(deltas);
+};
 
 } // namespace detail
 
@@ -176,7 +531,7 @@ constexpr unsigned kpack_max_size()
 
 // Return the delta for a given size.
 template <typename T>
-inline T kpack_get_delta(unsigned size)
+constexpr T kpack_get_delta(unsigned size)
 {
     assert(size > 0u && size <= detail::kpack_max_size<T>());
 
@@ -185,7 +540,7 @@ inline T kpack_get_delta(unsigned size)
 
 // Return the components' limits for a given size.
 template <typename T>
-inline ::std::pair<T, T> kpack_get_lims(unsigned size)
+constexpr ::std::pair<T, T> kpack_get_lims(unsigned size)
 {
     assert(size > 0u && size <= detail::kpack_max_size<T>());
 
@@ -200,7 +555,7 @@ inline ::std::pair<T, T> kpack_get_lims(unsigned size)
 
 // Return the coded values' limits for a given size.
 template <typename T>
-inline ::std::pair<T, T> kpack_get_klims(unsigned size)
+constexpr ::std::pair<T, T> kpack_get_klims(unsigned size)
 {
     assert(size > 0u && size <= detail::kpack_max_size<T>());
 
@@ -213,6 +568,20 @@ inline ::std::pair<T, T> kpack_get_klims(unsigned size)
     }
 }
 
+// Helper to perform the division of n by a constant, using
+// the data mp, sh1 and sh2 from the divcnst tables. This is the algorithm
+// in Figure 4.1 in:
+// https://gmplib.org/~tege/divcnst-pldi94.pdf
+template <typename U>
+inline U kpack_divcnst(U n, U mp, unsigned sh1, unsigned sh2)
+{
+    // NOTE: the casts are needed for
+    // integral types subject to promotion.
+    const auto t1 = detail::mulhi(mp, n);
+    const auto tmp = static_cast<U>((n - t1) >> sh1);
+    return static_cast<U>((t1 + tmp) >> sh2);
+}
+
 } // namespace detail
 
 // Kronecker packer.
@@ -260,7 +629,7 @@ public:
         }
 
         // Do the encoding.
-        m_value += n * m_cur_prod;
+        m_value = static_cast<T>(m_value + n * m_cur_prod);
         // Update the value of the current component
         // of the coding vector.
         m_cur_prod *= detail::kpack_get_delta<T>(m_size);
@@ -344,25 +713,18 @@ public:
         // Compute the shifted counterpart of m_value.
         const auto n = m_value - detail::kpack_get_klims<T>(m_size).first;
 
-        // Helper to perform the division by a constant. This is the algorithm
-        // in Figure 4.1 in:
-        // https://gmplib.org/~tege/divcnst-pldi94.pdf
         // NOTE: the division is performed using the unsigned counterpart of T.
         using unsigned_t = make_unsigned_t<T>;
-        auto divcnst = [](unsigned_t n, unsigned_t mp, unsigned sh1, unsigned sh2) {
-            const auto t1 = detail::mulhi(mp, n);
-            const auto tmp = (n - t1) >> sh1;
-            return (t1 + tmp) >> sh2;
-        };
 
         // Do the remainder part.
-        const auto q_r = divcnst(static_cast<unsigned_t>(n), mp_r, sh1_r, sh2_r);
+        const auto q_r = detail::kpack_divcnst(static_cast<unsigned_t>(n), mp_r, sh1_r, sh2_r);
         assert(q_r == static_cast<unsigned_t>(n) / static_cast<unsigned_t>(m_cur_prod));
-        const auto rem = static_cast<unsigned_t>(n) - q_r * static_cast<unsigned_t>(m_cur_prod);
+        const auto rem
+            = static_cast<unsigned_t>(static_cast<unsigned_t>(n) - q_r * static_cast<unsigned_t>(m_cur_prod));
         assert(rem == static_cast<unsigned_t>(n) % static_cast<unsigned_t>(m_cur_prod));
 
         // Do the division part.
-        const auto q_d = static_cast<T>(divcnst(rem, mp_d, sh1_d, sh2_d));
+        const auto q_d = static_cast<T>(detail::kpack_divcnst(rem, mp_d, sh1_d, sh2_d));
         assert(q_d == static_cast<T>(rem) / (m_cur_prod / delta));
 
         // Write out the result.
@@ -374,12 +736,130 @@ public:
     }
 };
 
-} // namespace obake
+// Batch Kronecker unpacking: decode the n coded values in codes,
+// each consisting of size components, into the buffer out using a
+// structure-of-arrays layout (that is, the j-th component of the i-th
+// coded value is written into out[j * n + i]). out must provide space
+// for at least n * size values, and it must not overlap with codes.
+//
+// NOTE: once shifted by the lower limit of the coded values, the components
+// are the base-delta digits of the coded value. They can thus be extracted
+// with a single division by delta per component (whereas kunpacker needs two
+// divisions per component). The loops over the coded values have no
+// dependencies between iterations, so that the compiler can vectorise them.
+template <kpackable T>
+inline void kunpack_batch(const T *codes, ::std::size_t n, unsigned size, T *out)
+{
+    if (size == 0u) {
+        for (::std::size_t i = 0; i < n; ++i) {
+            if (obake_unlikely(codes[i] != T(0))) {
+                obake_throw(::std::invalid_argument,
+                            fmt::format("Only a value of zero can be used in a Kronecker unpacker "
+                                        "with a size of zero, but a value of {} was provided instead",
+                                        codes[i]));
+            }
+        }
 
-#if defined(_MSC_VER) && !defined(__clang__)
+        return;
+    }
 
-#pragma warning(pop)
+    if (obake_unlikely(size > detail::kpack_max_size<T>())) {
+        obake_throw(::std::overflow_error,
+                    fmt::format("Invalid size specified in a batch Kronecker unpacking for the type '{}': the "
+                                "maximum possible size is {}, but a size of {} was specified instead",
+                                ::obake::type_name<T>(), detail::kpack_max_size<T>(), size));
+    }
 
-#endif
+    using unsigned_t = make_unsigned_t<T>;
+
+    const auto [klim_min, klim_max] = detail::kpack_get_klims<T>(size);
+    const auto lim_min = detail::kpack_get_lims<T>(size).first;
+    const auto delta = static_cast<unsigned_t>(detail::kpack_get_delta<T>(size));
+
+    // Fetch the data necessary for the division by delta.
+    const auto [mp, sh1, sh2] = detail::kpack_data<T>::divcnst[size - 1u][1];
+    assert(mp != 0u);
+
+    // NOTE: the last row of out is used as a buffer for the
+    // (shifted) coded values while extracting the components.
+    const auto u = out + (size - 1u) * n;
+
+    for (::std::size_t i = 0; i < n; ++i) {
+        if (obake_unlikely(codes[i] < klim_min || codes[i] > klim_max)) {
+            obake_throw(::std::overflow_error,
+                        fmt::format("The value {} passed to a Kronecker unpacker for the type "
+                                    "'{}' is outside the allowed range [{}, {}]",
+                                    codes[i], ::obake::type_name<T>(), klim_min, klim_max));
+        }
+
+        u[i] = static_cast<T>(static_cast<unsigned_t>(codes[i]) - static_cast<unsigned_t>(klim_min));
+    }
+
+    for (auto j = 0u; j < size - 1u; ++j) {
+        const auto row = out + j * n;
+
+        for (::std::size_t i = 0; i < n; ++i) {
+            const auto v = static_cast<unsigned_t>(u[i]);
+            const auto q = detail::kpack_divcnst(v, mp, sh1, sh2);
+            assert(q == v / delta);
+
+            row[i] = static_cast<T>(v - q * delta) + lim_min;
+            u[i] = static_cast<T>(q);
+        }
+    }
+
+    // The last component is what is left in the buffer.
+    for (::std::size_t i = 0; i < n; ++i) {
+        u[i] += lim_min;
+    }
+}
+
+// Kronecker unpacking with a size known at compile time: decode the
+// coded value n into the Size components written to out. All the data
+// necessary for the decoding is known at compile time, and
+// the loop over the components is fully unrolled.
+template <unsigned Size, kpackable T>
+    requires(Size > 0u) && (Size <= detail::kpack_max_size<T>())
+inline void kunpack(const T &n, T *out)
+{
+    using unsigned_t = make_unsigned_t<T>;
+
+    constexpr auto klims = detail::kpack_get_klims<T>(Size);
+    constexpr auto lim_min = detail::kpack_get_lims<T>(Size).first;
+    constexpr auto delta = static_cast<unsigned_t>(detail::kpack_get_delta<T>(Size));
+
+    // The data necessary for the division by delta.
+    constexpr auto mp = ::std::get<0>(detail::kpack_data<T>::divcnst[Size - 1u][1]);
+    constexpr auto sh1 = ::std::get<1>(detail::kpack_data<T>::divcnst[Size - 1u][1]);
+    constexpr auto sh2 = ::std::get<2>(detail::kpack_data<T>::divcnst[Size - 1u][1]);
+
+    if (obake_unlikely(n < klims.first || n > klims.second)) {
+        obake_throw(::std::overflow_error,
+                    fmt::format("The value {} passed to a Kronecker unpacker for the type "
+                                "'{}' is outside the allowed range [{}, {}]",
+                                n, ::obake::type_name<T>(), klims.first, klims.second));
+    }
+
+    // NOTE: as in kunpack_batch(), peel off the components
+    // one at a time via a division by delta.
+    auto v = static_cast<unsigned_t>(static_cast<unsigned_t>(n) - static_cast<unsigned_t>(klims.first));
+
+    [&v, out]<unsigned... J>(::std::integer_sequence<unsigned, J...>) {
+        [[maybe_unused]] auto peel = [&v](T &o) {
+            const auto q = detail::kpack_divcnst(v, mp, sh1, sh2);
+            assert(q == v / delta);
+
+            o = static_cast<T>(static_cast<T>(v - q * delta) + lim_min);
+            v = q;
+        };
+
+        (peel(out[J]), ...);
+    }(::std::make_integer_sequence<unsigned, Size - 1u>{});
+
+    // The last component is what is left in v.
+    out[Size - 1u] = static_cast<T>(static_cast<T>(v) + lim_min);
+}
+
+} // namespace obake
 
 #endif
@@ -0,0 +1,1025 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OBAKE_POLYNOMIALS_BW_PACKED_MONOMIAL_HPP
+#define OBAKE_POLYNOMIALS_BW_PACKED_MONOMIAL_HPP
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <boost/serialization/access.hpp>
+
+#include <mp++/integer.hpp>
+
+#include <obake/config.hpp>
+#include <obake/detail/mppp_utils.hpp>
+#include <obake/exceptions.hpp>
+#include <obake/math/pow.hpp>
+#include <obake/math/safe_cast.hpp>
+#include <obake/math/safe_convert.hpp>
+#include <obake/polynomials/monomial_homomorphic_hash.hpp>
+#include <obake/polynomials/packed_monomial.hpp>
+#include <obake/ranges.hpp>
+#include <obake/s11n.hpp>
+#include <obake/symbols.hpp>
+#include <obake/type_name.hpp>
+#include <obake/type_traits.hpp>
+
+namespace obake
+{
+
+namespace polynomials
+{
+
+// A layout for bw_packed_monomial is a type L providing
+// the static member function
+//
+// static unsigned exponent_bits(const std::string &name);
+//
+// which returns the number of bits used to represent the exponent
+// of the symbol name, or zero if the symbol cannot be represented.
+// The number of bits of a symbol must not change during the
+// execution of the program.
+template <typename L>
+concept BwLayout = requires(const ::std::string &name)
+{
+    L::exponent_bits(name);
+    requires ::std::is_same_v<decltype(L::exponent_bits(name)), unsigned>;
+};
+
+namespace detail
+{
+
+// The bit layout of a bw_packed_monomial for a given
+// symbol set: the number of bits of each exponent, and
+// their sum.
+// NOTE: each exponent takes at least one bit, thus
+// a valid layout contains at most 64 exponents.
+struct bw_layout {
+    ::std::array<unsigned, 64> widths;
+    unsigned size = 0;
+    unsigned nbits = 0;
+
+    // Append an exponent with w bits. If the total number
+    // of bits would exceed 64, false will be returned and
+    // the layout will not be modified.
+    bool push_back(unsigned w)
+    {
+        assert(w > 0u);
+
+        if (w > 64u - nbits) {
+            return false;
+        }
+
+        widths[size++] = w;
+        nbits += w;
+
+        return true;
+    }
+};
+
+// Compute the bit layout for the symbol set ss according
+// to the layout type L. If at least one symbol in ss cannot be
+// represented, or if the total number of bits is larger than 64,
+// an empty optional will be returned.
+// NOTE: the layout is built on the stack, no memory
+// allocation is involved.
+template <typename L>
+inline ::std::optional<bw_layout> bw_make_layout(const symbol_set &ss)
+{
+    bw_layout ret;
+
+    for (const auto &name : ss) {
+        const auto w = L::exponent_bits(name);
+
+        if (w == 0u || !ret.push_back(w)) {
+            return {};
+        }
+    }
+
+    return ret;
+}
+
+// Fetch the bit layout for the symbol set ss according to the
+// layout type L (see bw_make_layout()).
+// The key operations are typically invoked many times in a row
+// with the same symbol set (e.g., when computing the degrees of all
+// the terms of a polynomial). Thus, the last computed layout is cached
+// in a thread-local variable together with its symbol set. The cached
+// symbol set is stored as a flyweight, and the symbol sets passed to the
+// key operations by series are references to flyweight values: in the
+// common case, the cache lookup is thus a pointer comparison. The cached
+// flyweight keeps its value alive, hence a different symbol set cannot
+// occupy the same address while it is cached. Symbol sets which are not
+// flyweight values are compared by value with the cached one.
+// NOTE: the layout is returned by copy, so that the
+// result is not affected by subsequent invocations.
+template <typename L>
+inline ::std::optional<bw_layout> bw_fetch_layout(const symbol_set &ss)
+{
+    thread_local ::std::optional<::obake::detail::ss_fw> c_ss;
+    thread_local ::std::optional<bw_layout> c_layout;
+
+    if (c_ss && (&ss == &c_ss->get() || ss == c_ss->get())) {
+        return c_layout;
+    }
+
+    c_layout = detail::bw_make_layout<L>(ss);
+    c_ss.emplace(ss);
+
+    return c_layout;
+}
+
+// The types which can be used in a bw_packed_monomial.
+template <typename T>
+inline constexpr bool is_bw_packable_v
+    = ::std::disjunction_v<::std::is_same<T, ::std::int32_t>, ::std::is_same<T, ::std::uint32_t>,
+                           ::std::is_same<T, ::std::int64_t>, ::std::is_same<T, ::std::uint64_t>>;
+
+// The bit width of the type T.
+template <typename T>
+inline constexpr unsigned bw_type_nbits = static_cast<unsigned>(sizeof(T) * CHAR_BIT);
+
+// Check if a layout is valid for the type T.
+template <typename T>
+inline bool bw_layout_ok(const ::std::optional<bw_layout> &l)
+{
+    return l && l->nbits <= bw_type_nbits<T>;
+}
+
+// Fetch the limits of an exponent represented
+// with w bits.
+template <typename T>
+constexpr ::std::pair<T, T> bw_field_lims(unsigned w)
+{
+    assert(w > 0u && w <= bw_type_nbits<T>);
+
+    using u_t = make_unsigned_t<T>;
+
+    if constexpr (is_signed_v<T>) {
+        const auto lim = static_cast<T>((u_t(1) << (w - 1u)) - 1u);
+
+        return ::std::pair{static_cast<T>(-lim - 1), lim};
+    } else {
+        return ::std::pair{T(0), w == bw_type_nbits<T> ? ~T(0) : static_cast<T>((u_t(1) << w) - 1u)};
+    }
+}
+
+// Decode the exponents from the value n according to the bit widths
+// in l, invoking f(i, e) for each exponent e at index i.
+template <typename T, typename F>
+inline void bw_decode(const T &n, const bw_layout &l, F &&f)
+{
+    using u_t = make_unsigned_t<T>;
+
+    auto u = static_cast<u_t>(n);
+
+    for (unsigned i = 0; i < l.size; ++i) {
+        const auto w = l.widths[i];
+
+        if (w == bw_type_nbits<T>) {
+            // NOTE: this can happen only if there is
+            // a single exponent spanning all the bits.
+            f(i, static_cast<T>(u));
+            u = 0;
+        } else {
+            const auto field = u & static_cast<u_t>((u_t(1) << w) - 1u);
+
+            T e;
+            if constexpr (is_signed_v<T>) {
+                // Sign extension.
+                // NOTE: the conversion of an out-of-range unsigned
+                // value to signed is well-defined in C++20.
+                e = field >= (u_t(1) << (w - 1u)) ? static_cast<T>(field - (u_t(1) << w)) : static_cast<T>(field);
+            } else {
+                e = field;
+            }
+
+            f(i, e);
+
+            // NOTE: subtracting e propagates the borrow
+            // into the next exponents, so that the encoding
+            // is homomorphic also for negative exponents.
+            u = static_cast<u_t>(u - static_cast<u_t>(e)) >> w;
+        }
+    }
+}
+
+// Packer for bw_packed_monomial, similar to kpacker.
+template <typename T>
+class bw_packer
+{
+    using u_t = make_unsigned_t<T>;
+
+    const bw_layout &m_layout;
+    u_t m_value = 0;
+    unsigned m_shift = 0;
+    unsigned m_index = 0;
+
+public:
+    explicit bw_packer(const bw_layout &l) : m_layout(l)
+    {
+        assert(l.nbits <= bw_type_nbits<T>);
+    }
+
+    // Insert the next value into the packer.
+    bw_packer &operator<<(const T &n)
+    {
+        if (obake_unlikely(m_index == m_layout.size)) {
+            obake_throw(::std::out_of_range,
+                        fmt::format("Cannot push any more values to this bit-width packer for the type '{}': the "
+                                    "number of values already pushed to the packer is equal to the packer's size ({})",
+                                    ::obake::type_name<T>(), m_layout.size));
+        }
+
+        const auto w = m_layout.widths[m_index];
+        const auto [lim_min, lim_max] = detail::bw_field_lims<T>(w);
+
+        if (obake_unlikely(n < lim_min || n > lim_max)) {
+            obake_throw(::std::overflow_error,
+                        fmt::format("Cannot push the value {} to this bit-width packer for the type "
+                                    "'{}': the value is outside the allowed range [{}, {}]",
+                                    n, ::obake::type_name<T>(), lim_min, lim_max));
+        }
+
+        // NOTE: m_shift is always less than the bit width
+        // of T here, as it is the sum of the previous widths.
+        m_value = static_cast<u_t>(m_value + (static_cast<u_t>(n) << m_shift));
+        m_shift += w;
+        ++m_index;
+
+        return *this;
+    }
+
+    // Fetch the encoded value.
+    T get() const
+    {
+        if (obake_unlikely(m_index != m_layout.size)) {
+            obake_throw(::std::invalid_argument,
+                        fmt::format("A bit-width packer of size {} was used to pack only {} values",
+                                    m_layout.size, m_index));
+        }
+
+        return static_cast<T>(m_value);
+    }
+};
+
+// Compute the layout for ss, throwing an error if ss
+// cannot be represented by a bw_packed_monomial<T, L>.
+template <typename T, typename L>
+inline bw_layout bw_make_layout_checked(const symbol_set &ss)
+{
+    auto ret = detail::bw_fetch_layout<L>(ss);
+
+    if (obake_unlikely(!detail::bw_layout_ok<T>(ret))) {
+        obake_throw(::std::invalid_argument,
+                    fmt::format("The symbol set {} cannot be represented by a bit-width packed monomial of type "
+                                "'{}': either some symbols are not supported by the layout, or the total number "
+                                "of bits is larger than the bit width of the type",
+                                ::obake::detail::to_string(ss), ::obake::type_name<T>()));
+    }
+
+    return *ret;
+}
+
+} // namespace detail
+
+// Packed monomial with per-variable bit widths.
+//
+// In packed_monomial, all the exponents share the same range,
+// which is determined by the number of variables. Here,
+// instead, each exponent is stored in a bit field whose width is
+// associated to the name of the variable by the layout type L
+// (see BwLayout).
+// Signed exponents are stored in two's complement, and the fields
+// are summed (rather than OR-ed) into the value, so that the encoding
+// is homomorphic also in the presence of negative exponents.
+//
+// Because the widths depend on the symbol set, the constructors
+// from exponents require the symbol set.
+template <typename T, typename L>
+    requires detail::is_bw_packable_v<T> && BwLayout<L>
+class bw_packed_monomial
+{
+    friend class ::boost::serialization::access;
+
+public:
+    // Alias for T.
+    using value_type = T;
+    // Alias for L.
+    using layout_type = L;
+
+    // Def ctor inits to a monomial with all zero exponents.
+    constexpr bw_packed_monomial() : m_value(0) {}
+    // Constructor from symbol set.
+    constexpr explicit bw_packed_monomial(const symbol_set &) : bw_packed_monomial() {}
+    // Constructor from value.
+    constexpr explicit bw_packed_monomial(const T &n) : m_value(n) {}
+    // Constructor from a pair of input iterators and symbol set.
+    template <typename It>
+        requires InputIterator<It> && SafelyCastable<typename ::std::iterator_traits<It>::reference, T>
+    explicit bw_packed_monomial(It b, It e, const symbol_set &ss)
+    {
+        const auto l = detail::bw_make_layout_checked<T, L>(ss);
+
+        detail::bw_packer<T> bp(l);
+        for (; b != e; ++b) {
+            bp << ::obake::safe_cast<T>(*b);
+        }
+        m_value = bp.get();
+    }
+    // Ctor from input range and symbol set.
+    template <typename Range>
+        requires InputRange<Range>
+                 && SafelyCastable<typename ::std::iterator_traits<range_begin_t<Range>>::reference, T>
+    explicit bw_packed_monomial(Range &&r, const symbol_set &ss)
+        : bw_packed_monomial(::obake::begin(::std::forward<Range>(r)), ::obake::end(::std::forward<Range>(r)), ss)
+    {
+    }
+    // Ctor from init list and symbol set.
+    template <typename U>
+        requires SafelyCastable<const U &, T>
+    explicit bw_packed_monomial(::std::initializer_list<U> l, const symbol_set &ss)
+        : bw_packed_monomial(l.begin(), l.end(), ss)
+    {
+    }
+    // Getter for the internal value.
+    constexpr const T &get_value() const
+    {
+        return m_value;
+    }
+    // Setter for the internal value.
+    constexpr void _set_value(const T &n)
+    {
+        m_value = n;
+    }
+
+private:
+    // Serialisation.
+    template <class Archive>
+    void serialize(Archive &ar, unsigned)
+    {
+        ar &m_value;
+    }
+
+private:
+    T m_value;
+};
+
+// Implementation of key_is_zero(). A monomial is never zero.
+template <typename T, typename L>
+constexpr bool key_is_zero(const bw_packed_monomial<T, L> &, const symbol_set &)
+{
+    return false;
+}
+
+// Implementation of key_is_one(). A monomial is one if all its exponents are zero.
+template <typename T, typename L>
+constexpr bool key_is_one(const bw_packed_monomial<T, L> &p, const symbol_set &)
+{
+    return p.get_value() == T(0);
+}
+
+// Comparison operators.
+template <typename T, typename L>
+constexpr bool operator==(const bw_packed_monomial<T, L> &m1, const bw_packed_monomial<T, L> &m2)
+{
+    return m1.get_value() == m2.get_value();
+}
+
+template <typename T, typename L>
+constexpr bool operator!=(const bw_packed_monomial<T, L> &m1, const bw_packed_monomial<T, L> &m2)
+{
+    return m1.get_value() != m2.get_value();
+}
+
+// Hash implementation.
+template <typename T, typename L>
+constexpr ::std::size_t hash(const bw_packed_monomial<T, L> &m)
+{
+    return static_cast<::std::size_t>(m.get_value());
+}
+
+// Symbol set compatibility implementation.
+template <typename T, typename L>
+inline bool key_is_compatible(const bw_packed_monomial<T, L> &m, const symbol_set &s)
+{
+    if (s.empty()) {
+        // In case of an empty symbol set,
+        // the only valid value for the monomial
+        // is zero.
+        return m.get_value() == T(0);
+    }
+
+    const auto l = detail::bw_fetch_layout<L>(s);
+
+    if (!detail::bw_layout_ok<T>(l)) {
+        return false;
+    }
+
+    // Decode and re-encode the value. The value is valid
+    // if the re-encoding yields the original value.
+    detail::bw_packer<T> bp(*l);
+    detail::bw_decode(m.get_value(), *l, [&bp](auto, const T &e) { bp << e; });
+
+    return bp.get() == m.get_value();
+}
+
+// Stream insertion.
+// NOTE: requires that m is compatible with s.
+template <typename T, typename L>
+inline void key_stream_insert(::std::ostream &os, const bw_packed_monomial<T, L> &m, const symbol_set &s)
+{
+    assert(polynomials::key_is_compatible(m, s));
+
+    bool wrote_something = false;
+
+    if (!s.empty()) {
+        const auto l = detail::bw_fetch_layout<L>(s);
+
+        detail::bw_decode(m.get_value(), *l, [&os, &s, &wrote_something](auto i, const T &e) {
+            if (e != T(0)) {
+                // The exponent of the current variable
+                // is nonzero.
+                if (wrote_something) {
+                    os << '*';
+                }
+                // Print the variable name.
+                os << *s.nth(i);
+                wrote_something = true;
+                if (e != T(1)) {
+                    // The exponent is not unitary,
+                    // print it.
+                    os << "**" << e;
+                }
+            }
+        });
+    }
+
+    if (!wrote_something) {
+        // All variables have zero
+        // exponent, thus we print only "1".
+        assert(m.get_value() == T(0));
+        os << '1';
+    }
+}
+
+// Tex stream insertion.
+// NOTE: requires that m is compatible with s.
+template <typename T, typename L>
+inline void key_tex_stream_insert(::std::ostream &os, const bw_packed_monomial<T, L> &m, const symbol_set &s)
+{
+    assert(polynomials::key_is_compatible(m, s));
+
+    // Use separate streams for numerator and denominator
+    // (the denominator is used only in case of negative powers).
+    ::std::ostringstream oss_num, oss_den;
+    oss_num.exceptions(::std::ios_base::failbit | ::std::ios_base::badbit);
+    oss_num.flags(os.flags());
+    oss_den.exceptions(::std::ios_base::failbit | ::std::ios_base::badbit);
+    oss_den.flags(os.flags());
+
+    if (!s.empty()) {
+        const auto l = detail::bw_fetch_layout<L>(s);
+
+        // NOTE: go through a multiprecision integer, so that
+        // we do not need to care about overflow when taking
+        // the absolute value of the exponent.
+        ::mppp::integer<1> tmp_mp;
+        detail::bw_decode(m.get_value(), *l, [&](auto i, const T &e) {
+            tmp_mp = e;
+
+            const auto sgn = tmp_mp.sgn();
+            if (sgn != 0) {
+                auto *cur_oss = &oss_num;
+                if (sgn == -1) {
+                    tmp_mp.neg();
+                    cur_oss = &oss_den;
+                }
+
+                // Print the symbol name.
+                *cur_oss << fmt::format("{{{}}}", *s.nth(i));
+
+                // Raise to power, if the exponent is not one.
+                if (!tmp_mp.is_one()) {
+                    *cur_oss << fmt::format(fmt::runtime("^{{{}}}"), tmp_mp);
+                }
+            }
+        });
+    }
+
+    const auto num_str = oss_num.str(), den_str = oss_den.str();
+
+    if (!num_str.empty() && !den_str.empty()) {
+        os << fmt::format("\\frac{{{}}}{{{}}}", num_str, den_str);
+    } else if (!num_str.empty() && den_str.empty()) {
+        os << num_str;
+    } else if (num_str.empty() && !den_str.empty()) {
+        os << fmt::format("\\frac{{1}}{{{}}}", den_str);
+    } else {
+        assert(m.get_value() == T(0));
+        os << '1';
+    }
+}
+
+// Symbols merging.
+// NOTE: requires that m is compatible with s, and ins_map consistent with s.
+template <typename T, typename L>
+inline bw_packed_monomial<T, L> key_merge_symbols(const bw_packed_monomial<T, L> &m,
+                                                  const symbol_idx_map<symbol_set> &ins_map, const symbol_set &s)
+{
+    assert(polynomials::key_is_compatible(m, s));
+    assert(ins_map.empty() || ins_map.rbegin()->first <= s.size());
+
+    // Build the layout of the merged symbol set, and unpack
+    // the exponents of m.
+    detail::bw_layout ml;
+    ::std::vector<T> exps;
+
+    auto push_w = [&ml](unsigned w) {
+        if (obake_unlikely(!ml.push_back(w) || ml.nbits > detail::bw_type_nbits<T>)) {
+            obake_throw(::std::overflow_error,
+                        fmt::format("Cannot merge new symbols into a bit-width packed monomial of type '{}': the "
+                                    "total number of bits after merging is larger than the bit width of the type",
+                                    ::obake::type_name<T>()));
+        }
+    };
+
+    auto add_new = [&push_w, &exps](const symbol_set &new_s) {
+        for (const auto &name : new_s) {
+            const auto w = L::exponent_bits(name);
+
+            if (obake_unlikely(w == 0u)) {
+                obake_throw(::std::invalid_argument,
+                            fmt::format("Cannot merge the symbol '{}' into a bit-width packed monomial: the "
+                                        "symbol is not supported by the layout",
+                                        name));
+            }
+
+            push_w(w);
+            exps.push_back(T(0));
+        }
+    };
+
+    auto map_it = ins_map.begin();
+    const auto map_end = ins_map.end();
+
+    if (!s.empty()) {
+        const auto l = detail::bw_fetch_layout<L>(s);
+
+        detail::bw_decode(m.get_value(), *l, [&](auto i, const T &e) {
+            if (map_it != map_end && map_it->first == i) {
+                add_new(map_it->second);
+                ++map_it;
+            }
+
+            push_w(l->widths[i]);
+            exps.push_back(e);
+        });
+    }
+
+    // We could still have symbols which need to be appended at the end.
+    if (map_it != map_end) {
+        add_new(map_it->second);
+        assert(map_it + 1 == map_end);
+    }
+
+    detail::bw_packer<T> bp(ml);
+    for (const auto &e : exps) {
+        bp << e;
+    }
+
+    return bw_packed_monomial<T, L>(bp.get());
+}
+
+// Implementation of monomial_mul().
+// NOTE: requires a, b and out to be compatible with ss.
+template <typename T, typename L>
+inline void monomial_mul(bw_packed_monomial<T, L> &out, const bw_packed_monomial<T, L> &a,
+                         const bw_packed_monomial<T, L> &b, [[maybe_unused]] const symbol_set &ss)
+{
+    // Verify the inputs.
+    assert(polynomials::key_is_compatible(a, ss));
+    assert(polynomials::key_is_compatible(b, ss));
+    assert(polynomials::key_is_compatible(out, ss));
+
+    // NOTE: do the addition in unsigned arithmetic,
+    // the overflow check ensures that the result is
+    // a valid encoding.
+    using u_t = make_unsigned_t<T>;
+    out._set_value(static_cast<T>(static_cast<u_t>(static_cast<u_t>(a.get_value()) + static_cast<u_t>(b.get_value()))));
+
+    // Verify the output as well.
+    assert(polynomials::key_is_compatible(out, ss));
+}
+
+namespace detail
+{
+
+// Small helper to detect if 2 types
+// are the same bw_packed_monomial type.
+template <typename, typename>
+struct same_bw_packed_monomial : ::std::false_type {
+};
+
+template <typename T, typename L>
+struct same_bw_packed_monomial<bw_packed_monomial<T, L>, bw_packed_monomial<T, L>> : ::std::true_type {
+};
+
+template <typename T, typename U>
+inline constexpr bool same_bw_packed_monomial_v = same_bw_packed_monomial<T, U>::value;
+
+} // namespace detail
+
+// Monomial overflow checking.
+// NOTE: this assumes that all the monomials in the 2 ranges
+// are compatible with ss.
+template <typename R1, typename R2>
+    requires InputRange<R1> && InputRange<R2>
+             && detail::same_bw_packed_monomial_v<
+                 remove_cvref_t<typename ::std::iterator_traits<range_begin_t<R1>>::reference>,
+                 remove_cvref_t<typename ::std::iterator_traits<range_begin_t<R2>>::reference>>
+inline bool monomial_range_overflow_check(R1 &&r1, R2 &&r2, const symbol_set &ss)
+{
+    using pm_t = remove_cvref_t<typename ::std::iterator_traits<range_begin_t<R1>>::reference>;
+    using value_type = typename pm_t::value_type;
+    using layout_t = typename pm_t::layout_type;
+    using int_t = ::mppp::integer<1>;
+
+    if (ss.empty()) {
+        // If the monomials have zero variables,
+        // there cannot be overflow.
+        return true;
+    }
+
+    auto b1 = ::obake::begin(::std::forward<R1>(r1));
+    const auto e1 = ::obake::end(::std::forward<R1>(r1));
+    auto b2 = ::obake::begin(::std::forward<R2>(r2));
+    const auto e2 = ::obake::end(::std::forward<R2>(r2));
+
+    if (b1 == e1 || b2 == e2) {
+        // If either range is empty, there will be no overflow.
+        return true;
+    }
+
+    const auto l = detail::bw_fetch_layout<layout_t>(ss);
+    assert(detail::bw_layout_ok<value_type>(l));
+
+    // Compute the min/max exponents of the monomials in a range.
+    auto compute_limits = [&l](auto b, auto e) {
+        ::std::vector<::std::pair<value_type, value_type>> limits;
+        limits.reserve(l->size);
+
+        detail::bw_decode((*b).get_value(), *l, [&limits](auto, const value_type &n) { limits.emplace_back(n, n); });
+
+        for (++b; b != e; ++b) {
+            detail::bw_decode((*b).get_value(), *l, [&limits](auto i, const value_type &n) {
+                limits[i].first = ::std::min(limits[i].first, n);
+                limits[i].second = ::std::max(limits[i].second, n);
+            });
+        }
+
+        return limits;
+    };
+
+    const auto limits1 = compute_limits(b1, e1);
+    const auto limits2 = compute_limits(b2, e2);
+
+    // Add the limits via interval arithmetics
+    // and check them against the limits of each field.
+    for (decltype(limits1.size()) i = 0; i < limits1.size(); ++i) {
+        const auto [lim_min, lim_max] = detail::bw_field_lims<value_type>(l->widths[i]);
+
+        const auto add_min = int_t{limits1[i].first} + limits2[i].first;
+        const auto add_max = int_t{limits1[i].second} + limits2[i].second;
+
+        if (obake_unlikely(add_min < lim_min || add_max > lim_max)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Implementation of key_degree().
+// NOTE: this assumes that p is compatible with ss.
+// NOTE: the degree cannot overflow, because the sum
+// of the widths is not greater than the bit width of T.
+template <typename T, typename L>
+inline T key_degree(const bw_packed_monomial<T, L> &p, const symbol_set &ss)
+{
+    assert(polynomials::key_is_compatible(p, ss));
+
+    T retval(0);
+
+    if (!ss.empty()) {
+        detail::bw_decode(p.get_value(), *detail::bw_fetch_layout<L>(ss),
+                          [&retval](auto, const T &e) { retval = static_cast<T>(retval + e); });
+    }
+
+    return retval;
+}
+
+// Implementation of key_p_degree().
+// NOTE: this assumes that p and si are compatible with ss.
+template <typename T, typename L>
+inline T key_p_degree(const bw_packed_monomial<T, L> &p, const symbol_idx_set &si, const symbol_set &ss)
+{
+    assert(polynomials::key_is_compatible(p, ss));
+    assert(si.empty() || *(si.end() - 1) < ss.size());
+
+    T retval(0);
+
+    if (!si.empty()) {
+        detail::bw_decode(p.get_value(), *detail::bw_fetch_layout<L>(ss), [&retval, &si](auto i, const T &e) {
+            if (si.find(static_cast<symbol_idx>(i)) != si.end()) {
+                retval = static_cast<T>(retval + e);
+            }
+        });
+    }
+
+    return retval;
+}
+
+// Monomial exponentiation.
+// NOTE: this assumes that p is compatible with ss.
+template <typename T, typename L, typename U,
+          ::std::enable_if_t<::std::disjunction_v<::obake::detail::is_mppp_integer<U>,
+                                                  is_safely_convertible<const U &, ::mppp::integer<1> &>>,
+                             int>
+          = 0>
+inline bw_packed_monomial<T, L> monomial_pow(const bw_packed_monomial<T, L> &p, const U &n, const symbol_set &ss)
+{
+    assert(polynomials::key_is_compatible(p, ss));
+
+    if (ss.empty()) {
+        return p;
+    }
+
+    // NOTE: exp will be a const ref if n is already
+    // an mppp integer, a new value otherwise.
+    decltype(auto) exp = [&n]() -> decltype(auto) {
+        if constexpr (::obake::detail::is_mppp_integer_v<U>) {
+            return n;
+        } else {
+            ::mppp::integer<1> ret;
+
+            if (obake_unlikely(!::obake::safe_convert(ret, n))) {
+                obake_throw(::std::invalid_argument, "Invalid exponent for monomial exponentiation: the exponent "
+                                                     "cannot be converted into an integral value");
+            }
+
+            return ret;
+        }
+    }();
+
+    // Unpack, multiply in arbitrary-precision arithmetic, re-pack.
+    const auto l = detail::bw_fetch_layout<L>(ss);
+    detail::bw_packer<T> bp(*l);
+    remove_cvref_t<decltype(exp)> tmp_int;
+    detail::bw_decode(p.get_value(), *l, [&](auto, const T &e) {
+        tmp_int = e;
+        tmp_int *= exp;
+        bp << static_cast<T>(tmp_int);
+    });
+
+    return bw_packed_monomial<T, L>(bp.get());
+}
+
+// Evaluation of a bit-width packed monomial.
+// NOTE: this requires that p is compatible with ss,
+// and that sm is consistent with ss.
+template <typename T, typename L, typename U, ::std::enable_if_t<detail::pm_key_evaluate_algo<T, U> != 0, int> = 0>
+inline detail::pm_key_evaluate_ret_t<T, U> key_evaluate(const bw_packed_monomial<T, L> &p, const symbol_idx_map<U> &sm,
+                                                        const symbol_set &ss)
+{
+    assert(polynomials::key_is_compatible(p, ss));
+    assert(sm.size() == ss.size() && (sm.empty() || (sm.cend() - 1)->first == ss.size() - 1u));
+
+    detail::pm_key_evaluate_ret_t<T, U> retval(1);
+
+    if (!ss.empty()) {
+        auto sm_it = sm.cbegin();
+        detail::bw_decode(p.get_value(), *detail::bw_fetch_layout<L>(ss), [&retval, &sm_it](auto, const T &e) {
+            retval *= ::obake::pow(sm_it->second, e);
+            ++sm_it;
+        });
+    }
+
+    return retval;
+}
+
+// Substitution of symbols in a bit-width packed monomial.
+// NOTE: this requires that p is compatible with ss,
+// and that sm is consistent with ss.
+template <typename T, typename L, typename U, ::std::enable_if_t<detail::pm_monomial_subs_algo<T, U> != 0, int> = 0>
+inline ::std::pair<detail::pm_monomial_subs_ret_t<T, U>, bw_packed_monomial<T, L>>
+monomial_subs(const bw_packed_monomial<T, L> &p, const symbol_idx_map<U> &sm, const symbol_set &ss)
+{
+    assert(polynomials::key_is_compatible(p, ss));
+    assert(sm.size() <= ss.size() && (sm.empty() || (sm.cend() - 1)->first < ss.size()));
+
+    detail::pm_monomial_subs_ret_t<T, U> retval(1);
+
+    if (ss.empty()) {
+        return ::std::make_pair(::std::move(retval), p);
+    }
+
+    const auto l = detail::bw_fetch_layout<L>(ss);
+    detail::bw_packer<T> bp(*l);
+    auto sm_it = sm.cbegin();
+    const auto sm_end = sm.cend();
+    detail::bw_decode(p.get_value(), *l, [&](auto i, const T &e) {
+        if (sm_it != sm_end && sm_it->first == i) {
+            // The current exponent is in the subs map,
+            // accumulate the result of the substitution
+            // and set the exponent to zero.
+            retval *= ::obake::pow(sm_it->second, e);
+            bp << T(0);
+            ++sm_it;
+        } else {
+            bp << e;
+        }
+    });
+    assert(sm_it == sm_end);
+
+    return ::std::make_pair(::std::move(retval), bw_packed_monomial<T, L>(bp.get()));
+}
+
+// Identify non-trimmable exponents in p.
+// NOTE: this requires that p is compatible with ss,
+// and that v has the same size as ss.
+template <typename T, typename L>
+inline void key_trim_identify(::std::vector<int> &v, const bw_packed_monomial<T, L> &p, const symbol_set &ss)
+{
+    assert(polynomials::key_is_compatible(p, ss));
+    assert(v.size() == ss.size());
+
+    if (!ss.empty()) {
+        detail::bw_decode(p.get_value(), *detail::bw_fetch_layout<L>(ss), [&v](auto i, const T &e) {
+            if (e != T(0)) {
+                // The current exponent is nonzero,
+                // thus it must not be trimmed.
+                v[i] = 0;
+            }
+        });
+    }
+}
+
+// Eliminate from p the exponents at the indices
+// specifed by si.
+// NOTE: this requires that p is compatible with ss,
+// and that si is consistent with ss.
+template <typename T, typename L>
+inline bw_packed_monomial<T, L> key_trim(const bw_packed_monomial<T, L> &p, const symbol_idx_set &si,
+                                         const symbol_set &ss)
+{
+    assert(polynomials::key_is_compatible(p, ss));
+    assert(si.size() <= ss.size() && (si.empty() || *(si.cend() - 1) < ss.size()));
+
+    if (ss.empty()) {
+        return p;
+    }
+
+    const auto l = detail::bw_fetch_layout<L>(ss);
+
+    // Build the layout of the trimmed symbol set.
+    // NOTE: the trimmed layout is a subset of a valid
+    // layout, thus the insertions cannot fail.
+    detail::bw_layout tl;
+    for (unsigned i = 0; i < l->size; ++i) {
+        if (si.find(static_cast<symbol_idx>(i)) == si.end()) {
+            [[maybe_unused]] const auto ret = tl.push_back(l->widths[i]);
+            assert(ret);
+        }
+    }
+
+    detail::bw_packer<T> bp(tl);
+    detail::bw_decode(p.get_value(), *l, [&bp, &si](auto i, const T &e) {
+        if (si.find(static_cast<symbol_idx>(i)) == si.end()) {
+            bp << e;
+        }
+    });
+
+    return bw_packed_monomial<T, L>(bp.get());
+}
+
+// Monomial differentiation.
+// NOTE: this requires that p is compatible with ss,
+// and idx is within ss.
+template <typename T, typename L>
+inline ::std::pair<T, bw_packed_monomial<T, L>> monomial_diff(const bw_packed_monomial<T, L> &p, const symbol_idx &idx,
+                                                           const symbol_set &ss)
+{
+    assert(polynomials::key_is_compatible(p, ss));
+    assert(idx < ss.size());
+
+    const auto l = detail::bw_fetch_layout<L>(ss);
+    detail::bw_packer<T> bp(*l);
+    T ret_exp(0);
+    detail::bw_decode(p.get_value(), *l, [&](auto i, T e) {
+        if (i == idx && e != T(0)) {
+            // NOTE: the exponent of the differentiation variable
+            // is not zero. Take the derivative.
+            if (obake_unlikely(e == detail::bw_field_lims<T>(l->widths[i]).first)) {
+                obake_throw(::std::overflow_error, "Overflow detected while differentiating a bit-width "
+                                                   "packed monomial");
+            }
+
+            ret_exp = e--;
+        }
+
+        bp << e;
+    });
+
+    return ::std::make_pair(ret_exp, bw_packed_monomial<T, L>(bp.get()));
+}
+
+// Monomial integration.
+// NOTE: this requires that p is compatible with ss,
+// and idx is within ss.
+template <typename T, typename L>
+inline ::std::pair<T, bw_packed_monomial<T, L>> monomial_integrate(const bw_packed_monomial<T, L> &p,
+                                                                   const symbol_idx &idx, const symbol_set &ss)
+{
+    assert(polynomials::key_is_compatible(p, ss));
+    assert(idx < ss.size());
+
+    const auto l = detail::bw_fetch_layout<L>(ss);
+    detail::bw_packer<T> bp(*l);
+    T ret_exp(0);
+    detail::bw_decode(p.get_value(), *l, [&](auto i, T e) {
+        if (i == idx) {
+            if constexpr (is_signed_v<T>) {
+                // For signed integrals, make sure
+                // we are not integrating x**-1.
+                if (obake_unlikely(e == T(-1))) {
+                    obake_throw(::std::domain_error,
+                                fmt::format("Cannot integrate a bit-width packed monomial: the exponent of the "
+                                            "integration variable ('{}') is -1, and the integration would "
+                                            "generate a logarithmic term",
+                                            *ss.nth(i)));
+                }
+            }
+
+            if (obake_unlikely(e == detail::bw_field_lims<T>(l->widths[i]).second)) {
+                obake_throw(::std::overflow_error, "Overflow detected while integrating a bit-width "
+                                                   "packed monomial");
+            }
+
+            ret_exp = ++e;
+        }
+
+        bp << e;
+    });
+    // We must have written some nonzero value to ret_exp.
+    assert(ret_exp != T(0));
+
+    return ::std::make_pair(ret_exp, bw_packed_monomial<T, L>(bp.get()));
+}
+
+} // namespace polynomials
+
+// Lift to the obake namespace.
+template <typename T, typename L>
+using bw_packed_monomial = polynomials::bw_packed_monomial<T, L>;
+
+// Specialise monomial_has_homomorphic_hash.
+template <typename T, typename L>
+inline constexpr bool monomial_hash_is_homomorphic<bw_packed_monomial<T, L>> = true;
+
+} // namespace obake
+
+namespace boost::serialization
+{
+
+// Disable tracking for bw_packed_monomial.
+template <typename T, typename L>
+struct tracking_level<::obake::bw_packed_monomial<T, L>>
+    : ::obake::detail::s11n_no_tracking<::obake::bw_packed_monomial<T, L>> {
+};
+
+} // namespace boost::serialization
+
+#endif
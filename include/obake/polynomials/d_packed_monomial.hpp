@@ -10,6 +10,7 @@
 #define OBAKE_POLYNOMIALS_D_PACKED_MONOMIAL_HPP
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -24,6 +25,7 @@
 
 #include <boost/container/container_fwd.hpp>
 #include <boost/container/small_vector.hpp>
+#include <boost/container/static_vector.hpp>
 #include <boost/serialization/access.hpp>
 #include <boost/serialization/split_member.hpp>
 
@@ -80,7 +82,13 @@ template <kpackable T>
 inline constexpr unsigned dpm_max_psize = ::obake::detail::kpack_max_size<T>();
 
 // Dynamic packed monomial.
-template <kpackable T, unsigned PSize>
+// NOTE: if NPacks is nonzero, the packs are stored inline in a
+// container with a fixed capacity of NPacks packs, rather than in a
+// small vector which allocates on the heap when more than one pack is needed.
+// All the monomials of this type then have the same size and no
+// dynamic allocation is ever performed, so that in a series table
+// the keys are stored contiguously with a fixed stride.
+template <kpackable T, unsigned PSize, unsigned NPacks = 0>
     requires(PSize > 0u) && (PSize <= dpm_max_psize<T>)
 class d_packed_monomial
 {
@@ -90,19 +98,40 @@ public:
     // Alias for PSize
     static constexpr unsigned psize = PSize;
 
+    // Alias for NPacks.
+    static constexpr unsigned npacks = NPacks;
+
     // Alias for T.
     using value_type = T;
 
     // The container type.
-    using container_t = ::boost::container::small_vector<T, 1>;
+    using container_t = ::std::conditional_t<NPacks == 0u, ::boost::container::small_vector<T, 1>,
+                                             ::boost::container::static_vector<T, NPacks>>;
+
+private:
+    // Helper to check that n packs fit in a container
+    // with fixed capacity.
+    static void check_n_packs([[maybe_unused]] ::std::size_t n)
+    {
+        if constexpr (NPacks != 0u) {
+            if (obake_unlikely(n > NPacks)) {
+                obake_throw(::std::overflow_error,
+                            fmt::format("Cannot construct a dynamic packed monomial with {} packs: the "
+                                        "capacity of the monomial is limited to {} packs",
+                                        n, NPacks));
+            }
+        }
+    }
 
+public:
     // Default constructor.
     d_packed_monomial() = default;
 
     // Constructor from symbol set.
     explicit d_packed_monomial(const symbol_set &ss)
-        : m_container(::obake::safe_cast<typename container_t::size_type>(
-            detail::dpm_n_expos_to_vsize<d_packed_monomial>(ss.size())))
+        : m_container((check_n_packs(detail::dpm_n_expos_to_vsize<d_packed_monomial>(ss.size())),
+                       ::obake::safe_cast<typename container_t::size_type>(
+                           detail::dpm_n_expos_to_vsize<d_packed_monomial>(ss.size()))))
     {
     }
 
@@ -112,7 +141,8 @@ public:
     explicit d_packed_monomial(It it, ::std::size_t n)
         // LCOV_EXCL_START
         : m_container(
-            ::obake::safe_cast<typename container_t::size_type>(detail::dpm_n_expos_to_vsize<d_packed_monomial>(n)),
+            (check_n_packs(detail::dpm_n_expos_to_vsize<d_packed_monomial>(n)),
+             ::obake::safe_cast<typename container_t::size_type>(detail::dpm_n_expos_to_vsize<d_packed_monomial>(n))),
             // NOTE: avoid value-init of the elements, as we will
             // be setting all of them to some value in the loop below.
             ::boost::container::default_init_t{})
@@ -149,6 +179,7 @@ private:
                 kp << ::obake::safe_cast<T>(*b);
             }
 
+            check_n_packs(static_cast<::std::size_t>(m_container.size()) + 1u);
             m_container.push_back(kp.get());
         }
     }
@@ -204,6 +235,7 @@ private:
     {
         decltype(m_container.size()) size;
         ar >> size;
+        check_n_packs(::obake::safe_cast<::std::size_t>(size));
         m_container.resize(size);
 
         for (auto &n : m_container) {
@@ -244,35 +276,35 @@ using dpm_default_u_t =
     ;
 
 // Implementation of key_is_zero(). A monomial is never zero.
-template <typename T, unsigned PSize>
-inline bool key_is_zero(const d_packed_monomial<T, PSize> &, const symbol_set &)
+template <typename T, unsigned PSize, unsigned NPacks>
+inline bool key_is_zero(const d_packed_monomial<T, PSize, NPacks> &, const symbol_set &)
 {
     return false;
 }
 
 // Implementation of key_is_one(). A monomial is one if all its exponents are zero.
-template <typename T, unsigned PSize>
-inline bool key_is_one(const d_packed_monomial<T, PSize> &d, const symbol_set &)
+template <typename T, unsigned PSize, unsigned NPacks>
+inline bool key_is_one(const d_packed_monomial<T, PSize, NPacks> &d, const symbol_set &)
 {
     return ::std::all_of(d._container().cbegin(), d._container().cend(), [](const T &n) { return n == T(0); });
 }
 
 // Comparisons.
-template <typename T, unsigned PSize>
-inline bool operator==(const d_packed_monomial<T, PSize> &d1, const d_packed_monomial<T, PSize> &d2)
+template <typename T, unsigned PSize, unsigned NPacks>
+inline bool operator==(const d_packed_monomial<T, PSize, NPacks> &d1, const d_packed_monomial<T, PSize, NPacks> &d2)
 {
     return d1._container() == d2._container();
 }
 
-template <typename T, unsigned PSize>
-inline bool operator!=(const d_packed_monomial<T, PSize> &d1, const d_packed_monomial<T, PSize> &d2)
+template <typename T, unsigned PSize, unsigned NPacks>
+inline bool operator!=(const d_packed_monomial<T, PSize, NPacks> &d1, const d_packed_monomial<T, PSize, NPacks> &d2)
 {
     return !(d1 == d2);
 }
 
 // Hash implementation.
-template <typename T, unsigned PSize>
-inline ::std::size_t hash(const d_packed_monomial<T, PSize> &d)
+template <typename T, unsigned PSize, unsigned NPacks>
+inline ::std::size_t hash(const d_packed_monomial<T, PSize, NPacks> &d)
 {
     // NOTE: the idea is that we will mix the individual
     // hashes for every pack of exponents via addition.
@@ -318,16 +350,17 @@ inline bool dpm_key_is_compatible(const T &d, const symbol_set &s, const F &f, u
 } // namespace detail
 
 // Symbol set compatibility implementation.
-template <typename T, unsigned PSize>
-inline bool key_is_compatible(const d_packed_monomial<T, PSize> &d, const symbol_set &s)
+template <typename T, unsigned PSize, unsigned NPacks>
+inline bool key_is_compatible(const d_packed_monomial<T, PSize, NPacks> &d, const symbol_set &s)
 {
-    return detail::dpm_key_is_compatible(d, s, detail::dpm_n_expos_to_vsize<d_packed_monomial<T, PSize>>, PSize);
+    return detail::dpm_key_is_compatible(d, s, detail::dpm_n_expos_to_vsize<d_packed_monomial<T, PSize, NPacks>>,
+                                         PSize);
 }
 
 // Implementation of stream insertion.
 // NOTE: requires that d is compatible with s.
-template <typename T, unsigned PSize>
-inline void key_stream_insert(::std::ostream &os, const d_packed_monomial<T, PSize> &d, const symbol_set &s)
+template <typename T, unsigned PSize, unsigned NPacks>
+inline void key_stream_insert(::std::ostream &os, const d_packed_monomial<T, PSize, NPacks> &d, const symbol_set &s)
 {
     assert(polynomials::key_is_compatible(d, s));
 
@@ -382,8 +415,8 @@ extern template void key_stream_insert(::std::ostream &, const d_packed_monomial
 
 // Implementation of tex stream insertion.
 // NOTE: requires that d is compatible with s.
-template <typename T, unsigned PSize>
-inline void key_tex_stream_insert(::std::ostream &os, const d_packed_monomial<T, PSize> &d, const symbol_set &s)
+template <typename T, unsigned PSize, unsigned NPacks>
+inline void key_tex_stream_insert(::std::ostream &os, const d_packed_monomial<T, PSize, NPacks> &d, const symbol_set &s)
 {
     assert(polynomials::key_is_compatible(d, s));
 
@@ -470,9 +503,10 @@ extern template void key_tex_stream_insert(::std::ostream &,
 
 // Implementation of symbols merging.
 // NOTE: requires that m is compatible with s, and ins_map consistent with s.
-template <typename T, unsigned PSize>
-inline d_packed_monomial<T, PSize> key_merge_symbols(const d_packed_monomial<T, PSize> &d,
-                                                     const symbol_idx_map<symbol_set> &ins_map, const symbol_set &s)
+template <typename T, unsigned PSize, unsigned NPacks>
+inline d_packed_monomial<T, PSize, NPacks> key_merge_symbols(const d_packed_monomial<T, PSize, NPacks> &d,
+                                                             const symbol_idx_map<symbol_set> &ins_map,
+                                                             const symbol_set &s)
 {
     assert(polynomials::key_is_compatible(d, s));
     // The last element of the insertion map must be at most s.size(), which means that there
@@ -516,7 +550,7 @@ inline d_packed_monomial<T, PSize> key_merge_symbols(const d_packed_monomial<T,
         assert(map_it + 1 == map_end);
     }
 
-    return d_packed_monomial<T, PSize>(tmp_v);
+    return d_packed_monomial<T, PSize, NPacks>(tmp_v);
 }
 
 extern template d_packed_monomial<dpm_default_s_t, dpm_default_psize>
@@ -529,9 +563,9 @@ key_merge_symbols(const d_packed_monomial<dpm_default_u_t, dpm_default_psize> &,
 
 // Implementation of monomial_mul().
 // NOTE: requires a, b and out to be compatible with ss.
-template <typename T, unsigned PSize>
-inline void monomial_mul(d_packed_monomial<T, PSize> &out, const d_packed_monomial<T, PSize> &a,
-                         const d_packed_monomial<T, PSize> &b, [[maybe_unused]] const symbol_set &ss)
+template <typename T, unsigned PSize, unsigned NPacks>
+inline void monomial_mul(d_packed_monomial<T, PSize, NPacks> &out, const d_packed_monomial<T, PSize, NPacks> &a,
+                         const d_packed_monomial<T, PSize, NPacks> &b, [[maybe_unused]] const symbol_set &ss)
 {
     // Verify the inputs.
     assert(polynomials::key_is_compatible(a, ss));
@@ -557,8 +591,9 @@ template <typename, typename>
 struct same_d_packed_monomial : ::std::false_type {
 };
 
-template <typename T, unsigned PSize>
-struct same_d_packed_monomial<d_packed_monomial<T, PSize>, d_packed_monomial<T, PSize>> : ::std::true_type {
+template <typename T, unsigned PSize, unsigned NPacks>
+struct same_d_packed_monomial<d_packed_monomial<T, PSize, NPacks>, d_packed_monomial<T, PSize, NPacks>>
+    : ::std::true_type {
 };
 
 template <typename T, typename U>
@@ -709,13 +744,13 @@ inline bool monomial_range_overflow_check(R1 &&r1, R2 &&r2, const symbol_set &ss
                 assert(polynomials::key_is_compatible(cur, ss));
 
                 symbol_idx idx = 0;
-                value_type tmp;
+                ::std::array<value_type, pm_t::psize> tmp_arr;
                 int_t deg;
                 for (const auto &n : cur._container()) {
-                    kunpacker<value_type> ku(n, psize);
+                    kunpack<pm_t::psize>(n, tmp_arr.data());
 
                     for (auto j = 0u; j < psize && idx < s_size; ++j, ++idx) {
-                        ku >> tmp;
+                        const auto &tmp = tmp_arr[j];
                         // Accumulate the degree.
                         deg += tmp;
 
@@ -775,13 +810,13 @@ inline bool monomial_range_overflow_check(R1 &&r1, R2 &&r2, const symbol_set &ss
                             assert(polynomials::key_is_compatible(m, ss));
 
                             symbol_idx idx = 0;
-                            value_type tmp;
+                            ::std::array<value_type, pm_t::psize> tmp_arr;
                             int_t deg;
                             for (const auto &n : m._container()) {
-                                kunpacker<value_type> ku(n, psize);
+                                kunpack<pm_t::psize>(n, tmp_arr.data());
 
                                 for (auto j = 0u; j < psize && idx < s_size; ++j, ++idx) {
-                                    ku >> tmp;
+                                    const auto &tmp = tmp_arr[j];
                                     // Accumulate the degree.
                                     deg += tmp;
 
@@ -898,21 +933,21 @@ inline bool monomial_range_overflow_check(R1 &&r1, R2 &&r2, const symbol_set &ss
 
 // Implementation of key_degree().
 // NOTE: this assumes that d is compatible with ss.
-template <typename T, unsigned PSize>
-inline T key_degree(const d_packed_monomial<T, PSize> &d, const symbol_set &ss)
+template <typename T, unsigned PSize, unsigned NPacks>
+inline T key_degree(const d_packed_monomial<T, PSize, NPacks> &d, const symbol_set &ss)
 {
     assert(polynomials::key_is_compatible(d, ss));
 
     const auto s_size = ss.size();
 
     symbol_idx idx = 0;
-    T tmp, retval(0);
+    T retval(0);
+    ::std::array<T, PSize> tmp;
     for (const auto &n : d._container()) {
-        kunpacker<T> ku(n, PSize);
+        kunpack<PSize>(n, tmp.data());
 
         for (auto j = 0u; j < PSize && idx < s_size; ++j, ++idx) {
-            ku >> tmp;
-            retval = ::obake::detail::safe_int_add(retval, tmp);
+            retval = ::obake::detail::safe_int_add(retval, tmp[j]);
         }
     }
 
@@ -927,8 +962,8 @@ extern template dpm_default_u_t key_degree(const d_packed_monomial<dpm_default_u
 
 // Implementation of key_p_degree().
 // NOTE: this assumes that d and si are compatible with ss.
-template <typename T, unsigned PSize>
-inline T key_p_degree(const d_packed_monomial<T, PSize> &d, const symbol_idx_set &si, const symbol_set &ss)
+template <typename T, unsigned PSize, unsigned NPacks>
+inline T key_p_degree(const d_packed_monomial<T, PSize, NPacks> &d, const symbol_idx_set &si, const symbol_set &ss)
 {
     assert(polynomials::key_is_compatible(d, ss));
     assert(si.empty() || *(si.end() - 1) < ss.size());
@@ -936,17 +971,16 @@ inline T key_p_degree(const d_packed_monomial<T, PSize> &d, const symbol_idx_set
     const auto s_size = ss.size();
 
     symbol_idx idx = 0;
-    T tmp, retval(0);
+    T retval(0);
+    ::std::array<T, PSize> tmp;
     auto si_it = si.begin();
     const auto si_it_end = si.end();
     for (const auto &n : d._container()) {
-        kunpacker<T> ku(n, PSize);
+        kunpack<PSize>(n, tmp.data());
 
         for (auto j = 0u; j < PSize && idx < s_size && si_it != si_it_end; ++j, ++idx) {
-            ku >> tmp;
-
             if (idx == *si_it) {
-                retval = ::obake::detail::safe_int_add(retval, tmp);
+                retval = ::obake::detail::safe_int_add(retval, tmp[j]);
                 ++si_it;
             }
         }
@@ -965,12 +999,13 @@ extern template dpm_default_u_t key_p_degree(const d_packed_monomial<dpm_default
 
 // Monomial exponentiation.
 // NOTE: this assumes that d is compatible with ss.
-template <typename T, unsigned PSize, typename U,
+template <typename T, unsigned PSize, unsigned NPacks, typename U,
           ::std::enable_if_t<::std::disjunction_v<::obake::detail::is_mppp_integer<U>,
                                                   is_safely_convertible<const U &, ::mppp::integer<1> &>>,
                              int>
           = 0>
-inline d_packed_monomial<T, PSize> monomial_pow(const d_packed_monomial<T, PSize> &d, const U &n, const symbol_set &ss)
+inline d_packed_monomial<T, PSize, NPacks> monomial_pow(const d_packed_monomial<T, PSize, NPacks> &d, const U &n,
+                                                        const symbol_set &ss)
 {
     assert(polynomials::key_is_compatible(d, ss));
 
@@ -995,7 +1030,7 @@ inline d_packed_monomial<T, PSize> monomial_pow(const d_packed_monomial<T, PSize
 
     // Prepare the return value.
     const auto &c_in = d._container();
-    d_packed_monomial<T, PSize> retval;
+    d_packed_monomial<T, PSize, NPacks> retval;
     auto &c_out = retval._container();
     c_out.reserve(c_in.size());
 
@@ -1026,10 +1061,16 @@ inline d_packed_monomial<T, PSize> monomial_pow(const d_packed_monomial<T, PSize
 // dynamic or static storage is being used.
 // Thus, this function will slightly overestimate
 // the actual byte size of d.
-template <typename T, unsigned PSize>
-inline ::std::size_t byte_size(const d_packed_monomial<T, PSize> &d)
+// NOTE: if NPacks is nonzero, the storage is
+// entirely inline and sizeof() is exact.
+template <typename T, unsigned PSize, unsigned NPacks>
+inline ::std::size_t byte_size(const d_packed_monomial<T, PSize, NPacks> &d)
 {
-    return sizeof(d) + d._container().capacity() * sizeof(T);
+    if constexpr (NPacks == 0u) {
+        return sizeof(d) + d._container().capacity() * sizeof(T);
+    } else {
+        return sizeof(d);
+    }
 }
 
 namespace detail
@@ -1078,8 +1119,9 @@ using dpm_key_evaluate_ret_t = typename decltype(dpm_key_evaluate_algorithm<T, U
 // Evaluation of a dynamic packed monomial.
 // NOTE: this requires that d is compatible with ss,
 // and that sm is consistent with ss.
-template <typename T, unsigned PSize, typename U, ::std::enable_if_t<detail::dpm_key_evaluate_algo<T, U> != 0, int> = 0>
-inline detail::dpm_key_evaluate_ret_t<T, U> key_evaluate(const d_packed_monomial<T, PSize> &d,
+template <typename T, unsigned PSize, unsigned NPacks, typename U,
+          ::std::enable_if_t<detail::dpm_key_evaluate_algo<T, U> != 0, int> = 0>
+inline detail::dpm_key_evaluate_ret_t<T, U> key_evaluate(const d_packed_monomial<T, PSize, NPacks> &d,
                                                          const symbol_idx_map<U> &sm, const symbol_set &ss)
 {
     assert(polynomials::key_is_compatible(d, ss));
@@ -1126,10 +1168,10 @@ using dpm_monomial_subs_ret_t = typename decltype(dpm_key_evaluate_algorithm<T,
 // Substitution of symbols in a dynamic packed monomial.
 // NOTE: this requires that d is compatible with ss,
 // and that sm is consistent with ss.
-template <typename T, unsigned PSize, typename U,
+template <typename T, unsigned PSize, unsigned NPacks, typename U,
           ::std::enable_if_t<detail::dpm_monomial_subs_algo<T, U> != 0, int> = 0>
-inline ::std::pair<detail::dpm_monomial_subs_ret_t<T, U>, d_packed_monomial<T, PSize>>
-monomial_subs(const d_packed_monomial<T, PSize> &d, const symbol_idx_map<U> &sm, const symbol_set &ss)
+inline ::std::pair<detail::dpm_monomial_subs_ret_t<T, U>, d_packed_monomial<T, PSize, NPacks>>
+monomial_subs(const d_packed_monomial<T, PSize, NPacks> &d, const symbol_idx_map<U> &sm, const symbol_set &ss)
 {
     assert(polynomials::key_is_compatible(d, ss));
     // sm must not be larger than ss, and the last element
@@ -1140,7 +1182,7 @@ monomial_subs(const d_packed_monomial<T, PSize> &d, const symbol_idx_map<U> &sm,
 
     // Init the return values.
     const auto &in_c = d._container();
-    d_packed_monomial<T, PSize> out_dpm;
+    d_packed_monomial<T, PSize, NPacks> out_dpm;
     auto &out_c = out_dpm._container();
     out_c.reserve(in_c.size());
     detail::dpm_monomial_subs_ret_t<T, U> retval(1);
@@ -1185,8 +1227,9 @@ monomial_subs(const d_packed_monomial<T, PSize> &d, const symbol_idx_map<U> &sm,
 // Identify non-trimmable exponents in d.
 // NOTE: this requires that d is compatible with ss,
 // and that v has the same size as ss.
-template <typename T, unsigned PSize>
-inline void key_trim_identify(::std::vector<int> &v, const d_packed_monomial<T, PSize> &d, const symbol_set &ss)
+template <typename T, unsigned PSize, unsigned NPacks>
+inline void key_trim_identify(::std::vector<int> &v, const d_packed_monomial<T, PSize, NPacks> &d,
+                              const symbol_set &ss)
 {
     assert(polynomials::key_is_compatible(d, ss));
     assert(v.size() == ss.size());
@@ -1222,9 +1265,9 @@ extern template void key_trim_identify(::std::vector<int> &,
 // specifed by si.
 // NOTE: this requires that d is compatible with ss,
 // and that si is consistent with ss.
-template <typename T, unsigned PSize>
-inline d_packed_monomial<T, PSize> key_trim(const d_packed_monomial<T, PSize> &d, const symbol_idx_set &si,
-                                            const symbol_set &ss)
+template <typename T, unsigned PSize, unsigned NPacks>
+inline d_packed_monomial<T, PSize, NPacks> key_trim(const d_packed_monomial<T, PSize, NPacks> &d,
+                                                    const symbol_idx_set &si, const symbol_set &ss)
 {
     assert(polynomials::key_is_compatible(d, ss));
     // NOTE: si cannot be larger than ss, and its last element must be smaller
@@ -1266,7 +1309,7 @@ inline d_packed_monomial<T, PSize> key_trim(const d_packed_monomial<T, PSize> &d
     }
     assert(si_it == si_end);
 
-    return d_packed_monomial<T, PSize>(tmp_v);
+    return d_packed_monomial<T, PSize, NPacks>(tmp_v);
 }
 
 extern template d_packed_monomial<dpm_default_s_t, dpm_default_psize>
@@ -1278,9 +1321,9 @@ key_trim(const d_packed_monomial<dpm_default_u_t, dpm_default_psize> &, const sy
 // Monomial differentiation.
 // NOTE: this requires that d is compatible with ss,
 // and idx is within ss.
-template <typename T, unsigned PSize>
-inline ::std::pair<T, d_packed_monomial<T, PSize>> monomial_diff(const d_packed_monomial<T, PSize> &d,
-                                                                 const symbol_idx &idx, const symbol_set &ss)
+template <typename T, unsigned PSize, unsigned NPacks>
+inline ::std::pair<T, d_packed_monomial<T, PSize, NPacks>>
+monomial_diff(const d_packed_monomial<T, PSize, NPacks> &d, const symbol_idx &idx, const symbol_set &ss)
 {
     assert(polynomials::key_is_compatible(d, ss));
     assert(idx < ss.size());
@@ -1289,7 +1332,7 @@ inline ::std::pair<T, d_packed_monomial<T, PSize>> monomial_diff(const d_packed_
 
     // Init the return value.
     const auto &in_c = d._container();
-    d_packed_monomial<T, PSize> out_dpm;
+    d_packed_monomial<T, PSize, NPacks> out_dpm;
     auto &out_c = out_dpm._container();
     out_c.reserve(in_c.size());
 
@@ -1332,9 +1375,9 @@ monomial_diff(const d_packed_monomial<dpm_default_u_t, dpm_default_psize> &, con
 // Monomial integration.
 // NOTE: this requires that d is compatible with ss,
 // and idx is within ss.
-template <typename T, unsigned PSize>
-inline ::std::pair<T, d_packed_monomial<T, PSize>> monomial_integrate(const d_packed_monomial<T, PSize> &d,
-                                                                      const symbol_idx &idx, const symbol_set &ss)
+template <typename T, unsigned PSize, unsigned NPacks>
+inline ::std::pair<T, d_packed_monomial<T, PSize, NPacks>>
+monomial_integrate(const d_packed_monomial<T, PSize, NPacks> &d, const symbol_idx &idx, const symbol_set &ss)
 {
     assert(polynomials::key_is_compatible(d, ss));
     assert(idx < ss.size());
@@ -1343,7 +1386,7 @@ inline ::std::pair<T, d_packed_monomial<T, PSize>> monomial_integrate(const d_pa
 
     // Init the return value.
     const auto &in_c = d._container();
-    d_packed_monomial<T, PSize> out_dpm;
+    d_packed_monomial<T, PSize, NPacks> out_dpm;
     auto &out_c = out_dpm._container();
     out_c.reserve(in_c.size());
 
@@ -1398,8 +1441,8 @@ monomial_integrate(const d_packed_monomial<dpm_default_u_t, dpm_default_psize> &
 } // namespace polynomials
 
 // Lift to the obake namespace.
-template <typename T, unsigned PSize>
-using d_packed_monomial = polynomials::d_packed_monomial<T, PSize>;
+template <typename T, unsigned PSize, unsigned NPacks = 0>
+using d_packed_monomial = polynomials::d_packed_monomial<T, PSize, NPacks>;
 
 // Definition of the default dynamically-packed monomial type.
 using d_monomial = d_packed_monomial<polynomials::dpm_default_u_t, polynomials::dpm_default_psize>;
@@ -1408,8 +1451,8 @@ using d_monomial = d_packed_monomial<polynomials::dpm_default_u_t, polynomials::
 using d_laurent_monomial = d_packed_monomial<polynomials::dpm_default_s_t, polynomials::dpm_default_psize>;
 
 // Specialise monomial_has_homomorphic_hash.
-template <typename T, unsigned PSize>
-inline constexpr bool monomial_hash_is_homomorphic<d_packed_monomial<T, PSize>> = true;
+template <typename T, unsigned PSize, unsigned NPacks>
+inline constexpr bool monomial_hash_is_homomorphic<d_packed_monomial<T, PSize, NPacks>> = true;
 
 } // namespace obake
 
@@ -1417,9 +1460,9 @@ namespace boost::serialization
 {
 
 // Disable tracking for d_packed_monomial.
-template <typename T, unsigned PSize>
-struct tracking_level<::obake::d_packed_monomial<T, PSize>>
-    : ::obake::detail::s11n_no_tracking<::obake::d_packed_monomial<T, PSize>> {
+template <typename T, unsigned PSize, unsigned NPacks>
+struct tracking_level<::obake::d_packed_monomial<T, PSize, NPacks>>
+    : ::obake::detail::s11n_no_tracking<::obake::d_packed_monomial<T, PSize, NPacks>> {
 };
 
 } // namespace boost::serialization
@@ -0,0 +1,469 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OBAKE_POLYNOMIALS_DEG_PACKED_MONOMIAL_HPP
+#define OBAKE_POLYNOMIALS_DEG_PACKED_MONOMIAL_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/iterator/transform_iterator.hpp>
+#include <boost/serialization/access.hpp>
+
+#include <mp++/integer.hpp>
+
+#include <obake/config.hpp>
+#include <obake/detail/mppp_utils.hpp>
+#include <obake/kpack.hpp>
+#include <obake/math/safe_cast.hpp>
+#include <obake/polynomials/monomial_homomorphic_hash.hpp>
+#include <obake/polynomials/packed_monomial.hpp>
+#include <obake/ranges.hpp>
+#include <obake/s11n.hpp>
+#include <obake/symbols.hpp>
+#include <obake/type_traits.hpp>
+
+namespace obake
+{
+
+namespace polynomials
+{
+
+namespace detail
+{
+
+// The integral type used to store the code of a degree-augmented
+// packed monomial with exponents of type T.
+template <typename T>
+using deg_pm_code_t = ::std::conditional_t<is_signed_v<T>, ::std::int64_t, ::std::uint64_t>;
+
+} // namespace detail
+
+// Degree-augmented packed monomial.
+//
+// The exponents are Kronecker-packed into a 32-bit code, exactly as in
+// packed_monomial<T>. The code is stored in the low half of a 64-bit
+// integer, while the high half stores the total degree of the monomial:
+//
+// value = degree * 2**32 + code.
+//
+// Because both the degree and the Kronecker code are additive
+// in monomial multiplication, the value is still homomorphic,
+// and the total degree can be extracted with a shift. Additionally,
+// the ordering of the values corresponds to the ordering by total degree.
+template <typename T>
+    requires(::std::is_same_v<T, ::std::int32_t> || ::std::is_same_v<T, ::std::uint32_t>)
+class deg_packed_monomial
+{
+    friend class ::boost::serialization::access;
+
+    static constexpr detail::deg_pm_code_t<T> shift_mul = detail::deg_pm_code_t<T>(1) << 32;
+
+    // Helper to build the value from the Kronecker code
+    // and the total degree.
+    static constexpr detail::deg_pm_code_t<T> encode(const T &code, const T &deg)
+    {
+        return static_cast<detail::deg_pm_code_t<T>>(deg) * shift_mul + code;
+    }
+
+public:
+    // Alias for T.
+    using value_type = T;
+    // The type of the augmented value.
+    using code_type = detail::deg_pm_code_t<T>;
+
+    // Def ctor inits to a monomial with all zero exponents.
+    constexpr deg_packed_monomial() : m_value(0) {}
+    // Constructor from symbol set.
+    constexpr explicit deg_packed_monomial(const symbol_set &) : deg_packed_monomial() {}
+    // Constructor from a packed monomial.
+    // NOTE: this requires p to be compatible with ss.
+    explicit deg_packed_monomial(const packed_monomial<T> &p, const symbol_set &ss)
+        : m_value(encode(p.get_value(), polynomials::key_degree(p, ss)))
+    {
+    }
+    // Constructor from input iterator and size.
+    template <typename It>
+        requires InputIterator<It> && SafelyCastable<typename ::std::iterator_traits<It>::reference, T>
+    constexpr explicit deg_packed_monomial(It it, unsigned n)
+    {
+        kpacker<T> kp(n);
+        T deg(0);
+        for (auto i = 0u; i < n; ++i, ++it) {
+            const auto tmp = ::obake::safe_cast<T>(*it);
+            kp << tmp;
+            // NOTE: no overflow is possible here, as the limits
+            // of the components ensure that their sum is representable.
+            deg += tmp;
+        }
+        m_value = encode(kp.get(), deg);
+    }
+
+private:
+    struct fwd_it_ctor_tag {
+    };
+    template <typename It>
+    constexpr explicit deg_packed_monomial(fwd_it_ctor_tag, It b, It e)
+        : deg_packed_monomial(b, ::obake::safe_cast<unsigned>(::std::distance(b, e)))
+    {
+    }
+
+public:
+    // Ctor from a pair of forward iterators.
+    template <typename It>
+        requires ForwardIterator<It> && SafelyCastable<typename ::std::iterator_traits<It>::difference_type, unsigned>
+                 && SafelyCastable<typename ::std::iterator_traits<It>::reference, T>
+    constexpr explicit deg_packed_monomial(It b, It e) : deg_packed_monomial(fwd_it_ctor_tag{}, b, e)
+    {
+    }
+    // Ctor from forward range.
+    template <typename Range>
+        requires ForwardRange<Range>
+                 && SafelyCastable<typename ::std::iterator_traits<range_begin_t<Range>>::difference_type, unsigned>
+                 && SafelyCastable<typename ::std::iterator_traits<range_begin_t<Range>>::reference, T>
+    constexpr explicit deg_packed_monomial(Range &&r)
+        : deg_packed_monomial(fwd_it_ctor_tag{}, ::obake::begin(::std::forward<Range>(r)),
+                              ::obake::end(::std::forward<Range>(r)))
+    {
+    }
+    // Ctor from init list.
+    template <typename U>
+        requires SafelyCastable<const U &, T>
+    constexpr explicit deg_packed_monomial(::std::initializer_list<U> l)
+        : deg_packed_monomial(fwd_it_ctor_tag{}, l.begin(), l.end())
+    {
+    }
+    // Create a monomial from the Kronecker code and the total degree.
+    // NOTE: deg must be the total degree of the monomial
+    // represented by code.
+    static constexpr deg_packed_monomial from_code(const T &code, const T &deg)
+    {
+        deg_packed_monomial retval;
+        retval.m_value = encode(code, deg);
+        return retval;
+    }
+    // Getter for the internal value.
+    constexpr const code_type &get_value() const
+    {
+        return m_value;
+    }
+    // Setter for the internal value.
+    constexpr void _set_value(const code_type &n)
+    {
+        m_value = n;
+    }
+    // Fetch the total degree.
+    constexpr T get_degree() const
+    {
+        if constexpr (is_signed_v<T>) {
+            // NOTE: the Kronecker code is in the [-2**31, 2**31)
+            // range, thus adding 2**31 and shifting
+            // yields the degree.
+            return static_cast<T>((m_value + shift_mul / 2) >> 32);
+        } else {
+            return static_cast<T>(m_value >> 32);
+        }
+    }
+    // Fetch the Kronecker code.
+    constexpr T get_code() const
+    {
+        return static_cast<T>(m_value - static_cast<code_type>(get_degree()) * shift_mul);
+    }
+    // Fetch the packed monomial with the same exponents.
+    constexpr packed_monomial<T> to_packed() const
+    {
+        return packed_monomial<T>(get_code());
+    }
+
+private:
+    // Serialisation.
+    template <class Archive>
+    void serialize(Archive &ar, unsigned)
+    {
+        ar &m_value;
+    }
+
+private:
+    code_type m_value;
+};
+
+// Implementation of key_is_zero(). A monomial is never zero.
+template <typename T>
+constexpr bool key_is_zero(const deg_packed_monomial<T> &, const symbol_set &)
+{
+    return false;
+}
+
+// Implementation of key_is_one(). A monomial is one if all its exponents are zero.
+template <typename T>
+constexpr bool key_is_one(const deg_packed_monomial<T> &p, const symbol_set &)
+{
+    return p.get_value() == 0;
+}
+
+// Comparison operators.
+template <typename T>
+constexpr bool operator==(const deg_packed_monomial<T> &m1, const deg_packed_monomial<T> &m2)
+{
+    return m1.get_value() == m2.get_value();
+}
+
+template <typename T>
+constexpr bool operator!=(const deg_packed_monomial<T> &m1, const deg_packed_monomial<T> &m2)
+{
+    return m1.get_value() != m2.get_value();
+}
+
+// Hash implementation.
+// NOTE: the hash is homomorphic also if std::size_t
+// is narrower than the value, because the conversion to
+// an unsigned type is a reduction modulo a power of two.
+template <typename T>
+constexpr ::std::size_t hash(const deg_packed_monomial<T> &m)
+{
+    return static_cast<::std::size_t>(m.get_value());
+}
+
+// Symbol set compatibility implementation.
+template <typename T>
+inline bool key_is_compatible(const deg_packed_monomial<T> &m, const symbol_set &s)
+{
+    const auto p = m.to_packed();
+
+    // The Kronecker code must be compatible with s,
+    // and the degree must be consistent with the code.
+    return polynomials::key_is_compatible(p, s) && polynomials::key_degree(p, s) == m.get_degree();
+}
+
+// Stream insertion.
+template <typename T>
+inline void key_stream_insert(::std::ostream &os, const deg_packed_monomial<T> &m, const symbol_set &s)
+{
+    polynomials::key_stream_insert(os, m.to_packed(), s);
+}
+
+// Tex stream insertion.
+template <typename T>
+inline void key_tex_stream_insert(::std::ostream &os, const deg_packed_monomial<T> &m, const symbol_set &s)
+{
+    polynomials::key_tex_stream_insert(os, m.to_packed(), s);
+}
+
+// Symbols merging.
+// NOTE: the merged symbols have zero exponents,
+// thus the degree does not change.
+template <typename T>
+inline deg_packed_monomial<T> key_merge_symbols(const deg_packed_monomial<T> &m,
+                                                const symbol_idx_map<symbol_set> &ins_map, const symbol_set &s)
+{
+    const auto pm = polynomials::key_merge_symbols(m.to_packed(), ins_map, s);
+
+    return deg_packed_monomial<T>::from_code(pm.get_value(), m.get_degree());
+}
+
+// Implementation of monomial_mul().
+// NOTE: requires a, b and out to be compatible with ss.
+template <typename T>
+constexpr void monomial_mul(deg_packed_monomial<T> &out, const deg_packed_monomial<T> &a,
+                            const deg_packed_monomial<T> &b, [[maybe_unused]] const symbol_set &ss)
+{
+    // Verify the inputs.
+    assert(polynomials::key_is_compatible(a, ss));
+    assert(polynomials::key_is_compatible(b, ss));
+    assert(polynomials::key_is_compatible(out, ss));
+
+    // NOTE: both the degrees and the Kronecker codes add up.
+    out._set_value(a.get_value() + b.get_value());
+
+    // Verify the output as well.
+    assert(polynomials::key_is_compatible(out, ss));
+}
+
+namespace detail
+{
+
+// Small helper to detect if 2 types
+// are the same deg_packed_monomial type.
+template <typename, typename>
+struct same_deg_packed_monomial : ::std::false_type {
+};
+
+template <typename T>
+struct same_deg_packed_monomial<deg_packed_monomial<T>, deg_packed_monomial<T>> : ::std::true_type {
+};
+
+template <typename T, typename U>
+inline constexpr bool same_deg_packed_monomial_v = same_deg_packed_monomial<T, U>::value;
+
+// Functor to convert a degree-augmented packed monomial
+// into the packed monomial with the same exponents.
+struct deg_pm_to_packed {
+    template <typename T>
+    constexpr auto operator()(const deg_packed_monomial<T> &m) const
+    {
+        return m.to_packed();
+    }
+};
+
+} // namespace detail
+
+// Monomial overflow checking.
+// NOTE: the check is run on the Kronecker codes. If the exponents
+// of the product are representable, so is its total degree.
+// NOTE: this assumes that all the monomials in the 2 ranges
+// are compatible with ss.
+template <typename R1, typename R2>
+    requires InputRange<R1> && InputRange<R2>
+             && detail::same_deg_packed_monomial_v<
+                 remove_cvref_t<typename ::std::iterator_traits<range_begin_t<R1>>::reference>,
+                 remove_cvref_t<typename ::std::iterator_traits<range_begin_t<R2>>::reference>>
+inline bool monomial_range_overflow_check(R1 &&r1, R2 &&r2, const symbol_set &ss)
+{
+    auto b1 = ::obake::begin(::std::forward<R1>(r1));
+    auto e1 = ::obake::end(::std::forward<R1>(r1));
+    auto b2 = ::obake::begin(::std::forward<R2>(r2));
+    auto e2 = ::obake::end(::std::forward<R2>(r2));
+
+    return polynomials::monomial_range_overflow_check(
+        ::obake::detail::make_range(::boost::make_transform_iterator(b1, detail::deg_pm_to_packed{}),
+                                    ::boost::make_transform_iterator(e1, detail::deg_pm_to_packed{})),
+        ::obake::detail::make_range(::boost::make_transform_iterator(b2, detail::deg_pm_to_packed{}),
+                                    ::boost::make_transform_iterator(e2, detail::deg_pm_to_packed{})),
+        ss);
+}
+
+// Implementation of key_degree().
+// NOTE: this assumes that p is compatible with ss.
+template <typename T>
+constexpr T key_degree(const deg_packed_monomial<T> &p, [[maybe_unused]] const symbol_set &ss)
+{
+    assert(polynomials::key_is_compatible(p, ss));
+
+    return p.get_degree();
+}
+
+// Implementation of key_p_degree().
+// NOTE: this assumes that p and si are compatible with ss.
+template <typename T>
+inline T key_p_degree(const deg_packed_monomial<T> &p, const symbol_idx_set &si, const symbol_set &ss)
+{
+    return polynomials::key_p_degree(p.to_packed(), si, ss);
+}
+
+// Exponentiation.
+// NOTE: this assumes that p is compatible with ss.
+template <typename T, typename U,
+          ::std::enable_if_t<::std::disjunction_v<::obake::detail::is_mppp_integer<U>,
+                                                  is_safely_convertible<const U &, ::mppp::integer<1> &>>,
+                             int>
+          = 0>
+inline deg_packed_monomial<T> monomial_pow(const deg_packed_monomial<T> &p, const U &n, const symbol_set &ss)
+{
+    return deg_packed_monomial<T>(polynomials::monomial_pow(p.to_packed(), n, ss), ss);
+}
+
+// Evaluation of a degree-augmented packed monomial.
+// NOTE: this requires that p is compatible with ss,
+// and that sm is consistent with ss.
+template <typename T, typename U, ::std::enable_if_t<detail::pm_key_evaluate_algo<T, U> != 0, int> = 0>
+inline detail::pm_key_evaluate_ret_t<T, U> key_evaluate(const deg_packed_monomial<T> &p, const symbol_idx_map<U> &sm,
+                                                        const symbol_set &ss)
+{
+    return polynomials::key_evaluate(p.to_packed(), sm, ss);
+}
+
+// Substitution of symbols in a degree-augmented packed monomial.
+// NOTE: this requires that p is compatible with ss,
+// and that sm is consistent with ss.
+template <typename T, typename U, ::std::enable_if_t<detail::pm_monomial_subs_algo<T, U> != 0, int> = 0>
+inline ::std::pair<detail::pm_monomial_subs_ret_t<T, U>, deg_packed_monomial<T>>
+monomial_subs(const deg_packed_monomial<T> &p, const symbol_idx_map<U> &sm, const symbol_set &ss)
+{
+    auto [val, pm] = polynomials::monomial_subs(p.to_packed(), sm, ss);
+
+    return ::std::make_pair(::std::move(val), deg_packed_monomial<T>(pm, ss));
+}
+
+// Identify non-trimmable exponents in p.
+template <typename T>
+inline void key_trim_identify(::std::vector<int> &v, const deg_packed_monomial<T> &p, const symbol_set &ss)
+{
+    polynomials::key_trim_identify(v, p.to_packed(), ss);
+}
+
+// Eliminate from p the exponents at the indices
+// specifed by si.
+template <typename T>
+inline deg_packed_monomial<T> key_trim(const deg_packed_monomial<T> &p, const symbol_idx_set &si,
+                                       const symbol_set &ss)
+{
+    const auto pm = p.to_packed();
+
+    // NOTE: the degree of the trimmed monomial is the degree
+    // of p minus the partial degree of the eliminated exponents.
+    return deg_packed_monomial<T>::from_code(polynomials::key_trim(pm, si, ss).get_value(),
+                                             static_cast<T>(p.get_degree() - polynomials::key_p_degree(pm, si, ss)));
+}
+
+// Monomial differentiation.
+template <typename T>
+inline ::std::pair<T, deg_packed_monomial<T>> monomial_diff(const deg_packed_monomial<T> &p, const symbol_idx &idx,
+                                                             const symbol_set &ss)
+{
+    const auto [e, pm] = polynomials::monomial_diff(p.to_packed(), idx, ss);
+
+    // NOTE: if the exponent is zero, the monomial
+    // is unchanged, otherwise the degree decreases by one.
+    if (e == T(0)) {
+        return ::std::make_pair(e, p);
+    }
+
+    return ::std::make_pair(e, deg_packed_monomial<T>::from_code(pm.get_value(), static_cast<T>(p.get_degree() - 1)));
+}
+
+// Monomial integration.
+template <typename T>
+inline ::std::pair<T, deg_packed_monomial<T>> monomial_integrate(const deg_packed_monomial<T> &p, const symbol_idx &idx,
+                                                                  const symbol_set &ss)
+{
+    const auto [e, pm] = polynomials::monomial_integrate(p.to_packed(), idx, ss);
+
+    return ::std::make_pair(e, deg_packed_monomial<T>::from_code(pm.get_value(), static_cast<T>(p.get_degree() + 1)));
+}
+
+} // namespace polynomials
+
+// Lift to the obake namespace.
+template <typename T>
+using deg_packed_monomial = polynomials::deg_packed_monomial<T>;
+
+// Specialise monomial_has_homomorphic_hash.
+template <typename T>
+inline constexpr bool monomial_hash_is_homomorphic<deg_packed_monomial<T>> = true;
+
+} // namespace obake
+
+namespace boost::serialization
+{
+
+// Disable tracking for deg_packed_monomial.
+template <typename T>
+struct tracking_level<::obake::deg_packed_monomial<T>>
+    : ::obake::detail::s11n_no_tracking<::obake::deg_packed_monomial<T>> {
+};
+
+} // namespace boost::serialization
+
+#endif
@@ -0,0 +1,473 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OBAKE_POLYNOMIALS_MOD_INT_HPP
+#define OBAKE_POLYNOMIALS_MOD_INT_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+
+#include <gmp.h>
+
+#include <boost/serialization/access.hpp>
+
+#include <mp++/integer.hpp>
+
+#include <obake/config.hpp>
+#include <obake/detail/to_string.hpp>
+#include <obake/exceptions.hpp>
+
+namespace obake
+{
+
+namespace polynomials
+{
+
+namespace detail
+{
+
+// Compute -n**-1 mod 2**32, for odd n.
+constexpr ::std::uint32_t mod_int_neg_inv(::std::uint32_t n)
+{
+    // NOTE: n is its own inverse modulo 2**3, and
+    // each Newton iteration doubles the number
+    // of correct bits.
+    ::std::uint32_t inv = n;
+    for (auto i = 0; i < 4; ++i) {
+        inv *= 2u - n * inv;
+    }
+
+    return 0u - inv;
+}
+
+// Montgomery reduction: compute n * 2**-32 mod p,
+// for n < p * 2**32 and ninv == -p**-1 mod 2**32.
+// NOTE: because p < 2**31, n + m * p < 2**64.
+constexpr ::std::uint32_t mod_int_redc(::std::uint64_t n, ::std::uint32_t p, ::std::uint32_t ninv)
+{
+    const auto m = static_cast<::std::uint32_t>(n) * ninv;
+    const auto t = static_cast<::std::uint32_t>((n + static_cast<::std::uint64_t>(m) * p) >> 32);
+
+    return t >= p ? t - p : t;
+}
+
+} // namespace detail
+
+// Word-sized modular integer.
+//
+// This class represents an integer modulo P, where P is an odd
+// modulus smaller than 2**31. The value is stored in Montgomery
+// form (i.e., as n * 2**32 mod P), so that the modular multiplication
+// requires only 64-bit integer multiplications and no divisions.
+// mod_int satisfies the coefficient requirements, and it can thus be
+// used as a coefficient type in polynomials. The result of the multiplication
+// of two polynomials with mod_int coefficients is the product modulo P.
+template <::std::uint32_t P>
+class mod_int
+{
+    static_assert(P % 2u == 1u && P > 1u && P < (::std::uint32_t(1) << 31),
+                  "The modulus of a mod_int must be an odd integer smaller than 2**31");
+
+    friend class ::boost::serialization::access;
+
+    // -P**-1 mod 2**32.
+    static constexpr ::std::uint32_t s_ninv = detail::mod_int_neg_inv(P);
+    // 2**64 mod P.
+    static constexpr ::std::uint32_t s_r2 = static_cast<::std::uint32_t>((~::std::uint64_t(0) % P + 1u) % P);
+
+    // Montgomery reduction: compute n * 2**-32 mod P,
+    // for n < P * 2**32.
+    static constexpr ::std::uint32_t redc(::std::uint64_t n)
+    {
+        return detail::mod_int_redc(n, P, s_ninv);
+    }
+
+    // Conversion of a residue n in [0, P)
+    // into Montgomery form.
+    static constexpr ::std::uint32_t to_mont(::std::uint32_t n)
+    {
+        return mod_int::redc(static_cast<::std::uint64_t>(n) * s_r2);
+    }
+
+public:
+    using value_type = ::std::uint32_t;
+
+    static constexpr value_type modulus = P;
+
+    // Def ctor, inits to zero.
+    constexpr mod_int() : m_value(0) {}
+    // Constructor from C++ integral types.
+    template <typename T>
+        requires ::std::is_integral_v<T> && (!::std::is_same_v<T, bool>) && (sizeof(T) <= sizeof(long long))
+    constexpr explicit mod_int(const T &n) : m_value(0)
+    {
+        if constexpr (::std::is_signed_v<T>) {
+            const auto r = static_cast<long long>(n) % static_cast<long long>(P);
+            m_value = mod_int::to_mont(static_cast<::std::uint32_t>(r < 0 ? r + static_cast<long long>(P) : r));
+        } else {
+            m_value = mod_int::to_mont(static_cast<::std::uint32_t>(static_cast<unsigned long long>(n) % P));
+        }
+    }
+    // Constructor from mp++ integers.
+    template <::std::size_t SSize>
+    explicit mod_int(const ::mppp::integer<SSize> &n)
+        // NOTE: mpz_fdiv_ui() returns the nonnegative remainder.
+        : m_value(mod_int::to_mont(static_cast<::std::uint32_t>(::mpz_fdiv_ui(n.get_mpz_view(), P))))
+    {
+    }
+
+    // Get the residue in the [0, P) range.
+    constexpr value_type get_value() const
+    {
+        return mod_int::redc(m_value);
+    }
+
+    // Internal accessors for the value
+    // in Montgomery form.
+    constexpr const value_type &_get_mvalue() const
+    {
+        return m_value;
+    }
+    constexpr void _set_mvalue(const value_type &n)
+    {
+        m_value = n;
+    }
+
+    // In-place arithmetic operators.
+    constexpr mod_int &operator+=(const mod_int &other)
+    {
+        // NOTE: both values are less than 2**31,
+        // the sum cannot overflow.
+        const auto s = m_value + other.m_value;
+        m_value = s >= P ? s - P : s;
+
+        return *this;
+    }
+    constexpr mod_int &operator-=(const mod_int &other)
+    {
+        m_value = m_value >= other.m_value ? m_value - other.m_value : m_value + (P - other.m_value);
+
+        return *this;
+    }
+    constexpr mod_int &operator*=(const mod_int &other)
+    {
+        m_value = mod_int::redc(static_cast<::std::uint64_t>(m_value) * other.m_value);
+
+        return *this;
+    }
+
+private:
+    // Serialisation.
+    template <class Archive>
+    void serialize(Archive &ar, unsigned)
+    {
+        ar &m_value;
+    }
+
+private:
+    value_type m_value;
+};
+
+// Arithmetic operators.
+template <::std::uint32_t P>
+constexpr mod_int<P> operator+(const mod_int<P> &x)
+{
+    return x;
+}
+
+template <::std::uint32_t P>
+constexpr mod_int<P> operator-(const mod_int<P> &x)
+{
+    mod_int<P> retval;
+    retval._set_mvalue(x._get_mvalue() == 0u ? 0u : P - x._get_mvalue());
+
+    return retval;
+}
+
+template <::std::uint32_t P>
+constexpr mod_int<P> operator+(const mod_int<P> &x, const mod_int<P> &y)
+{
+    auto retval(x);
+    retval += y;
+
+    return retval;
+}
+
+template <::std::uint32_t P>
+constexpr mod_int<P> operator-(const mod_int<P> &x, const mod_int<P> &y)
+{
+    auto retval(x);
+    retval -= y;
+
+    return retval;
+}
+
+template <::std::uint32_t P>
+constexpr mod_int<P> operator*(const mod_int<P> &x, const mod_int<P> &y)
+{
+    auto retval(x);
+    retval *= y;
+
+    return retval;
+}
+
+// Implementation of fma3().
+// NOTE: the product is reduced before the accumulation,
+// so that the result is always in the [0, P) range.
+template <::std::uint32_t P>
+constexpr void fma3(mod_int<P> &ret, const mod_int<P> &x, const mod_int<P> &y)
+{
+    auto tmp(x);
+    tmp *= y;
+    ret += tmp;
+}
+
+// Comparison operators.
+// NOTE: the Montgomery form of a residue is unique.
+template <::std::uint32_t P>
+constexpr bool operator==(const mod_int<P> &x, const mod_int<P> &y)
+{
+    return x._get_mvalue() == y._get_mvalue();
+}
+
+template <::std::uint32_t P>
+constexpr bool operator!=(const mod_int<P> &x, const mod_int<P> &y)
+{
+    return !(x == y);
+}
+
+// Stream insertion.
+template <::std::uint32_t P>
+inline ::std::ostream &operator<<(::std::ostream &os, const mod_int<P> &x)
+{
+    return os << x.get_value();
+}
+
+// Word-sized modular integer with a runtime modulus.
+//
+// This class is the runtime counterpart of mod_int: the modulus
+// (an odd integer smaller than 2**31) is stored together with the
+// value (in Montgomery form), so that a single type can represent
+// residues modulo different primes. A default-constructed rt_mod_int
+// is a zero without a modulus, which adopts the modulus of the other
+// operand in the arithmetic operations. Mixing nonzero values with
+// different moduli is undefined behaviour.
+class rt_mod_int
+{
+    friend class ::boost::serialization::access;
+
+    // Conversion of a residue n in [0, m_mod)
+    // into Montgomery form.
+    ::std::uint32_t to_mont(::std::uint32_t n) const
+    {
+        return static_cast<::std::uint32_t>((static_cast<::std::uint64_t>(n) << 32) % m_mod);
+    }
+
+    // Validate the modulus and set up m_mod/m_ninv.
+    void set_modulus(::std::uint32_t p)
+    {
+        if (obake_unlikely(p % 2u == 0u || p == 1u || p >= (::std::uint32_t(1) << 31))) {
+            obake_throw(::std::invalid_argument, "The modulus of an rt_mod_int must be an odd integer greater "
+                                                 "than 1 and smaller than 2**31, but a modulus of "
+                                                     + ::obake::detail::to_string(p) + " was provided instead");
+        }
+
+        m_mod = p;
+        m_ninv = detail::mod_int_neg_inv(p);
+    }
+
+    // Adopt the modulus of other, if this
+    // does not have a modulus yet.
+    void adopt_modulus(const rt_mod_int &other)
+    {
+        assert(m_mod == 0u || other.m_mod == 0u || m_mod == other.m_mod);
+
+        if (m_mod == 0u) {
+            m_mod = other.m_mod;
+            m_ninv = other.m_ninv;
+        }
+    }
+
+public:
+    using value_type = ::std::uint32_t;
+
+    // Def ctor, inits to zero without a modulus.
+    rt_mod_int() : m_value(0), m_mod(0), m_ninv(0) {}
+    // Constructor from C++ integral types.
+    template <typename T>
+        requires ::std::is_integral_v<T> && (!::std::is_same_v<T, bool>) && (sizeof(T) <= sizeof(long long))
+    explicit rt_mod_int(const T &n, ::std::uint32_t p) : m_value(0)
+    {
+        set_modulus(p);
+
+        if constexpr (::std::is_signed_v<T>) {
+            const auto r = static_cast<long long>(n) % static_cast<long long>(p);
+            m_value = to_mont(static_cast<::std::uint32_t>(r < 0 ? r + static_cast<long long>(p) : r));
+        } else {
+            m_value = to_mont(static_cast<::std::uint32_t>(static_cast<unsigned long long>(n) % p));
+        }
+    }
+    // Constructor from mp++ integers.
+    template <::std::size_t SSize>
+    explicit rt_mod_int(const ::mppp::integer<SSize> &n, ::std::uint32_t p) : m_value(0)
+    {
+        set_modulus(p);
+
+        // NOTE: mpz_fdiv_ui() returns the nonnegative remainder.
+        m_value = to_mont(static_cast<::std::uint32_t>(::mpz_fdiv_ui(n.get_mpz_view(), p)));
+    }
+
+    // Get the modulus (zero if the modulus
+    // has not been set).
+    value_type get_modulus() const
+    {
+        return m_mod;
+    }
+
+    // Get the residue in the [0, modulus) range.
+    value_type get_value() const
+    {
+        return detail::mod_int_redc(m_value, m_mod, m_ninv);
+    }
+
+    // Internal accessor for the value
+    // in Montgomery form.
+    const value_type &_get_mvalue() const
+    {
+        return m_value;
+    }
+
+    // In-place arithmetic operators.
+    rt_mod_int &operator+=(const rt_mod_int &other)
+    {
+        adopt_modulus(other);
+
+        // NOTE: both values are less than 2**31,
+        // the sum cannot overflow.
+        const auto s = m_value + other.m_value;
+        m_value = s >= m_mod ? s - m_mod : s;
+
+        return *this;
+    }
+    rt_mod_int &operator-=(const rt_mod_int &other)
+    {
+        adopt_modulus(other);
+
+        m_value = m_value >= other.m_value ? m_value - other.m_value : m_value + (m_mod - other.m_value);
+
+        return *this;
+    }
+    rt_mod_int &operator*=(const rt_mod_int &other)
+    {
+        adopt_modulus(other);
+
+        // NOTE: if either operand has no modulus, its value
+        // is zero and the reduction will produce zero.
+        m_value = detail::mod_int_redc(static_cast<::std::uint64_t>(m_value) * other.m_value, m_mod, m_ninv);
+
+        return *this;
+    }
+    rt_mod_int operator-() const
+    {
+        auto retval(*this);
+        retval.m_value = m_value == 0u ? 0u : m_mod - m_value;
+
+        return retval;
+    }
+
+private:
+    // Serialisation.
+    template <class Archive>
+    void serialize(Archive &ar, unsigned)
+    {
+        ar &m_value;
+        ar &m_mod;
+        ar &m_ninv;
+    }
+
+private:
+    value_type m_value;
+    value_type m_mod;
+    value_type m_ninv;
+};
+
+// Arithmetic operators.
+inline rt_mod_int operator+(const rt_mod_int &x)
+{
+    return x;
+}
+
+inline rt_mod_int operator+(const rt_mod_int &x, const rt_mod_int &y)
+{
+    auto retval(x);
+    retval += y;
+
+    return retval;
+}
+
+inline rt_mod_int operator-(const rt_mod_int &x, const rt_mod_int &y)
+{
+    auto retval(x);
+    retval -= y;
+
+    return retval;
+}
+
+inline rt_mod_int operator*(const rt_mod_int &x, const rt_mod_int &y)
+{
+    auto retval(x);
+    retval *= y;
+
+    return retval;
+}
+
+// Implementation of fma3().
+inline void fma3(rt_mod_int &ret, const rt_mod_int &x, const rt_mod_int &y)
+{
+    auto tmp(x);
+    tmp *= y;
+    ret += tmp;
+}
+
+// Comparison operators.
+// NOTE: the Montgomery form of a residue is unique
+// and zero is represented as zero for every modulus.
+inline bool operator==(const rt_mod_int &x, const rt_mod_int &y)
+{
+    return x._get_mvalue() == y._get_mvalue();
+}
+
+inline bool operator!=(const rt_mod_int &x, const rt_mod_int &y)
+{
+    return !(x == y);
+}
+
+// Implementation of is_zero().
+// NOTE: rt_mod_int is not constructible from
+// the integral zero, thus we cannot rely
+// on the default implementation.
+inline bool is_zero(const rt_mod_int &x)
+{
+    return x._get_mvalue() == 0u;
+}
+
+// Stream insertion.
+inline ::std::ostream &operator<<(::std::ostream &os, const rt_mod_int &x)
+{
+    return os << x.get_value();
+}
+
+} // namespace polynomials
+
+} // namespace obake
+
+#endif
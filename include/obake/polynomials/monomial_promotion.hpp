@@ -0,0 +1,228 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OBAKE_POLYNOMIALS_MONOMIAL_PROMOTION_HPP
+#define OBAKE_POLYNOMIALS_MONOMIAL_PROMOTION_HPP
+
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <obake/config.hpp>
+#include <obake/detail/not_implemented.hpp>
+#include <obake/detail/type_c.hpp>
+#include <obake/kpack.hpp>
+#include <obake/polynomials/d_packed_monomial.hpp>
+#include <obake/polynomials/packed_monomial.hpp>
+#include <obake/symbols.hpp>
+#include <obake/type_traits.hpp>
+
+namespace obake
+{
+
+namespace customisation
+{
+
+// External customisation point for monomial_promotion.
+template <typename T>
+inline constexpr auto monomial_promotion = not_implemented;
+
+} // namespace customisation
+
+// Main monomial_promotion implementation.
+// Defaults to no promotion.
+template <typename T>
+inline constexpr auto monomial_promotion = detail::type_c<void>{};
+
+namespace detail
+{
+
+template <typename>
+struct is_type_c : ::std::false_type {
+};
+
+template <typename T>
+struct is_type_c<type_c<T>> : ::std::true_type {
+};
+
+// The 64-bit integral type with the same signedness as T.
+template <typename T>
+using monomial_promotion_wide_t = ::std::conditional_t<::std::is_signed_v<T>, ::std::int64_t, ::std::uint64_t>;
+
+// Promotion chain for packed_monomial:
+// - the 32-bit exponents are promoted to 64-bit exponents (if available),
+// - otherwise, the packed monomial is promoted to a d_packed_monomial
+//   packing a single exponent per value.
+// NOTE: the promotion type cannot depend on the number of
+// symbols. A d_packed_monomial with PSize > 1 would have, for
+// a small number of symbols, a narrower exponent range than the
+// packed_monomial it is promoted from (e.g., with a single symbol
+// the packed_monomial already packs one exponent per value).
+// With PSize == 1, the exponent range is never narrower.
+template <typename T>
+constexpr auto pm_promotion()
+{
+#if defined(OBAKE_PACKABLE_INT64)
+    if constexpr (sizeof(T) < sizeof(::std::int64_t)) {
+        return type_c<polynomials::packed_monomial<monomial_promotion_wide_t<T>>>{};
+    } else {
+        return type_c<polynomials::d_packed_monomial<T, 1>>{};
+    }
+#else
+    return type_c<polynomials::d_packed_monomial<T, 1>>{};
+#endif
+}
+
+// Promotion chain for d_packed_monomial:
+// - the PSize is halved until it reaches 1,
+// - then, the 32-bit exponents are promoted to 64-bit
+//   exponents (if available).
+template <typename T, unsigned PSize>
+constexpr auto dpm_promotion()
+{
+    if constexpr (PSize > 1u) {
+        return type_c<polynomials::d_packed_monomial<T, PSize / 2u>>{};
+    } else {
+#if defined(OBAKE_PACKABLE_INT64)
+        if constexpr (sizeof(T) < sizeof(::std::int64_t)) {
+            return type_c<polynomials::d_packed_monomial<monomial_promotion_wide_t<T>, 1>>{};
+        } else {
+            return type_c<void>{};
+        }
+#else
+        return type_c<void>{};
+#endif
+    }
+}
+
+} // namespace detail
+
+template <typename T>
+inline constexpr auto monomial_promotion<polynomials::packed_monomial<T>> = detail::pm_promotion<T>();
+
+template <typename T, unsigned PSize>
+inline constexpr auto monomial_promotion<polynomials::d_packed_monomial<T, PSize>> = detail::dpm_promotion<T, PSize>();
+
+namespace detail
+{
+
+// Implementation of monomial_promotion_t:
+// - if we have a valid implementation in the external customisation
+//   namespace, use that, otherwise,
+// - if we have a valid implementation in the main namespace, use that,
+//   otherwise,
+// - no promotion.
+// NOTE: a valid implementation is a type_c instance.
+template <typename T>
+constexpr auto monomial_promotion_impl()
+{
+    if constexpr (is_type_c<remove_cvref_t<decltype(customisation::monomial_promotion<T>)>>::value) {
+        return customisation::monomial_promotion<T>;
+    } else if constexpr (is_type_c<remove_cvref_t<decltype(monomial_promotion<T>)>>::value) {
+        return monomial_promotion<T>;
+    } else {
+        return type_c<void>{};
+    }
+}
+
+} // namespace detail
+
+// The monomial type into which the monomial type T is promoted
+// when the exponents of a product of monomials of type T cannot be
+// represented. The promotions form a chain (e.g., packed_monomial<std::uint32_t>
+// -> packed_monomial<std::uint64_t> -> d_packed_monomial<std::uint64_t, 1>),
+// which is terminated by void.
+template <typename T>
+using monomial_promotion_t = typename decltype(detail::monomial_promotion_impl<T>())::type;
+
+namespace detail
+{
+
+// Unpack the exponents of a monomial into out.
+// NOTE: these assume that the monomial is compatible with ss.
+template <typename T>
+inline void monomial_promotion_unpack(::std::vector<T> &out, const polynomials::packed_monomial<T> &p,
+                                      const symbol_set &ss)
+{
+    const auto s_size = static_cast<unsigned>(ss.size());
+
+    out.resize(s_size);
+
+    kunpacker<T> ku(p.get_value(), s_size);
+    for (auto &e : out) {
+        ku >> e;
+    }
+}
+
+template <typename T, unsigned PSize>
+inline void monomial_promotion_unpack(::std::vector<T> &out, const polynomials::d_packed_monomial<T, PSize> &d,
+                                      const symbol_set &ss)
+{
+    const auto s_size = ss.size();
+
+    out.resize(s_size);
+
+    symbol_idx idx = 0;
+    for (const auto &n : d._container()) {
+        kunpacker<T> ku(n, PSize);
+
+        for (auto j = 0u; j < PSize && idx < s_size; ++j, ++idx) {
+            ku >> out[idx];
+        }
+    }
+
+    assert(idx == s_size);
+}
+
+template <typename T>
+using monomial_promotion_unpack_t = decltype(detail::monomial_promotion_unpack(
+    ::std::declval<::std::vector<typename T::value_type> &>(), ::std::declval<const T &>(),
+    ::std::declval<const symbol_set &>()));
+
+// Detect if the monomial type T can be converted
+// into the monomial type monomial_promotion_t<T>.
+// NOTE: the conversion goes through the unpacking of
+// the exponents, which is currently implemented only for
+// packed_monomial and d_packed_monomial. Chains
+// declared via the customisation point must thus
+// consist of these monomial types.
+template <typename T>
+constexpr bool monomial_is_promotable_impl()
+{
+    if constexpr (::std::is_void_v<monomial_promotion_t<T>>) {
+        return false;
+    } else if constexpr (is_detected_v<monomial_promotion_unpack_t, T>) {
+        return ::std::is_constructible_v<monomial_promotion_t<T>, const ::std::vector<typename T::value_type> &>;
+    } else {
+        return false;
+    }
+}
+
+} // namespace detail
+
+template <typename T>
+inline constexpr bool is_promotable_monomial_v = detail::monomial_is_promotable_impl<T>();
+
+// Convert the monomial m, with symbol set ss, into
+// the monomial type monomial_promotion_t<T>.
+// NOTE: the buffer tmp is used to store the exponents.
+template <typename T>
+    requires is_promotable_monomial_v<T>
+inline monomial_promotion_t<T> monomial_promote(const T &m, const symbol_set &ss,
+                                                ::std::vector<typename T::value_type> &tmp)
+{
+    detail::monomial_promotion_unpack(tmp, m, ss);
+
+    return monomial_promotion_t<T>(::std::as_const(tmp));
+}
+
+} // namespace obake
+
+#endif
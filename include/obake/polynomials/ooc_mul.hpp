@@ -0,0 +1,413 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef OBAKE_POLYNOMIALS_OOC_MUL_HPP
+#define OBAKE_POLYNOMIALS_OOC_MUL_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include <mp++/integer.hpp>
+#include <mp++/rational.hpp>
+
+#include <obake/byte_size.hpp>
+#include <obake/config.hpp>
+#include <obake/detail/to_string.hpp>
+#include <obake/exceptions.hpp>
+#include <obake/polynomials/bw_packed_monomial.hpp>
+#include <obake/polynomials/d_packed_monomial.hpp>
+#include <obake/polynomials/deg_packed_monomial.hpp>
+#include <obake/polynomials/mod_int.hpp>
+#include <obake/polynomials/monomial_homomorphic_hash.hpp>
+#include <obake/polynomials/packed_monomial.hpp>
+#include <obake/polynomials/polynomial.hpp>
+#include <obake/series.hpp>
+#include <obake/symbols.hpp>
+#include <obake/type_traits.hpp>
+
+namespace obake
+{
+
+namespace polynomials
+{
+
+// Product of two polynomials stored on disk, as
+// returned by ooc_mul().
+//
+// The segments of the product are stored in scratch files
+// (one file per segment). The segments can be loaded
+// one at a time via get_segment(), or the whole product can
+// be reassembled in memory via to_polynomial(). The scratch
+// files are removed upon destruction.
+template <typename K, typename C>
+class ooc_product
+{
+public:
+    using poly_t = polynomial<K, C>;
+    using s_size_type = typename poly_t::s_size_type;
+
+    explicit ooc_product(const symbol_set &ss, unsigned log2_nsegs, ::std::vector<::std::filesystem::path> files)
+        : m_ss(ss), m_log2_nsegs(log2_nsegs), m_files(::std::move(files))
+    {
+        assert(m_files.empty() || m_files.size() == (s_size_type(1) << m_log2_nsegs));
+    }
+    ooc_product(const ooc_product &) = delete;
+    ooc_product(ooc_product &&) noexcept = default;
+    ooc_product &operator=(const ooc_product &) = delete;
+    ooc_product &operator=(ooc_product &&) = delete;
+    ~ooc_product()
+    {
+        for (const auto &p : m_files) {
+            // NOTE: use the non-throwing overload,
+            // and ignore any error.
+            ::std::error_code ec;
+            ::std::filesystem::remove(p, ec);
+        }
+    }
+
+    const symbol_set &get_symbol_set() const
+    {
+        return m_ss;
+    }
+    // The base-2 logarithm of the number of segments.
+    unsigned get_s_size() const
+    {
+        return m_log2_nsegs;
+    }
+    // Load the segment i into a (non-segmented) polynomial.
+    poly_t get_segment(s_size_type i) const
+    {
+        if (obake_unlikely(i >= (s_size_type(1) << m_log2_nsegs))) {
+            obake_throw(::std::out_of_range, "Cannot load the segment at index " + ::obake::detail::to_string(i)
+                                                 + " of an out-of-core polynomial product with only "
+                                                 + ::obake::detail::to_string(s_size_type(1) << m_log2_nsegs)
+                                                 + " segment(s)");
+        }
+
+        poly_t retval;
+
+        if (m_files.empty()) {
+            // Empty product.
+            retval.set_symbol_set(m_ss);
+        } else {
+            const auto &p = m_files[static_cast<decltype(m_files.size())>(i)];
+
+            ::std::ifstream ifs(p, ::std::ios_base::in | ::std::ios_base::binary);
+            if (obake_unlikely(!ifs.is_open())) {
+                obake_throw(::std::runtime_error, "Could not open the scratch file '" + p.string()
+                                                      + "' of an out-of-core polynomial product");
+            }
+
+            ::boost::archive::binary_iarchive iarchive(ifs);
+            iarchive >> retval;
+        }
+
+        return retval;
+    }
+    // Reassemble the product in memory.
+    poly_t to_polynomial() const
+    {
+        poly_t retval;
+        retval.set_symbol_set(m_ss);
+        retval.set_n_segments(m_log2_nsegs);
+
+        if (!m_files.empty()) {
+            ::tbb::parallel_for(::tbb::blocked_range<s_size_type>(0, s_size_type(1) << m_log2_nsegs),
+                                [this, &retval](const auto &range) {
+                                    for (auto i = range.begin(); i != range.end(); ++i) {
+                                        auto seg = get_segment(i);
+
+                                        // NOTE: the terms in the file were originally in the
+                                        // segment i, thus they can be moved directly into
+                                        // the segment i of retval.
+                                        using ::std::swap;
+                                        swap(retval._get_s_table()[i], seg._get_s_table()[0]);
+                                    }
+                                });
+        }
+
+        return retval;
+    }
+
+private:
+    symbol_set m_ss;
+    unsigned m_log2_nsegs;
+    ::std::vector<::std::filesystem::path> m_files;
+};
+
+namespace detail
+{
+
+// Default implementation of ooc_serialisable.
+template <typename T>
+struct ooc_serialisable_impl : ::std::bool_constant<::std::is_arithmetic_v<T>> {
+};
+
+template <::std::size_t SSize>
+struct ooc_serialisable_impl<::mppp::integer<SSize>> : ::std::true_type {
+};
+
+template <::std::size_t SSize>
+struct ooc_serialisable_impl<::mppp::rational<SSize>> : ::std::true_type {
+};
+
+template <::std::uint32_t P>
+struct ooc_serialisable_impl<mod_int<P>> : ::std::true_type {
+};
+
+template <>
+struct ooc_serialisable_impl<rt_mod_int> : ::std::true_type {
+};
+
+template <typename T>
+struct ooc_serialisable_impl<packed_monomial<T>> : ::std::true_type {
+};
+
+template <typename T, unsigned PSize, unsigned NPacks>
+struct ooc_serialisable_impl<d_packed_monomial<T, PSize, NPacks>> : ::std::true_type {
+};
+
+template <typename T>
+struct ooc_serialisable_impl<deg_packed_monomial<T>> : ::std::true_type {
+};
+
+template <typename T, typename L>
+struct ooc_serialisable_impl<bw_packed_monomial<T, L>> : ::std::true_type {
+};
+
+} // namespace detail
+
+// Detect if objects of type T can be stored in the
+// scratch files written by ooc_mul().
+//
+// NOTE: Boost.Serialization does not offer a SFINAE-friendly
+// way of detecting serialisability (archiving a type without
+// serialisation support is a hard error), thus serialisability
+// must be opted into explicitly. The arithmetic types, the mp++
+// integers and rationals, the modular integers and the monomials
+// shipped with obake are serialisable, and series are serialisable
+// if their keys and coefficients are. Other types can be enabled
+// by specialising this variable template.
+template <typename T>
+inline constexpr bool ooc_serialisable = detail::ooc_serialisable_impl<T>::value;
+
+namespace detail
+{
+
+template <typename K, typename C, typename Tag>
+struct ooc_serialisable_impl<series<K, C, Tag>> : ::std::bool_constant<ooc_serialisable<K> && ooc_serialisable<C>> {
+};
+
+// Segment sink for the out-of-core multiplication: each segment
+// of the product is serialised to a scratch file as soon as it has been
+// computed, and it is then freed. The number of segments
+// resident in memory at any time is established from the memory budget.
+template <typename K, typename C>
+struct poly_ooc_mul_sink {
+    using poly_t = polynomial<K, C>;
+
+    template <typename S, typename I>
+    S batch_size(const S &nsegs, const I &est_bytes)
+    {
+        assert(nsegs > 0u);
+
+        // Prepare the names of the scratch files.
+        m_files.clear();
+        m_files.reserve(static_cast<decltype(m_files.size())>(nsegs));
+        for (S i = 0; i < nsegs; ++i) {
+            m_files.push_back(m_dir / ("obake_ooc_" + m_tag + "_" + ::obake::detail::to_string(i)));
+        }
+
+        // Estimate the size in bytes of a segment.
+        const auto seg_bytes = ::std::max(static_cast<double>(est_bytes) / static_cast<double>(nsegs), 1.);
+
+        // Determine how many segments fit in the budget.
+        // NOTE: at least one segment must be computed
+        // at a time, regardless of the budget.
+        const auto n = ::std::floor(static_cast<double>(m_mem_budget) / seg_bytes);
+
+        return n >= static_cast<double>(nsegs) ? nsegs : ::std::max(S(1), static_cast<S>(n));
+    }
+
+    template <typename S>
+    void consume(poly_t &retval, const S &begin, const S &end)
+    {
+        assert(m_files.size() == (S(1) << retval.get_s_size()));
+
+        ::tbb::parallel_for(::tbb::blocked_range<S>(begin, end), [this, &retval](const auto &range) {
+            for (auto i = range.begin(); i != range.end(); ++i) {
+                // Move the terms of the segment into a temporary
+                // polynomial, which will free them upon destruction.
+                poly_t seg;
+                seg.set_symbol_set_fw(retval.get_symbol_set_fw());
+
+                using ::std::swap;
+                swap(seg._get_s_table()[0], retval._get_s_table()[i]);
+
+                const auto &p = m_files[static_cast<decltype(m_files.size())>(i)];
+
+                ::std::ofstream ofs(p, ::std::ios_base::out | ::std::ios_base::binary | ::std::ios_base::trunc);
+                if (obake_unlikely(!ofs.is_open())) {
+                    obake_throw(::std::runtime_error, "Could not open the scratch file '" + p.string()
+                                                          + "' during an out-of-core polynomial multiplication");
+                }
+
+                ::boost::archive::binary_oarchive oarchive(ofs);
+                oarchive << ::std::as_const(seg);
+            }
+        });
+    }
+
+    // Remove the scratch files (used
+    // in case of errors).
+    void remove_files() noexcept
+    {
+        for (const auto &p : m_files) {
+            ::std::error_code ec;
+            ::std::filesystem::remove(p, ec);
+        }
+
+        m_files.clear();
+    }
+
+    ::std::filesystem::path m_dir;
+    ::std::size_t m_mem_budget;
+    ::std::string m_tag;
+    ::std::vector<::std::filesystem::path> m_files;
+};
+
+// Detect if the polynomials T and U can be multiplied out-of-core.
+// NOTE: the requirements are those of the homomorphic
+// multithreaded implementation, plus the serialisability
+// of the product.
+template <typename T, typename U>
+constexpr bool poly_ooc_mul_enabled_impl()
+{
+    if constexpr (poly_mul_algo<T, U> == 0) {
+        return false;
+    } else {
+        using ret_t = poly_mul_ret_t<T, U>;
+
+        return is_homomorphically_hashable_monomial_v<series_key_t<ret_t>>
+               && is_size_measurable_v<const series_key_t<ret_t> &>
+               && is_size_measurable_v<const series_cf_t<ret_t> &> && ooc_serialisable<ret_t>;
+    }
+}
+
+template <typename T, typename U>
+inline constexpr bool poly_ooc_mul_enabled = detail::poly_ooc_mul_enabled_impl<T, U>();
+
+// Implementation of ooc_mul() with identical symbol sets.
+template <typename T, typename U>
+inline auto poly_ooc_mul_impl(const T &x, const U &y, const ::std::filesystem::path &dir, ::std::size_t mem_budget)
+{
+    using ret_t = poly_mul_ret_t<T, U>;
+    using ret_key_t = series_key_t<ret_t>;
+    using ret_cf_t = series_cf_t<ret_t>;
+    using prod_t = polynomials::ooc_product<ret_key_t, ret_cf_t>;
+
+    assert(x.get_symbol_set_fw() == y.get_symbol_set_fw());
+
+    if (x.empty() || y.empty()) {
+        return prod_t(x.get_symbol_set(), 0, {});
+    }
+
+    // Unique tag for the names of the scratch files.
+    ::std::random_device rd;
+    poly_ooc_mul_sink<ret_key_t, ret_cf_t> sink{dir, mem_budget,
+                                                 ::obake::detail::to_string(rd()) + "_"
+                                                     + ::obake::detail::to_string(rd()),
+                                                 {}};
+
+    ret_t retval;
+    retval.set_symbol_set_fw(x.get_symbol_set_fw());
+
+    try {
+        if (x.size() <= y.size()) {
+            detail::poly_mul_impl_mt_hm_sink(retval, sink, x, y);
+        } else {
+            detail::poly_mul_impl_mt_hm_sink(retval, sink, y, x);
+        }
+    } catch (...) {
+        sink.remove_files();
+        throw;
+    }
+
+    // NOTE: all the terms have been moved into the scratch files.
+    assert(retval.empty());
+
+    return prod_t(x.get_symbol_set(), sink.m_files.empty() ? 0u : retval.get_s_size(), ::std::move(sink.m_files));
+}
+
+} // namespace detail
+
+// Out-of-core polynomial multiplication.
+//
+// The product of x and y is computed segment by segment via the
+// homomorphic multithreaded algorithm. As soon as a batch of
+// segments has been computed, the segments are serialised into
+// scratch files in the directory dir and freed. mem_budget is the
+// approximate amount of memory (in bytes) that the segments
+// of the product resident in memory are allowed to occupy
+// at any given time. The result is returned as an ooc_product,
+// from which the segments can be loaded individually or the
+// whole product can be reassembled.
+template <typename K, typename C0, typename C1>
+    requires detail::poly_ooc_mul_enabled<polynomial<K, C0>, polynomial<K, C1>>
+inline auto ooc_mul(const polynomial<K, C0> &x, const polynomial<K, C1> &y, const ::std::filesystem::path &dir,
+                    ::std::size_t mem_budget)
+{
+    if (x.get_symbol_set_fw() == y.get_symbol_set_fw()) {
+        return detail::poly_ooc_mul_impl(x, y, dir, mem_budget);
+    }
+
+    // Merge the symbol sets.
+    const auto &[merged_ss, ins_map_x, ins_map_y]
+        = ::obake::detail::merge_symbol_sets(x.get_symbol_set(), y.get_symbol_set());
+
+    // Helper to extend the symbol set of an operand.
+    auto extend = [&ms = merged_ss](const auto &p, const auto &ins_map) {
+        remove_cvref_t<decltype(p)> ret;
+
+        if (ins_map.empty()) {
+            ret = p;
+        } else {
+            ret.set_symbol_set(ms);
+            ::obake::detail::series_sym_extender(ret, p, ins_map);
+        }
+
+        return ret;
+    };
+
+    return detail::poly_ooc_mul_impl(extend(x, ins_map_x), extend(y, ins_map_y), dir, mem_budget);
+}
+
+} // namespace polynomials
+
+} // namespace obake
+
+#endif
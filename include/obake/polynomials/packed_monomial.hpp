@@ -10,6 +10,7 @@
 #define OBAKE_POLYNOMIALS_PACKED_MONOMIAL_HPP
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -214,6 +215,13 @@ OBAKE_DLL_PUBLIC void key_stream_insert(::std::ostream &, const packed_monomial<
 
 #endif
 
+#if defined(OBAKE_PACKABLE_INT128)
+
+OBAKE_DLL_PUBLIC void key_stream_insert(::std::ostream &, const packed_monomial<__int128_t> &, const symbol_set &);
+OBAKE_DLL_PUBLIC void key_stream_insert(::std::ostream &, const packed_monomial<__uint128_t> &, const symbol_set &);
+
+#endif
+
 // Tex stream insertion.
 OBAKE_DLL_PUBLIC void key_tex_stream_insert(::std::ostream &, const packed_monomial<::std::int32_t> &,
                                             const symbol_set &);
@@ -229,6 +237,13 @@ OBAKE_DLL_PUBLIC void key_tex_stream_insert(::std::ostream &, const packed_monom
 
 #endif
 
+#if defined(OBAKE_PACKABLE_INT128)
+
+OBAKE_DLL_PUBLIC void key_tex_stream_insert(::std::ostream &, const packed_monomial<__int128_t> &, const symbol_set &);
+OBAKE_DLL_PUBLIC void key_tex_stream_insert(::std::ostream &, const packed_monomial<__uint128_t> &, const symbol_set &);
+
+#endif
+
 // Symbols merging.
 OBAKE_DLL_PUBLIC packed_monomial<::std::int32_t>
 key_merge_symbols(const packed_monomial<::std::int32_t> &, const symbol_idx_map<symbol_set> &, const symbol_set &);
@@ -244,6 +259,15 @@ key_merge_symbols(const packed_monomial<::std::uint64_t> &, const symbol_idx_map
 
 #endif
 
+#if defined(OBAKE_PACKABLE_INT128)
+
+OBAKE_DLL_PUBLIC packed_monomial<__int128_t>
+key_merge_symbols(const packed_monomial<__int128_t> &, const symbol_idx_map<symbol_set> &, const symbol_set &);
+OBAKE_DLL_PUBLIC packed_monomial<__uint128_t>
+key_merge_symbols(const packed_monomial<__uint128_t> &, const symbol_idx_map<symbol_set> &, const symbol_set &);
+
+#endif
+
 // Implementation of monomial_mul().
 // NOTE: requires a, b and out to be compatible with ss.
 template <typename T>
@@ -277,189 +301,238 @@ struct same_packed_monomial<packed_monomial<T>, packed_monomial<T>> : ::std::tru
 template <typename T, typename U>
 inline constexpr bool same_packed_monomial_v = same_packed_monomial<T, U>::value;
 
-} // namespace detail
-
-// Monomial overflow checking.
-// NOTE: this assumes that all the monomials in the 2 ranges
-// are compatible with ss.
-// NOTE: this can be parallelised. We need:
-// - a good heuristic (should not be too difficult given
-//   the constraints on packed_monomial),
-// - the random-access iterator concept.
-template <typename R1, typename R2>
-    requires InputRange<R1> && InputRange<R2>
-             && detail::same_packed_monomial_v<
-                 remove_cvref_t<typename ::std::iterator_traits<range_begin_t<R1>>::reference>,
-                 remove_cvref_t<typename ::std::iterator_traits<range_begin_t<R2>>::reference>>
-inline bool monomial_range_overflow_check(R1 &&r1, R2 &&r2, const symbol_set &ss)
+// The type used to represent the exponent limits
+// of a range of packed monomials with exponents of type T:
+// a vector of min/max exponent pairs (signed case) or of
+// max exponents (unsigned case), one element per variable.
+template <typename T>
+using pm_exponent_limits_t = ::std::conditional_t<is_signed_v<T>, ::std::vector<::std::pair<T, T>>, ::std::vector<T>>;
+
+// Implementation of the computation of the exponent limits
+// of the monomials in a range of packed monomials. If par is true
+// and the range is random-access, the computation is run in parallel.
+// NOTE: this assumes that all the monomials in the range
+// are compatible with ss, and that neither ss nor the
+// range are empty.
+template <typename R>
+inline auto pm_range_exponent_limits_impl(R &&r, const symbol_set &ss, bool par)
 {
-    using pm_t = remove_cvref_t<typename ::std::iterator_traits<range_begin_t<R1>>::reference>;
+    using pm_t = remove_cvref_t<typename ::std::iterator_traits<range_begin_t<R>>::reference>;
     using value_type = typename pm_t::value_type;
-    using int_t = ::mppp::integer<1>;
 
     // NOTE: because we assume compatibility, the static cast is safe.
     const auto s_size = static_cast<unsigned>(ss.size());
-
-    if (s_size == 0u) {
-        // If the monomials have zero variables,
-        // there cannot be overflow.
-        return true;
-    }
+    assert(s_size > 0u);
 
     // Get out the begin/end iterators.
-    auto b1 = ::obake::begin(::std::forward<R1>(r1));
-    const auto e1 = ::obake::end(::std::forward<R1>(r1));
-    auto b2 = ::obake::begin(::std::forward<R2>(r2));
-    const auto e2 = ::obake::end(::std::forward<R2>(r2));
+    auto b = ::obake::begin(::std::forward<R>(r));
+    const auto e = ::obake::end(::std::forward<R>(r));
 
-    if (b1 == e1 || b2 == e2) {
-        // If either range is empty, there will be no overflow.
-        return true;
-    }
-
-    // Prepare the limits vectors.
-    auto [limits1, limits2] = [s_size]() {
-        if constexpr (is_signed_v<value_type>) {
-            ::std::vector<::std::pair<value_type, value_type>> minmax1, minmax2;
-            minmax1.reserve(static_cast<decltype(minmax1.size())>(s_size));
-            minmax2.reserve(static_cast<decltype(minmax2.size())>(s_size));
+    assert(b != e);
 
-            return ::std::make_tuple(::std::move(minmax1), ::std::move(minmax2));
-        } else {
-            ::std::vector<value_type> max1, max2;
-            max1.reserve(static_cast<decltype(max1.size())>(s_size));
-            max2.reserve(static_cast<decltype(max2.size())>(s_size));
+    // Prepare the limits vector.
+    pm_exponent_limits_t<value_type> limits;
+    limits.reserve(static_cast<decltype(limits.size())>(s_size));
 
-            return ::std::make_tuple(::std::move(max1), ::std::move(max2));
-        }
-    }();
-
-    // Init the limits vectors with the first elements of the ranges.
+    // Init the limits vector with the first element of the range.
     {
-        // NOTE: if the iterators return copies
+        // NOTE: if the iterator returns copies
         // of the monomials, rather than references,
         // capturing them via const
         // ref will extend their lifetimes.
-        const auto &init1 = *b1;
-        const auto &init2 = *b2;
+        const auto &init = *b;
 
-        assert(polynomials::key_is_compatible(init1, ss));
-        assert(polynomials::key_is_compatible(init2, ss));
+        assert(polynomials::key_is_compatible(init, ss));
 
-        kunpacker<value_type> ku1(init1.get_value(), s_size);
-        kunpacker<value_type> ku2(init2.get_value(), s_size);
+        kunpacker<value_type> ku(init.get_value(), s_size);
         value_type tmp;
         for (auto i = 0u; i < s_size; ++i) {
-            ku1 >> tmp;
-            if constexpr (is_signed_v<value_type>) {
-                limits1.emplace_back(tmp, tmp);
-            } else {
-                limits1.emplace_back(tmp);
-            }
-            ku2 >> tmp;
+            ku >> tmp;
             if constexpr (is_signed_v<value_type>) {
-                limits2.emplace_back(tmp, tmp);
+                limits.emplace_back(tmp, tmp);
             } else {
-                limits2.emplace_back(tmp);
+                limits.emplace_back(tmp);
             }
         }
     }
 
-    // Serial implementation.
-    auto serial_impl = [&ss, s_size, b1, e1, &l1 = limits1, b2, e2, &l2 = limits2]() {
-        // Helper to examine the rest of the ranges.
-        auto update_minmax = [&ss, s_size](auto b, auto e, auto &limits) {
-            ::obake::detail::ignore(ss);
-
-            for (++b; b != e; ++b) {
-                const auto &cur = *b;
-
-                assert(polynomials::key_is_compatible(cur, ss));
-
-                kunpacker<value_type> ku(cur.get_value(), s_size);
-                value_type tmp;
-                for (auto i = 0u; i < s_size; ++i) {
-                    ku >> tmp;
-                    if constexpr (is_signed_v<value_type>) {
-                        limits[i].first = ::std::min(limits[i].first, tmp);
-                        limits[i].second = ::std::max(limits[i].second, tmp);
-                    } else {
-                        limits[i] = ::std::max(limits[i], tmp);
+    // Number of monomials decoded at once.
+    constexpr ::std::size_t batch_size = 256;
+
+    // Helper to update the limits l with the exponents of
+    // the monomials in the range [it_b, it_e).
+    // NOTE: the monomials are decoded in batches, and the
+    // limits are then updated one variable at a time.
+    // NOTE: the decoding buffers live on the stack,
+    // so that no memory allocation is needed.
+    auto update_minmax = [&ss, s_size](auto it_b, auto it_e, auto &l) {
+        ::obake::detail::ignore(ss);
+
+        assert(s_size <= ::obake::detail::kpack_max_size<value_type>());
+
+        ::std::array<value_type, batch_size> codes;
+        ::std::array<value_type, batch_size * ::obake::detail::kpack_max_size<value_type>()> exps;
+
+        while (it_b != it_e) {
+            ::std::size_t n = 0;
+            for (; n < batch_size && it_b != it_e; ++n, ++it_b) {
+                const auto &m = *it_b;
+
+                assert(polynomials::key_is_compatible(m, ss));
+
+                codes[n] = m.get_value();
+            }
+
+            kunpack_batch(codes.data(), n, s_size, exps.data());
+
+            for (auto i = 0u; i < s_size; ++i) {
+                const auto row = exps.data() + i * n;
+
+                if constexpr (is_signed_v<value_type>) {
+                    auto [cur_min, cur_max] = l[i];
+                    for (::std::size_t k = 0; k < n; ++k) {
+                        cur_min = ::std::min(cur_min, row[k]);
+                        cur_max = ::std::max(cur_max, row[k]);
+                    }
+                    l[i] = ::std::pair{cur_min, cur_max};
+                } else {
+                    auto cur_max = l[i];
+                    for (::std::size_t k = 0; k < n; ++k) {
+                        cur_max = ::std::max(cur_max, row[k]);
                     }
+                    l[i] = cur_max;
                 }
             }
-        };
-        // Examine the rest of the ranges.
-        update_minmax(b1, e1, l1);
-        update_minmax(b2, e2, l2);
+        }
     };
 
-    if constexpr (::std::conjunction_v<is_random_access_iterator<decltype(b1)>,
-                                       is_random_access_iterator<decltype(b2)>>) {
-        // If both ranges are random-access, we have the option of running a parallel
-        // overflow check.
-        const auto size1 = ::std::distance(b1, e1);
-        const auto size2 = ::std::distance(b2, e2);
-
-        // NOTE: run the parallel implementation only if
-        // at least one of the sizes is large enough.
-        if (size1 > 5000 || size2 > 5000) {
-            auto par_functor = [&ss, s_size](auto b, auto e, const auto &limits) {
-                return ::tbb::parallel_reduce(
-                    // NOTE: the ranges are guaranteed to be non-empty,
-                    // thus b + 1 is always well-defined.
-                    ::tbb::blocked_range<decltype(b)>(b + 1, e), limits,
-                    [&ss, s_size](const auto &range, auto cur) {
-                        ::obake::detail::ignore(ss);
-
-                        for (const auto &m : range) {
-                            assert(polynomials::key_is_compatible(m, ss));
-
-                            kunpacker<value_type> ku(m.get_value(), s_size);
-                            value_type tmp;
-                            for (auto i = 0u; i < s_size; ++i) {
-                                ku >> tmp;
-                                if constexpr (is_signed_v<value_type>) {
-                                    cur[i].first = ::std::min(cur[i].first, tmp);
-                                    cur[i].second = ::std::max(cur[i].second, tmp);
-                                } else {
-                                    cur[i] = ::std::max(cur[i], tmp);
-                                }
-                            }
-                        }
+    // Serial implementation.
+    auto serial_impl = [update_minmax, b, e, &limits]() {
+        // NOTE: the first element was already
+        // used to init the limits.
+        update_minmax(::std::next(b), e, limits);
+    };
 
-                        return cur;
-                    },
-                    [s_size](const auto &l1, const auto &l2) {
-                        assert(l1.size() == s_size);
-                        assert(l2.size() == s_size);
-
-                        remove_cvref_t<decltype(l1)> ret;
-                        ret.reserve(s_size);
-
-                        for (auto i = 0u; i < s_size; ++i) {
-                            if constexpr (is_signed_v<value_type>) {
-                                ret.emplace_back(::std::min(l1[i].first, l2[i].first),
-                                                 ::std::max(l1[i].second, l2[i].second));
-                            } else {
-                                ret.emplace_back(::std::max(l1[i], l2[i]));
-                            }
+    if constexpr (is_random_access_iterator_v<decltype(b)>) {
+        // If the range is random-access, we have the option of running a parallel
+        // computation.
+        if (par) {
+            limits = ::tbb::parallel_reduce(
+                // NOTE: the range is guaranteed to be non-empty,
+                // thus b + 1 is always well-defined.
+                // NOTE: use a grain size equal to the batch size,
+                // so that the batched decoding is not defeated
+                // by tiny chunks.
+                ::tbb::blocked_range<decltype(b)>(b + 1, e, batch_size), limits,
+                [update_minmax](const auto &range, auto cur) {
+                    update_minmax(range.begin(), range.end(), cur);
+
+                    return cur;
+                },
+                [s_size](const auto &l1, const auto &l2) {
+                    assert(l1.size() == s_size);
+                    assert(l2.size() == s_size);
+
+                    remove_cvref_t<decltype(l1)> ret;
+                    ret.reserve(s_size);
+
+                    for (auto i = 0u; i < s_size; ++i) {
+                        if constexpr (is_signed_v<value_type>) {
+                            ret.emplace_back(::std::min(l1[i].first, l2[i].first),
+                                             ::std::max(l1[i].second, l2[i].second));
+                        } else {
+                            ret.emplace_back(::std::max(l1[i], l2[i]));
                         }
+                    }
 
-                        return ret;
-                    });
-            };
-
-            ::tbb::parallel_invoke([par_functor, b1, e1, &l1 = limits1]() { l1 = par_functor(b1, e1, l1); },
-                                   [par_functor, b2, e2, &l2 = limits2]() { l2 = par_functor(b2, e2, l2); });
+                    return ret;
+                });
         } else {
             serial_impl();
         }
     } else {
+        ::obake::detail::ignore(par);
+
         serial_impl();
     }
 
-    // Now add the limits via interval arithmetics
+    return limits;
+}
+
+// Compute the exponent limits of the monomials
+// in a range of packed monomials.
+// NOTE: this assumes that all the monomials in the range
+// are compatible with ss, and that neither ss nor the
+// range are empty.
+template <typename R>
+inline auto pm_range_exponent_limits(R &&r, const symbol_set &ss)
+{
+    bool par = false;
+    if constexpr (is_random_access_iterator_v<range_begin_t<R>>) {
+        // NOTE: run the parallel implementation only if
+        // the size is large enough.
+        par = ::std::distance(::obake::begin(r), ::obake::end(r)) > 5000;
+    }
+
+    return detail::pm_range_exponent_limits_impl(::std::forward<R>(r), ss, par);
+}
+
+// Compute the exponent limits of the monomials
+// in two ranges of packed monomials. The return value
+// is a pair of exponent limits, one per range.
+// NOTE: this assumes that all the monomials in the 2 ranges
+// are compatible with ss, and that neither ss nor the
+// ranges are empty.
+template <typename R1, typename R2>
+inline auto pm_range_exponent_limits(R1 &&r1, R2 &&r2, const symbol_set &ss)
+{
+    using ret_t = ::std::pair<decltype(detail::pm_range_exponent_limits_impl(::std::forward<R1>(r1), ss, false)),
+                              decltype(detail::pm_range_exponent_limits_impl(::std::forward<R2>(r2), ss, false))>;
+
+    if constexpr (::std::conjunction_v<is_random_access_iterator<range_begin_t<R1>>,
+                                       is_random_access_iterator<range_begin_t<R2>>>) {
+        // NOTE: run the parallel implementation only if
+        // at least one of the sizes is large enough. In such case,
+        // the two ranges are processed concurrently, each
+        // via a parallel reduction.
+        if (::std::distance(::obake::begin(r1), ::obake::end(r1)) > 5000
+            || ::std::distance(::obake::begin(r2), ::obake::end(r2)) > 5000) {
+            ret_t ret;
+
+            ::tbb::parallel_invoke(
+                [&ret, &r1, &ss]() {
+                    ret.first = detail::pm_range_exponent_limits_impl(::std::forward<R1>(r1), ss, true);
+                },
+                [&ret, &r2, &ss]() {
+                    ret.second = detail::pm_range_exponent_limits_impl(::std::forward<R2>(r2), ss, true);
+                });
+
+            return ret;
+        }
+    }
+
+    return ret_t{detail::pm_range_exponent_limits_impl(::std::forward<R1>(r1), ss, false),
+                 detail::pm_range_exponent_limits_impl(::std::forward<R2>(r2), ss, false)};
+}
+
+// Check that the multiplication of two ranges of packed monomials
+// whose exponent limits were computed by pm_range_exponent_limits()
+// does not result in an overflow.
+template <typename T, typename L>
+inline bool pm_exponent_limits_check(const L &limits1, const L &limits2)
+{
+    using value_type = T;
+    using int_t = ::mppp::integer<1>;
+
+    assert(limits1.size() == limits2.size());
+    assert(!limits1.empty());
+
+    // NOTE: the size of the limits vectors is the size of the
+    // symbol set, which was already checked to be representable
+    // in the packing.
+    const auto s_size = static_cast<unsigned>(limits1.size());
+
+    // Add the limits via interval arithmetics
     // and check for overflow. Use mppp::integer for the check.
     const auto [lim_min, lim_max] = ::obake::detail::kpack_get_lims<value_type>(s_size);
 
@@ -487,6 +560,160 @@ inline bool monomial_range_overflow_check(R1 &&r1, R2 &&r2, const symbol_set &ss
     return true;
 }
 
+// The bounds on the keys of a series of packed monomials
+// with exponents of type T, as cached in the series (see
+// series::_get_key_bounds()): the exponent limits
+// (in the format of pm_exponent_limits_t) and the
+// minimum/maximum total degree of the keys.
+// NOTE: the total degree of a packed monomial
+// is always representable by T.
+template <typename T>
+struct pm_key_bounds {
+    pm_exponent_limits_t<T> exps;
+    T min_deg;
+    T max_deg;
+};
+
+// Merge the bounds b2 into b1.
+// NOTE: this is an ADL hook used by series.
+template <typename T>
+inline void series_key_bounds_merge(pm_key_bounds<T> &b1, const pm_key_bounds<T> &b2)
+{
+    assert(b1.exps.size() == b2.exps.size());
+
+    for (decltype(b1.exps.size()) i = 0; i < b1.exps.size(); ++i) {
+        if constexpr (is_signed_v<T>) {
+            b1.exps[i].first = ::std::min(b1.exps[i].first, b2.exps[i].first);
+            b1.exps[i].second = ::std::max(b1.exps[i].second, b2.exps[i].second);
+        } else {
+            b1.exps[i] = ::std::max(b1.exps[i], b2.exps[i]);
+        }
+    }
+
+    b1.min_deg = ::std::min(b1.min_deg, b2.min_deg);
+    b1.max_deg = ::std::max(b1.max_deg, b2.max_deg);
+}
+
+// Compute the bounds on the keys of the product of two series
+// from the bounds b1 and b2 on the keys of the factors.
+// NOTE: this requires that the exponent limits
+// passed the check in pm_exponent_limits_check(), so that
+// the sums below cannot overflow.
+template <typename T>
+inline pm_key_bounds<T> pm_key_bounds_mul(const pm_key_bounds<T> &b1, const pm_key_bounds<T> &b2)
+{
+    assert(b1.exps.size() == b2.exps.size());
+    assert(b1.exps.empty() || detail::pm_exponent_limits_check<T>(b1.exps, b2.exps));
+
+    pm_key_bounds<T> retval;
+    retval.exps.reserve(b1.exps.size());
+
+    for (decltype(b1.exps.size()) i = 0; i < b1.exps.size(); ++i) {
+        if constexpr (is_signed_v<T>) {
+            retval.exps.emplace_back(static_cast<T>(b1.exps[i].first + b2.exps[i].first),
+                                     static_cast<T>(b1.exps[i].second + b2.exps[i].second));
+        } else {
+            retval.exps.emplace_back(static_cast<T>(b1.exps[i] + b2.exps[i]));
+        }
+    }
+
+    retval.min_deg = static_cast<T>(b1.min_deg + b2.min_deg);
+    retval.max_deg = static_cast<T>(b1.max_deg + b2.max_deg);
+
+    return retval;
+}
+
+} // namespace detail
+
+// Monomial overflow checking.
+// NOTE: this assumes that all the monomials in the 2 ranges
+// are compatible with ss.
+template <typename R1, typename R2>
+    requires InputRange<R1> && InputRange<R2>
+             && detail::same_packed_monomial_v<
+                 remove_cvref_t<typename ::std::iterator_traits<range_begin_t<R1>>::reference>,
+                 remove_cvref_t<typename ::std::iterator_traits<range_begin_t<R2>>::reference>>
+inline bool monomial_range_overflow_check(R1 &&r1, R2 &&r2, const symbol_set &ss)
+{
+    using pm_t = remove_cvref_t<typename ::std::iterator_traits<range_begin_t<R1>>::reference>;
+    using value_type = typename pm_t::value_type;
+
+    if (ss.empty()) {
+        // If the monomials have zero variables,
+        // there cannot be overflow.
+        return true;
+    }
+
+    if (::obake::begin(r1) == ::obake::end(r1) || ::obake::begin(r2) == ::obake::end(r2)) {
+        // If either range is empty, there will be no overflow.
+        return true;
+    }
+
+    const auto [limits1, limits2]
+        = detail::pm_range_exponent_limits(::std::forward<R1>(r1), ::std::forward<R2>(r2), ss);
+
+    return detail::pm_exponent_limits_check<value_type>(limits1, limits2);
+}
+
+// Hooks for the bounds on the keys of a series,
+// which are computed term by term and cached
+// in the series (see series::_get_key_bounds()).
+// NOTE: these assume that p is compatible with ss.
+template <typename T>
+inline detail::pm_key_bounds<T> series_key_bounds_init(const packed_monomial<T> &p, const symbol_set &ss)
+{
+    assert(polynomials::key_is_compatible(p, ss));
+
+    // NOTE: because we assume compatibility, the static cast is safe.
+    const auto s_size = static_cast<unsigned>(ss.size());
+
+    detail::pm_key_bounds<T> retval;
+    retval.exps.reserve(s_size);
+
+    kunpacker<T> ku(p.get_value(), s_size);
+    T tmp, deg(0);
+    for (auto i = 0u; i < s_size; ++i) {
+        ku >> tmp;
+        if constexpr (is_signed_v<T>) {
+            retval.exps.emplace_back(tmp, tmp);
+        } else {
+            retval.exps.emplace_back(tmp);
+        }
+        deg += tmp;
+    }
+
+    retval.min_deg = deg;
+    retval.max_deg = deg;
+
+    return retval;
+}
+
+template <typename T>
+inline void series_key_bounds_update(detail::pm_key_bounds<T> &b, const packed_monomial<T> &p, const symbol_set &ss)
+{
+    assert(polynomials::key_is_compatible(p, ss));
+    assert(b.exps.size() == ss.size());
+
+    // NOTE: because we assume compatibility, the static cast is safe.
+    const auto s_size = static_cast<unsigned>(ss.size());
+
+    kunpacker<T> ku(p.get_value(), s_size);
+    T tmp, deg(0);
+    for (auto i = 0u; i < s_size; ++i) {
+        ku >> tmp;
+        if constexpr (is_signed_v<T>) {
+            b.exps[i].first = ::std::min(b.exps[i].first, tmp);
+            b.exps[i].second = ::std::max(b.exps[i].second, tmp);
+        } else {
+            b.exps[i] = ::std::max(b.exps[i], tmp);
+        }
+        deg += tmp;
+    }
+
+    b.min_deg = ::std::min(b.min_deg, deg);
+    b.max_deg = ::std::max(b.max_deg, deg);
+}
+
 // Implementation of key_degree().
 OBAKE_DLL_PUBLIC ::std::int32_t key_degree(const packed_monomial<::std::int32_t> &, const symbol_set &);
 OBAKE_DLL_PUBLIC ::std::uint32_t key_degree(const packed_monomial<::std::uint32_t> &, const symbol_set &);
@@ -498,6 +725,13 @@ OBAKE_DLL_PUBLIC ::std::uint64_t key_degree(const packed_monomial<::std::uint64_
 
 #endif
 
+#if defined(OBAKE_PACKABLE_INT128)
+
+OBAKE_DLL_PUBLIC __int128_t key_degree(const packed_monomial<__int128_t> &, const symbol_set &);
+OBAKE_DLL_PUBLIC __uint128_t key_degree(const packed_monomial<__uint128_t> &, const symbol_set &);
+
+#endif
+
 // Implementation of key_p_degree().
 OBAKE_DLL_PUBLIC ::std::int32_t key_p_degree(const packed_monomial<::std::int32_t> &, const symbol_idx_set &,
                                              const symbol_set &);
@@ -513,6 +747,15 @@ OBAKE_DLL_PUBLIC ::std::uint64_t key_p_degree(const packed_monomial<::std::uint6
 
 #endif
 
+#if defined(OBAKE_PACKABLE_INT128)
+
+OBAKE_DLL_PUBLIC __int128_t key_p_degree(const packed_monomial<__int128_t> &, const symbol_idx_set &,
+                                         const symbol_set &);
+OBAKE_DLL_PUBLIC __uint128_t key_p_degree(const packed_monomial<__uint128_t> &, const symbol_idx_set &,
+                                          const symbol_set &);
+
+#endif
+
 // Monomial exponentiation.
 // NOTE: this assumes that p is compatible with ss.
 template <typename T, typename U,
@@ -617,14 +860,18 @@ inline detail::pm_key_evaluate_ret_t<T, U> key_evaluate(const packed_monomial<T>
     // NOTE: because we assume compatibility, the static cast is safe.
     const auto s_size = static_cast<unsigned>(ss.size());
 
-    // Init the return value and the unpacking machinery.
+    // Unpack the exponents.
+    // NOTE: the batch unpacking of a single value
+    // is cheaper than the use of a kunpacker.
+    ::std::array<T, ::obake::detail::kpack_max_size<T>()> exps;
+    kunpack_batch(&p.get_value(), 1, s_size, exps.data());
+
+    // Init the return value.
     detail::pm_key_evaluate_ret_t<T, U> retval(1);
-    kunpacker<T> ku(p.get_value(), s_size);
-    T tmp;
     // Accumulate the result.
+    auto e_it = exps.cbegin();
     for (const auto &pr : sm) {
-        ku >> tmp;
-        retval *= ::obake::pow(pr.second, ::std::as_const(tmp));
+        retval *= ::obake::pow(pr.second, *e_it++);
     }
 
     return retval;
@@ -711,6 +958,13 @@ OBAKE_DLL_PUBLIC void key_trim_identify(::std::vector<int> &, const packed_monom
 
 #endif
 
+#if defined(OBAKE_PACKABLE_INT128)
+
+OBAKE_DLL_PUBLIC void key_trim_identify(::std::vector<int> &, const packed_monomial<__int128_t> &, const symbol_set &);
+OBAKE_DLL_PUBLIC void key_trim_identify(::std::vector<int> &, const packed_monomial<__uint128_t> &, const symbol_set &);
+
+#endif
+
 // Eliminate from p the exponents at the indices
 // specifed by si.
 OBAKE_DLL_PUBLIC packed_monomial<::std::int32_t> key_trim(const packed_monomial<::std::int32_t> &,
@@ -727,6 +981,15 @@ OBAKE_DLL_PUBLIC packed_monomial<::std::uint64_t> key_trim(const packed_monomial
 
 #endif
 
+#if defined(OBAKE_PACKABLE_INT128)
+
+OBAKE_DLL_PUBLIC packed_monomial<__int128_t> key_trim(const packed_monomial<__int128_t> &,
+                                                      const symbol_idx_set &, const symbol_set &);
+OBAKE_DLL_PUBLIC packed_monomial<__uint128_t> key_trim(const packed_monomial<__uint128_t> &,
+                                                       const symbol_idx_set &, const symbol_set &);
+
+#endif
+
 // Monomial differentiation.
 OBAKE_DLL_PUBLIC ::std::pair<::std::int32_t, packed_monomial<::std::int32_t>>
 monomial_diff(const packed_monomial<::std::int32_t> &, const symbol_idx &, const symbol_set &);
@@ -742,6 +1005,15 @@ monomial_diff(const packed_monomial<::std::uint64_t> &, const symbol_idx &, cons
 
 #endif
 
+#if defined(OBAKE_PACKABLE_INT128)
+
+OBAKE_DLL_PUBLIC ::std::pair<__int128_t, packed_monomial<__int128_t>>
+monomial_diff(const packed_monomial<__int128_t> &, const symbol_idx &, const symbol_set &);
+OBAKE_DLL_PUBLIC ::std::pair<__uint128_t, packed_monomial<__uint128_t>>
+monomial_diff(const packed_monomial<__uint128_t> &, const symbol_idx &, const symbol_set &);
+
+#endif
+
 // Monomial integration.
 OBAKE_DLL_PUBLIC ::std::pair<::std::int32_t, packed_monomial<::std::int32_t>>
 monomial_integrate(const packed_monomial<::std::int32_t> &, const symbol_idx &, const symbol_set &);
@@ -757,6 +1029,15 @@ monomial_integrate(const packed_monomial<::std::uint64_t> &, const symbol_idx &,
 
 #endif
 
+#if defined(OBAKE_PACKABLE_INT128)
+
+OBAKE_DLL_PUBLIC ::std::pair<__int128_t, packed_monomial<__int128_t>>
+monomial_integrate(const packed_monomial<__int128_t> &, const symbol_idx &, const symbol_set &);
+OBAKE_DLL_PUBLIC ::std::pair<__uint128_t, packed_monomial<__uint128_t>>
+monomial_integrate(const packed_monomial<__uint128_t> &, const symbol_idx &, const symbol_set &);
+
+#endif
+
 } // namespace polynomials
 
 // Lift to the obake namespace.
@@ -10,62 +10,93 @@
 #define OBAKE_POLYNOMIALS_POLYNOMIAL_HPP
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <cassert>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <initializer_list>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <numeric>
+#include <ostream>
 #include <random>
 #include <stdexcept>
 #include <string>
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <variant>
 #include <vector>
 
+#include <gmp.h>
+
 #include <boost/container/container_fwd.hpp>
 #include <boost/iterator/permutation_iterator.hpp>
 #include <boost/iterator/transform_iterator.hpp>
 #include <boost/numeric/conversion/cast.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/string.hpp>
 #include <boost/serialization/tracking.hpp>
+#include <boost/unordered/unordered_flat_map.hpp>
 #include <boost/unordered/unordered_flat_set.hpp>
 
 #include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
 #include <tbb/parallel_for.h>
 #include <tbb/parallel_invoke.h>
 #include <tbb/parallel_reduce.h>
 #include <tbb/parallel_sort.h>
+#include <tbb/task_arena.h>
 
 #include <mp++/integer.hpp>
+#include <mp++/rational.hpp>
 
 #include <obake/byte_size.hpp>
 #include <obake/config.hpp>
+#include <obake/detail/atomic_flag_array.hpp>
+#include <obake/detail/atomic_lock_guard.hpp>
+#include <obake/detail/default_init_allocator.hpp>
 #include <obake/detail/hc.hpp>
 #include <obake/detail/ignore.hpp>
 #include <obake/detail/it_diff_check.hpp>
+#include <obake/detail/limits.hpp>
 #include <obake/detail/make_array.hpp>
+#include <obake/detail/mppp_utils.hpp>
+#include <obake/detail/safe_integral_arith.hpp>
 #include <obake/detail/ss_func_forward.hpp>
 #include <obake/detail/to_string.hpp>
 #include <obake/detail/type_c.hpp>
+#include <obake/detail/visibility.hpp>
 #include <obake/detail/xoroshiro128_plus.hpp>
 #include <obake/exceptions.hpp>
 #include <obake/hash.hpp>
+#include <obake/key/key_degree.hpp>
+#include <obake/key/key_is_one.hpp>
 #include <obake/key/key_merge_symbols.hpp>
+#include <obake/key/key_p_degree.hpp>
+#include <obake/kpack.hpp>
 #include <obake/math/diff.hpp>
 #include <obake/math/fma3.hpp>
 #include <obake/math/is_zero.hpp>
 #include <obake/math/pow.hpp>
 #include <obake/math/safe_cast.hpp>
+#include <obake/math/safe_convert.hpp>
 #include <obake/math/subs.hpp>
+#include <obake/polynomials/deg_packed_monomial.hpp>
+#include <obake/polynomials/mod_int.hpp>
 #include <obake/polynomials/monomial_diff.hpp>
 #include <obake/polynomials/monomial_homomorphic_hash.hpp>
 #include <obake/polynomials/monomial_integrate.hpp>
 #include <obake/polynomials/monomial_mul.hpp>
 #include <obake/polynomials/monomial_pow.hpp>
+#include <obake/polynomials/monomial_promotion.hpp>
 #include <obake/polynomials/monomial_range_overflow_check.hpp>
 #include <obake/polynomials/monomial_subs.hpp>
+#include <obake/polynomials/packed_monomial.hpp>
 #include <obake/ranges.hpp>
 #include <obake/s11n.hpp>
 #include <obake/series.hpp>
@@ -83,11 +114,191 @@ struct tag {
     }
 };
 
+// Policies for polynomial multiplication:
+// - mul_auto: automatic selection of the algorithm (the default),
+// - mul_heap: heap-based algorithm, which generates the terms of the
+//   product in monomial order and which avoids the memory overhead of the
+//   intermediate hash tables. Available only for packed monomials,
+// - mul_crt: multi-modular algorithm for polynomials with mp++ integer
+//   coefficients. The product is computed in parallel modulo several
+//   word-sized primes, and the integral coefficients are reconstructed
+//   via the Chinese remainder theorem. If the coefficients of the product
+//   are too large for the available primes, mul_auto is used instead.
+struct mul_auto_t {
+};
+
+struct mul_heap_t {
+};
+
+struct mul_crt_t {
+};
+
+inline constexpr mul_auto_t mul_auto{};
+inline constexpr mul_heap_t mul_heap{};
+inline constexpr mul_crt_t mul_crt{};
+
+// Estimated cost of a polynomial multiplication,
+// as returned by estimate_mul() and estimate_truncated_mul().
+struct mul_estimate {
+    // Estimated number of terms in the product.
+    ::mppp::integer<1> n_terms;
+    // Estimated size in bytes of the terms of the product.
+    ::mppp::integer<1> n_bytes;
+    // Number of term-by-term multiplications.
+    ::mppp::integer<1> n_mults;
+};
+
+// Process-wide memory ceiling (in bytes) for polynomial
+// multiplications. If nonzero, a multiplication whose estimated
+// product size exceeds the ceiling will throw mul_mem_limit_error
+// before any memory is allocated for the product. A value of zero
+// (the default) disables the ceiling.
+OBAKE_DLL_PUBLIC void set_mul_mem_limit(::std::size_t);
+OBAKE_DLL_PUBLIC ::std::size_t get_mul_mem_limit();
+
+// Process-wide flag to enable the splitting of hot segments in the
+// multithreaded homomorphic multiplication. A segment of the product is
+// hot if its estimated cost exceeds the amount of work each thread
+// would be assigned in a perfectly balanced schedule. If the flag is set
+// (the default), the computation of a hot segment is split across several
+// tasks, each accumulating into a private table, and the private tables
+// are merged afterwards. Note that, with floating-point coefficients, this
+// changes the order in which the products are accumulated.
+OBAKE_DLL_PUBLIC void set_mul_split_hot_segments(bool);
+OBAKE_DLL_PUBLIC bool get_mul_split_hot_segments();
+
+// Exception thrown when the memory ceiling is exceeded.
+struct mul_mem_limit_error final : ::std::runtime_error {
+    using ::std::runtime_error::runtime_error;
+};
+
+// Coefficient threshold for the pruned multiplication of
+// polynomials with floating-point coefficients (see pruned_mul()).
+// The terms of the product whose coefficients are smaller (in absolute
+// value) than the threshold are discarded. If relative is false, value
+// is the absolute threshold. Otherwise, the absolute threshold is value
+// times the product of the largest coefficients (in absolute value) of
+// the operands, that is, of the factors in a multiplication, or of the
+// truncated series itself in the truncation of a single series. In
+// a multiplication, the reference magnitude is thus an upper bound for
+// the magnitude of the term-by-term products, and it does not depend
+// on the number of terms of the operands.
+struct cf_threshold {
+    double value = 0;
+    bool relative = false;
+
+    template <typename Archive>
+    void serialize(Archive &ar, unsigned)
+    {
+        ar &value;
+        ar &relative;
+    }
+};
+
+inline bool operator==(const cf_threshold &t0, const cf_threshold &t1)
+{
+    return t0.value == t1.value && t0.relative == t1.relative;
+}
+
+inline bool operator!=(const cf_threshold &t0, const cf_threshold &t1)
+{
+    return !(t0 == t1);
+}
+
+inline ::std::size_t hash(const cf_threshold &t)
+{
+    return ::std::hash<double>{}(t.value) + static_cast<::std::size_t>(t.relative);
+}
+
+inline ::std::ostream &operator<<(::std::ostream &os, const cf_threshold &t)
+{
+    return os << t.value << (t.relative ? " (relative)" : " (absolute)");
+}
+
+// Per-symbol integral weights for weighted degree truncation.
+// The weighted degree of a monomial is the sum of its exponents
+// multiplied by the weights of the corresponding symbols. The
+// symbols which do not appear in the map have a weight of zero.
+struct deg_weights {
+    symbol_map<long long> weights;
+
+    template <typename Archive>
+    void save(Archive &ar, unsigned) const
+    {
+        ar << weights.size();
+
+        for (const auto &p : weights) {
+            ar << p.first;
+            ar << p.second;
+        }
+    }
+    template <typename Archive>
+    void load(Archive &ar, unsigned)
+    {
+        decltype(weights.size()) size;
+        ar >> size;
+
+        typename symbol_map<long long>::sequence_type seq;
+        seq.resize(size);
+        for (auto &p : seq) {
+            ar >> p.first;
+            ar >> p.second;
+        }
+
+        weights.adopt_sequence(::boost::container::ordered_unique_range_t{}, ::std::move(seq));
+    }
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
+};
+
+inline bool operator==(const deg_weights &w0, const deg_weights &w1)
+{
+    return w0.weights == w1.weights;
+}
+
+inline bool operator!=(const deg_weights &w0, const deg_weights &w1)
+{
+    return !(w0 == w1);
+}
+
+inline ::std::size_t hash(const deg_weights &w)
+{
+    ::std::size_t ret = 0;
+    for (const auto &p : w.weights) {
+        ret = ret * 31u + ::std::hash<::std::string>{}(p.first);
+        ret = ret * 31u + ::std::hash<long long>{}(p.second);
+    }
+
+    return ret;
+}
+
+inline ::std::ostream &operator<<(::std::ostream &os, const deg_weights &w)
+{
+    os << '{';
+    for (auto it = w.weights.begin(); it != w.weights.end();) {
+        os << '\'' << it->first << "': " << it->second;
+
+        if (++it != w.weights.end()) {
+            os << ", ";
+        }
+    }
+
+    return os << '}';
+}
+
+template <typename, typename>
+class prepared_operand;
+
 } // namespace obake::polynomials
 
 // Disable tracking for the polynomial tag.
 BOOST_CLASS_TRACKING(::obake::polynomials::tag, ::boost::serialization::track_never)
 
+// Disable tracking for the coefficient threshold.
+BOOST_CLASS_TRACKING(::obake::polynomials::cf_threshold, ::boost::serialization::track_never)
+
+// Disable tracking for the degree weights.
+BOOST_CLASS_TRACKING(::obake::polynomials::deg_weights, ::boost::serialization::track_never)
+
 namespace obake
 {
 
@@ -124,14 +335,29 @@ namespace detail
 // - need at least 1 Arg,
 // - T must be a polynomial,
 // - std::string can be constructed from each input Args,
-// - poly key can be constructed from a const int * range,
+// - poly key can be constructed from a const int * range
+//   (optionally accompanied by a symbol set),
 // - poly cf can be constructed from an integral literal.
 template <typename T, typename... Args>
-using make_polynomials_supported
-    = ::std::conjunction<::std::integral_constant<bool, (sizeof...(Args) > 0u)>, is_polynomial<T>,
-                         ::std::is_constructible<::std::string, const Args &>...,
-                         ::std::is_constructible<series_key_t<T>, const int *, const int *>,
-                         ::std::is_constructible<series_cf_t<T>, int>>;
+using make_polynomials_supported = ::std::conjunction<
+    ::std::integral_constant<bool, (sizeof...(Args) > 0u)>, is_polynomial<T>,
+    ::std::is_constructible<::std::string, const Args &>...,
+    ::std::disjunction<::std::is_constructible<series_key_t<T>, const int *, const int *>,
+                       ::std::is_constructible<series_key_t<T>, const int *, const int *, const symbol_set &>>,
+    ::std::is_constructible<series_cf_t<T>, int>>;
+
+// Construct a key of type K from the range [b, e) of exponents,
+// passing along the symbol set ss if the key requires it
+// (e.g., bw_packed_monomial).
+template <typename K>
+inline K make_polynomials_key(const int *b, const int *e, [[maybe_unused]] const symbol_set &ss)
+{
+    if constexpr (::std::is_constructible_v<K, const int *, const int *>) {
+        return K(b, e);
+    } else {
+        return K(b, e, ss);
+    }
+}
 
 template <typename T, typename... Args>
 using make_polynomials_enabler = ::std::enable_if_t<make_polynomials_supported<T, Args...>::value, int>;
@@ -182,7 +408,9 @@ inline auto make_polynomials_impl(const symbol_set &ss, const Args &...names)
         // a range. Make sure we can safely represent the size of tmp via
         // iterator difference.
         ::obake::detail::it_diff_check<decltype(::std::as_const(tmp).data())>(tmp.size());
-        retval.add_term(series_key_t<T>(::std::as_const(tmp).data(), ::std::as_const(tmp).data() + tmp.size()), 1);
+        retval.add_term(detail::make_polynomials_key<series_key_t<T>>(::std::as_const(tmp).data(),
+                                                                      ::std::as_const(tmp).data() + tmp.size(), ss),
+                        1);
 
         // Set back to zero the exponent that was previously set to 1.
         tmp[static_cast<::std::vector<int>::size_type>(ss.index_of(it))] = 0;
@@ -211,7 +439,8 @@ inline auto make_polynomials_impl(const Args &...names)
         static constexpr int arr[] = {1};
 
         // Create and add a new term.
-        retval.add_term(series_key_t<T>(&arr[0], &arr[0] + 1), 1);
+        retval.add_term(
+            detail::make_polynomials_key<series_key_t<T>>(&arr[0], &arr[0] + 1, retval.get_symbol_set()), 1);
 
         return retval;
     };
@@ -237,10 +466,9 @@ namespace detail
 template <typename V>
 inline auto poly_mul_impl_par_make_idx_vector(const V &v)
 {
-    // NOTE: we could use here a custom allocator
-    // that does default initialisation, instead of
-    // value initialisation.
-    ::std::vector<decltype(v.size())> ret;
+    // NOTE: use a default-initialising allocator, as all
+    // the elements will be overwritten below.
+    ::obake::detail::dinit_vector<decltype(v.size())> ret;
     ret.resize(::obake::safe_cast<decltype(ret.size())>(v.size()));
 
     ::tbb::parallel_for(::tbb::blocked_range<decltype(v.size())>(0, v.size()), [&ret](const auto &range) {
@@ -252,10 +480,386 @@ inline auto poly_mul_impl_par_make_idx_vector(const V &v)
     return ret;
 }
 
+// Small helper to apply in parallel the permutation vidx
+// to the vector v. That is, the returned vector ret
+// will be such that ret[i] == v[vidx[i]]. If Move is true,
+// the elements of v will be moved into ret.
+template <bool Move, typename V, typename VIdx>
+inline remove_cvref_t<V> poly_mul_impl_par_permute(V &v, const VIdx &vidx)
+{
+    assert(v.size() == vidx.size());
+
+    // NOTE: the value type of v is required to be
+    // def-constructible. If the allocator of v is
+    // default-initialising, the elements of ret
+    // will not be zeroed out.
+    remove_cvref_t<V> ret;
+    ret.resize(::obake::safe_cast<decltype(ret.size())>(v.size()));
+
+    ::tbb::parallel_for(::tbb::blocked_range<decltype(vidx.size())>(0, vidx.size()),
+                        [&ret, &v, &vidx](const auto &range) {
+                            for (auto i = range.begin(); i != range.end(); ++i) {
+                                if constexpr (Move) {
+                                    ret[i] = ::std::move(v[vidx[i]]);
+                                } else {
+                                    ret[i] = ::std::as_const(v)[vidx[i]];
+                                }
+                            }
+                        });
+
+    return ret;
+}
+
+// Detect weighted degree truncation (i.e., the
+// truncation arguments consist of a degree limit
+// and a set of degree weights).
+template <typename... Args>
+inline constexpr bool poly_mul_is_w_truncated = false;
+
+template <typename V>
+inline constexpr bool poly_mul_is_w_truncated<V, polynomials::deg_weights> = true;
+
+// Helper to turn degree weights into groups of symbol
+// indices with the same nonzero weight. The weighted degree
+// of a monomial is then computed with one partial degree
+// computation per group.
+inline auto poly_w_degree_groups(const polynomials::deg_weights &w, const symbol_set &ss)
+{
+    ::std::map<long long, symbol_idx_set> gmap;
+    for (const auto &[idx, wi] : ::obake::detail::sm_intersect_idx(w.weights, ss)) {
+        if (wi != 0) {
+            gmap[wi].insert(idx);
+        }
+    }
+
+    ::std::vector<::std::pair<symbol_idx_set, ::mppp::integer<1>>> ret;
+    ret.reserve(gmap.size());
+    for (auto &[wi, si] : gmap) {
+        ret.emplace_back(::std::move(si), wi);
+    }
+
+    return ret;
+}
+
+// Helper to extract the weighted degree of the key
+// of a term (or of a pointer to a term). The weighted
+// degree is computed in multiprecision arithmetic, so
+// that it cannot overflow.
+struct poly_w_degree_extractor {
+    template <typename P>
+    ::mppp::integer<1> operator()(const P &p) const
+    {
+        assert(groups != nullptr);
+        assert(ss != nullptr);
+
+        ::mppp::integer<1> ret;
+        for (const auto &[si, wi] : *groups) {
+            ::mppp::addmul(ret, ::mppp::integer<1>{::obake::key_p_degree(p.first, si, *ss)}, wi);
+        }
+
+        return ret;
+    }
+    template <typename P>
+    ::mppp::integer<1> operator()(const P *p) const
+    {
+        return operator()(*p);
+    }
+    const ::std::vector<::std::pair<symbol_idx_set, ::mppp::integer<1>>> *groups = nullptr;
+    const symbol_set *ss = nullptr;
+};
+
+// Helper to construct a vector of weighted degrees from
+// a range of terms. The 'parallel' flag establishes
+// if the construction of the vector of degrees should
+// be done in a parallel fashion. 'It' must be a random-access iterator.
+template <typename It>
+inline auto poly_make_w_degree_vector(It begin, It end, const symbol_set &ss, const polynomials::deg_weights &w,
+                                      bool parallel)
+{
+    static_assert(is_random_access_iterator_v<It>);
+
+    const auto groups = detail::poly_w_degree_groups(w, ss);
+    const auto d_ex = poly_w_degree_extractor{&groups, &ss};
+
+    if (parallel) {
+        ::obake::detail::dinit_vector<::mppp::integer<1>> retval;
+        retval.resize(::obake::safe_cast<decltype(retval.size())>(end - begin));
+
+        ::tbb::parallel_for(::tbb::blocked_range(begin, end), [&retval, &d_ex, begin](const auto &range) {
+            for (auto it = range.begin(); it != range.end(); ++it) {
+                retval[static_cast<decltype(retval.size())>(it - begin)] = d_ex(*it);
+            }
+        });
+
+        return retval;
+    } else {
+        return ::obake::detail::dinit_vector<::mppp::integer<1>>(::boost::make_transform_iterator(begin, d_ex),
+                                                                 ::boost::make_transform_iterator(end, d_ex));
+    }
+}
+
+// Detect if the total degree of the terms of the series S
+// depends only on the key and the key is a packed monomial.
+template <typename S>
+inline constexpr bool poly_has_pm_key_degree
+    = same_packed_monomial_v<series_key_t<S>, series_key_t<S>>
+      && customisation::internal::series_default_degree_impl::algo<S> == 3;
+
+// Helper to construct the vector of the total degrees of the
+// terms in the range [begin, end) of a series of type S whose
+// key is a packed monomial. The exponents are decoded in chunks
+// via kunpack_batch(), and then summed up row by row.
+// 'It' must be a random-access iterator over terms or term pointers.
+template <typename S, typename It>
+inline auto poly_make_pm_degree_vector(It begin, It end, const symbol_set &ss, bool parallel)
+{
+    static_assert(is_random_access_iterator_v<It>);
+    static_assert(poly_has_pm_key_degree<S>);
+
+    using value_type = typename series_key_t<S>::value_type;
+    using deg_t = customisation::internal::series_default_degree_impl::ret_t<S>;
+    static_assert(::std::is_same_v<deg_t, value_type>);
+
+    // NOTE: the keys are compatible with ss,
+    // thus the static cast is safe.
+    const auto s_size = static_cast<unsigned>(ss.size());
+
+    ::obake::detail::dinit_vector<deg_t> retval;
+    retval.resize(::obake::safe_cast<decltype(retval.size())>(end - begin));
+
+    // Number of terms decoded at once.
+    constexpr ::std::size_t batch_size = 256;
+
+    // NOTE: the buffers are sized for the largest
+    // packable symbol set, thus they can be placed on the
+    // stack and no allocation is needed for each chunk.
+    auto compute = [&retval, s_size, begin](It b, It e) {
+        assert(s_size <= ::obake::detail::kpack_max_size<value_type>());
+
+        ::std::array<value_type, batch_size> codes;
+        ::std::array<value_type, batch_size * ::obake::detail::kpack_max_size<value_type>()> exps;
+
+        while (b != e) {
+            const auto n = static_cast<::std::size_t>(
+                ::std::min(e - b, static_cast<decltype(e - b)>(batch_size)));
+
+            for (::std::size_t i = 0; i < n; ++i) {
+                if constexpr (::std::is_pointer_v<remove_cvref_t<decltype(*b)>>) {
+                    codes[i] = b[static_cast<decltype(e - b)>(i)]->first.get_value();
+                } else {
+                    codes[i] = b[static_cast<decltype(e - b)>(i)].first.get_value();
+                }
+            }
+
+            kunpack_batch(codes.data(), n, s_size, exps.data());
+
+            const auto out = retval.data() + (b - begin);
+            ::std::fill(out, out + n, deg_t(0));
+            for (auto j = 0u; j < s_size; ++j) {
+                const auto row = exps.data() + static_cast<::std::size_t>(j) * n;
+                for (::std::size_t i = 0; i < n; ++i) {
+                    out[i] += row[i];
+                }
+            }
+
+            b += static_cast<decltype(e - b)>(n);
+        }
+    };
+
+    if (parallel) {
+        // NOTE: chunks smaller than a batch would
+        // waste the batched decoding.
+        ::tbb::parallel_for(::tbb::blocked_range(begin, end, batch_size),
+                            [&compute](const auto &range) { compute(range.begin(), range.end()); });
+    } else {
+        compute(begin, end);
+    }
+
+    return retval;
+}
+
+// Detect pruned multiplication (i.e., the extra
+// arguments of the multiplication functions consist
+// of a single coefficient threshold).
+template <typename... Args>
+inline constexpr bool poly_mul_is_pruned = false;
+
+template <>
+inline constexpr bool poly_mul_is_pruned<polynomials::cf_threshold> = true;
+
+// Magnitude of a floating-point coefficient,
+// used in pruned multiplication.
+template <typename C>
+inline double poly_mul_cf_mag(const C &c)
+{
+    return static_cast<double>(::std::abs(c));
+}
+
+// Check that the coefficients of the series x
+// are finite (required in pruned multiplication).
+template <typename T>
+inline void poly_mul_check_pruned_cfs(const T &x)
+{
+    for (const auto &t : x) {
+        if (obake_unlikely(!::std::isfinite(t.second))) {
+            obake_throw(::std::invalid_argument, "The pruned multiplication of polynomials requires finite "
+                                                 "coefficients, but the coefficient "
+                                                     + ::obake::detail::to_string(t.second)
+                                                     + " was encountered instead");
+        }
+    }
+}
+
+// Compute the absolute coefficient threshold corresponding
+// to thr for the operands s (see the documentation
+// of cf_threshold).
+template <typename... S>
+inline double poly_abs_cf_threshold(const polynomials::cf_threshold &thr, const S &...s)
+{
+    if (!thr.relative) {
+        ::obake::detail::ignore(s...);
+
+        return thr.value;
+    }
+
+    auto max_mag = [](const auto &a) {
+        double ret = 0;
+        for (const auto &t : a) {
+            ret = ::std::max(ret, detail::poly_mul_cf_mag(t.second));
+        }
+        return ret;
+    };
+
+    return (thr.value * ... * max_mag(s));
+}
+
+// The operations on the degrees of the terms used by the machinery
+// for truncated multiplication. In truncated mode, the degree of
+// a term-by-term product is the sum of the degrees of the factors,
+// the terms are sorted in ascending order of degree, and a term-by-term
+// product is skipped if its degree is greater than the truncation limit.
+template <typename... Args>
+struct poly_mul_deg_ops {
+    // The degree of the product of two terms with degrees d1 and d2.
+    template <typename D1, typename D2>
+    static auto prod(const D1 &d1, const D2 &d2)
+    {
+        return d1 + d2;
+    }
+    // The sorting order of the degrees.
+    template <typename D1, typename D2>
+    static bool less(const D1 &d1, const D2 &d2)
+    {
+        return d1 < d2;
+    }
+    // Check if a term-by-term product of degree d
+    // must be skipped, given the truncation limit lim.
+    // NOTE: we require below comparability between const lvalue
+    // limit and rvalue of the sum of the degrees.
+    template <typename L, typename D>
+    static bool skip(const L &lim, const D &d)
+    {
+        return lim < d;
+    }
+};
+
+// In pruned mode, the degree of a term is the magnitude of its
+// coefficient: the degree of a term-by-term product is the product of
+// the magnitudes, the terms are sorted in descending order of magnitude,
+// and a term-by-term product is skipped if its magnitude is less
+// than the absolute threshold.
+template <>
+struct poly_mul_deg_ops<polynomials::cf_threshold> {
+    static double prod(double d1, double d2)
+    {
+        return d1 * d2;
+    }
+    static bool less(double d1, double d2)
+    {
+        return d1 > d2;
+    }
+    static bool skip(const polynomials::cf_threshold &thr, double d)
+    {
+        assert(!thr.relative);
+
+        return d < thr.value;
+    }
+};
+
+// Helper to construct the vector of the magnitudes of the
+// coefficients of the terms in the range [begin, end).
+// 'It' must be a random-access iterator over terms.
+template <typename It>
+inline auto poly_make_cf_mag_vector(It begin, It end, bool parallel)
+{
+    static_assert(is_random_access_iterator_v<It>);
+
+    ::obake::detail::dinit_vector<double> retval;
+    retval.resize(::obake::safe_cast<decltype(retval.size())>(end - begin));
+
+    auto compute = [&retval, begin](It b, It e) {
+        for (; b != e; ++b) {
+            retval[static_cast<decltype(retval.size())>(b - begin)] = detail::poly_mul_cf_mag(b->second);
+        }
+    };
+
+    if (parallel) {
+        ::tbb::parallel_for(::tbb::blocked_range(begin, end),
+                            [&compute](const auto &range) { compute(range.begin(), range.end()); });
+    } else {
+        compute(begin, end);
+    }
+
+    return retval;
+}
+
+// Helper to construct the vector of the degrees of the terms
+// in the range [begin, end) of a series of type S, according to
+// the truncation arguments args (total, partial or weighted degree).
+template <typename S, typename It, typename... Args>
+inline auto poly_mul_impl_make_degree_vector(It begin, It end, const symbol_set &ss, bool parallel,
+                                             const Args &...args)
+{
+    static_assert(sizeof...(Args) == 1u || sizeof...(Args) == 2u);
+
+    if constexpr (poly_mul_is_pruned<Args...>) {
+        // Coefficient magnitude (pruned mode).
+        ::obake::detail::ignore(ss, args...);
+
+        return detail::poly_make_cf_mag_vector(begin, end, parallel);
+    } else if constexpr (sizeof...(Args) == 1u) {
+        // Total degree.
+        ::obake::detail::ignore(args...);
+
+        if constexpr (poly_has_pm_key_degree<S>) {
+            return detail::poly_make_pm_degree_vector<S>(begin, end, ss, parallel);
+        } else {
+            return customisation::internal::make_degree_vector<S>(begin, end, ss, parallel);
+        }
+    } else if constexpr (poly_mul_is_w_truncated<Args...>) {
+        // Weighted degree.
+        return detail::poly_make_w_degree_vector(begin, end, ss, ::std::get<1>(::std::forward_as_tuple(args...)),
+                                                 parallel);
+    } else {
+        // Partial degree.
+        return customisation::internal::make_p_degree_vector<S>(begin, end, ss,
+                                                                ::std::get<1>(::std::forward_as_tuple(args...)),
+                                                                parallel);
+    }
+}
+
+// Detect if, in a multiplication truncated according to Args,
+// the terms of the series S can be sorted by degree via a direct
+// comparison of the codes of their keys. This is the case
+// for total degree truncation with degree-augmented packed monomials.
+template <typename S, typename... Args>
+inline constexpr bool poly_mul_impl_code_degree_sort = sizeof...(Args) == 1u && !poly_mul_is_pruned<Args...>
+                                                       && same_deg_packed_monomial_v<series_key_t<S>, series_key_t<S>>;
+
 // Helper to prepare the variables that will hold the degree
 // data used during polynomial multiplication. In untruncated
 // multiplication, an empty tuple will be returned, otherwise
-// a tuple of 2 vectors containing the (partial) degrees of the terms
+// a tuple of 2 vectors containing the (partial/weighted) degrees of the terms
 // in the input series will be returned.
 // The input series are of types T and U, while the terms
 // of the series are stored in the input vectors v1 and v2.
@@ -272,20 +876,13 @@ inline auto poly_mul_impl_prepare_degree_data([[maybe_unused]] const V1 &v1, [[m
     if constexpr (sizeof...(Args) == 0u) {
         // Untruncated case, return an empty tuple.
         return ::std::make_tuple();
-    } else if constexpr (sizeof...(Args) == 1u) {
-        // Total truncation.
+    } else {
+        // Truncated case.
         return ::std::make_tuple(
             // NOTE: the invocation here uses parallel mode, but it does not really
             // matter as the return type does not change wrt serial mode.
-            decltype(customisation::internal::make_degree_vector<T>(v1.cbegin(), v1.cend(), ss, true)){},
-            decltype(customisation::internal::make_degree_vector<U>(v2.cbegin(), v2.cend(), ss, true)){});
-    } else {
-        // Partial truncation.
-        return ::std::make_tuple(
-            decltype(customisation::internal::make_p_degree_vector<T>(
-                v1.cbegin(), v1.cend(), ss, ::std::get<1>(::std::forward_as_tuple(args...)), true)){},
-            decltype(customisation::internal::make_p_degree_vector<U>(
-                v2.cbegin(), v2.cend(), ss, ::std::get<1>(::std::forward_as_tuple(args...)), true)){});
+            decltype(detail::poly_mul_impl_make_degree_vector<T>(v1.cbegin(), v1.cend(), ss, true, args...)){},
+            decltype(detail::poly_mul_impl_make_degree_vector<U>(v2.cbegin(), v2.cend(), ss, true, args...)){});
     }
 }
 
@@ -380,6 +977,146 @@ inline constexpr int poly_mul_algo = poly_mul_algorithm<T, U>.first;
 template <typename T, typename U>
 using poly_mul_ret_t = typename decltype(poly_mul_algorithm<T, U>.second)::type;
 
+// Machinery to handle the operands of the multiplication
+// functions, which can be either series or prepared operands.
+template <typename T>
+struct is_prepared_operand_impl : ::std::false_type {
+};
+
+template <typename K, typename C>
+struct is_prepared_operand_impl<prepared_operand<K, C>> : ::std::true_type {
+};
+
+template <typename T>
+inline constexpr bool is_prepared_operand_v = is_prepared_operand_impl<T>::value;
+
+// The series type of an operand.
+template <typename T>
+struct poly_mul_op_series_impl {
+    using type = T;
+};
+
+template <typename K, typename C>
+struct poly_mul_op_series_impl<prepared_operand<K, C>> {
+    using type = polynomial<K, C>;
+};
+
+template <typename T>
+using poly_mul_op_series_t = typename poly_mul_op_series_impl<T>::type;
+
+// Fetch a const reference to the series of an operand.
+template <typename T>
+inline const poly_mul_op_series_t<T> &poly_mul_op_series(const T &x)
+{
+    if constexpr (is_prepared_operand_v<T>) {
+        return x.get_poly();
+    } else {
+        return x;
+    }
+}
+
+// Detect if the multiplication of the series x and y
+// is a squaring (i.e., x and y are the same object). In such
+// case, the multiplication engines can compute each off-diagonal
+// term-by-term product only once.
+// NOTE: the squaring kernel doubles the coefficients of x. For C++
+// integral coefficient types, this may overflow: in such case,
+// the squaring kernel is not used.
+template <typename T, typename U>
+inline bool poly_mul_impl_is_square(const T &x, const U &y)
+{
+    if constexpr (::std::is_same_v<T, U>) {
+        if (&x != &y) {
+            return false;
+        }
+
+        using cf_t = series_cf_t<T>;
+
+        if constexpr (is_integral_v<cf_t>) {
+            constexpr auto cf_max = ::obake::detail::limits_max<cf_t> / cf_t(2);
+
+            return ::std::all_of(x.begin(), x.end(), [](const auto &t) {
+                if constexpr (is_signed_v<cf_t>) {
+                    constexpr auto cf_min = ::obake::detail::limits_min<cf_t> / cf_t(2);
+
+                    return t.second >= cf_min && t.second <= cf_max;
+                } else {
+                    return t.second <= cf_max;
+                }
+            });
+        } else {
+            return true;
+        }
+    } else {
+        ::obake::detail::ignore(x, y);
+
+        return false;
+    }
+}
+
+// The data used by the multithreaded multiplication for
+// each operand: the terms sorted according to the segmentation
+// order, the segmentation ranges and the degrees of the terms
+// (only in truncated multiplication).
+template <typename V, typename VSeg, typename VD>
+struct poly_mul_seg_data {
+    V v;
+    VSeg vseg;
+    VD vd;
+};
+
+// The multiplication data cached in a prepared operand for a given
+// number of segments and type of truncation: the permutation which
+// sorts the terms of the operand according to the segmentation order
+// (and, in truncated multiplication, according to the degree within
+// each segment), and the segmentation ranges.
+template <typename Idx, typename SSize>
+struct poly_mul_prep_data {
+    ::obake::detail::dinit_vector<Idx> perm;
+    ::std::vector<::std::tuple<Idx, Idx, SSize>> vseg;
+};
+
+// The maximum number of entries in the cache of a prepared
+// operand. When the cache is full, it is cleared before
+// a new entry is inserted.
+inline constexpr ::std::size_t prepared_operand_max_cache_size = 16;
+
+// The key used to identify the multiplication data in the cache
+// of a prepared operand: the base-2 logarithm of the number of segments,
+// the truncation type (0 for no truncation, 1 for total degree
+// truncation, 2 for partial degree truncation, 3 for weighted
+// degree truncation, 4 for coefficient-threshold pruning), the symbols
+// for partial degree truncation and the weights for weighted degree
+// truncation. In pruning mode, the key does not contain the threshold,
+// because the sorting of the terms according to the magnitude of the
+// coefficients does not depend on it.
+using poly_mul_cache_key_t = ::std::tuple<unsigned, unsigned, symbol_set, symbol_map<long long>>;
+
+template <typename... Args>
+inline poly_mul_cache_key_t poly_mul_impl_cache_key(unsigned log2_nsegs, const Args &...args)
+{
+    static_assert(sizeof...(Args) <= 2u);
+
+    if constexpr (poly_mul_is_w_truncated<Args...>) {
+        return poly_mul_cache_key_t{log2_nsegs, 3u, symbol_set{},
+                                    ::std::get<1>(::std::forward_as_tuple(args...)).weights};
+    } else if constexpr (poly_mul_is_pruned<Args...>) {
+        // NOTE: the sorting according to the magnitude of
+        // the coefficients does not depend on the threshold.
+        ::obake::detail::ignore(args...);
+
+        return poly_mul_cache_key_t{log2_nsegs, 4u, symbol_set{}, symbol_map<long long>{}};
+    } else if constexpr (sizeof...(Args) == 2u) {
+        return poly_mul_cache_key_t{log2_nsegs, 2u, ::std::get<1>(::std::forward_as_tuple(args...)),
+                                    symbol_map<long long>{}};
+    } else {
+        ::obake::detail::ignore(args...);
+
+        return poly_mul_cache_key_t{log2_nsegs, static_cast<unsigned>(sizeof...(Args)), symbol_set{},
+                                    symbol_map<long long>{}};
+    }
+}
+
 // Helper to estimate the average term size (in bytes) in a poly multiplication.
 // NOTE: should this also be made proportional to the number
 // of estimated term-by-term multiplications?
@@ -459,11 +1196,281 @@ struct poly_mul_impl_pair_transform {
     }
 };
 
-// This function will:
-// - estimate the size of the product of two input polynomials,
-// - compute the total number of term-by-term multiplications that will
-//   be performed in the computation of the polynomial product
-//   (which could be different from the product of the sizes of the
+// Create a vector containing copies of the terms of
+// the series s (with the const removed from the key type).
+// If s is segmented and large enough, the copy
+// is performed in parallel over the segments.
+template <typename S>
+inline auto poly_mul_impl_make_term_vector(const S &s)
+{
+    using vec_t = ::std::vector<::std::pair<series_key_t<S>, series_cf_t<S>>>;
+
+    const auto &s_table = s._get_s_table();
+
+    if (s_table.size() == 1u || s.size() < 10000u) {
+        return vec_t(::boost::make_transform_iterator(s.begin(), poly_mul_impl_pair_transform{}),
+                     ::boost::make_transform_iterator(s.end(), poly_mul_impl_pair_transform{}));
+    }
+
+    // Compute the offset of each segment in the output vector.
+    // NOTE: the terms are copied in the same order
+    // in which they are visited by the series' iterators.
+    ::std::vector<typename vec_t::size_type> offsets;
+    offsets.reserve(::obake::safe_cast<decltype(offsets.size())>(s_table.size()));
+    typename vec_t::size_type cur_offset = 0;
+    for (const auto &tab : s_table) {
+        offsets.push_back(cur_offset);
+        cur_offset += ::obake::safe_cast<typename vec_t::size_type>(tab.size());
+    }
+
+    vec_t ret;
+    ret.resize(cur_offset);
+
+    ::tbb::parallel_for(::tbb::blocked_range<decltype(s_table.size())>(0, s_table.size()),
+                        [&s_table, &offsets, &ret](const auto &range) {
+                            for (auto i = range.begin(); i != range.end(); ++i) {
+                                const auto &tab = s_table[i];
+
+                                ::std::transform(tab.begin(), tab.end(), ret.data() + offsets[i],
+                                                 poly_mul_impl_pair_transform{});
+                            }
+                        });
+
+    return ret;
+}
+
+// Non-owning reference to a term of a series. Vectors of term
+// references can be used in place of vectors of terms in the
+// estimation of the cost of a multiplication, so that the
+// estimation does not need to copy the terms of the operands.
+template <typename K, typename C>
+struct poly_mul_term_ref {
+    using first_type = K;
+    using second_type = C;
+
+    const K &first;
+    const C &second;
+};
+
+// Create a vector of references to the terms of the series s.
+// NOTE: the references are stored in the same order
+// in which the terms are visited by the series' iterators.
+template <typename S>
+inline auto poly_mul_impl_make_term_ref_vector(const S &s)
+{
+    ::std::vector<poly_mul_term_ref<series_key_t<S>, series_cf_t<S>>> ret;
+    ret.reserve(::obake::safe_cast<decltype(ret.size())>(s.size()));
+
+    for (const auto &[k, c] : s) {
+        ret.push_back({k, c});
+    }
+
+    return ret;
+}
+
+// Hasher for the values of packed monomials, consistent with
+// the hash of packed monomials.
+// NOTE: this does not rely on the availability of a standard
+// hasher for the value type (e.g., for __int128_t in strict mode).
+struct poly_pm_value_hasher {
+    template <typename T>
+    ::std::size_t operator()(const T &n) const noexcept
+    {
+        return static_cast<::std::size_t>(n);
+    }
+};
+
+// Minimum ratio between the sizes of the operands
+// above which a multiplication is considered rectangular
+// for the purpose of the estimation of the product size.
+inline constexpr ::std::size_t poly_mul_rect_ratio = 8;
+
+// Estimate the size of the product of two polynomials with packed
+// monomials in a rectangular multiplication (i.e., when y is
+// much longer than x).
+//
+// In rectangular multiplications, the trials of the generic estimator
+// very rarely produce duplicate terms, and the product size is thus
+// estimated to be close to the number of term-by-term multiplications.
+// Here we use instead the fact that the number of distinct terms in the
+// product is the sum, over all the term-by-term multiplications x_i*y_j,
+// of 1/c_ij, where c_ij is the number of term-by-term multiplications
+// producing the same monomial as x_i*y_j. For packed monomials, c_ij
+// can be computed exactly by checking, for each term x_l in x, whether
+// the value of the packed monomial of x_i*y_j minus the value of x_l is
+// the value of a packed monomial in y. The estimate is then obtained
+// by sampling randomly the term-by-term multiplications.
+//
+// vidx2 and degree_data are the vector of indices into y and the degree
+// data computed in poly_mul_estimate_product_size(). In truncated mode,
+// vidx2 and the degree data of y are sorted according to the degree. The
+// term-by-term multiplications violating the truncation limits contribute
+// zero to the sum (because the degree of a monomial does not depend
+// on the way it is produced, c_ij includes only term-by-term multiplications
+// within the truncation limits). In pruned mode, the degree data contains
+// the magnitudes of the coefficients: the term-by-term multiplications below
+// the threshold contribute zero to the sum, and they are excluded
+// from the computation of c_ij.
+template <typename T1, typename T2, typename VIdx, typename DD, typename... Args>
+inline ::mppp::integer<1> poly_mul_estimate_product_size_rect(const ::std::vector<T1> &x, const ::std::vector<T2> &y,
+                                                               const symbol_set &ss, const VIdx &vidx2,
+                                                               const DD &degree_data, const Args &...args)
+{
+    using key_type = typename T1::first_type;
+    using value_type = typename key_type::value_type;
+
+    // Preconditions.
+    assert(!x.empty());
+    assert(!y.empty());
+    assert(vidx2.size() == y.size());
+
+    // Helper to compute a - b, returning false
+    // in case of overflow.
+    auto checked_sub = [](const value_type &a, const value_type &b, value_type &out) {
+        if constexpr (::std::is_unsigned_v<value_type>) {
+            if (a < b) {
+                return false;
+            }
+        } else {
+            if ((b > 0 && a < ::obake::detail::limits_min<value_type> + b)
+                || (b < 0 && a > ::obake::detail::limits_max<value_type> + b)) {
+                return false;
+            }
+        }
+
+        out = a - b;
+
+        return true;
+    };
+
+    // Build the set of the values of the
+    // packed monomials in y. In pruned mode, map the values
+    // to the magnitudes of the coefficients.
+    auto yset = [&y]() {
+        if constexpr (poly_mul_is_pruned<Args...>) {
+            ::boost::unordered_flat_map<value_type, double, poly_pm_value_hasher> ret;
+            ret.reserve(y.size());
+            for (const auto &p : y) {
+                ret.emplace(p.first.get_value(), detail::poly_mul_cf_mag(p.second));
+            }
+
+            return ret;
+        } else {
+            ::boost::unordered_flat_set<value_type, poly_pm_value_hasher> ret;
+            ret.reserve(y.size());
+            for (const auto &p : y) {
+                ret.insert(p.first.get_value());
+            }
+
+            return ret;
+        }
+    }();
+
+    // Establish the number of samples. Each sample requires
+    // x.size() lookups into yset, and the total number of lookups
+    // is capped to 2**24 (but at least one sample is always taken).
+    // The samples are processed in chunks of chunk_size.
+    constexpr auto chunk_size = 256u;
+    constexpr auto max_lookups = ::std::size_t(1) << 24;
+    const auto n_samples = static_cast<unsigned>(
+        ::std::max(::std::size_t(1), ::std::min(::std::size_t(256) * chunk_size, max_lookups / x.size())));
+    const auto n_chunks = n_samples / chunk_size + static_cast<unsigned>(n_samples % chunk_size != 0u);
+
+    using dist1_type = ::std::uniform_int_distribution<decltype(x.size())>;
+    using dist2_type = ::std::uniform_int_distribution<decltype(y.size())>;
+
+    const auto acc = ::tbb::parallel_reduce(
+        ::tbb::blocked_range<unsigned>(0, n_chunks), 0.,
+        [&x, &y, &ss, &vidx2, &degree_data, &yset, &checked_sub, n_samples, &args...](const auto &range,
+                                                                                       double cur) {
+            // Temporary object for monomial multiplications.
+            key_type tmp_key(ss);
+
+            dist1_type dist1(0, x.size() - 1u);
+            dist2_type dist2(0, y.size() - 1u);
+
+            for (auto i = range.begin(); i != range.end(); ++i) {
+                // Init a random engine for this chunk, mixing compile
+                // time randomness with the current chunk index.
+                constexpr ::std::uint64_t s1 = 11400714819323198485ull;
+                constexpr ::std::uint64_t s2 = 13787848793156543929ull;
+                ::obake::detail::xoroshiro128_plus rng{static_cast<::std::uint64_t>(i + s1),
+                                                       static_cast<::std::uint64_t>(i + s2)};
+
+                // NOTE: the last chunk may be incomplete.
+                // NOTE: pass a copy of chunk_size to std::min(),
+                // so that it is not odr-used (and thus it does not
+                // need to be captured).
+                const auto cur_size = ::std::min(static_cast<unsigned>(chunk_size), n_samples - i * chunk_size);
+                for (auto j = 0u; j < cur_size; ++j) {
+                    // Pick a random term-by-term multiplication.
+                    const auto idx1 = dist1(rng);
+                    const auto k2 = dist2(rng);
+
+                    if constexpr (sizeof...(args) > 0u) {
+                        // Check the truncation limits.
+                        const auto &max_deg = ::std::get<0>(::std::forward_as_tuple(args...));
+                        const auto &[v1_deg, v2_deg] = degree_data;
+
+                        using d_ops = poly_mul_deg_ops<Args...>;
+
+                        if (d_ops::skip(max_deg, d_ops::prod(v1_deg[idx1], v2_deg[k2]))) {
+                            continue;
+                        }
+                    } else {
+                        ::obake::detail::ignore(degree_data, args...);
+                    }
+
+                    ::obake::monomial_mul(tmp_key, x[idx1].first, y[vidx2[k2]].first, ss);
+                    const auto m = tmp_key.get_value();
+
+                    // Count how many term-by-term multiplications
+                    // produce the same monomial.
+                    ::std::size_t c = 0;
+                    value_type q;
+                    for (const auto &p : x) {
+                        if constexpr (poly_mul_is_pruned<Args...>) {
+                            // NOTE: count only the term-by-term
+                            // multiplications above the threshold.
+                            if (!checked_sub(m, p.first.get_value(), q)) {
+                                continue;
+                            }
+
+                            const auto it = yset.find(q);
+                            c += static_cast<::std::size_t>(
+                                it != yset.end()
+                                && !poly_mul_deg_ops<Args...>::skip(
+                                    ::std::get<0>(::std::forward_as_tuple(args...)),
+                                    poly_mul_deg_ops<Args...>::prod(detail::poly_mul_cf_mag(p.second), it->second)));
+                        } else {
+                            c += static_cast<::std::size_t>(checked_sub(m, p.first.get_value(), q)
+                                                            && yset.contains(q));
+                        }
+                    }
+                    // NOTE: at least x[idx1]*y[vidx2[k2]]
+                    // produces m.
+                    assert(c > 0u);
+
+                    cur += 1. / static_cast<double>(c);
+                }
+            }
+
+            return cur;
+        },
+        [](double a, double b) { return a + b; });
+
+    // Extrapolate to all the term-by-term multiplications.
+    const auto est = ::std::ceil(acc / static_cast<double>(n_samples) * static_cast<double>(x.size())
+                                 * static_cast<double>(y.size()));
+
+    return ::std::isfinite(est) && est >= 1. ? ::mppp::integer<1>{est} : ::mppp::integer<1>{1};
+}
+
+// This function will:
+// - estimate the size of the product of two input polynomials,
+// - compute the total number of term-by-term multiplications that will
+//   be performed in the computation of the polynomial product
+//   (which could be different from the product of the sizes of the
 //   factors due to truncation).
 // S1 and S2 are the types of the polynomials, x and y the polynomials
 // represented as vectors of terms. The extra arguments represent
@@ -472,12 +1479,17 @@ struct poly_mul_impl_pair_transform {
 // value is guaranteed to be nonzero.
 // NOTE: by imposing that x is the shorter series, we are able to
 // greatly reduce the estimation overhead for highly rectangular
-// multiplications. The downside is that we overestimate the final
-// series size quite a bit. Not sure how we could proceed to
-// improve the situation.
-template <typename S1, typename S2, typename T1, typename T2, typename... Args>
-inline auto poly_mul_estimate_product_size(const ::std::vector<T1> &x, const ::std::vector<T2> &y, const symbol_set &ss,
-                                           const Args &...args)
+// multiplications. The downside is that the generic estimator
+// overestimates the final series size quite a bit in such cases,
+// thus for packed monomials a dedicated estimator is used
+// in rectangular multiplications.
+// NOTE: in_dd is a tuple containing the degrees of the terms of
+// x and y (in truncated mode), or an empty tuple (in untruncated mode).
+// The degrees are computed by the caller, so that they can be re-used
+// after the estimation (e.g., for the segmentation of the input series).
+template <typename S1, typename S2, typename T1, typename T2, typename DD, typename... Args>
+inline auto poly_mul_estimate_product_size_dd(const ::std::vector<T1> &x, const ::std::vector<T2> &y,
+                                              const symbol_set &ss, const DD &in_dd, const Args &...args)
 {
     // Preconditions.
     assert(!x.empty());
@@ -493,81 +1505,62 @@ inline auto poly_mul_estimate_product_size(const ::std::vector<T1> &x, const ::s
     static_assert(::std::is_same_v<series_cf_t<S1>, typename T1::second_type>);
     static_assert(::std::is_same_v<series_cf_t<S2>, typename T2::second_type>);
 
-    // Prepare the variable to hold the degree data.
-    auto degree_data = detail::poly_mul_impl_prepare_degree_data<S1, S2>(x, y, ss, args...);
-
     // Prepare vectors of indices into x/y.
     decltype(detail::poly_mul_impl_par_make_idx_vector(x)) vidx1;
     decltype(detail::poly_mul_impl_par_make_idx_vector(y)) vidx2;
 
-    // Concurrently create the degree data for x and y, and fill
-    // in the vidx1/vidx2 vectors. vidx2 and y's degree data
-    // will also be sorted, if the multiplication is truncated.
-    ::tbb::parallel_invoke(
-        [&vidx1, &x, &ss, &degree_data, &args...]() {
-            if constexpr (sizeof...(args) == 1u) {
-                // Total degree truncation.
-                ::obake::detail::ignore(args...);
-
-                ::obake::detail::container_it_diff_check(x);
-
-                ::std::get<0>(degree_data)
-                    = customisation::internal::make_degree_vector<S1>(x.cbegin(), x.cend(), ss, true);
-            } else if constexpr (sizeof...(args) == 2u) {
-                // Partial degree truncation.
-                ::obake::detail::container_it_diff_check(x);
-
-                ::std::get<0>(degree_data) = customisation::internal::make_p_degree_vector<S1>(
-                    x.cbegin(), x.cend(), ss, ::std::get<1>(::std::forward_as_tuple(args...)), true);
-            } else {
-                ::obake::detail::ignore(ss, degree_data, args...);
-            }
-
-            vidx1 = detail::poly_mul_impl_par_make_idx_vector(x);
-        },
-        [&vidx2, &y, &ss, &degree_data, &args...]() {
-            if constexpr (sizeof...(args) == 1u) {
-                // Total degree truncation.
-                ::obake::detail::ignore(args...);
-
-                ::obake::detail::container_it_diff_check(y);
-
-                ::std::get<1>(degree_data)
-                    = customisation::internal::make_degree_vector<S2>(y.cbegin(), y.cend(), ss, true);
-            } else if constexpr (sizeof...(args) == 2u) {
-                // Partial degree truncation.
-                ::obake::detail::container_it_diff_check(y);
-
-                ::std::get<1>(degree_data) = customisation::internal::make_p_degree_vector<S2>(
-                    y.cbegin(), y.cend(), ss, ::std::get<1>(::std::forward_as_tuple(args...)), true);
-            } else {
-                ::obake::detail::ignore(ss, degree_data, args...);
-            }
-
-            vidx2 = detail::poly_mul_impl_par_make_idx_vector(y);
-
-            // In truncated multiplication, order
-            // the indices into y according to the degree of
-            // the terms, and sort the vector of
-            // degrees as well.
-            if constexpr (sizeof...(args) > 0u) {
-                auto &v2_deg = ::std::get<1>(degree_data);
-
-                ::tbb::parallel_sort(vidx2.begin(), vidx2.end(),
-                                     [&cv2_deg = ::std::as_const(v2_deg)](const auto &idx1, const auto &idx2) {
-                                         return cv2_deg[idx1] < cv2_deg[idx2];
-                                     });
-
-                // Apply the permutation to v2_deg.
-                ::obake::detail::container_it_diff_check(v2_deg);
-                v2_deg = ::std::remove_reference_t<decltype(v2_deg)>(
-                    ::boost::make_permutation_iterator(v2_deg.cbegin(), vidx2.cbegin()),
-                    ::boost::make_permutation_iterator(v2_deg.cend(), vidx2.cend()));
+    // In truncated multiplication, the degree data consists of a reference
+    // to the degrees of the terms of x and of a copy of the degrees of the
+    // terms of y, sorted according to the degree.
+    using v2_deg_t = typename ::std::conditional_t<(sizeof...(Args) > 0u), ::std::tuple_element<1, DD>,
+                                                   ::obake::detail::type_c<::std::tuple<>>>::type;
+    remove_cvref_t<v2_deg_t> v2_deg_sorted;
+
+    // Concurrently fill in the vidx1/vidx2 vectors. vidx2 and the
+    // copy of y's degree data will also be sorted, if the
+    // multiplication is truncated.
+    ::tbb::parallel_invoke([&vidx1, &x]() { vidx1 = detail::poly_mul_impl_par_make_idx_vector(x); },
+                           [&vidx2, &y, &v2_deg_sorted, &in_dd]() {
+                               vidx2 = detail::poly_mul_impl_par_make_idx_vector(y);
+
+                               // In truncated multiplication, order
+                               // the indices into y according to the degree of
+                               // the terms, and create the sorted vector of
+                               // degrees.
+                               if constexpr (sizeof...(Args) > 0u) {
+                                   const auto &v2_deg = ::std::get<1>(in_dd);
+                                   assert(v2_deg.size() == y.size());
+
+                                   ::tbb::parallel_sort(vidx2.begin(), vidx2.end(),
+                                                        [&v2_deg](const auto &idx1, const auto &idx2) {
+                                                            return poly_mul_deg_ops<Args...>::less(v2_deg[idx1],
+                                                                                                   v2_deg[idx2]);
+                                                        });
+
+                                   // Apply the permutation to v2_deg.
+                                   v2_deg_sorted = detail::poly_mul_impl_par_permute<false>(v2_deg, vidx2);
+
+                                   // Verify the sorting in debug mode.
+                                   assert(::std::is_sorted(v2_deg_sorted.cbegin(), v2_deg_sorted.cend(),
+                                                           [](const auto &a, const auto &b) {
+                                                               return poly_mul_deg_ops<Args...>::less(a, b);
+                                                           }));
+                               } else {
+                                   ::obake::detail::ignore(v2_deg_sorted, in_dd);
+                               }
+                           });
+
+    const auto degree_data = [&x, &in_dd, &v2_deg_sorted]() {
+        if constexpr (sizeof...(Args) > 0u) {
+            assert(::std::get<0>(in_dd).size() == x.size());
+
+            return ::std::forward_as_tuple(::std::get<0>(in_dd), ::std::as_const(v2_deg_sorted));
+        } else {
+            ::obake::detail::ignore(x, in_dd, v2_deg_sorted);
 
-                // Verify the sorting in debug mode.
-                assert(::std::is_sorted(v2_deg.cbegin(), v2_deg.cend()));
-            }
-        });
+            return ::std::make_tuple();
+        }
+    }();
 
     // Determine the total number of term-by-term multiplications
     // that will be performed in the poly multiplication.
@@ -600,14 +1593,12 @@ inline auto poly_mul_estimate_product_size(const ::std::vector<T1> &x, const ::s
                         // Fetch the degree of the current term in x.
                         const auto &d1 = v1_deg[idx1];
 
-                        // Find the first degree d2 in v2_deg such that d1 + d2 > max_degree.
-                        const auto it = ::std::upper_bound(v2_deg.cbegin(), v2_deg.cend(), max_deg,
-                                                           [&d1](const auto &mdeg, const auto &d2) {
-                                                               // NOTE: we require below
-                                                               // comparability between const lvalue limit
-                                                               // and rvalue of the sum of the degrees.
-                                                               return mdeg < d1 + d2;
-                                                           });
+                        // Find the first degree d2 in v2_deg such that the product
+                        // of the terms violates the truncation limit.
+                        const auto it = ::std::upper_bound(
+                            v2_deg.cbegin(), v2_deg.cend(), max_deg, [&d1](const auto &mdeg, const auto &d2) {
+                                return poly_mul_deg_ops<Args...>::skip(mdeg, poly_mul_deg_ops<Args...>::prod(d1, d2));
+                            });
 
                         // Accumulate in cur how many terms in y would be multiplied
                         // by the current term in x.
@@ -622,6 +1613,15 @@ inline auto poly_mul_estimate_product_size(const ::std::vector<T1> &x, const ::s
         }
     }();
 
+    if constexpr (detail::same_packed_monomial_v<key_type, key_type>) {
+        if (y.size() / x.size() >= poly_mul_rect_ratio && !tot_n_mults.is_zero()) {
+            // Rectangular multiplication, use the dedicated estimator.
+            return ::std::make_tuple(
+                detail::poly_mul_estimate_product_size_rect(x, y, ss, vidx2, degree_data, args...),
+                ::std::move(tot_n_mults));
+        }
+    }
+
     // Parameters for the random trials.
     // NOTE: the idea here is that the larger the
     // multiplication, the larger the number of trials we can
@@ -714,14 +1714,13 @@ inline auto poly_mul_estimate_product_size(const ::std::vector<T1> &x, const ::s
                             // Fetch the degree of the current term in x.
                             const auto &d1 = v1_deg[idx1];
 
-                            // Find the first degree d2 in v2_deg such that d1 + d2 > max_degree.
-                            const auto it = ::std::upper_bound(v2_deg.cbegin(), v2_deg.cend(), max_deg,
-                                                               [&d1](const auto &mdeg, const auto &d2) {
-                                                                   // NOTE: we require below
-                                                                   // comparability between const lvalue limit
-                                                                   // and rvalue of the sum of the degrees.
-                                                                   return mdeg < d1 + d2;
-                                                               });
+                            // Find the first degree d2 in v2_deg such that the product
+                            // of the terms violates the truncation limit.
+                            const auto it = ::std::upper_bound(
+                                v2_deg.cbegin(), v2_deg.cend(), max_deg, [&d1](const auto &mdeg, const auto &d2) {
+                                    return poly_mul_deg_ops<Args...>::skip(mdeg,
+                                                                           poly_mul_deg_ops<Args...>::prod(d1, d2));
+                                });
 
                             // We checked when constructing v2_deg that its iterator
                             // diff type can represent the total size. Because
@@ -793,134 +1792,2116 @@ inline auto poly_mul_estimate_product_size(const ::std::vector<T1> &x, const ::s
     }
 }
 
-// The multi-threaded homomorphic implementation.
-template <typename Ret, typename T, typename U, typename... Args>
-inline void poly_mul_impl_mt_hm(Ret &retval, const T &x, const U &y, const Args &...args)
+// Helper to compute the degree data of the terms in x and y
+// (in truncated mode), in parallel. In untruncated mode,
+// an empty tuple will be returned.
+template <typename S1, typename S2, typename T1, typename T2, typename... Args>
+inline auto poly_mul_impl_make_degree_data(const ::std::vector<T1> &x, const ::std::vector<T2> &y,
+                                           const symbol_set &ss, const Args &...args)
+{
+    auto ret = detail::poly_mul_impl_prepare_degree_data<S1, S2>(x, y, ss, args...);
+
+    if constexpr (sizeof...(Args) > 0u) {
+        // NOTE: in the make_(p_/w_)degree_vector() helpers we need
+        // to compute the sizes of x and y via iterator differences.
+        ::obake::detail::container_it_diff_check(x);
+        ::obake::detail::container_it_diff_check(y);
+
+        ::tbb::parallel_invoke(
+            [&ret, &x, &ss, &args...]() {
+                ::std::get<0>(ret)
+                    = detail::poly_mul_impl_make_degree_vector<S1>(x.cbegin(), x.cend(), ss, true, args...);
+            },
+            [&ret, &y, &ss, &args...]() {
+                ::std::get<1>(ret)
+                    = detail::poly_mul_impl_make_degree_vector<S2>(y.cbegin(), y.cend(), ss, true, args...);
+            });
+    } else {
+        ::obake::detail::ignore(ss, args...);
+    }
+
+    return ret;
+}
+
+// Overload of poly_mul_estimate_product_size_dd() which
+// computes the degree data internally.
+template <typename S1, typename S2, typename T1, typename T2, typename... Args>
+inline auto poly_mul_estimate_product_size(const ::std::vector<T1> &x, const ::std::vector<T2> &y, const symbol_set &ss,
+                                           const Args &...args)
+{
+    return detail::poly_mul_estimate_product_size_dd<S1, S2>(
+        x, y, ss, detail::poly_mul_impl_make_degree_data<S1, S2>(x, y, ss, args...), args...);
+}
+
+// Detect if the dense Kronecker engine can be used in the
+// multithreaded homomorphic multiplication. We need:
+// - packed_monomial keys,
+// - a coefficient type whose value-initialised
+//   state is zero, so that the dense coefficient
+//   array can be set up cheaply.
+template <typename K, typename C>
+inline constexpr bool poly_mul_impl_kbox_enabled
+    = detail::same_packed_monomial_v<K, K> && (is_arithmetic_v<C> || ::obake::detail::is_mppp_integer_v<C>);
+
+// Helper to insert into the segmented table of retval the
+// terms resulting from a polynomial multiplication.
+//
+// c_terms is a vector of chunks of terms, each term being represented
+// as a pair (packed monomial value, coefficient). The terms must
+// be all distinct and with nonzero coefficients. retval must be
+// empty and already set up with the desired number of segments.
+// The content of c_terms will be destroyed.
+template <typename Ret, typename VT>
+inline void poly_mul_impl_insert_terms(Ret &retval, VT &c_terms)
 {
-    using cf1_t = series_cf_t<T>;
-    using cf2_t = series_cf_t<U>;
     using ret_key_t = series_key_t<Ret>;
-    using ret_cf_t = series_cf_t<Ret>;
     using s_size_t = typename Ret::s_size_type;
 
-    // Preconditions.
-    static_assert(sizeof...(args) <= 2u);
-    assert(!x.empty());
-    assert(!y.empty());
-    assert(x.size() <= y.size());
-    assert(retval.get_symbol_set_fw() == x.get_symbol_set_fw());
-    assert(retval.get_symbol_set_fw() == y.get_symbol_set_fw());
     assert(retval.empty());
-    assert(retval._get_s_table().size() == 1u);
 
-    // Cache the symbol set.
-    const auto &ss = retval.get_symbol_set();
+    const auto nchunks = c_terms.size();
+    const auto nsegs = static_cast<s_size_t>(retval._get_s_table().size());
+
+    // Sort the terms in each chunk according to the destination
+    // segment (counting sort), and record the segment boundaries.
+    ::std::vector<::std::vector<::std::size_t>> c_offs(nchunks);
+    ::tbb::parallel_for(::tbb::blocked_range<decltype(c_terms.size())>(0, nchunks), [&c_terms, &c_offs,
+                                                                                     nsegs](const auto &range) {
+        for (auto c = range.begin(); c != range.end(); ++c) {
+            auto &offs = c_offs[c];
+            offs.assign(static_cast<decltype(offs.size())>(nsegs) + 1u, 0);
+            if (nsegs == 1u) {
+                offs[1] = c_terms[c].size();
+                continue;
+            }
 
-    // Create vectors containing copies of
-    // the input terms.
-    // NOTE: in theory, it would be possible here
-    // to move the coefficients (in conjunction with
-    // rref_cleaner, as usual).
-    // NOTE: drop the const from the key type in order
-    // to allow mutability.
-    // NOTE: need to better assess the benefits of
-    // copying the input series.
-    ::std::vector<::std::pair<series_key_t<T>, cf1_t>> v1(
-        ::boost::make_transform_iterator(x.begin(), poly_mul_impl_pair_transform{}),
-        ::boost::make_transform_iterator(x.end(), poly_mul_impl_pair_transform{}));
-    ::std::vector<::std::pair<series_key_t<U>, cf2_t>> v2(
-        ::boost::make_transform_iterator(y.begin(), poly_mul_impl_pair_transform{}),
-        ::boost::make_transform_iterator(y.end(), poly_mul_impl_pair_transform{}));
+            for (const auto &p : c_terms[c]) {
+                ++offs[::obake::hash(ret_key_t{p.first}) % nsegs + 1u];
+            }
+            ::std::partial_sum(offs.begin(), offs.end(), offs.begin());
 
-    // Do the monomial overflow checking, if supported.
-    // NOTE: we have to sequence the overflow checking before the product
-    // size estimation and the average term size estimation, as those two
-    // operations might generate overflows during monomial multiplication.
-    const auto r1
-        = ::obake::detail::make_range(::boost::make_transform_iterator(v1.cbegin(), poly_term_key_ref_extractor{}),
-                                      ::boost::make_transform_iterator(v1.cend(), poly_term_key_ref_extractor{}));
-    const auto r2
-        = ::obake::detail::make_range(::boost::make_transform_iterator(v2.cbegin(), poly_term_key_ref_extractor{}),
-                                      ::boost::make_transform_iterator(v2.cend(), poly_term_key_ref_extractor{}));
-    if constexpr (are_overflow_testable_monomial_ranges_v<decltype(r1) &, decltype(r2) &>) {
-        // The monomial overflow checking is supported, run it.
-        if (obake_unlikely(!::obake::monomial_range_overflow_check(r1, r2, ss))) {
-            obake_throw(::std::overflow_error, "An overflow in the monomial exponents was detected while "
-                                               "attempting to multiply two polynomials");
+            auto pos(offs);
+            remove_cvref_t<decltype(c_terms[c])> tmp_terms(c_terms[c].size());
+            for (auto &p : c_terms[c]) {
+                tmp_terms[pos[::obake::hash(ret_key_t{p.first}) % nsegs]++] = ::std::move(p);
+            }
+            c_terms[c] = ::std::move(tmp_terms);
         }
-    }
+    });
 
-    // Estimate the total number of terms, and compute the total number
-    // of term-by-term multiplications.
-    // NOTE: poly_mul_estimate_product_size() requires the shorter series first,
-    // which is ensured by the preconditions of this function.
-    const auto [est_nterms, tot_n_mults] = detail::poly_mul_estimate_product_size<T, U>(v1, v2, ss, args...);
-    // Exit early if the truncation limits
-    // result in an empty output series.
-    if (sizeof...(Args) > 0u && tot_n_mults.is_zero()) {
-        return;
-    }
+    try {
+        ::tbb::parallel_for(::tbb::blocked_range<s_size_t>(0, nsegs), [&c_terms, &c_offs, nchunks, &retval,
+                                                                        mts = retval._get_max_table_size()](
+                                                                           const auto &range) {
+            for (auto seg_idx = range.begin(); seg_idx != range.end(); ++seg_idx) {
+                auto &table = retval._get_s_table()[seg_idx];
+
+                // Compute the total number of terms in the current table.
+                ::std::size_t count = 0;
+                for (::std::size_t c = 0; c < nchunks; ++c) {
+                    count += c_offs[c][seg_idx + 1u] - c_offs[c][seg_idx];
+                }
 
-    // Estimate the average term size.
-    // NOTE: once poly_mul_impl_estimate_average_term_size() becomes more computationally intensive,
-    // we can do it in parallel with poly_mul_estimate_product_size().
-    const auto avg_term_size = detail::poly_mul_impl_estimate_average_term_size<ret_cf_t>(v1, v2, ss);
+                // LCOV_EXCL_START
+                // Check the table size against the max allowed size.
+                if (obake_unlikely(count > mts)) {
+                    obake_throw(::std::overflow_error, "The homomorphic multithreaded multiplication of two "
+                                                       "polynomials resulted in a table whose size ("
+                                                           + ::obake::detail::to_string(count)
+                                                           + ") is larger than the maximum allowed value ("
+                                                           + ::obake::detail::to_string(mts) + ")");
+                }
+                // LCOV_EXCL_STOP
 
-    // Compute the estimated sparsity.
-    const auto est_sp = static_cast<double>(est_nterms) / static_cast<double>(tot_n_mults);
+                table.reserve(static_cast<decltype(table.size())>(count));
 
-    // Establish the desired segment size in kilobytes.
-    // NOTE: the idea here is the following. For highly
-    // sparse polynomials (est_sp >= threshold), we want to pick
-    // a relatively large size so that it fits somewhere in L2
-    // cache, say. The reason is that we won't do much computation
-    // per segment due to the sparsity, thus we aim at reducing
-    // the parallelisation overhead by operating on larger chunks
-    // of the product series. When the sparsity is smaller, then
-    // we have a higher computational density, thus we will spend
-    // more time computing a single segment, and thus we can aim
-    // at staying in L1 cache instead, as the parallelisation overhead
-    // will be smaller. Note that these values will be just rule-of-thumb,
-    // because the sparsity is not estimated accurately and because
-    // of further manipulations below. Additionally, it is not clear
-    // to me how smooth the transition between high and low sparsity
-    // will be. Eventually, we may perhaps want to leave this parameter as
-    // a tunable parameter for the user or perhaps even determine
-    // the cache sizes at runtime and use those.
-    // NOTE: if est_sp is not finite, due to tot_n_mults being zero or other
-    // FP issues, go with a default value.
-    // NOTE: is it worth it to exit early if tot_n_mults is zero? This would
-    // mean that the truncation limits will produce an empty series.
-    const auto seg_size = (!::std::isfinite(est_sp) || est_sp >= 1E-3) ? 200ul : 20ul;
+                for (::std::size_t c = 0; c < nchunks; ++c) {
+                    auto &terms = c_terms[c];
 
-    // Estimate the number of segments via the deduced segment size.
-    const auto est_nsegs = (est_nterms * avg_term_size) / (seg_size * 1024ul);
+                    for (auto i = c_offs[c][seg_idx]; i < c_offs[c][seg_idx + 1u]; ++i) {
+                        // NOTE: the terms are all distinct, thus
+                        // the insertion will always succeed.
+                        [[maybe_unused]] const auto res
+                            = table.try_emplace(ret_key_t{terms[i].first}, ::std::move(terms[i].second));
+                        assert(res.second);
+                    }
+                }
+            }
+        });
+        // LCOV_EXCL_START
+    } catch (...) {
+        // In case of exceptions, clear retval before
+        // rethrowing to ensure a known sane state.
+        retval.clear();
+        throw;
+        // LCOV_EXCL_STOP
+    }
+}
 
-    // Fetch the base-2 logarithm + 1 of est_nsegs, making sure it does not
-    // overflow the max allowed value for the return polynomial type.
-    const auto log2_nsegs = ::std::min(::obake::safe_cast<unsigned>(est_nsegs.nbits()),
-                                       polynomial<ret_key_t, ret_cf_t>::get_max_s_size());
+// Detect if the Kronecker substitution can be used in the dense
+// Kronecker engine. We need multiprecision integral coefficients,
+// all of the same type.
+template <typename C, typename C1, typename C2>
+inline constexpr bool poly_mul_impl_ks_enabled
+    = ::obake::detail::is_mppp_integer_v<C> && ::std::is_same_v<C, C1> && ::std::is_same_v<C, C2>;
+
+// Write the limbs [src, src + n) into the limb array dst,
+// starting from the bit offset off. The destination
+// bits are assumed to be zero.
+inline void poly_ks_write_bits(::mp_limb_t *dst, ::std::size_t off, const ::mp_limb_t *src, ::std::size_t n)
+{
+    const auto lidx = off / unsigned(GMP_NUMB_BITS);
+    const auto shift = static_cast<unsigned>(off % unsigned(GMP_NUMB_BITS));
 
-    // Setup the number of segments in retval.
-    retval.set_n_segments(log2_nsegs);
+    for (::std::size_t i = 0; i < n; ++i) {
+        dst[lidx + i] |= src[i] << shift;
+        if (shift != 0u) {
+            dst[lidx + i + 1u] |= src[i] >> (unsigned(GMP_NUMB_BITS) - shift);
+        }
+    }
+}
 
-    // Cache the actual number of segments.
-    const auto nsegs = s_size_t(1) << log2_nsegs;
+// Read b bits from the limb array [src, src + src_n), starting from the
+// bit offset off, and write them into out, which must be able to
+// contain b bits. The bits beyond src_n limbs are assumed to be zero.
+inline void poly_ks_read_bits(::mp_limb_t *out, const ::mp_limb_t *src, ::std::size_t src_n, ::std::size_t off,
+                              ::std::size_t b)
+{
+    const auto lidx = off / unsigned(GMP_NUMB_BITS);
+    const auto shift = static_cast<unsigned>(off % unsigned(GMP_NUMB_BITS));
+    const auto nl = (b + unsigned(GMP_NUMB_BITS) - 1u) / unsigned(GMP_NUMB_BITS);
+
+    for (::std::size_t i = 0; i < nl; ++i) {
+        const auto lo = lidx + i < src_n ? src[lidx + i] : ::mp_limb_t(0);
+        if (shift == 0u) {
+            out[i] = lo;
+        } else {
+            const auto hi = lidx + i + 1u < src_n ? src[lidx + i + 1u] : ::mp_limb_t(0);
+            out[i] = (lo >> shift) | (hi << (unsigned(GMP_NUMB_BITS) - shift));
+        }
+    }
 
-    // Helper to sort the input terms according to the hash value modulo
-    // 2**log2_nsegs. That is, sort them according to the bucket
-    // they would occupy in a segmented table with 2**log2_nsegs
-    // segments.
-    auto t_sorter = [log2_nsegs](const auto &p1, const auto &p2) {
-        const auto h1 = ::obake::hash(p1.first);
-        const auto h2 = ::obake::hash(p2.first);
+    // Clear the bits beyond b.
+    if (const auto rem = static_cast<unsigned>(b % unsigned(GMP_NUMB_BITS)); rem != 0u) {
+        out[nl - 1u] &= (::mp_limb_t(1) << rem) - 1u;
+    }
+}
 
-        return h1 % (s_size_t(1) << log2_nsegs) < h2 % (s_size_t(1) << log2_nsegs);
-    };
+// Kronecker substitution: pack the dense sequence of integers [d, d + n)
+// into the integer sum(d[i] * 2**(b*i)). The absolute values of
+// the elements of d must be less than 2**b.
+template <typename T>
+inline T poly_ks_pack(const T *d, ::std::size_t n, ::std::size_t b)
+{
+    // NOTE: pack separately the absolute values of the
+    // positive and negative values. Because the absolute values
+    // are less than 2**b, the bits of the values don't overlap
+    // and they can be written with bitwise OR.
+    const auto nlimbs = ::obake::safe_cast<::mp_size_t>((n * b) / unsigned(GMP_NUMB_BITS) + 2u);
+    T pos, neg;
+    const auto p_ptr = pos.get_mpz_t(), n_ptr = neg.get_mpz_t();
+    const auto p_limbs = ::mpz_limbs_write(p_ptr, nlimbs), n_limbs = ::mpz_limbs_write(n_ptr, nlimbs);
+    ::std::fill(p_limbs, p_limbs + nlimbs, ::mp_limb_t(0));
+    ::std::fill(n_limbs, n_limbs + nlimbs, ::mp_limb_t(0));
+
+    for (::std::size_t i = 0; i < n; ++i) {
+        const auto sgn = d[i].sgn();
+        if (sgn == 0) {
+            continue;
+        }
 
-    // Helper to compute the segmentation for the input series.
-    // The segmentation is a vector of ranges (represented
-    // as pairs of indices into v1/v2) paired to indices
+        const auto v = d[i].get_mpz_view();
+        const auto v_ptr = v.get();
+        detail::poly_ks_write_bits(sgn > 0 ? p_limbs : n_limbs, i * b, ::mpz_limbs_read(v_ptr), ::mpz_size(v_ptr));
+    }
+
+    ::mpz_limbs_finish(p_ptr, nlimbs);
+    ::mpz_limbs_finish(n_ptr, nlimbs);
+
+    return pos - neg;
+}
+
+// Kronecker substitution: unpack the integer c = sum(d[i] * 2**(b*i))
+// into the first n elements of out. The absolute values of the d[i]
+// must be less than 2**(b-1), and the elements of out must be zero.
+template <typename T>
+inline void poly_ks_unpack(T *out, ::std::size_t n, const T &c, ::std::size_t b)
+{
+    const auto sgn = c.sgn();
+    if (sgn == 0) {
+        return;
+    }
+
+    const auto v = c.get_mpz_view();
+    const auto c_limbs = ::mpz_limbs_read(v.get());
+    const auto c_size = ::mpz_size(v.get());
+
+    // NOTE: we extract the digits of |c| in base 2**b, and we convert them
+    // to balanced digits in the [-2**(b-1), 2**(b-1)) range. This requires
+    // propagating a carry into the next digit.
+    const auto nl = (b + unsigned(GMP_NUMB_BITS) - 1u) / unsigned(GMP_NUMB_BITS);
+    const auto top_bit = static_cast<unsigned>((b - 1u) % unsigned(GMP_NUMB_BITS));
+    ::std::vector<::mp_limb_t> buffer(nl);
+    ::mp_limb_t carry = 0;
+
+    for (::std::size_t i = 0; i < n; ++i) {
+        detail::poly_ks_read_bits(buffer.data(), c_limbs, c_size, i * b, b);
+
+        // Add the carry from the previous digit. If the result
+        // is 2**b, the addition will either overflow the buffer
+        // or set the bit of index b.
+        const auto overflow = carry != 0u && ::mpn_add_1(buffer.data(), buffer.data(), static_cast<::mp_size_t>(nl), 1);
+        const auto beyond_b = b % unsigned(GMP_NUMB_BITS) != 0u
+                              && ((buffer[nl - 1u] >> (b % unsigned(GMP_NUMB_BITS))) & 1u) != 0u;
+
+        // Check if the digit is in the upper half of the range.
+        bool negative = overflow || beyond_b || ((buffer[nl - 1u] >> top_bit) & 1u) != 0u;
+        if (negative) {
+            // The balanced digit is digit - 2**b, whose absolute
+            // value is the two's complement of the digit, modulo 2**b.
+            ::mpn_neg(buffer.data(), buffer.data(), static_cast<::mp_size_t>(nl));
+            if (const auto rem = static_cast<unsigned>(b % unsigned(GMP_NUMB_BITS)); rem != 0u) {
+                buffer[nl - 1u] &= (::mp_limb_t(1) << rem) - 1u;
+            }
+            carry = 1;
+        } else {
+            carry = 0;
+        }
+
+        // Flip the sign if c is negative.
+        negative = (negative != (sgn < 0));
+
+        // Write the result.
+        ::mpz_t tmp;
+        const auto s_nl = static_cast<::mp_size_t>(nl);
+        ::mpz_roinit_n(tmp, buffer.data(), negative ? -s_nl : s_nl);
+        out[i] = T{static_cast<const ::mppp::mpz_struct_t *>(tmp)};
+    }
+}
+
+// Kronecker substitution multiplication of the dense univariate
+// polynomials [a, a + na) and [b, b + nb), with multiprecision integer
+// coefficients. The polynomials are evaluated at 2**b (with b large
+// enough to represent the coefficients of the product), the evaluations
+// are multiplied (thus taking advantage of the asymptotically-fast
+// multiplication algorithms implemented in GMP), and the product
+// is unpacked into ret, whose first na + nb - 1 elements must be zero.
+template <typename T>
+inline void poly_ks_mul(T *ret, const T *a, ::std::size_t na, const T *b, ::std::size_t nb)
+{
+    assert(na > 0u);
+    assert(nb > 0u);
+
+    auto max_nbits = [](const T *d, ::std::size_t n) {
+        ::std::size_t ret = 0;
+        for (::std::size_t i = 0; i < n; ++i) {
+            ret = ::std::max(ret, static_cast<::std::size_t>(d[i].nbits()));
+        }
+        return ret;
+    };
+
+    // The absolute values of the coefficients of the product
+    // are not greater than min(na, nb) * max(|a_i|) * max(|b_i|).
+    // Take an extra bit for the balanced representation.
+    const auto nb_a = max_nbits(a, na), nb_b = max_nbits(b, nb);
+    if (nb_a == 0u || nb_b == 0u) {
+        return;
+    }
+    const auto n_bits = nb_a + nb_b + static_cast<::std::size_t>(::mppp::integer<1>{::std::min(na, nb)}.nbits()) + 1u;
+
+    T pa, pb;
+    ::tbb::parallel_invoke([&pa, a, na, n_bits]() { pa = detail::poly_ks_pack(a, na, n_bits); },
+                           [&pb, b, nb, n_bits]() { pb = detail::poly_ks_pack(b, nb, n_bits); });
+
+    detail::poly_ks_unpack(ret, na + nb - 1u, pa * pb, n_bits);
+}
+
+// Establish if the dense Kronecker engine should use the Kronecker
+// substitution, given the sorted local codes of the input series
+// (paired to pointers to the coefficients).
+template <typename C, typename C1, typename C2, typename LC1, typename LC2>
+inline bool poly_mul_impl_kbox_use_ks(const LC1 &lc1, const LC2 &lc2)
+{
+    if constexpr (detail::poly_mul_impl_ks_enabled<C, C1, C2>) {
+        assert(!lc1.empty());
+        assert(!lc2.empty());
+
+        using int_t = ::mppp::integer<1>;
+
+        // The number of coefficients in the dense representations.
+        const auto n_dense = int_t{lc1.back().first} + lc2.back().first + 2u;
+
+        // Estimate the bit size of the coefficients of the product.
+        auto max_nbits = [](const auto &lc) {
+            ::std::size_t ret = 0;
+            for (const auto &p : lc) {
+                ret = ::std::max(ret, static_cast<::std::size_t>(p.second->nbits()));
+            }
+            return ret;
+        };
+        const auto n_bits = int_t{max_nbits(lc1)} + max_nbits(lc2) + int_t{::std::min(lc1.size(), lc2.size())}.nbits();
+
+        // The number of limbs in the product of the packed integers.
+        const auto n_limbs = (n_dense * n_bits) / unsigned(GMP_NUMB_BITS) + 1u;
+
+        // NOTE: this is a rough model of the cost of a (serial) GMP multiplication,
+        // in units of term-by-term multiplications. The term-by-term multiplications
+        // are run in parallel, thus we take the number of threads into account.
+        return n_limbs * n_limbs.nbits() * ::obake::detail::hc() * 4u < int_t{lc1.size()} * lc2.size();
+    } else {
+        ::obake::detail::ignore(lc1, lc2);
+
+        return false;
+    }
+}
+
+// Wide accumulators for the coefficients in the
+// multiplication engines.
+//
+// For some coefficient types, accumulating the term-by-term
+// products directly into the coefficients of the result is costly
+// or fragile: an mppp::integer<1> is promoted to dynamic storage
+// as soon as an intermediate sum does not fit in a single limb,
+// and with C++ signed integral types the intermediate sums
+// may overflow even if the final result is representable.
+// For these types, the products are accumulated into a wider
+// representation, which is converted back (normalised) only once
+// per term, after all the products have been accumulated.
+// The default implementation (void) signals that no wide accumulator
+// is available.
+//
+// NOTE: with C++ signed integral coefficients, wide accumulation
+// changes the semantics of the multiplication: instead of
+// silently overflowing (which is undefined behaviour), the
+// multiplication throws an std::overflow_error if a coefficient
+// of the result is not representable in the coefficient type.
+// Intermediate sums which do not fit in the coefficient type are
+// on the other hand fine, as long as the final value does.
+template <typename T, typename = void>
+struct poly_mul_wacc {
+    using type = void;
+};
+
+template <>
+struct poly_mul_wacc<::mppp::integer<1>> {
+    using type = ::mppp::integer<2>;
+};
+
+#if defined(OBAKE_HAVE_GCC_INT128)
+
+// NOTE: the product of two signed integers
+// with at most 63 bits always fits in __int128_t.
+// NOTE: in the multithreaded homomorphic multiplication,
+// the coefficients temporarily store the indices of the
+// accumulators (see poly_mul_wacc_set_idx()). Thus, we
+// restrict wide accumulation to the signed types
+// which are at least as wide as int, so that the
+// number of terms in a segment is not limited
+// by the range of the coefficient type.
+template <typename T>
+struct poly_mul_wacc<T, ::std::enable_if_t<::std::disjunction_v<::std::is_same<T, int>, ::std::is_same<T, long>,
+                                                                 ::std::is_same<T, long long>>>> {
+    static_assert(::obake::detail::limits_digits<T> <= 63);
+
+    using type = __int128_t;
+};
+
+#endif
+
+template <typename T>
+using poly_mul_wacc_t = typename poly_mul_wacc<T>::type;
+
+// Detect if wide accumulation can be used when multiplying
+// coefficients of types T and U into coefficients of type R.
+template <typename R, typename T, typename U>
+inline constexpr bool poly_mul_wacc_enabled
+    = ::std::conjunction_v<::std::negation<::std::is_void<poly_mul_wacc_t<R>>>, ::std::is_same<R, T>,
+                           ::std::is_same<R, U>>;
+
+// Widen an mppp::integer<1> into an mppp::integer<2>.
+// NOTE: for static integers, neither the mpz view
+// nor the construction from it allocate memory.
+inline ::mppp::integer<2> poly_mul_wacc_widen(const ::mppp::integer<1> &n)
+{
+    return ::mppp::integer<2>(n.get_mpz_view().get());
+}
+
+// Set the accumulator a to the product x*y.
+inline void poly_mul_wacc_set(::mppp::integer<2> &a, const ::mppp::integer<1> &x, const ::mppp::integer<1> &y)
+{
+    ::mppp::mul(a, detail::poly_mul_wacc_widen(x), detail::poly_mul_wacc_widen(y));
+}
+
+// Accumulate the product x*y into the accumulator a.
+inline void poly_mul_wacc_add(::mppp::integer<2> &a, const ::mppp::integer<1> &x, const ::mppp::integer<1> &y)
+{
+    ::mppp::addmul(a, detail::poly_mul_wacc_widen(x), detail::poly_mul_wacc_widen(y));
+}
+
+// Write the normalised value of the accumulator a into out.
+inline void poly_mul_wacc_get(::mppp::integer<1> &out, const ::mppp::integer<2> &a)
+{
+    out = ::mppp::integer<1>(a.get_mpz_view().get());
+}
+
+#if defined(OBAKE_HAVE_GCC_INT128)
+
+template <typename T>
+inline void poly_mul_wacc_set(__int128_t &a, const T &x, const T &y)
+{
+    a = static_cast<__int128_t>(x) * static_cast<__int128_t>(y);
+}
+
+template <typename T>
+inline void poly_mul_wacc_add(__int128_t &a, const T &x, const T &y)
+{
+    // NOTE: the sum of the products may overflow
+    // __int128_t (although this requires extremely large
+    // operands), check it.
+    a = ::obake::detail::safe_int_add(a, static_cast<__int128_t>(x) * static_cast<__int128_t>(y));
+}
+
+template <typename T>
+inline void poly_mul_wacc_get(T &out, const __int128_t &a)
+{
+    if (obake_unlikely(a > ::obake::detail::limits_max<T> || a < ::obake::detail::limits_min<T>)) {
+        obake_throw(::std::overflow_error, "Overflow detected in the accumulation of the coefficients "
+                                           "during a polynomial multiplication: the accumulated value "
+                                               + ::obake::detail::to_string(a)
+                                               + " does not fit in the coefficient type");
+    }
+
+    out = static_cast<T>(a);
+}
+
+#endif
+
+// Detect if the dense Kronecker engine can use the vectorised
+// kernel poly_mul_kbox_axpy() when multiplying coefficients of
+// types T and U into coefficients of type R.
+template <typename R, typename T, typename U>
+inline constexpr bool poly_mul_kbox_axpy_enabled
+    = ::std::conjunction_v<::std::disjunction<::std::is_same<R, float>, ::std::is_same<R, double>>,
+                           ::std::is_same<R, T>, ::std::is_same<R, U>>;
+
+// Vectorised kernel for the dense Kronecker engine: accumulate
+// a*x[i] into out[i] for i in [0, n). The accumulation is done
+// exactly as in the scalar loop of the engine (i.e., via fma3(),
+// if available), so that the results do not depend on which
+// path is taken. The loop is contiguous and branch-free, so that
+// it can be vectorised by the compiler for the target instruction set.
+template <typename T>
+inline void poly_mul_kbox_axpy(T *out, const T &a, const T *x, ::std::size_t n)
+{
+    for (::std::size_t i = 0; i < n; ++i) {
+        if constexpr (is_mult_addable_v<T &, const T &, const T &>) {
+            ::obake::fma3(out[i], a, x[i]);
+        } else {
+            out[i] += a * x[i];
+        }
+    }
+}
+
+// Establish if the dense Kronecker engine should use the vectorised
+// kernel, given the sorted local codes of the second input series
+// (paired to pointers to the coefficients).
+//
+// The kernel operates on runs of consecutive local codes: if the kernel is
+// to be used, the coefficients of the second series will be copied into the
+// contiguous array d2 (in the same order as in lc2), and runs will contain,
+// for each run, the local code of its first term and the index of its
+// first term in d2, followed by a sentinel whose index is the size of d2.
+// The kernel is used only if the runs are long enough (on average)
+// to amortise the setup costs of the vectorised loops.
+template <typename C, typename C1, typename C2, typename LC2, typename D2, typename Runs>
+inline bool poly_mul_impl_kbox_use_axpy(const LC2 &lc2, D2 &d2, Runs &runs)
+{
+    if constexpr (detail::poly_mul_kbox_axpy_enabled<C, C1, C2>) {
+        assert(!lc2.empty());
+        assert(d2.empty());
+        assert(runs.empty());
+
+        for (decltype(lc2.size()) i = 0; i < lc2.size(); ++i) {
+            if (i == 0u || lc2[i].first != lc2[i - 1u].first + 1u) {
+                runs.emplace_back(lc2[i].first, i);
+            }
+        }
+
+        if (runs.size() * 4u > lc2.size()) {
+            runs.clear();
+
+            return false;
+        }
+
+        d2.reserve(lc2.size());
+        for (const auto &p : lc2) {
+            d2.push_back(*p.second);
+        }
+        // NOTE: the local code of the sentinel is never used.
+        runs.emplace_back(lc2.back().first + 1u, lc2.size());
+
+        return true;
+    } else {
+        ::obake::detail::ignore(lc2, d2, runs);
+
+        return false;
+    }
+}
+
+// Dense Kronecker multiplication engine.
+//
+// If the exponents of the product of two series with packed monomial
+// keys are confined within a small enough box, the product is computed
+// by accumulating the term-by-term products into a flat array of
+// coefficients indexed by a local Kronecker code (i.e., a code
+// relative to the box of the exponents of the product). Because the
+// local code of a product is the sum of the local codes of the factors,
+// the accumulation requires neither hashing nor probing. If the product
+// is dense enough and the coefficients are multiprecision integers, the
+// accumulation is replaced by a Kronecker substitution, in which the input
+// series are interpreted as dense univariate polynomials in the local codes.
+// With single or double precision coefficients, the products of a term of
+// the first series by runs of terms of the second series with consecutive
+// local codes are accumulated via a vectorised kernel (see poly_mul_kbox_axpy()).
+// The flat array is converted into a segmented table at the end.
+//
+// The box is deduced from the exponent limits of the input series
+// (as computed by pm_range_exponent_limits()). retval must already
+// be set up with the desired number of segments. If the box
+// is too large, the function will return false without touching
+// retval, otherwise it will return true.
+template <typename Ret, typename V1, typename V2, typename L>
+inline bool poly_mul_impl_mt_kbox(Ret &retval, const V1 &v1, const V2 &v2, const L &limits1, const L &limits2,
+                                  const symbol_set &ss)
+{
+    using ret_key_t = series_key_t<Ret>;
+    using ret_cf_t = series_cf_t<Ret>;
+    using cf1_t = typename V1::value_type::second_type;
+    using cf2_t = typename V2::value_type::second_type;
+    using value_type = typename ret_key_t::value_type;
+    using uvalue_type = make_unsigned_t<value_type>;
+    using int_t = ::mppp::integer<1>;
+
+    // Wide accumulation setup (see poly_mul_wacc).
+    // NOTE: wide accumulation is used only if the Kronecker
+    // substitution is not available, as the latter writes
+    // the coefficients of the product directly into the flat array.
+    constexpr auto wacc = detail::poly_mul_wacc_enabled<ret_cf_t, cf1_t, cf2_t>
+                          && !detail::poly_mul_impl_ks_enabled<ret_cf_t, cf1_t, cf2_t>;
+    using arr_cf_t = ::std::conditional_t<wacc, poly_mul_wacc_t<ret_cf_t>, ret_cf_t>;
+
+    // NOTE: because we assume compatibility, the static cast is safe.
+    const auto s_size = static_cast<unsigned>(ss.size());
+
+    assert(s_size > 0u);
+    assert(limits1.size() == s_size);
+    assert(limits2.size() == s_size);
+    assert(!v1.empty());
+    assert(!v2.empty());
+    assert(retval.empty());
+
+    // The maximum allowed size (in number of coefficients) of the box.
+    // NOTE: this is a rule of thumb. We want the box to be small enough
+    // that the memory required by the flat coefficient array stays within
+    // reasonable limits (256MB), and that the time spent zeroing and scanning
+    // the array is small compared to the time spent in the term-by-term
+    // multiplications.
+    const auto max_box_size
+        = ::std::min(int_t{(1ul << 28) / sizeof(arr_cf_t)}, (int_t{v1.size()} * v2.size()) >> 2);
+
+    // Compute the lower limits and the extents of the box.
+    // NOTE: in the unsigned case, the exponent limits contain only
+    // the max exponents, and we use zero as a lower limit.
+    ::std::vector<value_type> pmin_v;
+    ::std::vector<::std::size_t> ext_v;
+    pmin_v.reserve(s_size);
+    ext_v.reserve(s_size);
+    int_t box_size{1};
+    for (auto i = 0u; i < s_size; ++i) {
+        int_t lo, hi;
+        if constexpr (is_signed_v<value_type>) {
+            lo = int_t{limits1[i].first} + limits2[i].first;
+            hi = int_t{limits1[i].second} + limits2[i].second;
+        } else {
+            hi = int_t{limits1[i]} + limits2[i];
+        }
+
+        const auto ext = hi - lo + 1;
+        box_size *= ext;
+        if (box_size > max_box_size) {
+            return false;
+        }
+
+        // NOTE: lo is a valid exponent (the overflow check was already
+        // performed), and ext is not larger than max_box_size.
+        pmin_v.push_back(static_cast<value_type>(lo));
+        ext_v.push_back(static_cast<::std::size_t>(ext));
+    }
+    const auto box_n = static_cast<::std::size_t>(box_size);
+
+    // Compute the strides of the local codes and of the
+    // Kronecker codes.
+    // NOTE: the Kronecker codes are computed in unsigned arithmetic,
+    // so that we can freely add and subtract the strides.
+    ::std::vector<::std::size_t> str_v(s_size);
+    ::std::vector<uvalue_type> kstr_v(s_size);
+    str_v[0] = 1;
+    kstr_v[0] = 1;
+    for (auto i = 1u; i < s_size; ++i) {
+        str_v[i] = str_v[i - 1u] * ext_v[i - 1u];
+        kstr_v[i] = kstr_v[i - 1u] * static_cast<uvalue_type>(::obake::detail::kpack_get_delta<value_type>(s_size));
+    }
+
+    // Helper to compute the local codes of the terms in v, paired
+    // to pointers to the coefficients and sorted in ascending order.
+    // The local codes of the terms in v are computed with respect
+    // to the minimum exponents in v, so that the local code of the product
+    // of two terms is the sum of the local codes of the factors.
+    auto make_lcodes = [s_size, &str_v](const auto &v, const auto &lims) {
+        using cf_t = typename remove_cvref_t<decltype(v)>::value_type::second_type;
+
+        ::std::vector<::std::pair<::std::size_t, const cf_t *>> ret;
+        ret.resize(::obake::safe_cast<decltype(ret.size())>(v.size()));
+
+        ::tbb::parallel_for(::tbb::blocked_range<decltype(v.size())>(0, v.size()),
+                            [s_size, &str_v, &v, &lims, &ret](const auto &range) {
+                                value_type tmp;
+
+                                for (auto i = range.begin(); i != range.end(); ++i) {
+                                    kunpacker<value_type> ku(v[i].first.get_value(), s_size);
+
+                                    ::std::size_t lc = 0;
+                                    for (auto j = 0u; j < s_size; ++j) {
+                                        ku >> tmp;
+                                        if constexpr (is_signed_v<value_type>) {
+                                            lc += static_cast<::std::size_t>(static_cast<uvalue_type>(tmp)
+                                                                             - static_cast<uvalue_type>(lims[j].first))
+                                                  * str_v[j];
+                                        } else {
+                                            ::obake::detail::ignore(lims);
+                                            lc += static_cast<::std::size_t>(tmp) * str_v[j];
+                                        }
+                                    }
+
+                                    ret[i] = ::std::make_pair(lc, &v[i].second);
+                                }
+                            });
+
+        ::tbb::parallel_sort(ret.begin(), ret.end(),
+                             [](const auto &p1, const auto &p2) { return p1.first < p2.first; });
+
+        return ret;
+    };
+
+    decltype(make_lcodes(v1, limits1)) lc1;
+    decltype(make_lcodes(v2, limits2)) lc2;
+    ::tbb::parallel_invoke([&lc1, &make_lcodes, &v1, &limits1]() { lc1 = make_lcodes(v1, limits1); },
+                           [&lc2, &make_lcodes, &v2, &limits2]() { lc2 = make_lcodes(v2, limits2); });
+
+    // The flat array of coefficients (or of wide accumulators).
+    ::std::vector<arr_cf_t> cf_arr(box_n);
+
+    // Split the box into chunks that will be processed in parallel.
+    // NOTE: for each chunk we need to run a binary search in lc2 for each
+    // term in lc1, thus we don't want the chunks to be too small. The idea
+    // is to have a few chunks per thread for load balancing purposes.
+    const auto chunk_size = ::std::max(box_n / (::obake::detail::hc() * 4u), ::std::size_t(1024));
+    const auto nchunks = box_n / chunk_size + static_cast<::std::size_t>(box_n % chunk_size != 0u);
+
+    // Setup for the vectorised kernel (see poly_mul_impl_kbox_use_axpy()).
+    ::std::vector<ret_cf_t> d2_axpy;
+    ::std::vector<::std::pair<::std::size_t, ::std::size_t>> runs2;
+
+    if (detail::poly_mul_impl_kbox_use_ks<ret_cf_t, cf1_t, cf2_t>(lc1, lc2)) {
+        // The product is dense enough for the Kronecker substitution: interpret
+        // the series as dense univariate polynomials in the local codes
+        // and multiply them via the Kronecker substitution.
+        if constexpr (detail::poly_mul_impl_ks_enabled<ret_cf_t, cf1_t, cf2_t>) {
+            auto make_dense = [](const auto &lc) {
+                ::std::vector<ret_cf_t> ret(lc.back().first + 1u);
+                for (const auto &[l, c] : lc) {
+                    ret[l] = *c;
+                }
+                return ret;
+            };
+
+            ::std::vector<ret_cf_t> d1, d2;
+            ::tbb::parallel_invoke([&d1, &make_dense, &lc1]() { d1 = make_dense(lc1); },
+                                   [&d2, &make_dense, &lc2]() { d2 = make_dense(lc2); });
+
+            // NOTE: the max local code of the product is the sum of the max
+            // local codes of the factors, thus the product fits in cf_arr.
+            assert(d1.size() + d2.size() - 1u <= box_n);
+            detail::poly_ks_mul(cf_arr.data(), d1.data(), d1.size(), d2.data(), d2.size());
+        }
+    } else if (detail::poly_mul_impl_kbox_use_axpy<ret_cf_t, cf1_t, cf2_t>(lc2, d2_axpy, runs2)) {
+        if constexpr (detail::poly_mul_kbox_axpy_enabled<ret_cf_t, cf1_t, cf2_t>) {
+            ::tbb::parallel_for(::tbb::blocked_range<::std::size_t>(0, nchunks), [&lc1, &d2_axpy, &runs2, &cf_arr,
+                                                                                   chunk_size,
+                                                                                   box_n](const auto &range) {
+                // NOTE: exclude the sentinel from the search range.
+                const auto r_begin = runs2.cbegin(), r_end = runs2.cend() - 1;
+                const auto d2_ptr = d2_axpy.data();
+                auto cf_ptr = cf_arr.data();
+
+                for (auto c = range.begin(); c != range.end(); ++c) {
+                    const auto lo = c * chunk_size, hi = ::std::min(lo + chunk_size, box_n);
+
+                    for (const auto &[l1, c1] : lc1) {
+                        if (l1 >= hi) {
+                            break;
+                        }
+
+                        // The range [a, b) of the local codes of the terms
+                        // in y whose products with the current term in x
+                        // end up within the chunk.
+                        const auto a = lo > l1 ? lo - l1 : ::std::size_t(0), b = hi - l1;
+
+                        // Locate the last run starting at or before a (or
+                        // the first run, if all runs start after a).
+                        auto r = ::std::upper_bound(r_begin, r_end, a,
+                                                    [](const auto &n, const auto &p) { return n < p.first; });
+                        if (r != r_begin) {
+                            --r;
+                        }
+
+                        const auto out = cf_ptr + l1;
+                        for (; r != r_end && r->first < b; ++r) {
+                            // Intersect the current run with [a, b).
+                            const auto r_len = (r + 1)->second - r->second;
+                            const auto js = ::std::max(a, r->first), je = ::std::min(b, r->first + r_len);
+
+                            if (js < je) {
+                                detail::poly_mul_kbox_axpy(out + js, *c1, d2_ptr + r->second + (js - r->first),
+                                                           je - js);
+                            }
+                        }
+                    }
+                }
+            });
+        }
+    } else {
+        ::tbb::parallel_for(::tbb::blocked_range<::std::size_t>(0, nchunks), [&lc1, &lc2, &cf_arr, chunk_size,
+                                                                               box_n](const auto &range) {
+            const auto lc2_begin = lc2.cbegin(), lc2_end = lc2.cend();
+            auto cf_ptr = cf_arr.data();
+
+            for (auto c = range.begin(); c != range.end(); ++c) {
+                // The range of local codes in the current chunk.
+                const auto lo = c * chunk_size, hi = ::std::min(lo + chunk_size, box_n);
+
+                for (const auto &[l1, c1] : lc1) {
+                    if (l1 >= hi) {
+                        // lc1 is sorted, no other term in x
+                        // will produce codes within the chunk.
+                        break;
+                    }
+
+                    // Locate the terms in y whose products with the
+                    // current term in x end up within the chunk.
+                    const auto cmp = [](const auto &p, const auto &n) { return p.first < n; };
+                    const auto b2 = lo > l1 ? ::std::lower_bound(lc2_begin, lc2_end, lo - l1, cmp) : lc2_begin;
+                    const auto e2 = ::std::lower_bound(b2, lc2_end, hi - l1, cmp);
+
+                    const auto out = cf_ptr + l1;
+                    for (auto it = b2; it != e2; ++it) {
+                        // NOTE: do it with fma3(), if possible.
+                        if constexpr (wacc) {
+                            detail::poly_mul_wacc_add(out[it->first], *c1, *it->second);
+                        } else if constexpr (is_mult_addable_v<ret_cf_t &, const cf1_t &, const cf2_t &>) {
+                            ::obake::fma3(out[it->first], *c1, *it->second);
+                        } else {
+                            out[it->first] += *c1 * *it->second;
+                        }
+                    }
+                }
+            }
+        });
+    }
+
+    // Convert the flat array into a list of nonzero terms
+    // for each chunk.
+    ::std::vector<::std::vector<::std::pair<value_type, ret_cf_t>>> c_terms(nchunks);
+
+    ::tbb::parallel_for(::tbb::blocked_range<::std::size_t>(0, nchunks), [&](const auto &range) {
+        ::std::vector<::std::size_t> dig(s_size);
+
+        for (auto c = range.begin(); c != range.end(); ++c) {
+            const auto lo = c * chunk_size, hi = ::std::min(lo + chunk_size, box_n);
+
+            // Decode the first local code in the chunk
+            // into the box digits and into a Kronecker code.
+            kpacker<value_type> kp(s_size);
+            for (auto j = 0u; j < s_size; ++j) {
+                dig[j] = (lo / str_v[j]) % ext_v[j];
+                kp << static_cast<value_type>(pmin_v[j] + static_cast<value_type>(dig[j]));
+            }
+            auto cur = static_cast<uvalue_type>(kp.get());
+
+            auto &terms = c_terms[c];
+            for (auto idx = lo; idx < hi; ++idx) {
+                if (!::obake::is_zero(::std::as_const(cf_arr[idx]))) {
+                    if constexpr (wacc) {
+                        ret_cf_t tmp;
+                        detail::poly_mul_wacc_get(tmp, ::std::as_const(cf_arr[idx]));
+                        terms.emplace_back(static_cast<value_type>(cur), ::std::move(tmp));
+                    } else {
+                        terms.emplace_back(static_cast<value_type>(cur), ::std::move(cf_arr[idx]));
+                    }
+                }
+
+                if (idx + 1u < hi) {
+                    // Move to the next local code, updating
+                    // the digits and the Kronecker code.
+                    for (auto j = 0u; j < s_size; ++j) {
+                        if (++dig[j] < ext_v[j]) {
+                            cur += kstr_v[j];
+                            break;
+                        }
+                        dig[j] = 0;
+                        cur -= static_cast<uvalue_type>(ext_v[j] - 1u) * kstr_v[j];
+                    }
+                }
+            }
+        }
+    });
+
+    // Free the flat array before filling in retval.
+    cf_arr = decltype(cf_arr){};
+
+    detail::poly_mul_impl_insert_terms(retval, c_terms);
+
+    return true;
+}
+
+// TBB range over the segment indices [begin, end) of a
+// segmented table, which is split so that the two halves have
+// approximately the same computational cost (rather than the same
+// number of segments). The costs are passed as a pointer
+// to the prefix sums of the costs of the segments starting
+// from the index base: psum[i - base] is the total cost
+// of the segments in the [base, i) range.
+template <typename S>
+class poly_mul_cost_range
+{
+public:
+    explicit poly_mul_cost_range(S base, S begin, S end, const double *psum)
+        : m_base(base), m_begin(begin), m_end(end), m_psum(psum)
+    {
+        assert(m_base <= m_begin);
+        assert(m_begin <= m_end);
+    }
+    poly_mul_cost_range(poly_mul_cost_range &r, ::tbb::split)
+        : m_base(r.m_base), m_begin(r.split_point()), m_end(r.m_end), m_psum(r.m_psum)
+    {
+        r.m_end = m_begin;
+    }
+
+    bool empty() const
+    {
+        return m_begin == m_end;
+    }
+    bool is_divisible() const
+    {
+        return m_end - m_begin > 1u;
+    }
+    S begin() const
+    {
+        return m_begin;
+    }
+    S end() const
+    {
+        return m_end;
+    }
+
+private:
+    // Locate the index mid such that the cost of [begin, mid)
+    // is as close as possible to half the cost of [begin, end).
+    // mid is in the [begin + 1, end - 1] range, so that
+    // both halves are non-empty.
+    S split_point() const
+    {
+        assert(is_divisible());
+
+        const auto p_begin = m_psum + (m_begin - m_base), p_end = m_psum + (m_end - m_base);
+        const auto half = *p_begin + (*p_end - *p_begin) / 2.;
+
+        // NOTE: it is the first position in [begin + 1, end - 1]
+        // whose prefix cost is not less than half.
+        auto it = ::std::lower_bound(p_begin + 1, p_end - 1, half);
+        if (it != p_begin + 1 && half - *(it - 1) < *it - half) {
+            --it;
+        }
+
+        return static_cast<S>(m_begin + static_cast<S>(it - p_begin));
+    }
+
+    S m_base, m_begin, m_end;
+    const double *m_psum;
+};
+
+// Max number of terms sampled when estimating the
+// cost of a truncated multiplication of two ranges of terms.
+inline constexpr unsigned poly_mul_cost_nsamples = 8;
+
+// Merge the wide accumulator b into a.
+inline void poly_mul_wacc_merge(::mppp::integer<2> &a, const ::mppp::integer<2> &b)
+{
+    a += b;
+}
+
+// In the multithreaded homomorphic multiplication, the wide
+// accumulators for the terms of a segment are stored in a
+// separate vector, and the coefficient of each term in the segment
+// table temporarily holds the index of the corresponding accumulator
+// in the vector. In this way, the key of each term is hashed only
+// once, and the normalised accumulators are written in place into
+// the segment table.
+template <typename T>
+inline void poly_mul_wacc_set_idx(T &c, ::std::size_t idx)
+{
+    if constexpr (::std::is_integral_v<T>) {
+        if (obake_unlikely(idx > static_cast<::std::make_unsigned_t<T>>(::obake::detail::limits_max<T>))) {
+            obake_throw(::std::overflow_error, "Overflow detected in the number of wide accumulators "
+                                               "used in a polynomial multiplication");
+        }
+
+        c = static_cast<T>(idx);
+    } else {
+        c = idx;
+    }
+}
+
+template <typename T>
+inline ::std::size_t poly_mul_wacc_get_idx(const T &c)
+{
+    return static_cast<::std::size_t>(c);
+}
+
+// The target of the accumulation of the products for a segment
+// in wide accumulation mode: the segment table, whose
+// coefficients are the indices of the accumulators in accs.
+template <typename Table, typename Acc>
+struct poly_mul_wacc_seg {
+    Table &table;
+    ::std::vector<Acc> &accs;
+};
+
+#if defined(OBAKE_HAVE_GCC_INT128)
+
+inline void poly_mul_wacc_merge(__int128_t &a, const __int128_t &b)
+{
+    a = ::obake::detail::safe_int_add(a, b);
+}
+
+#endif
+
+// Segment sink for the multi-threaded homomorphic
+// implementation. This is the default sink, which signals that
+// the product must be computed in memory.
+struct poly_mul_mt_hm_null_sink {
+};
+
+// The data used by the helpers of the multithreaded homomorphic
+// multiplication: the terms of the operands sorted according to the
+// segmentation order (v1 and v2), the segmentation ranges
+// (vseg1 and vseg2), the functor which computes the end index
+// in the inner multiplication loops (end_idx2), the symbol set,
+// the number of segments (and its base-2 logarithm), the squaring flag
+// and the flag signalling that both vseg1 and vseg2 are represented
+// in dense form (i.e., they contain a range for every segment).
+template <typename V1, typename V2, typename VSeg1, typename VSeg2, typename EndIdx2, typename S>
+struct poly_mul_mt_hm_data {
+    const V1 &v1;
+    const V2 &v2;
+    const VSeg1 &vseg1;
+    const VSeg2 &vseg2;
+    const EndIdx2 &end_idx2;
+    const symbol_set &ss;
+    unsigned log2_nsegs;
+    S nsegs;
+    bool sq;
+    bool dense;
+#if !defined(NDEBUG)
+    // Counter that we use in debug mode to
+    // check that all term-by-term multiplications
+    // are performed.
+    ::std::atomic<unsigned long long> *n_mults;
+#endif
+};
+
+// The type of the vector of wide accumulators
+// for the segments of a product of type Ret.
+template <bool Wacc, typename Ret>
+using poly_mul_mt_hm_wvec_t
+    = ::std::conditional_t<Wacc, ::std::vector<poly_mul_wacc_t<series_cf_t<Ret>>>, ::std::nullptr_t>;
+
+// Accumulate the product c1*c2 into the coefficient of the term
+// with key k in atable (which is either a segment table or, in wide
+// accumulation mode, a poly_mul_wacc_seg).
+template <bool Wacc, typename ATable, typename K, typename C1, typename C2>
+inline void poly_mul_mt_hm_acc_prod(ATable &atable, const K &k, const C1 &c1, const C2 &c2)
+{
+    if constexpr (Wacc) {
+        auto &table = atable.table;
+        auto &accs = atable.accs;
+
+        const auto res = table.try_emplace(k);
+
+        if (res.second) {
+            detail::poly_mul_wacc_set_idx(res.first->second, accs.size());
+            accs.emplace_back();
+            detail::poly_mul_wacc_set(accs.back(), c1, c2);
+        } else {
+            detail::poly_mul_wacc_add(accs[detail::poly_mul_wacc_get_idx(res.first->second)], c1, c2);
+        }
+    } else {
+        auto &table = atable;
+
+        // Attempt the insertion.
+        // NOTE: this will attempt to insert a term with a default-constructed
+        // coefficient. This is wasteful, it would be better to directly
+        // construct the coefficient product only if the insertion actually
+        // takes place (using a lazy multiplication approach).
+        // See the commit 3e334f560d5844f5f2d8face05aa58be21649ff8
+        // for an implementation of the lazy multiplication approach.
+        // NOTE: the coefficient concept demands default constructibility,
+        // thus we can always emplace without arguments for the coefficient.
+        const auto res = table.try_emplace(k);
+
+        // NOTE: optimise with likely/unlikely here?
+        if (res.second) {
+            // NOTE: coefficients are guaranteed to be move-assignable.
+            res.first->second = c1 * c2;
+        } else {
+            // The insertion failed, a term with the same monomial
+            // exists already. Accumulate c1*c2 into the
+            // existing coefficient.
+            // NOTE: do it with fma3(), if possible.
+            using ret_cf_t = remove_cvref_t<decltype(res.first->second)>;
+
+            if constexpr (is_mult_addable_v<ret_cf_t &, const C1 &, const C2 &>) {
+                ::obake::fma3(res.first->second, c1, c2);
+            } else {
+                res.first->second += c1 * c2;
+            }
+        }
+    }
+}
+
+// Finalise the accumulation for a segment: in wide accumulation
+// mode, the accumulators in accs are normalised and written into
+// the coefficients of table (which, on input, contain the indices
+// of the accumulators). The terms with zero coefficients are
+// erased from table.
+template <bool Wacc, typename Table, typename WVec>
+inline void poly_mul_mt_hm_finalise_seg(Table &table, [[maybe_unused]] WVec &accs)
+{
+    if constexpr (Wacc) {
+        assert(table.size() == accs.size());
+
+        const auto it_f = table.end();
+        for (auto it = table.begin(); it != it_f;) {
+            const auto &a = accs[detail::poly_mul_wacc_get_idx(::std::as_const(it->second))];
+
+            if (obake_unlikely(::obake::is_zero(a))) {
+                // NOTE: increase 'it' before erasing.
+                table.erase(it++);
+            } else {
+                detail::poly_mul_wacc_get(it->second, a);
+                ++it;
+            }
+        }
+
+        accs.clear();
+    } else {
+        // Locate and erase terms with zero coefficients
+        // in the current table.
+        const auto it_f = table.end();
+        for (auto it = table.begin(); it != it_f;) {
+            if (obake_unlikely(::obake::is_zero(::std::as_const(it->second)))) {
+                // NOTE: increase 'it' before erasing.
+                // erase() does not cause rehash and thus will not invalidate
+                // any other iterator apart from the one being erased.
+                table.erase(it++);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+// Check the size of a segment table against
+// the max allowed size mts.
+template <typename Table, typename S>
+inline void poly_mul_mt_hm_check_table_size(const Table &table, const S &mts)
+{
+    // LCOV_EXCL_START
+    if (obake_unlikely(table.size() > mts)) {
+        obake_throw(::std::overflow_error, "The homomorphic multithreaded multiplication of two "
+                                           "polynomials resulted in a table whose size ("
+                                               + ::obake::detail::to_string(table.size())
+                                               + ") is larger than the maximum allowed value ("
+                                               + ::obake::detail::to_string(mts) + ")");
+    }
+    // LCOV_EXCL_STOP
+}
+
+// Invoke f(r1, r2, i) on all the pairs of ranges (r1, r2),
+// with r1 = d.vseg1[i] and i in the [i_begin, i_end) range, whose
+// multiplication results in terms which end up at the bucket
+// index seg_idx in the product.
+template <typename D, typename S, typename F>
+inline void poly_mul_mt_hm_for_each_rpair(const D &d, S seg_idx, S i_begin, S i_end, F &&f)
+{
+    const auto &vseg1 = d.vseg1;
+    const auto &vseg2 = d.vseg2;
+    const auto nsegs = d.nsegs;
+    const auto sq = d.sq;
+
+    if (d.dense) {
+        // Due to homomorphic hashing, we know that,
+        // given two indices i and j in vseg1 and vseg2,
+        // the terms generated by the multiplication of the
+        // ranges vseg1[i] and vseg2[j] end up at the bucket
+        // (i + j) % nsegs in the product. Thus, we need to select
+        // all i, j pairs such that (i + j) % nsegs == seg_idx.
+        for (auto i = i_begin; i < i_end; ++i) {
+            const auto j = seg_idx >= i ? (seg_idx - i) : (nsegs - i + seg_idx);
+            assert(j < vseg2.size());
+
+            // In squaring mode, skip the pairs of ranges
+            // with j < i (see poly_mul_impl_mt_hm_sink()).
+            if (sq && j < i) {
+                continue;
+            }
+
+            // NOTE: in the dense case, the bucket
+            // indices must be equal to i/j.
+            assert(::std::get<2>(vseg1[i]) == i);
+            assert(::std::get<2>(vseg2[j]) == j);
+
+            f(vseg1[i], vseg2[j], i);
+        }
+    } else {
+        // Cache begin/end interators into vseg2.
+        const auto vseg2_begin = vseg2.begin(), vseg2_end = vseg2.end();
+
+        // The iterator in vseg2 that we will use
+        // as the end point in the binary search below.
+        // Initially, it is just the end of vseg2
+        // (so that all of vseg2 is searched).
+        auto end_search = vseg2_end;
+
+        // The wrap around flag (see below).
+        // NOTE: if i_begin > 0, the flag will be set
+        // at the first iteration if needed.
+        bool wrap_around = false;
+
+        for (auto i = i_begin; i < i_end; ++i) {
+            const auto &r1 = vseg1[i];
+            const auto bi1 = ::std::get<2>(r1);
+
+            // The first time that bi1 is > seg_idx
+            // we have a wrap-around. This means that:
+            // - the search range in vseg2 will be reset
+            //   to [vseg2_begin, vseg2_end),
+            // - the bucket idx we need to look for
+            //   in vseg2 is not seg_idx any more, but
+            //   seg_idx + nsegs.
+            // E.g., if seg_idx is 4, bi1 is 5 and nsegs
+            // is 8, then there is no bucket index bi2 in
+            // vseg2 such that 5 + bi2 = 4, but there might
+            // be a bi2 such that 5 + bi2 = 4 + 8.
+            if (!wrap_around && bi1 > seg_idx) {
+                wrap_around = true;
+                end_search = vseg2_end;
+            }
+
+            // Compute the target idx: this is seg_idx in case we
+            // have not wrapped around yet, otherwise seg_idx + nsegs
+            // (so that tgt_idx % nsegs == seg_idx).
+            // NOTE: the guarantee on get_max_s_size() ensures that
+            // we can always compute seg_idx + nsegs without overflow.
+            const auto tgt_idx = wrap_around ? (seg_idx + nsegs) : seg_idx;
+
+            // Locate a range in vseg2 such that the bucket idx of that range + bi1
+            // is equal to tgt_idx.
+            const auto it = ::std::lower_bound(
+                vseg2_begin, end_search, tgt_idx,
+                [bi1_ = bi1](const auto &t, const auto &b_idx) { return ::std::get<2>(t) + bi1_ < b_idx; });
+
+            if (it == end_search || ::std::get<2>(*it) + bi1 != tgt_idx) {
+                // There is no range in vseg2 such that its multiplication
+                // by the current range in vseg1 results in terms which
+                // end up at the bucket index seg_idx in the destination
+                // segmented table. Move to the next range in vseg1.
+                continue;
+            }
+            // Update the end point of the binary search. We know that
+            // the next vseg1 range will bump up bi1 at least by one, thus,
+            // in the next binary search, we know that anything we may find
+            // must be *before* it.
+            end_search = it;
+
+            // In squaring mode, skip the pairs of ranges
+            // with bi2 < bi1 (see poly_mul_impl_mt_hm_sink()).
+            if (sq && ::std::get<2>(*it) < bi1) {
+                continue;
+            }
+
+            f(r1, *it, i);
+        }
+    }
+}
+
+// Perform all the term-by-term multiplications between
+// the ranges d.vseg1[i] (with i in the [i_begin, i_end) range) and
+// the ranges in d.vseg2 whose products end up at the bucket index
+// seg_idx in the product. The products are accumulated into atable.
+// tmp_key is a scratch variable which is re-used across invocations.
+// Trunc signals truncated (or pruned) multiplication.
+template <bool Wacc, bool Trunc, typename D, typename ATable, typename K, typename S>
+inline void poly_mul_mt_hm_seg_mul(const D &d, ATable &atable, K &tmp_key, S seg_idx, S i_begin, S i_end)
+{
+    // Cache the pointers to the terms data.
+    auto vptr1 = d.v1.data();
+    auto vptr2 = d.v2.data();
+
+    const auto &ss = d.ss;
+    const auto &end_idx2 = d.end_idx2;
+    const auto sq = d.sq;
+
+    detail::poly_mul_mt_hm_for_each_rpair(d, seg_idx, i_begin, i_end, [&](const auto &r1, const auto &r2,
+                                                                           const auto &) {
+        // Unpack in local variables.
+        const auto [r1_start, r1_end, bi1] = r1;
+        const auto [r2_start, r2_end, bi2] = r2;
+        ::obake::detail::ignore(r2_end);
+
+        // The O(N**2) multiplication loop over the ranges.
+        for (auto idx1 = r1_start; idx1 != r1_end; ++idx1) {
+            const auto &[k1, c1] = *(vptr1 + idx1);
+
+            // Compute the end index in the second range
+            // for the current value of idx1.
+            const auto idx_end2 = end_idx2(idx1, r2);
+
+            // Compute the begin index in the second range. In
+            // squaring mode, on the diagonal (i.e., bi1 == bi2)
+            // we multiply only by the terms with index >= idx1.
+            const auto diag = sq && bi1 == bi2;
+            const auto idx_begin2 = diag ? idx1 : r2_start;
+
+            // In the truncated case, check if the end index
+            // does not go past the begin index. In such a case,
+            // we can skip all the remaining indices in r1 because
+            // none of them will ever generate a term which respects
+            // the truncation limits (both r1 and r2 are sorted
+            // according to the degree).
+            if (Trunc && idx_end2 <= idx_begin2) {
+                break;
+            }
+
+            auto ptr2 = vptr2 + idx_begin2;
+            // NOTE: squaring is possible only if
+            // the operands have the same type.
+            if constexpr (::std::is_same_v<remove_cvref_t<decltype(d.v1)>, remove_cvref_t<decltype(d.v2)>>) {
+                if (diag) {
+                    // The diagonal product, whose coefficient
+                    // must not be doubled.
+                    ::obake::monomial_mul(tmp_key, k1, k1, ss);
+                    detail::poly_mul_mt_hm_acc_prod<Wacc>(atable, tmp_key, c1, c1);
+
+                    // Check that the result ends up in the correct bucket.
+                    assert(::obake::hash(tmp_key) % (S(1) << d.log2_nsegs) == seg_idx);
+
+#if !defined(NDEBUG)
+                    ++*d.n_mults;
+#endif
+
+                    ++ptr2;
+                }
+            }
+
+            const auto end2 = vptr2 + idx_end2;
+            for (; ptr2 != end2; ++ptr2) {
+                const auto &[k2, c2] = *ptr2;
+
+                // Do the monomial multiplication.
+                ::obake::monomial_mul(tmp_key, k1, k2, ss);
+
+                // Check that the result ends up in the correct bucket.
+                assert(::obake::hash(tmp_key) % (S(1) << d.log2_nsegs) == seg_idx);
+
+                // Accumulate the coefficient product.
+                detail::poly_mul_mt_hm_acc_prod<Wacc>(atable, tmp_key, c1, c2);
+
+#if !defined(NDEBUG)
+                ++*d.n_mults;
+#endif
+            }
+        }
+    });
+}
+
+// Estimate the cost (i.e., the number of term-by-term
+// multiplications) of the multiplication of the ranges r1 and r2.
+// In truncated mode, the number of multiplications which respect
+// the truncation limits is estimated from a small sample
+// of the terms in r1.
+template <bool Trunc, typename D, typename R1, typename R2>
+inline double poly_mul_mt_hm_rpair_cost(const D &d, const R1 &r1, const R2 &r2)
+{
+    const auto [r1_start, r1_end, bi1] = r1;
+    const auto [r2_start, r2_end, bi2] = r2;
+    const auto diag = d.sq && bi1 == bi2;
+    const auto n1 = r1_end - r1_start;
+
+    if constexpr (Trunc) {
+        ::obake::detail::ignore(r2_end);
+
+        using idx_t = remove_cvref_t<decltype(n1)>;
+
+        const auto ns = ::std::min(n1, static_cast<idx_t>(detail::poly_mul_cost_nsamples));
+        if (ns == 0u) {
+            return 0.;
+        }
+
+        // NOTE: sample ns evenly-spaced terms in r1.
+        double ret = 0;
+        for (idx_t k = 0; k < ns; ++k) {
+            const auto idx1 = static_cast<idx_t>(r1_start + n1 / ns * k);
+            const auto idx_end2 = d.end_idx2(idx1, r2);
+            const auto idx_begin2 = diag ? idx1 : r2_start;
+
+            if (idx_end2 > idx_begin2) {
+                ret += static_cast<double>(idx_end2 - idx_begin2);
+            }
+        }
+
+        return ret * (static_cast<double>(n1) / static_cast<double>(ns));
+    } else {
+        const auto dn1 = static_cast<double>(n1);
+        return diag ? dn1 * (dn1 + 1.) / 2. : dn1 * static_cast<double>(r2_end - r2_start);
+    }
+}
+
+// Compute into ipsum the prefix sums of the costs of the
+// ranges in d.vseg1 for the segment seg_idx. ipsum[i + 1]
+// will contain the cost of the ranges up to d.vseg1[i] (included).
+template <bool Trunc, typename D, typename S>
+inline void poly_mul_mt_hm_seg_ipsum(const D &d, ::std::vector<double> &ipsum, S seg_idx)
+{
+    const auto n_vseg1 = static_cast<S>(d.vseg1.size());
+
+    ipsum.assign(static_cast<decltype(ipsum.size())>(n_vseg1) + 1u, 0.);
+    detail::poly_mul_mt_hm_for_each_rpair(d, seg_idx, S(0), n_vseg1,
+                                          [&d, &ipsum](const auto &r1, const auto &r2, const auto &i) {
+                                              ipsum[static_cast<decltype(ipsum.size())>(i) + 1u]
+                                                  = detail::poly_mul_mt_hm_rpair_cost<Trunc>(d, r1, r2);
+                                          });
+    ::std::partial_sum(ipsum.begin(), ipsum.end(), ipsum.begin());
+}
+
+// Compute the hot segment seg_idx of retval. The ranges in d.vseg1 are
+// partitioned in n_chunks chunks of approximately equal cost, and the chunks
+// are computed in parallel, each one accumulating into a private table.
+// The private tables are then merged into the segment table in retval.
+// ipsum contains the prefix sums of the costs of the ranges
+// in d.vseg1 (see poly_mul_mt_hm_seg_ipsum()).
+template <bool Wacc, bool Trunc, typename Ret, typename D, typename S>
+inline void poly_mul_mt_hm_compute_hot_seg(Ret &retval, const D &d, S seg_idx, S n_chunks,
+                                           const ::std::vector<double> &ipsum)
+{
+    using table_t = remove_cvref_t<decltype(retval._get_s_table()[0])>;
+    using wvec_t = poly_mul_mt_hm_wvec_t<Wacc, Ret>;
+
+    const auto n_vseg1 = static_cast<S>(d.vseg1.size());
+
+    assert(ipsum.size() == static_cast<decltype(ipsum.size())>(n_vseg1) + 1u);
+
+    // Determine the boundaries of the chunks.
+    ::std::vector<S> bounds{0};
+    for (S k = 1; k < n_chunks; ++k) {
+        const auto tgt = ipsum.back() * static_cast<double>(k) / static_cast<double>(n_chunks);
+        const auto b = static_cast<S>(::std::lower_bound(ipsum.begin(), ipsum.end(), tgt) - ipsum.begin());
+
+        if (b > bounds.back() && b < n_vseg1) {
+            bounds.push_back(b);
+        }
+    }
+    bounds.push_back(n_vseg1);
+
+    // Compute the chunks.
+    // NOTE: in wide accumulation mode, each chunk
+    // has its own vector of accumulators.
+    ::std::vector<table_t> ctables(bounds.size() - 1u);
+    ::std::vector<wvec_t> cwvecs(bounds.size() - 1u);
+    ::tbb::parallel_for(
+        ::tbb::blocked_range<decltype(ctables.size())>(0, ctables.size(), 1),
+        [&ctables, &cwvecs, &bounds, &d, seg_idx](const auto &range) {
+            series_key_t<Ret> tmp_key(d.ss);
+            for (auto c = range.begin(); c != range.end(); ++c) {
+                if constexpr (Wacc) {
+                    detail::poly_mul_wacc_seg<table_t, typename wvec_t::value_type> atable{ctables[c], cwvecs[c]};
+                    detail::poly_mul_mt_hm_seg_mul<Wacc, Trunc>(d, atable, tmp_key, seg_idx, bounds[c],
+                                                                bounds[c + 1u]);
+                } else {
+                    ::obake::detail::ignore(cwvecs);
+                    detail::poly_mul_mt_hm_seg_mul<Wacc, Trunc>(d, ctables[c], tmp_key, seg_idx, bounds[c],
+                                                                bounds[c + 1u]);
+                }
+            }
+        },
+        ::tbb::simple_partitioner());
+
+    // Merge the private tables into the first one.
+    auto &mtable = ctables[0];
+    auto &mwvec = cwvecs[0];
+    for (decltype(ctables.size()) c = 1; c < ctables.size(); ++c) {
+        for (auto &[k, a] : ctables[c]) {
+            if constexpr (Wacc) {
+                auto &w = cwvecs[c][detail::poly_mul_wacc_get_idx(::std::as_const(a))];
+                const auto res = mtable.try_emplace(k);
+
+                if (res.second) {
+                    detail::poly_mul_wacc_set_idx(res.first->second, mwvec.size());
+                    mwvec.push_back(::std::move(w));
+                } else {
+                    detail::poly_mul_wacc_merge(mwvec[detail::poly_mul_wacc_get_idx(res.first->second)],
+                                                ::std::as_const(w));
+                }
+            } else {
+                // NOTE: try_emplace() does not move from a
+                // if the insertion fails.
+                const auto res = mtable.try_emplace(k, ::std::move(a));
+
+                if (!res.second) {
+                    res.first->second += ::std::as_const(a);
+                }
+            }
+        }
+
+        // Free the memory.
+        ctables[c] = table_t{};
+        cwvecs[c] = wvec_t{};
+    }
+
+    // Finalise the accumulation into the segment table.
+    auto &table = retval._get_s_table()[seg_idx];
+    assert(table.empty());
+
+    using ::std::swap;
+    swap(table, mtable);
+
+    detail::poly_mul_mt_hm_finalise_seg<Wacc>(table, mwvec);
+
+    detail::poly_mul_mt_hm_check_table_size(table, retval._get_max_table_size());
+}
+
+// Compute the segments of retval in the range r (which can be either
+// a TBB blocked_range or a poly_mul_cost_range), skipping the hot
+// segments in the sorted vector hot_segs (which have been
+// computed already). est_seg_nterms is the estimated number
+// of terms per segment.
+template <bool Wacc, bool Trunc, typename Ret, typename D, typename R, typename S>
+inline void poly_mul_mt_hm_compute_seg_range(Ret &retval, const D &d, const R &r, const ::std::vector<S> &hot_segs,
+                                             ::std::size_t est_seg_nterms)
+{
+    using table_t = remove_cvref_t<decltype(retval._get_s_table()[0])>;
+    using wvec_t = poly_mul_mt_hm_wvec_t<Wacc, Ret>;
+
+    const auto n_vseg1 = static_cast<S>(d.vseg1.size());
+
+    // Temporary variable used in monomial multiplication.
+    series_key_t<Ret> tmp_key(d.ss);
+
+    // The vector of wide accumulators (if needed).
+    // NOTE: this is re-used across the segments in r,
+    // so that its storage is allocated only once.
+    [[maybe_unused]] wvec_t wvec{};
+    if constexpr (Wacc) {
+        wvec.reserve(est_seg_nterms);
+    } else {
+        ::obake::detail::ignore(est_seg_nterms);
+    }
+
+    for (auto seg_idx = r.begin(); seg_idx != r.end(); ++seg_idx) {
+        if (::std::binary_search(hot_segs.begin(), hot_segs.end(), seg_idx)) {
+            // The hot segments have been computed already.
+            continue;
+        }
+
+        // Get a reference to the current table in retval.
+        auto &table = retval._get_s_table()[seg_idx];
+
+        if constexpr (Wacc) {
+            detail::poly_mul_wacc_seg<table_t, typename wvec_t::value_type> atable{table, wvec};
+            detail::poly_mul_mt_hm_seg_mul<Wacc, Trunc>(d, atable, tmp_key, seg_idx, S(0), n_vseg1);
+        } else {
+            detail::poly_mul_mt_hm_seg_mul<Wacc, Trunc>(d, table, tmp_key, seg_idx, S(0), n_vseg1);
+        }
+
+        // Finalise the accumulation for the current table.
+        detail::poly_mul_mt_hm_finalise_seg<Wacc>(table, wvec);
+
+        detail::poly_mul_mt_hm_check_table_size(table, retval._get_max_table_size());
+    }
+}
+
+// Compute the segments of retval in the [begin, end) range.
+// est_seg_nterms is the estimated number of terms per segment.
+template <bool Wacc, bool Trunc, typename Ret, typename D, typename S>
+inline void poly_mul_mt_hm_compute_segs(Ret &retval, const D &d, S begin, S end, ::std::size_t est_seg_nterms)
+{
+    assert(begin < end);
+
+    const auto n_vseg1 = static_cast<S>(d.vseg1.size());
+
+    // Hot segments are the segments whose cost exceeds the amount
+    // of work each thread would be assigned in a perfectly balanced
+    // schedule. The computation of such a segment would end up on
+    // the critical path, thus we split it across several tasks (if requested).
+    const auto n_threads = static_cast<S>(::std::max(::tbb::this_task_arena::max_concurrency(), 1));
+    const auto split_hot = polynomials::get_mul_split_hot_segments() && n_threads > 1u && n_vseg1 > 1u;
+
+    if (n_threads == 1u) {
+        // With a single thread there is no load
+        // to balance: skip the estimation of the costs.
+        detail::poly_mul_mt_hm_compute_seg_range<Wacc, Trunc>(retval, d, ::tbb::blocked_range<S>(begin, end),
+                                                              ::std::vector<S>{}, est_seg_nterms);
+
+        return;
+    }
+
+    if (end - begin == 1u) {
+        // A single segment is hot by definition (if there is more than
+        // one thread): estimate only the costs of its ranges in order
+        // to split it, and skip the estimation of the costs of the segments.
+        if (split_hot) {
+            ::std::vector<double> ipsum;
+            detail::poly_mul_mt_hm_seg_ipsum<Trunc>(d, ipsum, begin);
+            detail::poly_mul_mt_hm_compute_hot_seg<Wacc, Trunc>(retval, d, begin, ::std::min(n_threads, n_vseg1),
+                                                                ipsum);
+        } else {
+            detail::poly_mul_mt_hm_compute_seg_range<Wacc, Trunc>(retval, d, ::tbb::blocked_range<S>(begin, end),
+                                                                  ::std::vector<S>{}, est_seg_nterms);
+        }
+
+        return;
+    }
+
+    // NOTE: a hot segment costs more than 1 / n_threads of the total,
+    // thus there are at most n_threads - 1 hot segments, and they are
+    // among the n_threads - 1 most expensive segments. We keep track
+    // of the most expensive segments found so far (together with
+    // the prefix sums of the costs of their ranges, so that they can be
+    // re-used in poly_mul_mt_hm_compute_hot_seg()) in hot_cands, which is
+    // protected by hot_mutex. hot_min_cost is the minimum cost a segment must
+    // have in order to enter hot_cands.
+    struct hot_cand {
+        double cost;
+        S seg_idx;
+        ::std::vector<double> ipsum;
+    };
+    ::std::vector<hot_cand> hot_cands;
+    ::std::mutex hot_mutex;
+    ::std::atomic<double> hot_min_cost(0);
+    const auto max_hot = static_cast<decltype(hot_cands.size())>(n_threads - 1u);
+    auto cost_less = [](const hot_cand &c1, const hot_cand &c2) { return c1.cost < c2.cost; };
+
+    // Estimate the costs of the segments. psum[i + 1]
+    // will contain the cost of the segment begin + i.
+    ::obake::detail::dinit_vector<double> psum;
+    psum.resize(static_cast<decltype(psum.size())>(end - begin) + 1u);
+    psum[0] = 0;
+    ::tbb::parallel_for(::tbb::blocked_range<S>(begin, end), [&d, &psum, &hot_cands, &hot_mutex, &hot_min_cost,
+                                                              &cost_less, begin, split_hot,
+                                                              max_hot](const auto &range) {
+        // The prefix sums of the costs of the ranges of
+        // the current segment.
+        ::std::vector<double> ipsum;
+
+        for (auto seg_idx = range.begin(); seg_idx != range.end(); ++seg_idx) {
+            detail::poly_mul_mt_hm_seg_ipsum<Trunc>(d, ipsum, seg_idx);
+
+            // NOTE: start from 1 in order to account for the fixed
+            // overhead of the computation of a segment.
+            const auto cost = 1 + ipsum.back();
+            psum[static_cast<decltype(psum.size())>(seg_idx - begin) + 1u] = cost;
+
+            if (!split_hot || !(cost > hot_min_cost.load(::std::memory_order_relaxed))) {
+                continue;
+            }
+
+            ::std::lock_guard lock{hot_mutex};
+
+            if (hot_cands.size() < max_hot) {
+                hot_cands.push_back(hot_cand{cost, seg_idx, ipsum});
+            } else {
+                // Replace the least expensive candidate.
+                const auto it = ::std::min_element(hot_cands.begin(), hot_cands.end(), cost_less);
+                if (cost > it->cost) {
+                    it->cost = cost;
+                    it->seg_idx = seg_idx;
+                    it->ipsum = ipsum;
+                }
+            }
+
+            if (hot_cands.size() == max_hot) {
+                hot_min_cost.store(::std::min_element(hot_cands.begin(), hot_cands.end(), cost_less)->cost,
+                                   ::std::memory_order_relaxed);
+            }
+        }
+    });
+
+    // Detect the hot segments among the candidates.
+    // NOTE: the hot segments are sorted in ascending order,
+    // and their cost is zeroed out in psum.
+    ::std::vector<S> hot_segs;
+    if (split_hot) {
+        const auto tot_cost = ::std::accumulate(psum.begin() + 1, psum.end(), 0.);
+        const auto hot_cost = tot_cost / static_cast<double>(n_threads);
+
+        ::std::erase_if(hot_cands, [hot_cost](const hot_cand &c) { return !(c.cost > hot_cost); });
+        ::std::sort(hot_cands.begin(), hot_cands.end(),
+                    [](const auto &c1, const auto &c2) { return c1.seg_idx < c2.seg_idx; });
+
+        for (const auto &c : hot_cands) {
+            hot_segs.push_back(c.seg_idx);
+            psum[static_cast<decltype(psum.size())>(c.seg_idx - begin) + 1u] = 0;
+        }
+    }
+    ::std::partial_sum(psum.begin(), psum.end(), psum.begin());
+
+    // Compute the hot segments first.
+    for (const auto &c : hot_cands) {
+        detail::poly_mul_mt_hm_compute_hot_seg<Wacc, Trunc>(retval, d, c.seg_idx, ::std::min(n_threads, n_vseg1),
+                                                            c.ipsum);
+    }
+
+    // Compute the other segments, using a range which
+    // is split according to the estimated costs.
+    ::tbb::parallel_for(detail::poly_mul_cost_range<S>(begin, begin, end, psum.data()),
+                        [&retval, &d, &hot_segs, est_seg_nterms](const auto &range) {
+                            detail::poly_mul_mt_hm_compute_seg_range<Wacc, Trunc>(retval, d, range, hot_segs,
+                                                                                  est_seg_nterms);
+                        });
+}
+
+// Check that the exponents of the product of x and y
+// (which must have the same symbol set) do not overflow,
+// scanning the keys of x and y.
+template <typename T, typename U>
+inline bool poly_mul_monomial_range_overflow_check(const T &x, const U &y)
+{
+    assert(x.get_symbol_set_fw() == y.get_symbol_set_fw());
+
+    const auto r1
+        = ::obake::detail::make_range(::boost::make_transform_iterator(x.cbegin(), poly_term_key_ref_extractor{}),
+                                      ::boost::make_transform_iterator(x.cend(), poly_term_key_ref_extractor{}));
+    const auto r2
+        = ::obake::detail::make_range(::boost::make_transform_iterator(y.cbegin(), poly_term_key_ref_extractor{}),
+                                      ::boost::make_transform_iterator(y.cend(), poly_term_key_ref_extractor{}));
+
+    if constexpr (are_overflow_testable_monomial_ranges_v<decltype(r1) &, decltype(r2) &>) {
+        return ::obake::monomial_range_overflow_check(r1, r2, x.get_symbol_set());
+    } else {
+        return true;
+    }
+}
+
+// Detect if the bounds on the keys of the polynomials T and U
+// are cached in the polynomials (i.e., if the keys are packed monomials).
+template <typename T, typename U>
+inline constexpr bool poly_mul_has_key_bounds = same_packed_monomial_v<series_key_t<T>, series_key_t<U>>;
+
+// Check that the multiplication of two polynomials whose keys
+// are packed monomials with bounds b1 and b2 does not result
+// in an overflow.
+template <typename V>
+inline bool poly_mul_key_bounds_check(const pm_key_bounds<V> &b1, const pm_key_bounds<V> &b2)
+{
+    // NOTE: if there are no variables, there
+    // cannot be overflow.
+    return b1.exps.empty() || detail::pm_exponent_limits_check<V>(b1.exps, b2.exps);
+}
+
+// Detect if the total degree truncation of the product of T and U
+// can be short-circuited via the degree bounds cached in the
+// operands. The keys must be packed monomials, the degree of the
+// terms must depend only on the keys and the degree limit
+// must be a C++ integral.
+template <typename T, typename U, typename... Args>
+constexpr bool poly_mul_deg_bounds_shortcut_impl()
+{
+    if constexpr (sizeof...(Args) == 1u) {
+        return poly_has_pm_key_degree<T> && poly_has_pm_key_degree<U> && (is_integral_v<Args> && ...);
+    } else {
+        return false;
+    }
+}
+
+template <typename T, typename U, typename... Args>
+inline constexpr bool poly_mul_deg_bounds_shortcut = detail::poly_mul_deg_bounds_shortcut_impl<T, U, Args...>();
+
+// Fetch the bounds on the keys of the non-empty polynomials x and y,
+// whose keys are packed monomials (see series::_get_key_bounds()).
+// If the bounds are not cached yet and the polynomials are
+// large, the bounds of x and y are computed concurrently.
+template <typename T, typename U>
+inline auto poly_mul_fetch_key_bounds(const T &x, const U &y)
+{
+    static_assert(same_packed_monomial_v<series_key_t<T>, series_key_t<U>>);
+
+    assert(!x.empty());
+    assert(!y.empty());
+
+    using b_t = ::obake::detail::series_key_bounds_t<series_key_t<T>>;
+
+    ::std::pair<const b_t *, const b_t *> retval{nullptr, nullptr};
+
+    if (static_cast<const void *>(&x) == static_cast<const void *>(&y)) {
+        // Squaring.
+        retval.first = x._get_key_bounds();
+        retval.second = retval.first;
+    } else if (x.size() > 5000u || y.size() > 5000u) {
+        ::tbb::parallel_invoke([&retval, &x]() { retval.first = x._get_key_bounds(); },
+                               [&retval, &y]() { retval.second = y._get_key_bounds(); });
+    } else {
+        retval.first = x._get_key_bounds();
+        retval.second = y._get_key_bounds();
+    }
+
+    assert(retval.first != nullptr);
+    assert(retval.second != nullptr);
+
+    return retval;
+}
+
+// Check that the exponents of the product of x and y
+// (which must have the same symbol set) do not overflow.
+template <typename T, typename U>
+inline bool poly_mul_monomial_overflow_check(const T &x, const U &y)
+{
+    assert(x.get_symbol_set_fw() == y.get_symbol_set_fw());
+
+    if constexpr (detail::poly_mul_has_key_bounds<T, U>) {
+        if (x.empty() || y.empty()) {
+            return true;
+        }
+
+        // Run the check on the bounds on the keys
+        // cached in the operands.
+        const auto [b1, b2] = detail::poly_mul_fetch_key_bounds(x, y);
+        if (detail::poly_mul_key_bounds_check(*b1, *b2)) {
+            return true;
+        }
+
+        // NOTE: the cached bounds are not guaranteed to be
+        // tight, confirm the overflow on the keys.
+    }
+
+    return detail::poly_mul_monomial_range_overflow_check(x, y);
+}
+
+// The multi-threaded homomorphic implementation.
+// The operands can be either series or prepared operands. For
+// prepared operands, the sorted terms, the segmentation and the degree
+// data will be fetched from (or stored into) the operand's cache.
+//
+// If Sink is not poly_mul_mt_hm_null_sink, the segments of the
+// product are computed in batches of consecutive segments. The number of
+// segments in a batch is determined via sink.batch_size(nsegs, est_bytes),
+// where nsegs is the total number of segments and est_bytes the estimated
+// byte size of the product. After the computation of each batch,
+// sink.consume(retval, begin, end) is invoked: the sink is expected to
+// take over the terms in the segments [begin, end) of retval, and
+// to leave the segments empty. In this mode, the dense
+// Kronecker engine is not used.
+//
+// If OCheck is false, the monomial overflow check is skipped
+// (the caller must have performed it already).
+template <bool OCheck = true, typename Ret, typename Sink, typename TO, typename UO, typename... Args>
+inline void poly_mul_impl_mt_hm_sink(Ret &retval, Sink &sink, const TO &xo, const UO &yo, const Args &...args)
+{
+    using T = poly_mul_op_series_t<TO>;
+    using U = poly_mul_op_series_t<UO>;
+    const auto &x = detail::poly_mul_op_series(xo);
+    const auto &y = detail::poly_mul_op_series(yo);
+
+    using cf1_t = series_cf_t<T>;
+    using cf2_t = series_cf_t<U>;
+    using ret_key_t = series_key_t<Ret>;
+    using ret_cf_t = series_cf_t<Ret>;
+    using s_size_t = typename Ret::s_size_type;
+
+    // Preconditions.
+    static_assert(sizeof...(args) <= 2u);
+    assert(!x.empty());
+    assert(!y.empty());
+    assert(x.size() <= y.size());
+    assert(retval.get_symbol_set_fw() == x.get_symbol_set_fw());
+    assert(retval.get_symbol_set_fw() == y.get_symbol_set_fw());
+    assert(retval.empty());
+    assert(retval._get_s_table().size() == 1u);
+
+    // Cache the symbol set.
+    const auto &ss = retval.get_symbol_set();
+
+    // Detect squaring.
+    const auto sq = detail::poly_mul_impl_is_square(x, y);
+
+    // Create vectors containing copies of
+    // the input terms.
+    // NOTE: in theory, it would be possible here
+    // to move the coefficients (in conjunction with
+    // rref_cleaner, as usual).
+    // NOTE: drop the const from the key type in order
+    // to allow mutability.
+    // NOTE: need to better assess the benefits of
+    // copying the input series.
+    // NOTE: prepared operands already contain a copy of
+    // their terms, which is accessed via uv1/uv2.
+    // NOTE: in squaring mode, the terms of y
+    // are not copied.
+    auto make_tv = [](const auto &op, const auto &s, bool copy) {
+        ::std::vector<::std::pair<series_key_t<remove_cvref_t<decltype(s)>>,
+                                  series_cf_t<remove_cvref_t<decltype(s)>>>>
+            ret;
+        if constexpr (!is_prepared_operand_v<remove_cvref_t<decltype(op)>>) {
+            if (copy) {
+                ret = detail::poly_mul_impl_make_term_vector(s);
+            }
+        } else {
+            ::obake::detail::ignore(s, copy);
+        }
+        return ret;
+    };
+    auto tv1 = make_tv(xo, x, true);
+    auto tv2 = make_tv(yo, y, !sq);
+    auto fetch_tv = [](const auto &op, const auto &tv) -> const auto & {
+        if constexpr (is_prepared_operand_v<remove_cvref_t<decltype(op)>>) {
+            return op._get_terms();
+        } else {
+            return tv;
+        }
+    };
+    const auto &uv1 = fetch_tv(xo, tv1);
+    const auto &uv2 = [&]() -> const auto & {
+        if constexpr (::std::is_same_v<T, U>) {
+            if (sq) {
+                return uv1;
+            }
+        }
+
+        return fetch_tv(yo, tv2);
+    }();
+
+    // Do the monomial overflow checking, if supported.
+    // NOTE: we have to sequence the overflow checking before the product
+    // size estimation and the average term size estimation, as those two
+    // operations might generate overflows during monomial multiplication.
+    const auto r1
+        = ::obake::detail::make_range(::boost::make_transform_iterator(uv1.cbegin(), poly_term_key_ref_extractor{}),
+                                      ::boost::make_transform_iterator(uv1.cend(), poly_term_key_ref_extractor{}));
+    const auto r2
+        = ::obake::detail::make_range(::boost::make_transform_iterator(uv2.cbegin(), poly_term_key_ref_extractor{}),
+                                      ::boost::make_transform_iterator(uv2.cend(), poly_term_key_ref_extractor{}));
+    // NOTE: for packed monomials, the check is performed on
+    // the bounds on the keys cached in the operands (see
+    // series::_get_key_bounds()), thus its cost does not
+    // depend on the number of terms once the bounds are available.
+    // If the dense Kronecker engine is available, the exponent limits
+    // of the operands will also be needed later, and they are
+    // returned from here.
+    [[maybe_unused]] const auto exp_limits = [&r1, &r2, &ss, &x, &y]() {
+        if constexpr (detail::same_packed_monomial_v<ret_key_t, ret_key_t>) {
+            using value_type = typename ret_key_t::value_type;
+            using limits_t = pm_exponent_limits_t<value_type>;
+
+            ::std::pair<limits_t, limits_t> ret;
+
+            if (ss.empty()) {
+                // No variables, no exponent limits
+                // and no possibility of overflow.
+                return ret;
+            }
+
+            const auto [b1, b2] = detail::poly_mul_fetch_key_bounds(x, y);
+
+            if (obake_likely(detail::poly_mul_key_bounds_check(*b1, *b2))) {
+                if constexpr (detail::poly_mul_impl_kbox_enabled<ret_key_t, ret_cf_t>) {
+                    ret.first = b1->exps;
+                    ret.second = b2->exps;
+                }
+
+                return ret;
+            }
+
+            // NOTE: the cached bounds are not guaranteed to be
+            // tight, compute the exact exponent limits from the keys.
+            ret = detail::pm_range_exponent_limits(r1, r2, ss);
+
+            if (OCheck && obake_unlikely(!detail::pm_exponent_limits_check<value_type>(ret.first, ret.second))) {
+                obake_throw(::std::overflow_error, "An overflow in the monomial exponents was detected while "
+                                                   "attempting to multiply two polynomials");
+            }
+
+            return ret;
+        } else {
+            ::obake::detail::ignore(x, y);
+
+            if constexpr (OCheck && are_overflow_testable_monomial_ranges_v<decltype(r1) &, decltype(r2) &>) {
+                // The monomial overflow checking is supported, run it.
+                if (obake_unlikely(!::obake::monomial_range_overflow_check(r1, r2, ss))) {
+                    obake_throw(::std::overflow_error, "An overflow in the monomial exponents was detected while "
+                                                       "attempting to multiply two polynomials");
+                }
+            } else {
+                // The overflow check was performed by the caller,
+                // or it is not supported.
+                ::obake::detail::ignore(r1, r2, ss);
+            }
+
+            // NOTE: the exponent limits are not needed,
+            // return a placeholder.
+            return 0;
+        }
+    }();
+
+    // In truncated mode, compute the degrees of the input terms.
+    // The degrees are computed only once, and they are re-used both
+    // in the estimation of the product size and in the segmentation
+    // of the input series.
+    // NOTE: in squaring mode, the degrees are computed only for x.
+    using degree_data_t = decltype(detail::poly_mul_impl_prepare_degree_data<T, U>(uv1, uv2, ss, args...));
+    using vd1_t = typename ::std::conditional_t<(sizeof...(Args) > 0u), ::std::tuple_element<0, degree_data_t>,
+                                                ::obake::detail::type_c<::std::tuple<>>>::type;
+    using vd2_t = typename ::std::conditional_t<(sizeof...(Args) > 0u), ::std::tuple_element<1, degree_data_t>,
+                                                ::obake::detail::type_c<::std::tuple<>>>::type;
+    vd1_t in_vd1;
+    vd2_t in_vd2;
+    if constexpr (sizeof...(Args) > 0u) {
+        // NOTE: in the make_(p_/w_)degree_vector() helpers we need
+        // to compute the sizes of uv1/uv2 via iterator differences.
+        ::obake::detail::container_it_diff_check(uv1);
+        ::obake::detail::container_it_diff_check(uv2);
+
+        ::tbb::parallel_invoke(
+            [&in_vd1, &uv1, &ss, &args...]() {
+                in_vd1
+                    = detail::poly_mul_impl_make_degree_vector<T>(uv1.cbegin(), uv1.cend(), ss, true, args...);
+            },
+            [&in_vd2, &uv2, &ss, sq, &args...]() {
+                if (!sq) {
+                    in_vd2
+                        = detail::poly_mul_impl_make_degree_vector<U>(uv2.cbegin(), uv2.cend(), ss, true, args...);
+                }
+            });
+    }
+
+    // Estimate the total number of terms, and compute the total number
+    // of term-by-term multiplications.
+    // NOTE: poly_mul_estimate_product_size_dd() requires the shorter series first,
+    // which is ensured by the preconditions of this function.
+    const auto [est_nterms, tot_n_mults] = [&]() {
+        if constexpr (sizeof...(Args) > 0u) {
+            const auto &vd2_ref = [&]() -> const auto & {
+                if constexpr (::std::is_same_v<vd1_t, vd2_t>) {
+                    if (sq) {
+                        return in_vd1;
+                    }
+                }
+
+                return in_vd2;
+            }();
+
+            return detail::poly_mul_estimate_product_size_dd<T, U>(uv1, uv2, ss,
+                                                                   ::std::forward_as_tuple(in_vd1, vd2_ref), args...);
+        } else {
+            return detail::poly_mul_estimate_product_size_dd<T, U>(uv1, uv2, ss, ::std::make_tuple());
+        }
+    }();
+
+    // Exit early if the truncation limits
+    // result in an empty output series.
+    if (sizeof...(Args) > 0u && tot_n_mults.is_zero()) {
+        return;
+    }
+
+    // Estimate the average term size.
+    // NOTE: once poly_mul_impl_estimate_average_term_size() becomes more computationally intensive,
+    // we can do it in parallel with poly_mul_estimate_product_size().
+    const auto avg_term_size = detail::poly_mul_impl_estimate_average_term_size<ret_cf_t>(uv1, uv2, ss);
+
+    // Compute the estimated sparsity.
+    const auto est_sp = static_cast<double>(est_nterms) / static_cast<double>(tot_n_mults);
+
+    // Establish the desired segment size in kilobytes.
+    // NOTE: the idea here is the following. For highly
+    // sparse polynomials (est_sp >= threshold), we want to pick
+    // a relatively large size so that it fits somewhere in L2
+    // cache, say. The reason is that we won't do much computation
+    // per segment due to the sparsity, thus we aim at reducing
+    // the parallelisation overhead by operating on larger chunks
+    // of the product series. When the sparsity is smaller, then
+    // we have a higher computational density, thus we will spend
+    // more time computing a single segment, and thus we can aim
+    // at staying in L1 cache instead, as the parallelisation overhead
+    // will be smaller. Note that these values will be just rule-of-thumb,
+    // because the sparsity is not estimated accurately and because
+    // of further manipulations below. Additionally, it is not clear
+    // to me how smooth the transition between high and low sparsity
+    // will be. Eventually, we may perhaps want to leave this parameter as
+    // a tunable parameter for the user or perhaps even determine
+    // the cache sizes at runtime and use those.
+    // NOTE: if est_sp is not finite, due to tot_n_mults being zero or other
+    // FP issues, go with a default value.
+    // NOTE: is it worth it to exit early if tot_n_mults is zero? This would
+    // mean that the truncation limits will produce an empty series.
+    const auto seg_size = (!::std::isfinite(est_sp) || est_sp >= 1E-3) ? 200ul : 20ul;
+
+    // Estimate the number of segments via the deduced segment size.
+    const auto est_nsegs = (est_nterms * avg_term_size) / (seg_size * 1024ul);
+
+    // Fetch the base-2 logarithm + 1 of est_nsegs, making sure it does not
+    // overflow the max allowed value for the return polynomial type.
+    const auto log2_nsegs = ::std::min(::obake::safe_cast<unsigned>(est_nsegs.nbits()),
+                                       polynomial<ret_key_t, ret_cf_t>::get_max_s_size());
+
+    // Setup the number of segments in retval.
+    retval.set_n_segments(log2_nsegs);
+
+    // Cache the actual number of segments.
+    const auto nsegs = s_size_t(1) << log2_nsegs;
+
+    // Flag to signal that the product is being
+    // computed in memory.
+    constexpr auto in_mem = ::std::is_same_v<Sink, poly_mul_mt_hm_null_sink>;
+
+    if constexpr (sizeof...(Args) == 0u && in_mem && detail::poly_mul_impl_kbox_enabled<ret_key_t, ret_cf_t>) {
+        // In the untruncated case, try first to run the dense Kronecker engine.
+        if (!ss.empty() && detail::poly_mul_impl_mt_kbox(retval, uv1, uv2, exp_limits.first, exp_limits.second, ss)) {
+            return;
+        }
+    }
+
+    // Helper to sort the input terms according to the hash value modulo
+    // 2**log2_nsegs. That is, sort them according to the bucket
+    // they would occupy in a segmented table with 2**log2_nsegs
+    // segments.
+    auto t_sorter = [log2_nsegs](const auto &p1, const auto &p2) {
+        const auto h1 = ::obake::hash(p1.first);
+        const auto h2 = ::obake::hash(p2.first);
+
+        return h1 % (s_size_t(1) << log2_nsegs) < h2 % (s_size_t(1) << log2_nsegs);
+    };
+
+    // Helper to compute the segmentation for the input series.
+    // The segmentation is a vector of ranges (represented
+    // as pairs of indices into v1/v2) paired to indices
     // representing the bucket that the range
     // would occupy in a segmented table
     // with 2**log2_nsegs segments.
@@ -991,151 +3972,342 @@ inline void poly_mul_impl_mt_hm(Ret &retval, const T &x, const U &y, const Args
         return vseg;
     };
 
-    // Helper that, given a segmentation vseg into a vector of terms
-    // v, will:
-    //
-    // - create and return a vector vd
-    //   containing the total/partial degrees of all the
-    //   terms in v, with the degrees within each vseg range sorted
-    //   in ascending order,
-    // - sort v according to vd.
+    // Helper to compute the permutation which sorts the vector of terms tv
+    // according to the segmentation order and, in truncated mode, according
+    // to the degree within each segmentation range (vd is the vector of
+    // the degrees of the terms in tv).
     //
-    // v will be one of v1/v2, t is a type_c instance
-    // containing either T or U.
-    auto seg_sorter = [&ss, &args...](auto &v, auto t, const auto &vseg) {
-        if constexpr (sizeof...(args) == 0u) {
-            // Non-truncated case: seg_sorter will be a no-op.
-            ::obake::detail::ignore(v, t, vseg, ss, args...);
-        } else {
-            // Truncated case.
-
-            // NOTE: we will be using the machinery from the default implementation
-            // of degree() for series, so that we can re-use the concept checking bits
-            // as well.
-            using s_t = typename decltype(t)::type;
-
-            // Compute the vector of degrees.
-            auto vd = [&v, &ss, &args...]() {
-                // NOTE: in the make_(p_)degree_vector() helpers we need
-                // to compute the size of v via iterator differences.
-                ::obake::detail::container_it_diff_check(v);
-
-                if constexpr (sizeof...(args) == 1u) {
-                    // Total degree.
-                    ::obake::detail::ignore(args...);
+    // In truncated mode, the sorting is done indirectly in a single
+    // pass (according to the bucket index first, and then according
+    // to the degree). For keys whose codes are ordered by degree
+    // (see poly_mul_impl_code_degree_sort), the permutation is instead
+    // computed by sorting directly the bucket indices and the key codes.
+    // t is a type_c instance containing either T or U.
+    auto seg_perm = [log2_nsegs, &args...](const auto &tv, const auto &vd, auto t) {
+        using idx_t = decltype(tv.size());
+
+        // Helper to compute the bucket indices of the terms.
+        auto make_vb = [&tv, log2_nsegs]() {
+            ::obake::detail::dinit_vector<s_size_t> vb;
+            vb.resize(::obake::safe_cast<decltype(vb.size())>(tv.size()));
+            ::tbb::parallel_for(::tbb::blocked_range<idx_t>(0, tv.size()), [&vb, &tv, log2_nsegs](const auto &range) {
+                for (auto i = range.begin(); i != range.end(); ++i) {
+                    vb[i] = static_cast<s_size_t>(::obake::hash(tv[i].first) % (s_size_t(1) << log2_nsegs));
+                }
+            });
 
-                    return customisation::internal::make_degree_vector<s_t>(v.cbegin(), v.cend(), ss, true);
-                } else {
-                    // Partial degree.
-                    static_assert(sizeof...(args) == 2u);
+            return vb;
+        };
 
-                    return customisation::internal::make_p_degree_vector<s_t>(
-                        v.cbegin(), v.cend(), ss, ::std::get<1>(::std::forward_as_tuple(args...)), true);
+        if constexpr (sizeof...(args) == 0u) {
+            // Non-truncated case: sort indirectly
+            // according to the bucket index.
+            ::obake::detail::ignore(vd, t, args...);
+
+            const auto vb = make_vb();
+
+            auto vidx = detail::poly_mul_impl_par_make_idx_vector(tv);
+            ::tbb::parallel_sort(vidx.begin(), vidx.end(),
+                                 [&vb](const auto &idx1, const auto &idx2) { return vb[idx1] < vb[idx2]; });
+
+            return vidx;
+        } else if constexpr (poly_mul_impl_code_degree_sort<typename decltype(t)::type, Args...>) {
+            // Truncated case in which the ordering of the key codes
+            // is consistent with the ordering of the degrees: sort
+            // directly compact records containing the bucket index,
+            // the key code and the index of each term, so that the
+            // comparisons do not need to access the terms or the degrees.
+            ::obake::detail::ignore(make_vb);
+
+            assert(vd.size() == tv.size());
+
+            using code_t = remove_cvref_t<decltype(tv[0].first.get_value())>;
+
+            ::obake::detail::dinit_vector<::std::tuple<s_size_t, code_t, idx_t>> vr;
+            vr.resize(::obake::safe_cast<decltype(vr.size())>(tv.size()));
+            ::tbb::parallel_for(::tbb::blocked_range<idx_t>(0, tv.size()), [&vr, &tv, log2_nsegs](const auto &range) {
+                for (auto i = range.begin(); i != range.end(); ++i) {
+                    const auto b = static_cast<s_size_t>(::obake::hash(tv[i].first) % (s_size_t(1) << log2_nsegs));
+                    vr[i] = ::std::tuple{b, tv[i].first.get_value(), i};
                 }
-            }();
+            });
+            ::tbb::parallel_sort(vr.begin(), vr.end());
+
+            // Extract the permutation.
+            ::obake::detail::dinit_vector<idx_t> vidx;
+            vidx.resize(::obake::safe_cast<decltype(vidx.size())>(vr.size()));
+            ::tbb::parallel_for(::tbb::blocked_range<idx_t>(0, vr.size()), [&vidx, &vr](const auto &range) {
+                for (auto i = range.begin(); i != range.end(); ++i) {
+                    vidx[i] = ::std::get<2>(vr[i]);
+                }
+            });
 
-            // Ensure that the size of vd is representable by the
-            // diff type of its iterators. We'll need to do some
-            // iterator arithmetics below.
-            // NOTE: cast to const as we will use cbegin/cend below.
-            ::obake::detail::container_it_diff_check(::std::as_const(vd));
+            return vidx;
+        } else {
+            // Truncated case.
+            assert(vd.size() == tv.size());
 
-            // Create a vector of indices into vd.
-            auto vidx = detail::poly_mul_impl_par_make_idx_vector(vd);
+            const auto vb = make_vb();
 
-            // Sort indirectly each range from vseg according to the degree.
+            // Sort indirectly according to the bucket index
+            // and, within each bucket, according to the degree.
             // NOTE: capture vd as const ref because in the lt-comparable requirements for the degree
             // type we are using const lrefs.
-            ::tbb::parallel_for(
-                ::tbb::blocked_range<decltype(vseg.cbegin())>(vseg.cbegin(), vseg.cend()),
-                [&vidx, &vdc = ::std::as_const(vd)](const auto &range) {
-                    for (const auto &r : range) {
-                        // NOTE: note sure if it is worth to run
-                        // a parallel sort here.
-                        ::std::sort(vidx.data() + ::std::get<0>(r), vidx.data() + ::std::get<1>(r),
-                                    [&vdc](const auto &idx1, const auto &idx2) { return vdc[idx1] < vdc[idx2]; });
-                    }
-                });
+            auto vidx = detail::poly_mul_impl_par_make_idx_vector(tv);
+            ::tbb::parallel_sort(vidx.begin(), vidx.end(),
+                                 [&vb, &vdc = ::std::as_const(vd)](const auto &idx1, const auto &idx2) {
+                                     if (vb[idx1] != vb[idx2]) {
+                                         return vb[idx1] < vb[idx2];
+                                     }
+
+                                     return poly_mul_deg_ops<Args...>::less(vdc[idx1], vdc[idx2]);
+                                 });
 
-            // Apply the sorting to vd and v. Ensure we don't run
-            // into overflows during the permutated access.
-            ::obake::detail::container_it_diff_check(vd);
-            // NOTE: use cbegin/cend on vd to ensure the copy ctor of
-            // the degree type is being called.
-            vd = decltype(vd)(::boost::make_permutation_iterator(vd.cbegin(), vidx.cbegin()),
-                              ::boost::make_permutation_iterator(vd.cend(), vidx.cend()));
-            ::obake::detail::container_it_diff_check(v);
-            v = ::std::remove_reference_t<decltype(v)>(::boost::make_permutation_iterator(v.cbegin(), vidx.cbegin()),
-                                                       ::boost::make_permutation_iterator(v.cend(), vidx.cend()));
+            return vidx;
+        }
+    };
 
 #if !defined(NDEBUG)
-            // Check the results in debug mode.
-            for (const auto &r : vseg) {
+    // Helper to check in debug mode that, in truncated mode,
+    // the terms in the segmented data sd are sorted according
+    // to the degree within each segmentation range.
+    // t is a type_c instance containing either T or U.
+    auto check_sd = [&ss, &args...](const auto &sd, auto t) {
+        if constexpr (sizeof...(args) > 0u) {
+            using s_t = typename decltype(t)::type;
+
+            for (const auto &r : sd.vseg) {
                 const auto &idx_begin = ::std::get<0>(r);
                 const auto &idx_end = ::std::get<1>(r);
 
-                // NOTE: add constness to vd in order to ensure that
+                // NOTE: add constness to sd.vd in order to ensure that
                 // the degrees are compared via const refs.
-                assert(::std::is_sorted(::std::as_const(vd).data() + idx_begin, ::std::as_const(vd).data() + idx_end));
+                assert(::std::is_sorted(
+                    ::std::as_const(sd.vd).data() + idx_begin, ::std::as_const(sd.vd).data() + idx_end,
+                    [](const auto &a, const auto &b) { return poly_mul_deg_ops<Args...>::less(a, b); }));
 
-                if constexpr (sizeof...(args) == 1u) {
+                if constexpr (poly_mul_is_pruned<Args...>) {
+                    assert(::std::equal(
+                        sd.vd.data() + idx_begin, sd.vd.data() + idx_end, sd.v.data() + idx_begin,
+                        [](const auto &a, const auto &b) { return a == detail::poly_mul_cf_mag(b.second); }));
+                } else if constexpr (sizeof...(args) == 1u) {
                     using d_impl = customisation::internal::series_default_degree_impl;
 
                     assert(::std::equal(
-                        vd.data() + idx_begin, vd.data() + idx_end,
-                        ::boost::make_transform_iterator(v.data() + idx_begin, d_impl::d_extractor<s_t>{&ss}),
+                        sd.vd.data() + idx_begin, sd.vd.data() + idx_end,
+                        ::boost::make_transform_iterator(sd.v.data() + idx_begin, d_impl::d_extractor<s_t>{&ss}),
                         [](const auto &a, const auto &b) { return !(a < b) && !(b < a); }));
+                } else if constexpr (poly_mul_is_w_truncated<Args...>) {
+                    const auto groups
+                        = detail::poly_w_degree_groups(::std::get<1>(::std::forward_as_tuple(args...)), ss);
+
+                    assert(::std::equal(sd.vd.data() + idx_begin, sd.vd.data() + idx_end,
+                                        ::boost::make_transform_iterator(sd.v.data() + idx_begin,
+                                                                         poly_w_degree_extractor{&groups, &ss}),
+                                        [](const auto &a, const auto &b) { return a == b; }));
                 } else {
                     using d_impl = customisation::internal::series_default_p_degree_impl;
 
                     const auto &s = ::std::get<1>(::std::forward_as_tuple(args...));
                     const auto si = ::obake::detail::ss_intersect_idx(s, ss);
 
-                    assert(::std::equal(
-                        vd.data() + idx_begin, vd.data() + idx_end,
-                        ::boost::make_transform_iterator(v.data() + idx_begin, d_impl::d_extractor<s_t>{&s, &si, &ss}),
-                        [](const auto &a, const auto &b) { return !(a < b) && !(b < a); }));
+                    assert(::std::equal(sd.vd.data() + idx_begin, sd.vd.data() + idx_end,
+                                        ::boost::make_transform_iterator(sd.v.data() + idx_begin,
+                                                                         d_impl::d_extractor<s_t>{&s, &si, &ss}),
+                                        [](const auto &a, const auto &b) { return !(a < b) && !(b < a); }));
                 }
             }
+        } else {
+            ::obake::detail::ignore(sd, t, ss, args...);
+        }
+    };
+#endif
+
+    // Helper that, given a vector of terms tv (and, in truncated mode,
+    // the vector vd of the degrees of the terms in tv), will:
+    //
+    // - sort the terms according to the segmentation order
+    //   and write them into sd.v,
+    // - compute the segmentation ranges into sd.vseg,
+    // - in truncated mode, sort the terms within each segmentation
+    //   range according to the degree, and write the sorted degrees
+    //   into sd.vd.
+    //
+    // In non-truncated mode, the terms are sorted directly. In truncated
+    // mode, the permutation computed by seg_perm() is applied in parallel
+    // to the terms and to the degrees. tv and vd will be
+    // left in a valid but unspecified state.
+    // t is a type_c instance containing either T or U.
+    auto seg_sorter = [t_sorter, seg_perm, compute_vseg
+#if !defined(NDEBUG)
+                       ,
+                       check_sd
 #endif
+    ](auto &sd, auto &tv, auto &vd, auto t) {
+        if constexpr (sizeof...(Args) == 0u) {
+            // Non-truncated case: sort the terms directly.
+            ::obake::detail::ignore(seg_perm, vd);
 
-            // Return the vector of degrees.
-            return vd;
+            sd.v = ::std::move(tv);
+            ::tbb::parallel_sort(sd.v.begin(), sd.v.end(), t_sorter);
+        } else {
+            ::obake::detail::ignore(t_sorter);
+
+            const auto vidx = seg_perm(::std::as_const(tv), ::std::as_const(vd), t);
+
+            // Apply the permutation to the terms and to the degrees.
+            ::tbb::parallel_invoke(
+                [&sd, &tv, &vidx]() { sd.v = detail::poly_mul_impl_par_permute<true>(tv, vidx); },
+                [&sd, &vd, &vidx]() { sd.vd = detail::poly_mul_impl_par_permute<true>(vd, vidx); });
         }
+
+        // Compute the segmentation ranges.
+        sd.vseg = compute_vseg(sd.v);
+
+#if !defined(NDEBUG)
+        check_sd(sd, t);
+#else
+        ::obake::detail::ignore(t);
+#endif
     };
 
-    // Prepare the variables to hold the segmentations
-    // and the degrees of the terms, if we are in a
-    // truncated multiplication.
-    decltype(compute_vseg(v1)) vseg1;
-    decltype(compute_vseg(v2)) vseg2;
-    auto degree_data = detail::poly_mul_impl_prepare_degree_data<T, U>(v1, v2, ss, args...);
+    // The segmented data for x and y.
+    using sd1_t = poly_mul_seg_data<decltype(tv1), decltype(compute_vseg(tv1)), vd1_t>;
+    using sd2_t = poly_mul_seg_data<decltype(tv2), decltype(compute_vseg(tv2)), vd2_t>;
+    ::std::shared_ptr<const sd1_t> sd1;
+    ::std::shared_ptr<const sd2_t> sd2;
 
-    // For both x and y, concurrently:
-    // - sort v1/v2 according to the segmentation order,
-    // - compute the segmentation ranges,
-    // - compute the degrees of the terms and sort according
-    //   to the degree within each segment (only for truncated
-    //   multiplication).
-    ::tbb::parallel_invoke(
-        [&v1, t_sorter, &vseg1, compute_vseg, &degree_data, seg_sorter]() {
-            ::tbb::parallel_sort(v1.begin(), v1.end(), t_sorter);
-            vseg1 = compute_vseg(v1);
-            if constexpr (sizeof...(Args) > 0u) {
-                ::std::get<0>(degree_data) = seg_sorter(v1, ::obake::detail::type_c<T>{}, vseg1);
-            } else {
-                ::obake::detail::ignore(degree_data, seg_sorter);
+    // Helper to compute the segmented data for the operand op,
+    // whose terms have been copied into tv (unless op is a prepared
+    // operand).
+    //
+    // For prepared operands, the terms are not copied into tv. The
+    // permutation which sorts the terms of the operand in the
+    // segmentation order and the segmentation ranges are fetched
+    // from the cache of the operand, if available, otherwise they are
+    // computed and stored in the cache. The sorted terms and degrees
+    // are then obtained by applying the permutation to the terms of the
+    // operand and to vd. In this way, the prepared operand stores
+    // a single copy of its terms, regardless of the number
+    // of cached entries.
+    auto make_sd = [log2_nsegs, seg_sorter, seg_perm, compute_vseg,
+#if !defined(NDEBUG)
+                    check_sd,
+#endif
+                    &args...](const auto &op, auto &tv, auto &vd, auto sd_t, auto s_t) {
+        using sd_type = typename decltype(sd_t)::type;
+
+        auto ret = ::std::make_shared<sd_type>();
+
+        if constexpr (is_prepared_operand_v<remove_cvref_t<decltype(op)>>) {
+            using mul_data_t = typename remove_cvref_t<decltype(op)>::mul_data_t;
+            static_assert(::std::is_same_v<decltype(mul_data_t::vseg), decltype(ret->vseg)>);
+
+            ::obake::detail::ignore(tv, seg_sorter);
+
+            const auto &terms = op._get_terms();
+            const auto key = detail::poly_mul_impl_cache_key(log2_nsegs, args...);
+
+            auto data = op._get_mul_data(key);
+            const auto fresh = !data;
+            ::std::shared_ptr<mul_data_t> new_data;
+            if (fresh) {
+                new_data = ::std::make_shared<mul_data_t>();
+                new_data->perm = seg_perm(terms, ::std::as_const(vd), s_t);
+                data = new_data;
             }
-        },
-        [&v2, t_sorter, &vseg2, compute_vseg, &degree_data, seg_sorter]() {
-            ::tbb::parallel_sort(v2.begin(), v2.end(), t_sorter);
-            vseg2 = compute_vseg(v2);
-            if constexpr (sizeof...(Args) > 0u) {
-                ::std::get<1>(degree_data) = seg_sorter(v2, ::obake::detail::type_c<U>{}, vseg2);
+
+            // Apply the permutation to the terms and to the degrees.
+            const auto &perm = data->perm;
+            ::tbb::parallel_invoke(
+                [&ret, &terms, &perm]() { ret->v = detail::poly_mul_impl_par_permute<false>(terms, perm); },
+                [&ret, &vd, &perm]() {
+                    if constexpr (sizeof...(Args) > 0u) {
+                        ret->vd = detail::poly_mul_impl_par_permute<true>(vd, perm);
+                    } else {
+                        ::obake::detail::ignore(ret, vd, perm);
+                    }
+                });
+
+            if (fresh) {
+                // Compute the segmentation ranges
+                // and store the new data in the cache.
+                ret->vseg = compute_vseg(ret->v);
+                new_data->vseg = ret->vseg;
+                op._set_mul_data(key, ::std::move(new_data));
             } else {
-                ::obake::detail::ignore(degree_data, seg_sorter);
+                ret->vseg = data->vseg;
             }
-        });
+
+#if !defined(NDEBUG)
+            check_sd(*ret, s_t);
+#endif
+        } else {
+            ::obake::detail::ignore(log2_nsegs, seg_perm, compute_vseg, args...);
+#if !defined(NDEBUG)
+            ::obake::detail::ignore(check_sd);
+#endif
+
+            seg_sorter(*ret, tv, vd, s_t);
+        }
+
+        return ::std::shared_ptr<const sd_type>(::std::move(ret));
+    };
+
+    // For both x and y, concurrently:
+    // - sort the terms according to the segmentation order,
+    // - compute the segmentation ranges,
+    // - sort according to the degree within each segment
+    //   (only for truncated multiplication).
+    // In squaring mode, this is done only for x.
+    if (sq) {
+        if constexpr (::std::is_same_v<sd1_t, sd2_t>) {
+            sd1 = make_sd(xo, tv1, in_vd1, ::obake::detail::type_c<sd1_t>{}, ::obake::detail::type_c<T>{});
+            sd2 = sd1;
+        }
+    } else {
+        ::tbb::parallel_invoke(
+            [&sd1, &make_sd, &xo, &tv1, &in_vd1]() {
+                sd1 = make_sd(xo, tv1, in_vd1, ::obake::detail::type_c<sd1_t>{}, ::obake::detail::type_c<T>{});
+            },
+            [&sd2, &make_sd, &yo, &tv2, &in_vd2]() {
+                sd2 = make_sd(yo, tv2, in_vd2, ::obake::detail::type_c<sd2_t>{}, ::obake::detail::type_c<U>{});
+            });
+    }
+
+    // Fetch references to the segmented data.
+    const auto &v1 = sd1->v;
+    const auto &vseg1 = sd1->vseg;
+    const auto &vseg2 = sd2->vseg;
+
+    // In squaring mode, the product of the terms x_i and x_j (with i != j)
+    // appears twice in the result. Thus, we multiply only the pairs
+    // of ranges (r1, r2) whose bucket indices satisfy bi1 <= bi2 and,
+    // if bi1 == bi2, only the pairs of terms with idx1 <= idx2. The
+    // off-diagonal products are computed using the terms of x with
+    // doubled coefficients, which are stored in v1d.
+    decltype(tv1) v1d;
+    if constexpr (::std::is_same_v<sd1_t, sd2_t>) {
+        if (sq) {
+            v1d = v1;
+
+            ::tbb::parallel_for(::tbb::blocked_range<decltype(v1d.size())>(0, v1d.size()),
+                                [&v1d, &v1](const auto &range) {
+                                    for (auto i = range.begin(); i != range.end(); ++i) {
+                                        v1d[i].second += v1[i].second;
+                                    }
+                                });
+        }
+    }
+    const auto &v2 = [&]() -> const auto & {
+        if constexpr (::std::is_same_v<sd1_t, sd2_t>) {
+            if (sq) {
+                return ::std::as_const(v1d);
+            }
+        }
+
+        return sd2->v;
+    }();
 
 #if !defined(NDEBUG)
     {
@@ -1184,21 +4356,21 @@ inline void poly_mul_impl_mt_hm(Ret &retval, const T &x, const U &y, const Args
     // of the range, otherwise the returned
     // value will ensure that the truncation limits
     // are respected.
-    auto compute_end_idx2 = [&degree_data, &args...]() {
+    auto compute_end_idx2 = [&sd1, &sd2, &args...]() {
         if constexpr (sizeof...(Args) == 0u) {
-            ::obake::detail::ignore(degree_data, args...);
+            ::obake::detail::ignore(sd1, sd2, args...);
 
             return [](const auto &, const auto &r2) { return ::std::get<1>(r2); };
         } else {
             // Create and return the functor. The degree data
-            // for the two series will be moved in as vd1 and vd2.
+            // for the two series will be captured by reference as vd1 and vd2.
 #if defined(_MSC_VER) && !defined(__clang__)
             // Until MS fixes the lambda capture.
-            auto vd1 = ::std::move(::std::get<0>(degree_data));
-            auto vd2 = ::std::move(::std::get<1>(degree_data));
-            return [&, vd1, vd2]
+            const auto &vd1 = sd1->vd;
+            const auto &vd2 = sd2->vd;
+            return [&]
 #else
-            return [vd1 = ::std::move(::std::get<0>(degree_data)), vd2 = ::std::move(::std::get<1>(degree_data)),
+            return [&vd1 = sd1->vd, &vd2 = sd2->vd,
                     // NOTE: max_deg is captured via const lref this way,
                     // as args is passed as a const lref pack.
                     &max_deg = ::std::get<0>(::std::forward_as_tuple(args...))]
@@ -1215,18 +4387,17 @@ inline void poly_mul_impl_mt_hm(Ret &retval, const T &x, const U &y, const Args
                     const auto &d_i = vd1[i];
 
                     // Find the first term in the range r2 such
-                    // that d_i + d_j > max_deg.
+                    // that the product of the terms violates the
+                    // truncation limit.
                     // NOTE: we checked above that the static cast
                     // to the it diff type is safe.
                     using it_diff_t = decltype(vd2.cend() - vd2.cbegin());
-                    const auto it = ::std::upper_bound(vd2.cbegin() + static_cast<it_diff_t>(::std::get<0>(r2)),
-                                                       vd2.cbegin() + static_cast<it_diff_t>(::std::get<1>(r2)),
-                                                       max_deg, [&d_i](const auto &mdeg, const auto &d_j) {
-                                                           // NOTE: we require below
-                                                           // comparability between const lvalue limit
-                                                           // and rvalue of the sum of the degrees.
-                                                           return mdeg < d_i + d_j;
-                                                       });
+                    const auto it = ::std::upper_bound(
+                        vd2.cbegin() + static_cast<it_diff_t>(::std::get<0>(r2)),
+                        vd2.cbegin() + static_cast<it_diff_t>(::std::get<1>(r2)), max_deg,
+                        [&d_i](const auto &mdeg, const auto &d_j) {
+                            return poly_mul_deg_ops<Args...>::skip(mdeg, poly_mul_deg_ops<Args...>::prod(d_i, d_j));
+                        });
 
                     // Turn the iterator into an index and return it.
                     // NOTE: we checked above that the iterator diff
@@ -1244,331 +4415,72 @@ inline void poly_mul_impl_mt_hm(Ret &retval, const T &x, const U &y, const Args
     ::std::atomic<unsigned long long> n_mults(0);
 #endif
 
-    // The parallel multiplication functor for the sparse case.
-    auto sparse_par_functor
-        = [&v1, &v2, &vseg1, &vseg2, nsegs, &retval, &ss, mts = retval._get_max_table_size(), &compute_end_idx2
-#if !defined(NDEBUG)
-           ,
-           log2_nsegs, &n_mults
-#endif
-    ](const auto &range) {
-              // Cache the pointers to the terms data.
-              // NOTE: doing it here rather than in the lambda
-              // capture seems to help performance on GCC.
-              auto vptr1 = v1.data();
-              auto vptr2 = v2.data();
-
-              // Temporary variable used in monomial multiplication.
-              ret_key_t tmp_key(ss);
-
-              // Cache begin/end interators into vseg2.
-              const auto vseg2_begin = vseg2.begin(), vseg2_end = vseg2.end();
-
-              for (auto seg_idx = range.begin(); seg_idx != range.end(); ++seg_idx) {
-                  // Get a reference to the current table in retval.
-                  auto &table = retval._get_s_table()[seg_idx];
-
-                  // The iterator in vseg2 that we will use
-                  // as the end point in the binary search below.
-                  // Initially, it is just the end of vseg2
-                  // (so that all of vseg2 is searched).
-                  auto end_search = vseg2_end;
-
-                  // The wrap around flag (see below).
-                  bool wrap_around = false;
-
-                  for (const auto &r1 : vseg1) {
-                      // Unpack in local variables.
-                      const auto [r1_start, r1_end, bi1] = r1;
-
-                      // The first time that bi1 is > seg_idx
-                      // we have a wrap-around. This means that:
-                      // - the search range in vseg2 will be reset
-                      //   to [vseg2_begin, vseg2_end),
-                      // - the bucket idx we need to look for
-                      //   in vseg2 is not seg_idx any more, but
-                      //   seg_idx + nsegs.
-                      // E.g., if seg_idx is 4, bi1 is 5 and nsegs
-                      // is 8, then there is no bucket index bi2 in
-                      // vseg2 such that 5 + bi2 = 4, but there might
-                      // be a bi2 such that 5 + bi2 = 4 + 8.
-                      if (!wrap_around && bi1 > seg_idx) {
-                          wrap_around = true;
-                          end_search = vseg2_end;
-                      }
-
-                      // Compute the target idx: this is seg_idx in case we
-                      // have not wrapped around yet, otherwise seg_idx + nsegs
-                      // (so that tgt_idx % nsegs == seg_idx).
-                      // NOTE: the guarantee on get_max_s_size() ensures that
-                      // we can always compute seg_idx + nsegs without overflow.
-                      const auto tgt_idx = wrap_around ? (seg_idx + nsegs) : seg_idx;
-
-                      // Locate a range in vseg2 such that the bucket idx of that range + bi1
-                      // is equal to tgt_idx.
-                      const auto it = ::std::lower_bound(
-                          vseg2_begin, end_search, tgt_idx,
-                          [bi1_ = bi1](const auto &t, const auto &b_idx) { return ::std::get<2>(t) + bi1_ < b_idx; });
-
-                      if (it == end_search || ::std::get<2>(*it) + bi1 != tgt_idx) {
-                          // There is no range in vseg2 such that its multiplication
-                          // by the current range in vseg1 results in terms which
-                          // end up at the bucket index seg_idx in the destination
-                          // segmented table. Move to the next range in vseg1.
-                          continue;
-                      }
-                      // Update the end point of the binary search. We know that
-                      // the next vseg1 range will bump up bi1 at least by one, thus,
-                      // in the next binary search, we know that anything we may find
-                      // must be *before* it.
-                      end_search = it;
-
-                      // Unpack in local variables.
-                      const auto &r2 = *it;
-                      const auto [r2_start, r2_end, bi2] = r2;
-                      ::obake::detail::ignore(r2_end, bi2);
-
-                      // The O(N**2) multiplication loop over the ranges.
-                      for (auto idx1 = r1_start; idx1 != r1_end; ++idx1) {
-                          const auto &[k1, c1] = *(vptr1 + idx1);
-
-                          // Compute the end index in the second range
-                          // for the current value of idx1.
-                          const auto idx_end2 = compute_end_idx2(idx1, r2);
-
-                          // In the truncated case, check if the end index
-                          // coincides with the begin index. In such a case,
-                          // we can skip all the remaining indices in r1 because
-                          // none of them will ever generate a term which respects
-                          // the truncation limits (both r1 and r2 are sorted
-                          // according to the degree).
-                          if (sizeof...(Args) > 0u && idx_end2 == r2_start) {
-                              break;
-                          }
-
-                          const auto end2 = vptr2 + idx_end2;
-                          for (auto ptr2 = vptr2 + r2_start; ptr2 != end2; ++ptr2) {
-                              const auto &[k2, c2] = *ptr2;
-
-                              // Do the monomial multiplication.
-                              ::obake::monomial_mul(tmp_key, k1, k2, ss);
-
-                              // Check that the result ends up in the correct bucket.
-                              assert(::obake::hash(tmp_key) % (s_size_t(1) << log2_nsegs) == seg_idx);
-
-                              // Attempt the insertion.
-                              // NOTE: this will attempt to insert a term with a default-constructed
-                              // coefficient. This is wasteful, it would be better to directly
-                              // construct the coefficient product only if the insertion actually
-                              // takes place (using a lazy multiplication approach).
-                              // See the commit 3e334f560d5844f5f2d8face05aa58be21649ff8
-                              // for an implementation of the lazy multiplication approach.
-                              // NOTE: the coefficient concept demands default constructibility,
-                              // thus we can always emplace without arguments for the coefficient.
-                              const auto res = table.try_emplace(tmp_key);
-
-                              // NOTE: optimise with likely/unlikely here?
-                              if (res.second) {
-                                  // NOTE: coefficients are guaranteed to be move-assignable.
-                                  res.first->second = c1 * c2;
-                              } else {
-                                  // The insertion failed, a term with the same monomial
-                                  // exists already. Accumulate c1*c2 into the
-                                  // existing coefficient.
-                                  // NOTE: do it with fma3(), if possible.
-                                  if constexpr (is_mult_addable_v<ret_cf_t &, const cf1_t &, const cf2_t &>) {
-                                      ::obake::fma3(res.first->second, c1, c2);
-                                  } else {
-                                      res.first->second += c1 * c2;
-                                  }
-                              }
-
-#if !defined(NDEBUG)
-                              ++n_mults;
-#endif
-                          }
-                      }
-                  }
-
-                  // Locate and erase terms with zero coefficients
-                  // in the current table.
-                  const auto it_f = table.end();
-                  for (auto it = table.begin(); it != it_f;) {
-                      if (obake_unlikely(::obake::is_zero(::std::as_const(it->second)))) {
-                          // NOTE: increase 'it' before erasing.
-                          // erase() does not cause rehash and thus will not invalidate
-                          // any other iterator apart from the one being erased.
-                          table.erase(it++);
-                      } else {
-                          ++it;
-                      }
-                  }
-
-                  // LCOV_EXCL_START
-                  // Check the table size against the max allowed size.
-                  if (obake_unlikely(table.size() > mts)) {
-                      obake_throw(::std::overflow_error, "The homomorphic multithreaded multiplication of two "
-                                                         "polynomials resulted in a table whose size ("
-                                                             + ::obake::detail::to_string(table.size())
-                                                             + ") is larger than the maximum allowed value ("
-                                                             + ::obake::detail::to_string(mts) + ")");
-                  }
-                  // LCOV_EXCL_STOP
-              }
-          };
-
-    // The parallel multiplication functor for the dense case.
-    auto dense_par_functor
-        = [&v1, &v2, &vseg1, &vseg2, nsegs, &retval, &ss, mts = retval._get_max_table_size(), &compute_end_idx2
+    // Wide accumulation setup (see poly_mul_wacc).
+    // When enabled, the products for a segment are accumulated
+    // into a vector of wide accumulators, which are then normalised
+    // into the segment table in retval (see poly_mul_wacc_set_idx()).
+    constexpr auto wacc = detail::poly_mul_wacc_enabled<ret_cf_t, cf1_t, cf2_t>;
+
+    // The estimated number of terms per segment, used to
+    // reserve space in the vectors of wide accumulators.
+    const auto est_seg_nterms = ::obake::safe_cast<::std::size_t>(est_nterms >> log2_nsegs);
+
+    // Pack the data needed by the segment
+    // multiplication helpers.
+    const detail::poly_mul_mt_hm_data<remove_cvref_t<decltype(v1)>, remove_cvref_t<decltype(v2)>,
+                                      remove_cvref_t<decltype(vseg1)>, remove_cvref_t<decltype(vseg2)>,
+                                      decltype(compute_end_idx2), s_size_t>
+        mdata{v1,
+              v2,
+              vseg1,
+              vseg2,
+              compute_end_idx2,
+              ss,
+              log2_nsegs,
+              nsegs,
+              sq,
+              // NOTE: both vseg1 and vseg2 are in dense form
+              // if they contain a range for every segment.
+              vseg1.size() == nsegs && vseg2.size() == nsegs
 #if !defined(NDEBUG)
-           ,
-           log2_nsegs, &n_mults
+              ,
+              &n_mults
 #endif
-    ](const auto &range) {
-              // Cache the pointers to the terms data.
-              // NOTE: doing it here rather than in the lambda
-              // capture seems to help performance on GCC.
-              auto vptr1 = v1.data();
-              auto vptr2 = v2.data();
-
-              // Temporary variable used in monomial multiplication.
-              ret_key_t tmp_key(ss);
-
-              for (auto seg_idx = range.begin(); seg_idx != range.end(); ++seg_idx) {
-                  // Get a reference to the current table in retval.
-                  auto &table = retval._get_s_table()[seg_idx];
-
-                  // The objective here is to perform all term-by-term multiplications
-                  // whose results end up in the current table (i.e., the table in retval
-                  // at index seg_idx). Due to homomorphic hashing, we know that,
-                  // given two indices i and j in vseg1 and vseg2,
-                  // the terms generated by the multiplication of the
-                  // ranges vseg1[i] and vseg2[j] end up at the bucket
-                  // (i + j) % nsegs in retval. Thus, we need to select
-                  // all i, j pairs such that (i + j) % nsegs == seg_idx.
-                  for (s_size_t i = 0; i < nsegs; ++i) {
-                      const auto j = seg_idx >= i ? (seg_idx - i) : (nsegs - i + seg_idx);
-                      assert(j < vseg2.size());
-
-                      // Fetch the corresponding ranges.
-                      const auto [r1_start, r1_end, bi1] = vseg1[i];
-                      const auto &r2 = vseg2[j];
-                      const auto [r2_start, r2_end, bi2] = r2;
-                      ::obake::detail::ignore(r2_end);
-
-                      // NOTE: in the dense case, the bucket
-                      // indices must be equal to i/j.
-                      assert(bi1 == i);
-                      assert(bi2 == j);
-                      ::obake::detail::ignore(bi1);
-                      ::obake::detail::ignore(bi2);
-
-                      // The O(N**2) multiplication loop over the ranges.
-                      for (auto idx1 = r1_start; idx1 != r1_end; ++idx1) {
-                          const auto &[k1, c1] = *(vptr1 + idx1);
-
-                          // Compute the end index in the second range
-                          // for the current value of idx1.
-                          const auto idx_end2 = compute_end_idx2(idx1, r2);
-
-                          // In the truncated case, check if the end index
-                          // coincides with the begin index. In such a case,
-                          // we can skip all the remaining indices in r1 because
-                          // none of them will ever generate a term which respects
-                          // the truncation limits (both r1 and r2 are sorted
-                          // according to the degree).
-                          if (sizeof...(Args) > 0u && idx_end2 == r2_start) {
-                              break;
-                          }
-
-                          const auto end2 = vptr2 + idx_end2;
-                          for (auto ptr2 = vptr2 + r2_start; ptr2 != end2; ++ptr2) {
-                              const auto &[k2, c2] = *ptr2;
-
-                              // Do the monomial multiplication.
-                              ::obake::monomial_mul(tmp_key, k1, k2, ss);
-
-                              // Check that the result ends up in the correct bucket.
-                              assert(::obake::hash(tmp_key) % (s_size_t(1) << log2_nsegs) == seg_idx);
-
-                              // Attempt the insertion.
-                              // NOTE: this will attempt to insert a term with a default-constructed
-                              // coefficient. This is wasteful, it would be better to directly
-                              // construct the coefficient product only if the insertion actually
-                              // takes place (using a lazy multiplication approach).
-                              // See the commit 3e334f560d5844f5f2d8face05aa58be21649ff8
-                              // for an implementation of the lazy multiplication approach.
-                              // NOTE: the coefficient concept demands default constructibility,
-                              // thus we can always emplace without arguments for the coefficient.
-                              const auto res = table.try_emplace(tmp_key);
-
-                              // NOTE: optimise with likely/unlikely here?
-                              if (res.second) {
-                                  // NOTE: coefficients are guaranteed to be move-assignable.
-                                  res.first->second = c1 * c2;
-                              } else {
-                                  // The insertion failed, a term with the same monomial
-                                  // exists already. Accumulate c1*c2 into the
-                                  // existing coefficient.
-                                  // NOTE: do it with fma3(), if possible.
-                                  if constexpr (is_mult_addable_v<ret_cf_t &, const cf1_t &, const cf2_t &>) {
-                                      ::obake::fma3(res.first->second, c1, c2);
-                                  } else {
-                                      res.first->second += c1 * c2;
-                                  }
-                              }
+        };
 
-#if !defined(NDEBUG)
-                              ++n_mults;
-#endif
-                          }
-                      }
-                  }
-
-                  // Locate and erase terms with zero coefficients
-                  // in the current table.
-                  const auto it_f = table.end();
-                  for (auto it = table.begin(); it != it_f;) {
-                      if (obake_unlikely(::obake::is_zero(::std::as_const(it->second)))) {
-                          // NOTE: increase 'it' before erasing.
-                          // erase() does not cause rehash and thus will not invalidate
-                          // any other iterator apart from the one being erased.
-                          table.erase(it++);
-                      } else {
-                          ++it;
-                      }
-                  }
-
-                  // LCOV_EXCL_START
-                  // Check the table size against the max allowed size.
-                  if (obake_unlikely(table.size() > mts)) {
-                      obake_throw(::std::overflow_error, "The homomorphic multithreaded multiplication of two "
-                                                         "polynomials resulted in a table whose size ("
-                                                             + ::obake::detail::to_string(table.size())
-                                                             + ") is larger than the maximum allowed value ("
-                                                             + ::obake::detail::to_string(mts) + ")");
-                  }
-                  // LCOV_EXCL_STOP
-              }
-          };
+    // Helper to compute the segments in the [begin, end) range.
+    auto compute_segs = [&retval, &mdata, est_seg_nterms](s_size_t begin, s_size_t end) {
+        detail::poly_mul_mt_hm_compute_segs<wacc, (sizeof...(Args) > 0u)>(retval, mdata, begin, end, est_seg_nterms);
+    };
 
     try {
-        if (vseg1.size() == nsegs && vseg2.size() == nsegs) {
-            // Both vseg1 and vseg2 are represented in dense
-            // form, run the dense functor.
-            ::tbb::parallel_for(::tbb::blocked_range<s_size_t>(0, nsegs), dense_par_functor);
+        if constexpr (in_mem) {
+            ::obake::detail::ignore(sink);
+
+            compute_segs(0, nsegs);
         } else {
-            // At least one of vseg1/vseg2 are represented
-            // in sparse form, run the sparse functor.
-            ::tbb::parallel_for(::tbb::blocked_range<s_size_t>(0, nsegs), sparse_par_functor);
+            // Compute the segments in batches, handing
+            // each completed batch over to the sink.
+            const s_size_t batch_size = sink.batch_size(nsegs, est_nterms * avg_term_size);
+            assert(batch_size > 0u);
+
+            for (s_size_t begin = 0; begin < nsegs;) {
+                const auto end = static_cast<s_size_t>(begin + ::std::min(batch_size, nsegs - begin));
+
+                compute_segs(begin, end);
+                sink.consume(retval, begin, end);
+
+                begin = end;
+            }
         }
 
 #if !defined(NDEBUG)
         // Verify the number of term multiplications we performed,
         // but only if we are in non-truncated mode.
         if constexpr (sizeof...(args) == 0u) {
-            assert(n_mults.load()
-                   == static_cast<unsigned long long>(x.size()) * static_cast<unsigned long long>(y.size()));
+            const auto n1 = static_cast<unsigned long long>(x.size()), n2 = static_cast<unsigned long long>(y.size());
+
+            assert(n_mults.load() == (sq ? n1 * (n1 + 1u) / 2u : n1 * n2));
         }
 #endif
         // LCOV_EXCL_START
@@ -1581,6 +4493,14 @@ inline void poly_mul_impl_mt_hm(Ret &retval, const T &x, const U &y, const Args
     }
 }
 
+// The multi-threaded homomorphic implementation, in-memory mode.
+template <bool OCheck = true, typename Ret, typename TO, typename UO, typename... Args>
+inline void poly_mul_impl_mt_hm(Ret &retval, const TO &xo, const UO &yo, const Args &...args)
+{
+    poly_mul_mt_hm_null_sink sink;
+    detail::poly_mul_impl_mt_hm_sink<OCheck>(retval, sink, xo, yo, args...);
+}
+
 #if defined(_MSC_VER) && !defined(__clang__)
 
 #pragma warning(pop)
@@ -1596,29 +4516,21 @@ struct poly_mul_impl_ptr_extractor {
     }
 };
 
-// Simple poly mult implementation: just multiply
-// term by term, no parallelisation, no segmentation,
-// no copying of the operands, etc.
-template <typename Ret, typename T, typename U, typename... Args>
-inline void poly_mul_impl_simple(Ret &retval, const T &x, const U &y, const Args &...args)
+// Helper to prepare the operands for the term-by-term
+// multiplication engines (simple and MT generic). It will return
+// a tuple containing the vectors of pointers to the terms
+// of x and y and the functor used to compute the upper limit
+// of the multiplication range in y for a given term of x.
+// In truncated mode, the vectors of pointers will be sorted
+// according to the degree of the terms. In pruned mode (in which
+// args is an absolute coefficient threshold), the vectors of
+// pointers will be sorted in descending order of the magnitude
+// of the coefficients. If OCheck is false, the monomial overflow
+// check is skipped (the caller must have performed it already).
+template <bool OCheck, typename T, typename U, typename... Args>
+inline auto poly_mul_impl_prepare_terms(const T &x, const U &y, const symbol_set &ss, const Args &...args)
 {
-    using ret_key_t = series_key_t<Ret>;
-    using ret_cf_t = series_cf_t<Ret>;
-    using cf1_t = series_cf_t<T>;
-    using cf2_t = series_cf_t<U>;
-
-    // Preconditions.
     static_assert(sizeof...(args) <= 2u);
-    assert(!x.empty());
-    assert(!y.empty());
-    assert(x.size() <= y.size());
-    assert(retval.get_symbol_set_fw() == x.get_symbol_set_fw());
-    assert(retval.get_symbol_set_fw() == y.get_symbol_set_fw());
-    assert(retval.empty());
-    assert(retval._get_s_table().size() == 1u);
-
-    // Cache the symbol set.
-    const auto &ss = retval.get_symbol_set();
 
     // Construct the vectors of pointer to the terms.
     ::std::vector<const series_term_t<T> *> v1(
@@ -1635,7 +4547,7 @@ inline void poly_mul_impl_simple(Ret &retval, const T &x, const U &y, const Args
     const auto r2
         = ::obake::detail::make_range(::boost::make_transform_iterator(v2.cbegin(), poly_term_key_ref_extractor{}),
                                       ::boost::make_transform_iterator(v2.cend(), poly_term_key_ref_extractor{}));
-    if constexpr (are_overflow_testable_monomial_ranges_v<decltype(r1) &, decltype(r2) &>) {
+    if constexpr (OCheck && are_overflow_testable_monomial_ranges_v<decltype(r1) &, decltype(r2) &>) {
         // Do the monomial overflow checking.
         if (obake_unlikely(!::obake::monomial_range_overflow_check(r1, r2, ss))) {
             obake_throw(
@@ -1660,6 +4572,44 @@ inline void poly_mul_impl_simple(Ret &retval, const T &x, const U &y, const Args
             ::obake::detail::ignore(v1, ss);
 
             return [v2_size = v2.size()](const auto &) { return v2_size; };
+        } else if constexpr (poly_mul_is_pruned<Args...>) {
+            ::obake::detail::ignore(ss);
+
+            const auto &thr = ::std::get<0>(::std::forward_as_tuple(args...));
+            assert(!thr.relative);
+
+            // Helper to sort v in descending order of the magnitude
+            // of the coefficients, and to return the sorted
+            // vector of magnitudes.
+            auto sorter = [](auto &v) {
+                ::std::sort(v.begin(), v.end(), [](const auto &p1, const auto &p2) {
+                    return detail::poly_mul_cf_mag(p1->second) > detail::poly_mul_cf_mag(p2->second);
+                });
+
+                ::std::vector<double> vm;
+                vm.reserve(v.size());
+                for (const auto &p : v) {
+                    vm.push_back(detail::poly_mul_cf_mag(p->second));
+                }
+
+                return vm;
+            };
+
+            return [vm1 = sorter(v1), vm2 = sorter(v2), thr_value = thr.value](const auto &i) {
+                using idx_t = remove_cvref_t<decltype(i)>;
+
+                const auto m_i = vm1[i];
+
+                // Find the first term in the second series such
+                // that m_i * m_j < thr_value. Because the magnitudes
+                // are sorted in descending order, all the following
+                // terms will also produce products below the threshold.
+                const auto it = ::std::partition_point(vm2.cbegin(), vm2.cend(), [m_i, thr_value](double m_j) {
+                    return !(m_i * m_j < thr_value);
+                });
+
+                return static_cast<idx_t>(it - vm2.cbegin());
+            };
         } else {
             // Helper that will:
             //
@@ -1678,23 +4628,11 @@ inline void poly_mul_impl_simple(Ret &retval, const T &x, const U &y, const Args
 
                 // Compute the vector of degrees.
                 auto vd = [&v, &ss, &args...]() {
-                    if constexpr (sizeof...(args) == 1u) {
-                        // Total degree.
-                        ::obake::detail::ignore(args...);
-
-                        // NOTE: in the make_degree_vector() helper we need
-                        // to compute the size of v via iterator differences.
-                        ::obake::detail::container_it_diff_check(v);
-
-                        return customisation::internal::make_degree_vector<s_t>(v.cbegin(), v.cend(), ss, false);
-                    } else {
-                        // NOTE: in the make_p_degree_vector() helper we need
-                        // to compute the size of v via iterator differences.
-                        ::obake::detail::container_it_diff_check(v);
+                    // NOTE: in the make_(p_/w_)degree_vector() helpers we need
+                    // to compute the size of v via iterator differences.
+                    ::obake::detail::container_it_diff_check(v);
 
-                        return customisation::internal::make_p_degree_vector<s_t>(
-                            v.cbegin(), v.cend(), ss, ::std::get<1>(::std::forward_as_tuple(args...)), false);
-                    }
+                    return detail::poly_mul_impl_make_degree_vector<s_t>(v.cbegin(), v.cend(), ss, false, args...);
                 }();
 
                 // Ensure that the size of vd is representable by the
@@ -1704,7 +4642,7 @@ inline void poly_mul_impl_simple(Ret &retval, const T &x, const U &y, const Args
                 ::obake::detail::container_it_diff_check(::std::as_const(vd));
 
                 // Create a vector of indices into vd.
-                ::std::vector<decltype(vd.size())> vidx;
+                ::obake::detail::dinit_vector<decltype(vd.size())> vidx;
                 vidx.resize(::obake::safe_cast<decltype(vidx.size())>(vd.size()));
                 ::std::iota(vidx.begin(), vidx.end(), decltype(vd.size())(0));
 
@@ -1739,6 +4677,14 @@ inline void poly_mul_impl_simple(Ret &retval, const T &x, const U &y, const Args
                     assert(::std::equal(vd.begin(), vd.end(),
                                         ::boost::make_transform_iterator(v.cbegin(), d_impl::d_extractor<s_t>{&ss}),
                                         [](const auto &a, const auto &b) { return !(a < b) && !(b < a); }));
+                } else if constexpr (poly_mul_is_w_truncated<Args...>) {
+                    const auto groups
+                        = detail::poly_w_degree_groups(::std::get<1>(::std::forward_as_tuple(args...)), ss);
+
+                    assert(::std::equal(
+                        vd.begin(), vd.end(),
+                        ::boost::make_transform_iterator(v.cbegin(), poly_w_degree_extractor{&groups, &ss}),
+                        [](const auto &a, const auto &b) { return a == b; }));
                 } else {
                     using d_impl = customisation::internal::series_default_p_degree_impl;
 
@@ -1795,6 +4741,40 @@ inline void poly_mul_impl_simple(Ret &retval, const T &x, const U &y, const Args
         }
     }();
 
+    return ::std::make_tuple(::std::move(v1), ::std::move(v2), ::std::move(compute_j_end));
+}
+
+// Simple poly mult implementation: just multiply
+// term by term, no parallelisation, no segmentation,
+// no copying of the operands, etc. If OCheck is false, the monomial
+// overflow check is skipped (the caller must have performed it already).
+template <bool OCheck = true, typename Ret, typename T, typename U, typename... Args>
+inline void poly_mul_impl_simple(Ret &retval, const T &x, const U &y, const Args &...args)
+{
+    using ret_key_t = series_key_t<Ret>;
+    using ret_cf_t = series_cf_t<Ret>;
+    using cf1_t = series_cf_t<T>;
+    using cf2_t = series_cf_t<U>;
+
+    // Preconditions.
+    static_assert(sizeof...(args) <= 2u);
+    assert(!x.empty());
+    assert(!y.empty());
+    assert(x.size() <= y.size());
+    assert(retval.get_symbol_set_fw() == x.get_symbol_set_fw());
+    assert(retval.get_symbol_set_fw() == y.get_symbol_set_fw());
+    assert(retval.empty());
+    assert(retval._get_s_table().size() == 1u);
+
+    // Cache the symbol set.
+    const auto &ss = retval.get_symbol_set();
+
+    // Prepare the operands.
+    auto prep = detail::poly_mul_impl_prepare_terms<OCheck>(x, y, ss, args...);
+    const auto &v1 = ::std::get<0>(prep);
+    const auto &v2 = ::std::get<1>(prep);
+    const auto &compute_j_end = ::std::get<2>(prep);
+
     // Proceed with the multiplication.
     auto &tab = retval._get_s_table()[0];
 
@@ -1802,48 +4782,101 @@ inline void poly_mul_impl_simple(Ret &retval, const T &x, const U &y, const Args
         // Temporary variable used in monomial multiplication.
         ret_key_t tmp_key(ss);
 
-        const auto v1_size = v1.size();
-        for (decltype(v1.size()) i = 0; i < v1_size; ++i) {
-            const auto &t1 = v1[i];
-            const auto &k1 = t1->first;
-            const auto &c1 = t1->second;
-
-            // Get the upper limit of the multiplication
-            // range in v2.
-            const auto j_end = compute_j_end(i);
-            if (sizeof...(Args) != 0u && j_end == 0u) {
-                // In truncated mode, if j_end is zero, we don't need to perform
-                // any more term multiplications as the remaining
-                // ones will all end up above the truncation limit.
-                break;
+        // Helper to accumulate the product of the terms
+        // (k1, c1) and (k2, c2) into tab.
+        auto acc_term = [&tab, &tmp_key, &ss](const auto &k1, const auto &c1, const auto &k2, const auto &c2) {
+            // Multiply the monomial.
+            ::obake::monomial_mul(tmp_key, k1, k2, ss);
+
+            // Try to insert the new term.
+            // NOTE: see the explanation in the other
+            // multiplication function about why we adopt
+            // this scheme (i.e., default-emplace the coefficient).
+            const auto res = tab.try_emplace(tmp_key);
+
+            // NOTE: optimise with likely/unlikely here?
+            if (res.second) {
+                res.first->second = c1 * c2;
+            } else {
+                // The insertion failed, accumulate c1*c2 into the
+                // existing coefficient.
+                // NOTE: do it with fma3(), if possible.
+                if constexpr (is_mult_addable_v<ret_cf_t &, const cf1_t &, const cf2_t &>) {
+                    ::obake::fma3(res.first->second, c1, c2);
+                } else {
+                    res.first->second += c1 * c2;
+                }
             }
+        };
 
-            for (decltype(v2.size()) j = 0; j < j_end; ++j) {
-                const auto &t2 = v2[j];
-                const auto &c2 = t2->second;
+        const auto v1_size = v1.size();
 
-                // Multiply the monomial.
-                ::obake::monomial_mul(tmp_key, k1, t2->first, ss);
+        // Flag to signal that the multiplication
+        // was performed via the squaring kernel.
+        bool sq_done = false;
+
+        if constexpr (::std::is_same_v<T, U>) {
+            if (detail::poly_mul_impl_is_square(x, y)) {
+                // Squaring: each off-diagonal product x_i*x_j = x_j*x_i is
+                // computed only once, using the doubled coefficients of x_j.
+                // NOTE: v1 and v2 contain the same terms in the same
+                // order (in truncated mode, they have been sorted in the same way),
+                // thus we can use v1 throughout.
+                ::std::vector<cf1_t> c2d;
+                c2d.reserve(v1.size());
+                for (const auto &t : v1) {
+                    c2d.emplace_back(t->second);
+                    c2d.back() += t->second;
+                }
 
-                // Try to insert the new term.
-                // NOTE: see the explanation in the other
-                // multiplication function about why we adopt
-                // this scheme (i.e., default-emplace the coefficient).
-                const auto res = tab.try_emplace(tmp_key);
+                for (decltype(v1.size()) i = 0; i < v1_size; ++i) {
+                    const auto &k1 = v1[i]->first;
+                    const auto &c1 = v1[i]->second;
+
+                    // Get the upper limit of the multiplication
+                    // range in v1.
+                    const auto j_end = compute_j_end(i);
+                    if (sizeof...(Args) != 0u && j_end <= i) {
+                        // In truncated/pruned mode, if j_end does not go past the diagonal,
+                        // the following values of i will also not, because the
+                        // terms are sorted according to the degree (or to the
+                        // magnitude of the coefficients).
+                        break;
+                    }
 
-                // NOTE: optimise with likely/unlikely here?
-                if (res.second) {
-                    res.first->second = c1 * c2;
-                } else {
-                    // The insertion failed, accumulate c1*c2 into the
-                    // existing coefficient.
-                    // NOTE: do it with fma3(), if possible.
-                    if constexpr (is_mult_addable_v<ret_cf_t &, const cf1_t &, const cf2_t &>) {
-                        ::obake::fma3(res.first->second, c1, c2);
-                    } else {
-                        res.first->second += c1 * c2;
+                    // The diagonal term.
+                    acc_term(k1, c1, k1, c1);
+
+                    for (auto j = i + 1u; j < j_end; ++j) {
+                        acc_term(k1, c1, v1[j]->first, c2d[j]);
                     }
                 }
+
+                sq_done = true;
+            }
+        }
+
+        if (!sq_done) {
+            for (decltype(v1.size()) i = 0; i < v1_size; ++i) {
+                const auto &t1 = v1[i];
+                const auto &k1 = t1->first;
+                const auto &c1 = t1->second;
+
+                // Get the upper limit of the multiplication
+                // range in v2.
+                const auto j_end = compute_j_end(i);
+                if (sizeof...(Args) != 0u && j_end == 0u) {
+                    // In truncated mode, if j_end is zero, we don't need to perform
+                    // any more term multiplications as the remaining
+                    // ones will all end up above the truncation limit.
+                    break;
+                }
+
+                for (decltype(v2.size()) j = 0; j < j_end; ++j) {
+                    const auto &t2 = v2[j];
+
+                    acc_term(k1, c1, t2->first, t2->second);
+                }
             }
         }
 
@@ -1861,26 +4894,534 @@ inline void poly_mul_impl_simple(Ret &retval, const T &x, const U &y, const Args
             }
         }
 
-        // NOTE: no need to check the table size, as retval
-        // is not segmented.
-        // LCOV_EXCL_START
-    } catch (...) {
-        // retval may now contain zero coefficients.
-        // Make sure to clear it before rethrowing.
-        tab.clear();
-        throw;
-        // LCOV_EXCL_STOP
+        // NOTE: no need to check the table size, as retval
+        // is not segmented.
+        // LCOV_EXCL_START
+    } catch (...) {
+        // retval may now contain zero coefficients.
+        // Make sure to clear it before rethrowing.
+        tab.clear();
+        throw;
+        // LCOV_EXCL_STOP
+    }
+}
+
+// Number of buffered term products (per segment)
+// after which the buffer is flushed into retval
+// in the MT generic multiplication engine.
+inline constexpr ::std::size_t poly_mul_mt_generic_buf_size = 128;
+
+// Multithreaded generic poly mult implementation.
+//
+// This engine does not require homomorphic hashing or the
+// ability to measure the byte size of the operands. The rows
+// of the term-by-term product (i.e., the terms of x) are distributed
+// among the threads. The segment of retval into which a term
+// of the product must be inserted is determined from the hash
+// of its monomial. Each thread accumulates the products into thread-local
+// per-segment buffers, which are flushed into the segments of retval
+// when full (and at the end). The segments are protected by an array of spinlocks,
+// so that different threads can write concurrently into different
+// segments.
+//
+// If OCheck is false, the monomial overflow check is skipped
+// (the caller must have performed it already).
+template <bool OCheck = true, typename Ret, typename T, typename U, typename... Args>
+inline void poly_mul_impl_mt_generic(Ret &retval, const T &x, const U &y, const Args &...args)
+{
+    using ret_key_t = series_key_t<Ret>;
+    using ret_cf_t = series_cf_t<Ret>;
+    using s_size_t = decltype(retval._get_s_table().size());
+
+    // Preconditions.
+    static_assert(sizeof...(args) <= 2u);
+    assert(!x.empty());
+    assert(!y.empty());
+    assert(x.size() <= y.size());
+    assert(retval.get_symbol_set_fw() == x.get_symbol_set_fw());
+    assert(retval.get_symbol_set_fw() == y.get_symbol_set_fw());
+    assert(retval.empty());
+    assert(retval._get_s_table().size() == 1u);
+
+    // Cache the symbol set.
+    const auto &ss = retval.get_symbol_set();
+
+    // Prepare the operands.
+    auto prep = detail::poly_mul_impl_prepare_terms<OCheck>(x, y, ss, args...);
+    const auto &v1 = ::std::get<0>(prep);
+    const auto &v2 = ::std::get<1>(prep);
+    const auto &compute_j_end = ::std::get<2>(prep);
+
+    // Setup the segmentation of retval. In absence of
+    // information on the byte size of the terms, use a number
+    // of segments proportional to the number of cores,
+    // in order to keep the lock contention low.
+    // NOTE: the number of segments must not exceed
+    // the max allowed value for the return polynomial type.
+    const auto log2_nsegs
+        = ::std::min(::obake::safe_cast<unsigned>(::mppp::integer<1>{::obake::detail::hc()}.nbits()) + 4u,
+                     polynomial<ret_key_t, ret_cf_t>::get_max_s_size());
+    retval.set_n_segments(log2_nsegs);
+
+    // Cache the actual number of segments.
+    const auto nsegs = s_size_t(1) << log2_nsegs;
+
+    // The spinlocks protecting the segments of retval.
+    ::obake::detail::atomic_flag_array sl_array(::obake::safe_cast<::std::size_t>(nsegs));
+
+    // The thread-local data: a temporary variable used in monomial
+    // multiplication and the per-segment buffers of term products.
+    // NOTE: the buffers are kept across the ranges processed by
+    // the same thread, and they are flushed at the end.
+    using bufs_t = ::std::vector<::std::vector<::std::pair<ret_key_t, ret_cf_t>>>;
+    using local_t = ::std::pair<ret_key_t, bufs_t>;
+    ::tbb::enumerable_thread_specific<local_t> ets([&ss, nsegs]() {
+        return local_t(ret_key_t(ss), bufs_t(::obake::safe_cast<typename bufs_t::size_type>(nsegs)));
+    });
+
+    // Helper to flush the buffer buf of the segment
+    // seg_idx into retval.
+    auto flush = [&retval, &sl_array](auto &buf, const auto &seg_idx) {
+        if (buf.empty()) {
+            // Nothing to do, don't lock the segment.
+            return;
+        }
+
+        auto &table = retval._get_s_table()[seg_idx];
+
+        {
+            // Lock the segment.
+            ::obake::detail::atomic_lock_guard lock(sl_array[static_cast<::std::size_t>(seg_idx)]);
+
+            for (auto &p : buf) {
+                const auto res = table.try_emplace(::std::move(p.first));
+                if (res.second) {
+                    res.first->second = ::std::move(p.second);
+                } else {
+                    res.first->second += ::std::move(p.second);
+                }
+            }
+        }
+
+        buf.clear();
+    };
+
+    try {
+        ::tbb::parallel_for(::tbb::blocked_range<decltype(v1.size())>(0, v1.size()), [&v1, &v2, &compute_j_end, &ss,
+                                                                                        nsegs, &ets,
+                                                                                        &flush](const auto &range) {
+            // NOTE: the multiplication of the coefficients (or of the
+            // monomials) might spawn TBB tasks. Isolate the body, so that
+            // this thread cannot pick up another range of this loop (which
+            // would use the same thread-local data) while waiting for them.
+            ::tbb::this_task_arena::isolate([&]() {
+                auto &[tmp_key, bufs] = ets.local();
+
+                for (auto i = range.begin(); i != range.end(); ++i) {
+                    const auto &t1 = v1[i];
+                    const auto &k1 = t1->first;
+                    const auto &c1 = t1->second;
+
+                    // Get the upper limit of the multiplication
+                    // range in v2.
+                    const auto j_end = compute_j_end(i);
+                    if (sizeof...(Args) != 0u && j_end == 0u) {
+                        // In truncated mode, if j_end is zero, we don't need to perform
+                        // any more term multiplications in this range, as the remaining
+                        // ones will all end up above the truncation limit.
+                        break;
+                    }
+
+                    for (decltype(v2.size()) j = 0; j < j_end; ++j) {
+                        const auto &t2 = v2[j];
+
+                        // Multiply the monomial.
+                        ::obake::monomial_mul(tmp_key, k1, t2->first, ss);
+
+                        // Buffer the term product into the
+                        // segment it belongs to.
+                        const auto seg_idx = static_cast<s_size_t>(::obake::hash(tmp_key) % nsegs);
+                        auto &buf = bufs[static_cast<decltype(bufs.size())>(seg_idx)];
+                        buf.emplace_back(tmp_key, c1 * t2->second);
+
+                        if (buf.size() == poly_mul_mt_generic_buf_size) {
+                            flush(buf, seg_idx);
+                        }
+                    }
+                }
+            });
+        });
+
+        // Flush the remaining buffered terms.
+        // NOTE: isolate the flushes as well, so that a thread holding
+        // the lock on a segment cannot pick up another flush.
+        ::tbb::parallel_for(ets.range(), [nsegs, &flush](const auto &range) {
+            ::tbb::this_task_arena::isolate([&]() {
+                for (auto &local : range) {
+                    auto &bufs = local.second;
+
+                    for (s_size_t seg_idx = 0; seg_idx < nsegs; ++seg_idx) {
+                        flush(bufs[static_cast<decltype(bufs.size())>(seg_idx)], seg_idx);
+                    }
+                }
+            });
+        });
+
+        // Determine and remove the keys whose coefficients are zero
+        // in the return value, and check the table sizes.
+        ::tbb::parallel_for(::tbb::blocked_range<s_size_t>(0, nsegs), [&retval, mts = retval._get_max_table_size()](
+                                                                          const auto &range) {
+            for (auto seg_idx = range.begin(); seg_idx != range.end(); ++seg_idx) {
+                auto &table = retval._get_s_table()[seg_idx];
+
+                const auto it_f = table.end();
+                for (auto it = table.begin(); it != it_f;) {
+                    if (obake_unlikely(::obake::is_zero(::std::as_const(it->second)))) {
+                        // NOTE: increase 'it' before erasing.
+                        table.erase(it++);
+                    } else {
+                        ++it;
+                    }
+                }
+
+                // LCOV_EXCL_START
+                // Check the table size against the max allowed size.
+                if (obake_unlikely(table.size() > mts)) {
+                    obake_throw(::std::overflow_error, "The generic multithreaded multiplication of two "
+                                                       "polynomials resulted in a table whose size ("
+                                                           + ::obake::detail::to_string(table.size())
+                                                           + ") is larger than the maximum allowed value ("
+                                                           + ::obake::detail::to_string(mts) + ")");
+                }
+                // LCOV_EXCL_STOP
+            }
+        });
+        // LCOV_EXCL_START
+    } catch (...) {
+        // retval may now contain zero coefficients
+        // or incomplete data. Make sure to clear it
+        // before rethrowing.
+        retval.clear_terms();
+        throw;
+        // LCOV_EXCL_STOP
+    }
+}
+
+// Heap-based multiplication engine.
+//
+// The terms of the input series are sorted according to the
+// values of their packed monomials. Because the value of the product
+// of two packed monomials is the sum of the values of the factors,
+// the terms of the product can be generated in ascending monomial
+// order by merging the rows v1[i]*v2[0], v1[i]*v2[1], ... via a binary
+// heap. Terms with the same monomial are thus generated consecutively
+// and they can be accumulated in place into a compact, ordered vector
+// of terms, without any intermediate hash table. At the end, the
+// terms are inserted into a segmented table sized exactly for them.
+// This keeps the peak memory usage low for sparse products
+// in which many term-by-term products collapse.
+//
+// In the parallel variant, the range of monomials of the product
+// is split into nparts intervals (via the quantiles of a random sample
+// of the monomials of the product), and each interval is processed
+// independently. If nparts is zero, it will be chosen automatically.
+//
+// If OCheck is false, the monomial overflow check is skipped
+// (the caller must have performed it already).
+template <bool OCheck = true, typename Ret, typename T, typename U>
+inline void poly_mul_impl_heap(Ret &retval, const T &x, const U &y, unsigned nparts = 0)
+{
+    using cf1_t = series_cf_t<T>;
+    using cf2_t = series_cf_t<U>;
+    using ret_key_t = series_key_t<Ret>;
+    using ret_cf_t = series_cf_t<Ret>;
+    using value_type = typename ret_key_t::value_type;
+    using int_t = ::mppp::integer<1>;
+
+    // Preconditions.
+    static_assert(detail::same_packed_monomial_v<ret_key_t, ret_key_t>);
+    assert(!x.empty());
+    assert(!y.empty());
+    assert(x.size() <= y.size());
+    assert(retval.get_symbol_set_fw() == x.get_symbol_set_fw());
+    assert(retval.get_symbol_set_fw() == y.get_symbol_set_fw());
+    assert(retval.empty());
+    assert(retval._get_s_table().size() == 1u);
+
+    // Cache the symbol set.
+    const auto &ss = retval.get_symbol_set();
+
+    // Create vectors containing copies of
+    // the input terms.
+    auto v1 = detail::poly_mul_impl_make_term_vector(x);
+    auto v2 = detail::poly_mul_impl_make_term_vector(y);
+
+    // Do the monomial overflow checking.
+    // NOTE: after the check, the value of any product
+    // monomial (i.e., the sum of the values of the factors)
+    // is guaranteed to be representable by value_type.
+    if constexpr (OCheck) {
+        const auto r1 = ::obake::detail::make_range(
+            ::boost::make_transform_iterator(v1.cbegin(), poly_term_key_ref_extractor{}),
+            ::boost::make_transform_iterator(v1.cend(), poly_term_key_ref_extractor{}));
+        const auto r2 = ::obake::detail::make_range(
+            ::boost::make_transform_iterator(v2.cbegin(), poly_term_key_ref_extractor{}),
+            ::boost::make_transform_iterator(v2.cend(), poly_term_key_ref_extractor{}));
+        if (obake_unlikely(!::obake::monomial_range_overflow_check(r1, r2, ss))) {
+            obake_throw(::std::overflow_error, "An overflow in the monomial exponents was detected while "
+                                               "attempting to multiply two polynomials");
+        }
+    }
+
+    // Sort the input terms according to the values of the monomials.
+    auto v_sorter = [](const auto &p1, const auto &p2) { return p1.first.get_value() < p2.first.get_value(); };
+    ::tbb::parallel_invoke([&v1, &v_sorter]() { ::tbb::parallel_sort(v1.begin(), v1.end(), v_sorter); },
+                           [&v2, &v_sorter]() { ::tbb::parallel_sort(v2.begin(), v2.end(), v_sorter); });
+
+    if (nparts == 0u) {
+        // NOTE: for small multiplications, the partitioning
+        // overhead is not worth it. Otherwise, create a few parts
+        // per thread for load balancing purposes.
+        nparts = (::obake::detail::hc() == 1u || int_t{v1.size()} * v2.size() < 100000)
+                     ? 1u
+                     : ::obake::safe_cast<unsigned>(int_t{::obake::detail::hc()} * 4u);
+    }
+
+    // Compute the splitters of the intervals of monomials
+    // of the product: part p contains the monomials in the
+    // [splitters[p - 1], splitters[p]) range.
+    ::std::vector<value_type> splitters;
+    if (nparts > 1u) {
+        // Init a xoroshiro rng, with some compile-time
+        // randomness mixed in with the sizes of v1/v2.
+        constexpr ::std::uint64_t s1 = 12394187629102367851ull;
+        constexpr ::std::uint64_t s2 = 10811208723487451637ull;
+        ::obake::detail::xoroshiro128_plus rng{static_cast<::std::uint64_t>(s1 + v1.size()),
+                                               static_cast<::std::uint64_t>(s2 + v2.size())};
+        ::std::uniform_int_distribution<decltype(v1.size())> dist1(0, v1.size() - 1u);
+        ::std::uniform_int_distribution<decltype(v2.size())> dist2(0, v2.size() - 1u);
+
+        // Sample the monomials of the product.
+        const auto nsamples = ::obake::safe_cast<::std::size_t>(int_t{nparts} * 32u);
+        ::std::vector<value_type> samples;
+        samples.reserve(nsamples);
+        for (::std::size_t i = 0; i < nsamples; ++i) {
+            samples.push_back(
+                static_cast<value_type>(v1[dist1(rng)].first.get_value() + v2[dist2(rng)].first.get_value()));
+        }
+        ::std::sort(samples.begin(), samples.end());
+
+        // Pick the quantiles, removing duplicates.
+        for (auto p = 1u; p < nparts; ++p) {
+            splitters.push_back(samples[p * (nsamples / nparts)]);
+        }
+        splitters.erase(::std::unique(splitters.begin(), splitters.end()), splitters.end());
+    }
+    const auto n_actual = splitters.size() + 1u;
+
+    // Run the multiplication, storing the nonzero terms
+    // of each part, in ascending monomial order, in c_terms.
+    ::std::vector<::std::vector<::std::pair<value_type, ret_cf_t>>> c_terms(n_actual);
+    ::tbb::parallel_for(::tbb::blocked_range<::std::size_t>(0, n_actual), [&v1, &v2, &splitters, &c_terms,
+                                                                           n_actual](const auto &range) {
+        using idx1_t = decltype(v1.size());
+        using idx2_t = decltype(v2.size());
+
+        // The heap of (monomial value, row index) pairs.
+        // NOTE: std::greater turns the std heap
+        // functions into a min-heap.
+        ::std::vector<::std::pair<value_type, idx1_t>> heap;
+        heap.reserve(v1.size());
+        const ::std::greater<> h_cmp;
+
+        // The current and end column indices for each row.
+        ::std::vector<idx2_t> cur_j(v1.size()), end_j(v1.size());
+
+        for (auto p = range.begin(); p != range.end(); ++p) {
+            // Determine the columns of each row whose products
+            // end up within the current part, and set up the heap.
+            heap.clear();
+            for (idx1_t i = 0; i < v1.size(); ++i) {
+                const auto a = v1[i].first.get_value();
+
+                // NOTE: compare via the value of the product
+                // monomial, which cannot overflow.
+                const auto cmp = [a](const auto &t, const value_type &n) {
+                    return static_cast<value_type>(a + t.first.get_value()) < n;
+                };
+                const auto b
+                    = p == 0u ? v2.cbegin() : ::std::lower_bound(v2.cbegin(), v2.cend(), splitters[p - 1u], cmp);
+                const auto e = p == n_actual - 1u ? v2.cend() : ::std::lower_bound(b, v2.cend(), splitters[p], cmp);
+
+                cur_j[i] = static_cast<idx2_t>(b - v2.cbegin());
+                end_j[i] = static_cast<idx2_t>(e - v2.cbegin());
+
+                if (b != e) {
+                    heap.emplace_back(static_cast<value_type>(a + b->first.get_value()), i);
+                }
+            }
+            ::std::make_heap(heap.begin(), heap.end(), h_cmp);
+
+            // Run the merge.
+            auto &out = c_terms[p];
+            while (!heap.empty()) {
+                ::std::pop_heap(heap.begin(), heap.end(), h_cmp);
+                const auto [code, i] = heap.back();
+
+                const auto &c1 = v1[i].second;
+                const auto &c2 = v2[cur_j[i]].second;
+
+                if (out.empty() || out.back().first != code) {
+                    // New monomial. Remove the previous
+                    // term if its coefficient is zero.
+                    if (!out.empty() && ::obake::is_zero(::std::as_const(out.back().second))) {
+                        out.pop_back();
+                    }
+                    out.emplace_back(code, c1 * c2);
+                } else {
+                    // Same monomial as the previous term,
+                    // accumulate.
+                    // NOTE: do it with fma3(), if possible.
+                    if constexpr (is_mult_addable_v<ret_cf_t &, const cf1_t &, const cf2_t &>) {
+                        ::obake::fma3(out.back().second, c1, c2);
+                    } else {
+                        out.back().second += c1 * c2;
+                    }
+                }
+
+                // Advance the current row, replacing
+                // it in the heap if necessary.
+                if (++cur_j[i] != end_j[i]) {
+                    heap.back().first = static_cast<value_type>(v1[i].first.get_value()
+                                                                + v2[cur_j[i]].first.get_value());
+                    ::std::push_heap(heap.begin(), heap.end(), h_cmp);
+                } else {
+                    heap.pop_back();
+                }
+            }
+            if (!out.empty() && ::obake::is_zero(::std::as_const(out.back().second))) {
+                out.pop_back();
+            }
+        }
+    });
+
+    // Compute the total number of terms.
+    int_t nterms;
+    for (const auto &terms : c_terms) {
+        nterms += terms.size();
+    }
+    if (nterms.is_zero()) {
+        return;
+    }
+
+    // Setup the number of segments in retval, using the exact
+    // number of terms and the estimated average term size.
+    // NOTE: aim at a segment size of ~200KB.
+    const auto avg_term_size = detail::poly_mul_impl_estimate_average_term_size<ret_cf_t>(v1, v2, ss);
+    const auto est_nsegs = (nterms * avg_term_size) / (200ul * 1024ul);
+    retval.set_n_segments(::std::min(::obake::safe_cast<unsigned>(est_nsegs.nbits()),
+                                     polynomial<ret_key_t, ret_cf_t>::get_max_s_size()));
+
+    detail::poly_mul_impl_insert_terms(retval, c_terms);
+}
+
+// Estimate the cost of the multiplication of the operands xo and yo.
+// The operands can be either series or prepared operands. Requires
+// identical symbol sets, non-empty operands and x not longer than y.
+template <typename TO, typename UO, typename... Args>
+inline polynomials::mul_estimate poly_mul_impl_estimate(const TO &xo, const UO &yo, const Args &...args)
+{
+    using T = poly_mul_op_series_t<TO>;
+    using U = poly_mul_op_series_t<UO>;
+    using ret_cf_t = series_cf_t<poly_mul_ret_t<T, U>>;
+
+    const auto &x = detail::poly_mul_op_series(xo);
+    const auto &y = detail::poly_mul_op_series(yo);
+
+    // Preconditions.
+    assert(!x.empty());
+    assert(!y.empty());
+    assert(x.size() <= y.size());
+    assert(x.get_symbol_set_fw() == y.get_symbol_set_fw());
+
+    // Fetch the vectors of terms. For prepared
+    // operands, they are already available, otherwise
+    // we use vectors of references to the terms
+    // (so that the terms are not copied).
+    auto make_tv = [](const auto &op, const auto &s) {
+        if constexpr (!is_prepared_operand_v<remove_cvref_t<decltype(op)>>) {
+            return detail::poly_mul_impl_make_term_ref_vector(s);
+        } else {
+            ::obake::detail::ignore(s);
+
+            return decltype(detail::poly_mul_impl_make_term_ref_vector(s)){};
+        }
+    };
+    const auto tv1 = make_tv(xo, x);
+    const auto tv2 = make_tv(yo, y);
+    const auto &uv1 = [&]() -> const auto & {
+        if constexpr (is_prepared_operand_v<TO>) {
+            return xo._get_terms();
+        } else {
+            return tv1;
+        }
+    }();
+    const auto &uv2 = [&]() -> const auto & {
+        if constexpr (is_prepared_operand_v<UO>) {
+            return yo._get_terms();
+        } else {
+            return tv2;
+        }
+    }();
+
+    const auto &ss = x.get_symbol_set();
+
+    auto [n_terms, n_mults] = detail::poly_mul_estimate_product_size<T, U>(uv1, uv2, ss, args...);
+    const auto avg_term_size = detail::poly_mul_impl_estimate_average_term_size<ret_cf_t>(uv1, uv2, ss);
+
+    auto n_bytes = n_terms * avg_term_size;
+
+    return polynomials::mul_estimate{::std::move(n_terms), ::std::move(n_bytes), ::std::move(n_mults)};
+}
+
+// Detect if the cost of the multiplication of the
+// polynomials T and U can be estimated.
+template <typename T, typename U>
+constexpr bool poly_mul_estimate_enabled_impl()
+{
+    if constexpr (poly_mul_algo<T, U> == 0) {
+        return false;
+    } else {
+        using ret_t = poly_mul_ret_t<T, U>;
+
+        return is_size_measurable_v<const series_key_t<ret_t> &> && is_size_measurable_v<const series_cf_t<ret_t> &>;
     }
 }
 
+template <typename T, typename U>
+inline constexpr bool poly_mul_estimate_enabled = detail::poly_mul_estimate_enabled_impl<T, U>();
+
+// Forward declaration.
+template <typename Ret, typename T, typename U>
+inline bool poly_mul_impl_crt(Ret &, const T &, const U &);
+
 // Implementation of poly multiplication with identical symbol sets.
-// Requires that x is not longer than y.
-template <typename T, typename U, typename... Args>
-inline auto poly_mul_impl_identical_ss(const T &x, const U &y, const Args &...args)
+// Requires that x is not longer than y. Policy is one of the
+// multiplication policy types. The operands can be
+// either series or prepared operands. If OCheck is false,
+// the monomial overflow check is skipped (the caller must
+// have performed it already).
+template <typename Policy, bool OCheck = true, typename TO, typename UO, typename... Args>
+inline auto poly_mul_impl_identical_ss(const TO &xo, const UO &yo, const Args &...args)
 {
+    using T = poly_mul_op_series_t<TO>;
+    using U = poly_mul_op_series_t<UO>;
     using ret_t = poly_mul_ret_t<T, U>;
     using ret_key_t = series_key_t<ret_t>;
 
+    const auto &x = detail::poly_mul_op_series(xo);
+    const auto &y = detail::poly_mul_op_series(yo);
+
     // Check the preconditions.
     assert(x.size() <= y.size());
     assert(x.get_symbol_set_fw() == y.get_symbol_set_fw());
@@ -1894,37 +5435,208 @@ inline auto poly_mul_impl_identical_ss(const T &x, const U &y, const Args &...ar
         return retval;
     }
 
-    if constexpr (::std::conjunction_v<is_homomorphically_hashable_monomial<ret_key_t>,
-                                       // Need also to be able to measure the byte size
-                                       // of x, y, and the key/cf of ret_t, via const lvalue references.
-                                       // NOTE: perhaps this is too much of a hard requirement,
-                                       // and we can make this optional (if not supported,
-                                       // fix the nsegs to something like twice the cores).
-                                       is_size_measurable<const T &>, is_size_measurable<const U &>,
-                                       is_size_measurable<const ret_key_t &>,
-                                       is_size_measurable<const series_cf_t<ret_t> &>>) {
-        // Homomorphic hashing is available, we can run
-        // the multi-threaded implementation.
-
-        // Establish the max byte size of the input series.
-        const auto max_bs = ::std::max(::obake::byte_size(x), ::obake::byte_size(y));
-
-        if ((x.size() == 1u && y.size() == 1u) || max_bs < 30000ul || ::obake::detail::hc() == 1u) {
-            // Run the simple implementation if either:
-            // - both polys have only 1 term, or
-            // - the maximum operand size is less than a threshold value, or
-            // - we have just 1 core.
-            detail::poly_mul_impl_simple(retval, x, y, args...);
+    // For packed monomials, fetch the bounds on the keys of the operands
+    // (which are cached in the operands, see series::_get_key_bounds())
+    // and run the monomial overflow check on them. The engines
+    // will then skip the overflow check.
+    [[maybe_unused]] const auto kb = [&x, &y]() {
+        if constexpr (detail::poly_mul_has_key_bounds<T, U>) {
+            const auto ret = detail::poly_mul_fetch_key_bounds(x, y);
+
+            // NOTE: the cached bounds are not guaranteed to be tight,
+            // thus if the check on the bounds fails the overflow
+            // is confirmed on the keys.
+            if (OCheck && obake_unlikely(!detail::poly_mul_key_bounds_check(*ret.first, *ret.second))
+                && !detail::poly_mul_monomial_range_overflow_check(x, y)) {
+                obake_throw(::std::overflow_error, "An overflow in the monomial exponents was detected while "
+                                                   "attempting to multiply two polynomials");
+            }
+
+            return ret;
+        } else {
+            ::obake::detail::ignore(x, y);
+
+            return 0;
+        }
+    }();
+    constexpr auto eng_ocheck = OCheck && !detail::poly_mul_has_key_bounds<T, U>;
+
+    if constexpr (detail::poly_mul_estimate_enabled<T, U>) {
+        // Enforce the memory ceiling, if set.
+        // NOTE: the estimation is repeated in the multithreaded
+        // implementation, but this is done only if the
+        // ceiling is active. The estimation works on references
+        // to the terms of the operands (or on the terms stored
+        // in the prepared operands), thus no term is copied.
+        // NOTE: the estimation multiplies sampled pairs of keys,
+        // thus it must be sequenced after the monomial overflow
+        // check. For packed monomials, the check was performed
+        // above on the cached bounds, otherwise it is run here
+        // (and it will be run again by the engines).
+        if (const auto limit = polynomials::get_mul_mem_limit(); limit != 0u) {
+            if constexpr (eng_ocheck) {
+                if (obake_unlikely(!detail::poly_mul_monomial_overflow_check(x, y))) {
+                    obake_throw(::std::overflow_error, "An overflow in the monomial exponents was detected while "
+                                                       "attempting to multiply two polynomials");
+                }
+            }
+
+            const auto est = [&]() {
+                if constexpr (poly_mul_is_pruned<Args...>) {
+                    // NOTE: in pruned mode, use the estimate
+                    // of the full product as an upper bound.
+                    return detail::poly_mul_impl_estimate(xo, yo);
+                } else {
+                    return detail::poly_mul_impl_estimate(xo, yo, args...);
+                }
+            }();
+
+            if (est.n_bytes > limit) {
+                obake_throw(polynomials::mul_mem_limit_error,
+                            "The estimated size of the product of two polynomials ("
+                                + est.n_bytes.to_string()
+                                + " bytes) exceeds the memory limit for polynomial multiplications ("
+                                + ::obake::detail::to_string(limit) + " bytes)");
+            }
+        }
+    }
+
+    // Helper to store in retval the bounds on its keys, computed
+    // from the bounds on the keys of the operands.
+    // NOTE: the bounds of the operands may not pass the overflow
+    // check even if the product does not overflow (as they are not
+    // guaranteed to be tight), in which case the bounds of the
+    // product are not computed.
+    auto set_key_bounds = [&retval, &kb]() {
+        if constexpr (detail::poly_mul_has_key_bounds<T, U>) {
+            if (!retval.empty() && detail::poly_mul_key_bounds_check(*kb.first, *kb.second)) {
+                retval._set_key_bounds(detail::pm_key_bounds_mul(*kb.first, *kb.second));
+            }
+        } else {
+            ::obake::detail::ignore(retval, kb);
+        }
+    };
+
+    if constexpr (::std::is_same_v<Policy, polynomials::mul_crt_t>) {
+        // The multi-modular implementation was explicitly requested.
+        // NOTE: if the coefficients of the product are too large
+        // for the available primes, fall through to the automatic
+        // selection of the algorithm.
+        static_assert(sizeof...(Args) == 0u);
+
+        if (detail::poly_mul_impl_crt(retval, x, y)) {
+            set_key_bounds();
+
+            return retval;
+        }
+    }
+
+    // Helper to run the automatic selection of the
+    // multiplication algorithm, with extra arguments a.
+    auto mul_auto = [&retval, &x, &y, &xo, &yo](const auto &...a) {
+        if constexpr (::std::conjunction_v<is_homomorphically_hashable_monomial<ret_key_t>,
+                                           // Need also to be able to measure the byte size
+                                           // of x, y, and the key/cf of ret_t, via const lvalue references.
+                                           // NOTE: perhaps this is too much of a hard requirement,
+                                           // and we can make this optional (if not supported,
+                                           // fix the nsegs to something like twice the cores).
+                                           is_size_measurable<const T &>, is_size_measurable<const U &>,
+                                           is_size_measurable<const ret_key_t &>,
+                                           is_size_measurable<const series_cf_t<ret_t> &>>) {
+            // Homomorphic hashing is available, we can run
+            // the multi-threaded implementation.
+
+            // Establish the max byte size of the input series.
+            const auto max_bs = ::std::max(::obake::byte_size(x), ::obake::byte_size(y));
+
+            if ((x.size() == 1u && y.size() == 1u) || max_bs < 30000ul || ::obake::detail::hc() == 1u) {
+                // Run the simple implementation if either:
+                // - both polys have only 1 term, or
+                // - the maximum operand size is less than a threshold value, or
+                // - we have just 1 core.
+                detail::poly_mul_impl_simple<eng_ocheck>(retval, x, y, a...);
+            } else {
+                // Otherwise, run the MT implementation.
+                detail::poly_mul_impl_mt_hm<eng_ocheck>(retval, xo, yo, a...);
+            }
+        } else {
+            // The monomial does not have homomorphic hashing, or
+            // the byte size of the operands cannot be measured.
+            // Use the number of term-by-term multiplications
+            // to decide between the simple and the MT generic
+            // implementations.
+            ::obake::detail::ignore(xo, yo);
+
+            using int_t = ::mppp::integer<1>;
+
+            if (::obake::detail::hc() == 1u || int_t{x.size()} * y.size() < 1000000) {
+                detail::poly_mul_impl_simple<eng_ocheck>(retval, x, y, a...);
+            } else {
+                detail::poly_mul_impl_mt_generic<eng_ocheck>(retval, x, y, a...);
+            }
+        }
+    };
+
+    if constexpr (poly_mul_is_pruned<Args...>) {
+        // Pruned multiplication. The ranges of term-by-term
+        // products below the threshold are skipped by the term-by-term
+        // engines, and the terms of the product below the threshold
+        // are removed at the end.
+        static_assert(::std::is_same_v<Policy, polynomials::mul_auto_t>);
+
+        // NOTE: the sorting of the terms according to the magnitude
+        // of the coefficients and the threshold checks require finite
+        // coefficients (a NaN breaks the ordering, and the product
+        // of an infinite magnitude by zero is a NaN).
+        detail::poly_mul_check_pruned_cfs(x);
+        detail::poly_mul_check_pruned_cfs(y);
+
+        // Compute the absolute threshold.
+        const auto abs_thr = detail::poly_abs_cf_threshold(::std::get<0>(::std::forward_as_tuple(args...)), x, y);
+
+        if (abs_thr == 0) {
+            // Nothing can be pruned, run
+            // the untruncated multiplication.
+            mul_auto();
+        } else {
+            mul_auto(polynomials::cf_threshold{abs_thr, false});
+
+            ::obake::filter(retval,
+                            [abs_thr](const auto &t) { return !(detail::poly_mul_cf_mag(t.second) < abs_thr); });
+        }
+    } else if constexpr (::std::is_same_v<Policy, polynomials::mul_heap_t>) {
+        // The heap-based implementation was explicitly requested.
+        static_assert(sizeof...(Args) == 0u);
+
+        detail::poly_mul_impl_heap<eng_ocheck>(retval, x, y);
+    } else if constexpr (detail::poly_mul_deg_bounds_shortcut<T, U, Args...>) {
+        // Total degree truncation. Use the degree bounds
+        // cached in the operands to detect if either none or
+        // all the term-by-term products are within the limit.
+        // NOTE: the degrees are summed via mppp::integer, as the
+        // bounds of the operands may not have passed the overflow
+        // check if OCheck is false.
+        using int_t = ::mppp::integer<1>;
+
+        const auto &limit = ::std::get<0>(::std::forward_as_tuple(args...));
+
+        if (int_t{kb.first->min_deg} + kb.second->min_deg > limit) {
+            // All the term-by-term products are above the limit,
+            // the product is empty.
+            return retval;
+        } else if (int_t{kb.first->max_deg} + kb.second->max_deg <= limit) {
+            // All the term-by-term products are within
+            // the limit, run the untruncated multiplication.
+            mul_auto();
         } else {
-            // Otherwise, run the MT implementation.
-            detail::poly_mul_impl_mt_hm(retval, x, y, args...);
+            mul_auto(args...);
         }
     } else {
-        // The monomial does not have homomorphic hashing,
-        // just use the simple implementation.
-        detail::poly_mul_impl_simple(retval, x, y, args...);
+        mul_auto(args...);
     }
 
+    set_key_bounds();
+
     return retval;
 }
 
@@ -1934,33 +5646,31 @@ inline auto poly_mul_impl_identical_ss(const T &x, const U &y, const Args &...ar
 // - make the ntrials for the estimation of the average term size
 //   dependent on the number of term-by-term multiplications (need data for that).
 // NOTE: performance considerations:
-// - the multithreaded implementation still computes
-//   the degrees of the terms of the input series twice. This
-//   could be reduced at the price of changing a bit the code structure
-//   and at the cost of additional indirect sorting (because we
-//   would be computing the degree vectors at the beginning and then
-//   we would need to sort them for segmentation purposes). It's not
-//   clear to me if this is worth it at this time, need to profile;
-// - in highly rectangular multiplications, quite a bit of time
-//   is spent copying the larger operand into a vector of terms.
-//   Perhaps this could be parallelised for segmented series?
-// - in highly rectangular multiplications, the series size
-//   estimation is quite poor (see comments on top of the
-//   function). Not sure what we could do about it;
-// - when constructing vectors of indices, or when building
-//   vectors of degrees, we could improve performance by using
-//   a default-constructing allocator, in order to avoid zeroing
-//   out data which we will be overwriting anyway;
-// - perhaps vector permutations could be done in parallel?
-template <typename T, typename U, typename... Args>
-inline auto poly_mul_impl(const T &x, const U &y, const Args &...args)
+// - unless prepared operands are used, the multithreaded
+//   implementations copy the operands into vectors of terms
+//   (in parallel over the segments, for large segmented series).
+// - in highly rectangular multiplications, the generic series size
+//   estimator overestimates the size of the product. A dedicated
+//   estimator is used for packed monomials (see
+//   poly_mul_estimate_product_size_rect()), but not for other key types.
+template <typename Policy, bool OCheck = true, typename TO, typename UO, typename... Args>
+inline auto poly_mul_impl(const TO &xo, const UO &yo, const Args &...args)
 {
+    using T = poly_mul_op_series_t<TO>;
+    using U = poly_mul_op_series_t<UO>;
+
+    const auto &x = detail::poly_mul_op_series(xo);
+    const auto &y = detail::poly_mul_op_series(yo);
+
     // Check the precondition.
     assert(x.size() <= y.size());
 
     if (x.get_symbol_set_fw() == y.get_symbol_set_fw()) {
-        return detail::poly_mul_impl_identical_ss(x, y, args...);
+        return detail::poly_mul_impl_identical_ss<Policy, OCheck>(xo, yo, args...);
     } else {
+        // NOTE: if the symbol sets differ, the operands must be
+        // extended, and the data cached in prepared operands
+        // cannot be used.
         // Merge the symbol sets.
         const auto &[merged_ss, ins_map_x, ins_map_y]
             = ::obake::detail::merge_symbol_sets(x.get_symbol_set(), y.get_symbol_set());
@@ -1984,7 +5694,7 @@ inline auto poly_mul_impl(const T &x, const U &y, const Args &...args)
                 b.set_symbol_set(merged_ss);
                 ::obake::detail::series_sym_extender(b, y, ins_map_y);
 
-                return detail::poly_mul_impl_identical_ss(x, ::std::move(b), args...);
+                return detail::poly_mul_impl_identical_ss<Policy, OCheck>(xo, ::std::move(b), args...);
             }
             case 2u: {
                 // y already has the correct symbol
@@ -1993,7 +5703,7 @@ inline auto poly_mul_impl(const T &x, const U &y, const Args &...args)
                 a.set_symbol_set(merged_ss);
                 ::obake::detail::series_sym_extender(a, x, ins_map_x);
 
-                return detail::poly_mul_impl_identical_ss(::std::move(a), y, args...);
+                return detail::poly_mul_impl_identical_ss<Policy, OCheck>(::std::move(a), yo, args...);
             }
         }
 
@@ -2005,32 +5715,583 @@ inline auto poly_mul_impl(const T &x, const U &y, const Args &...args)
         ::obake::detail::series_sym_extender(a, x, ins_map_x);
         ::obake::detail::series_sym_extender(b, y, ins_map_y);
 
-        return detail::poly_mul_impl_identical_ss(::std::move(a), ::std::move(b), args...);
+        return detail::poly_mul_impl_identical_ss<Policy, OCheck>(::std::move(a), ::std::move(b), args...);
     }
 }
 
 // Helper to ensure that poly_mul_impl() is called with the
 // shorter poly first, switching around the arguments if necessary.
-template <typename T, typename U, typename... Args>
+// If OCheck is false, the monomial overflow check is skipped
+// (the caller must have performed it already).
+template <typename Policy = polynomials::mul_auto_t, bool OCheck = true, typename T, typename U, typename... Args>
 inline auto poly_mul_impl_switch(const T &x, const U &y, const Args &...args)
 {
+    if (detail::poly_mul_op_series(x).size() <= detail::poly_mul_op_series(y).size()) {
+        return detail::poly_mul_impl<Policy, OCheck>(x, y, args...);
+    } else {
+        return detail::poly_mul_impl<Policy, OCheck>(y, x, args...);
+    }
+}
+
+// Helper to estimate the cost of the multiplication of the
+// operands xo and yo, with arbitrary symbol sets and sizes.
+// The operands can be either series or prepared operands.
+template <typename TO, typename UO, typename... Args>
+inline polynomials::mul_estimate poly_mul_estimate_switch(const TO &xo, const UO &yo, const Args &...args)
+{
+    const auto &x = detail::poly_mul_op_series(xo);
+    const auto &y = detail::poly_mul_op_series(yo);
+
+    if (x.empty() || y.empty()) {
+        return polynomials::mul_estimate{};
+    }
+
+    if (x.get_symbol_set_fw() != y.get_symbol_set_fw()) {
+        // Merge the symbol sets.
+        const auto &[merged_ss, ins_map_x, ins_map_y]
+            = ::obake::detail::merge_symbol_sets(x.get_symbol_set(), y.get_symbol_set());
+
+        // Helper to extend the symbol set of an operand.
+        auto extend = [&ms = merged_ss](const auto &p, const auto &ins_map) {
+            remove_cvref_t<decltype(p)> ret;
+
+            if (ins_map.empty()) {
+                ret = p;
+            } else {
+                ret.set_symbol_set(ms);
+                ::obake::detail::series_sym_extender(ret, p, ins_map);
+            }
+
+            return ret;
+        };
+
+        return detail::poly_mul_estimate_switch(extend(x, ins_map_x), extend(y, ins_map_y), args...);
+    }
+
+    // NOTE: the estimation multiplies sampled pairs of keys,
+    // thus the monomial overflow check must be run first.
+    if (obake_unlikely(!detail::poly_mul_monomial_overflow_check(x, y))) {
+        obake_throw(::std::overflow_error, "An overflow in the monomial exponents was detected while "
+                                           "attempting to estimate the cost of the multiplication of two polynomials");
+    }
+
     if (x.size() <= y.size()) {
-        return detail::poly_mul_impl(x, y, args...);
+        return detail::poly_mul_impl_estimate(xo, yo, args...);
+    } else {
+        return detail::poly_mul_impl_estimate(yo, xo, args...);
+    }
+}
+
+// The primes used in the multi-modular multiplication
+// (the largest primes below 2**31).
+inline constexpr ::std::array<::std::uint32_t, 16> poly_mul_crt_primes
+    = {2147483647u, 2147483629u, 2147483587u, 2147483579u, 2147483563u, 2147483549u, 2147483543u, 2147483497u,
+       2147483489u, 2147483477u, 2147483423u, 2147483399u, 2147483353u, 2147483323u, 2147483269u, 2147483249u};
+
+// Compute the product of x and y modulo the prime p. The residues
+// of the coefficients of the product are written into out.
+// NOTE: the modulus is a runtime quantity, so that the multiplication
+// machinery is instantiated only once for all the primes.
+template <typename T, typename U, typename R>
+inline void poly_mul_impl_crt_prime(const T &x, const U &y, ::std::uint32_t p, R &out)
+{
+    using mpoly_t = polynomial<series_key_t<T>, polynomials::rt_mod_int>;
+    using mod_t = series_cf_t<mpoly_t>;
+
+    // Helper to compute the image of a modulo the prime.
+    // NOTE: the image has the same segmentation of a,
+    // thus the tables can be processed independently.
+    auto reduce = [p](const auto &a) {
+        mpoly_t ret;
+        ret.set_symbol_set_fw(a.get_symbol_set_fw());
+        ret.set_n_segments(a.get_s_size());
+
+        ::tbb::parallel_for(::tbb::blocked_range<decltype(a._get_s_table().size())>(0, a._get_s_table().size()),
+                            [&ret, &a, p](const auto &range) {
+                                for (auto i = range.begin(); i != range.end(); ++i) {
+                                    const auto &a_tab = a._get_s_table()[i];
+                                    auto &r_tab = ret._get_s_table()[i];
+
+                                    r_tab.reserve(a_tab.size());
+                                    for (const auto &[k, c] : a_tab) {
+                                        const mod_t m(c, p);
+                                        if (!::obake::is_zero(m)) {
+                                            r_tab.emplace(k, m);
+                                        }
+                                    }
+                                }
+                            });
+
+        if constexpr (detail::poly_mul_has_key_bounds<mpoly_t, mpoly_t>) {
+            // NOTE: the keys of the image are a subset of the keys
+            // of a, thus the bounds on the keys of a
+            // (cached in a) can be re-used.
+            if (const auto *b = a._get_key_bounds()) {
+                ret._set_key_bounds(*b);
+            }
+        }
+
+        return ret;
+    };
+
+    mpoly_t xm, ym;
+    ::tbb::parallel_invoke([&xm, &x, &reduce]() { xm = reduce(x); }, [&ym, &y, &reduce]() { ym = reduce(y); });
+
+    const auto prod = detail::poly_mul_impl_switch(xm, ym);
+
+    // Write the residues into out.
+    out.set_symbol_set_fw(prod.get_symbol_set_fw());
+    out.set_n_segments(prod.get_s_size());
+    ::tbb::parallel_for(::tbb::blocked_range<decltype(prod._get_s_table().size())>(0, prod._get_s_table().size()),
+                        [&out, &prod](const auto &range) {
+                            for (auto i = range.begin(); i != range.end(); ++i) {
+                                const auto &p_tab = prod._get_s_table()[i];
+                                auto &o_tab = out._get_s_table()[i];
+
+                                o_tab.reserve(p_tab.size());
+                                for (const auto &[k, c] : p_tab) {
+                                    o_tab.emplace(k, c.get_value());
+                                }
+                            }
+                        });
+}
+
+// Multi-modular multiplication.
+//
+// The coefficients of x and y are reduced modulo several word-sized
+// primes, the modular products are computed in parallel and the
+// integral coefficients of the product are reconstructed via the
+// Chinese remainder theorem (using Garner's algorithm). The number
+// of primes is chosen via an a-priori bound on the coefficients of
+// the product. If the bound is too large for the available primes,
+// the function will return false without touching retval, otherwise it
+// will return true.
+template <typename Ret, typename T, typename U>
+inline bool poly_mul_impl_crt(Ret &retval, const T &x, const U &y)
+{
+    using ret_key_t = series_key_t<Ret>;
+    using ret_cf_t = series_cf_t<Ret>;
+    using s_size_t = typename Ret::s_size_type;
+    using int_t = ::mppp::integer<1>;
+    using res_poly_t = polynomial<ret_key_t, ::std::uint32_t>;
+
+    // Preconditions.
+    assert(!x.empty());
+    assert(!y.empty());
+    assert(retval.get_symbol_set_fw() == x.get_symbol_set_fw());
+    assert(retval.get_symbol_set_fw() == y.get_symbol_set_fw());
+    assert(retval.empty());
+    assert(retval._get_s_table().size() == 1u);
+
+    // Establish an upper bound for the bit size of the coefficients
+    // of the product: each coefficient is the sum of at most
+    // min(x.size(), y.size()) term-by-term products.
+    auto max_nbits = [](const auto &s) {
+        ::std::size_t ret = 0;
+        for (const auto &t : s) {
+            ret = ::std::max(ret, static_cast<::std::size_t>(t.second.nbits()));
+        }
+        return ret;
+    };
+    const auto nbits = int_t{max_nbits(x)} + max_nbits(y) + int_t{::std::min(x.size(), y.size())}.nbits();
+
+    // Determine the number of primes. Each prime is larger than 2**30,
+    // and the product of the primes must be larger than twice the
+    // bound (in order to account for the sign).
+    const auto np_int = (nbits + 1) / 30 + 1;
+    if (np_int > poly_mul_crt_primes.size()) {
+        return false;
+    }
+    const auto np = static_cast<::std::size_t>(np_int);
+    const auto &primes = poly_mul_crt_primes;
+
+    // Compute the modular products in parallel.
+    ::std::vector<res_poly_t> res(np);
+    ::tbb::parallel_for(::tbb::blocked_range<::std::size_t>(0, np), [&res, &primes, &x, &y](const auto &range) {
+        for (auto i = range.begin(); i != range.end(); ++i) {
+            detail::poly_mul_impl_crt_prime(x, y, primes[i], res[i]);
+        }
+    });
+
+    // Precompute the constants for Garner's algorithm:
+    // inv[i * np + j] is the inverse of the j-th prime
+    // modulo the i-th prime (for j < i).
+    auto mod_pow = [](::std::uint64_t b, ::std::uint64_t e, ::std::uint64_t m) {
+        ::std::uint64_t ret = 1;
+        for (b %= m; e != 0u; e >>= 1) {
+            if (e & 1u) {
+                ret = ret * b % m;
+            }
+            b = b * b % m;
+        }
+        return ret;
+    };
+    ::std::vector<::std::uint64_t> inv(np * np);
+    for (::std::size_t i = 0; i < np; ++i) {
+        for (::std::size_t j = 0; j < i; ++j) {
+            // NOTE: the primes are distinct, use Fermat's little theorem.
+            inv[i * np + j] = mod_pow(primes[j], primes[i] - 2u, primes[i]);
+        }
+    }
+
+    // The product of the primes, and its half.
+    ret_cf_t M{1};
+    for (::std::size_t i = 0; i < np; ++i) {
+        M *= primes[i];
+    }
+    const auto half_M = M / 2;
+
+    // Setup the segmentation of retval: we use the finest
+    // segmentation among the modular products.
+    unsigned log2_nsegs = 0;
+    for (const auto &r : res) {
+        log2_nsegs = ::std::max(log2_nsegs, r.get_s_size());
+    }
+    retval.set_n_segments(log2_nsegs);
+    const auto nsegs = s_size_t(1) << log2_nsegs;
+
+    try {
+        ::tbb::parallel_for(::tbb::blocked_range<s_size_t>(0, nsegs), [&](const auto &range) {
+            // Map from the keys of the product to the position
+            // of their residues in rvec.
+            ::boost::unordered::unordered_flat_map<ret_key_t, ::std::size_t, ::obake::detail::series_key_hasher,
+                                                   ::obake::detail::series_key_comparer>
+                idx_map;
+            ::std::vector<::std::uint32_t> rvec;
+
+            // The mixed-radix digits of a coefficient.
+            ::std::vector<::std::uint64_t> v(np);
+
+            for (auto seg_idx = range.begin(); seg_idx != range.end(); ++seg_idx) {
+                idx_map.clear();
+                rvec.clear();
+
+                // Collect the residues of the terms ending up in the current segment.
+                // NOTE: the segmentation of each modular product is not finer
+                // than the segmentation of retval, thus all the terms we need are
+                // in the table at index seg_idx % size of the modular product.
+                for (::std::size_t i = 0; i < np; ++i) {
+                    const auto &r_tabs = res[i]._get_s_table();
+                    const auto r_nsegs = static_cast<s_size_t>(r_tabs.size());
+
+                    for (const auto &[k, r] : r_tabs[seg_idx % r_nsegs]) {
+                        if (r_nsegs != nsegs && ::obake::hash(k) % nsegs != seg_idx) {
+                            continue;
+                        }
+
+                        const auto [it, ins] = idx_map.try_emplace(k, rvec.size());
+                        if (ins) {
+                            // NOTE: missing residues are zero.
+                            rvec.resize(rvec.size() + np);
+                        }
+                        rvec[it->second + i] = r;
+                    }
+                }
+
+                auto &table = retval._get_s_table()[seg_idx];
+                table.reserve(idx_map.size());
+
+                for (const auto &[k, idx] : idx_map) {
+                    // Compute the mixed-radix digits.
+                    for (::std::size_t i = 0; i < np; ++i) {
+                        const ::std::uint64_t p = primes[i];
+                        ::std::uint64_t t = rvec[idx + i];
+                        for (::std::size_t j = 0; j < i; ++j) {
+                            t = (t + p - v[j] % p) % p * inv[i * np + j] % p;
+                        }
+                        v[i] = t;
+                    }
+
+                    // Assemble the coefficient in the [0, M) range.
+                    ret_cf_t c{v[np - 1u]};
+                    for (auto i = np - 1u; i-- > 0u;) {
+                        c *= primes[i];
+                        c += v[i];
+                    }
+
+                    // Move to the symmetric range.
+                    if (c > half_M) {
+                        c -= M;
+                    }
+
+                    // NOTE: thanks to the bound, a coefficient can be zero
+                    // only if all its residues are zero, which never
+                    // happens for the terms in idx_map.
+                    assert(!::obake::is_zero(c));
+
+                    table.emplace(k, ::std::move(c));
+                }
+
+                // LCOV_EXCL_START
+                // Check the table size against the max allowed size.
+                if (obake_unlikely(table.size() > retval._get_max_table_size())) {
+                    obake_throw(::std::overflow_error, "The multi-modular multiplication of two "
+                                                       "polynomials resulted in a table whose size ("
+                                                           + ::obake::detail::to_string(table.size())
+                                                           + ") is larger than the maximum allowed value ("
+                                                           + ::obake::detail::to_string(retval._get_max_table_size())
+                                                           + ")");
+                }
+                // LCOV_EXCL_STOP
+            }
+        });
+        // LCOV_EXCL_START
+    } catch (...) {
+        // retval may now contain incomplete data.
+        // Make sure to clear it before rethrowing.
+        retval.clear_terms();
+        throw;
+        // LCOV_EXCL_STOP
+    }
+
+    return true;
+}
+
+// Detect if the multiplication of the polynomials T and U
+// can be performed with the policy Policy.
+template <typename T, typename U, typename Policy>
+constexpr bool poly_mul_policy_enabled_impl()
+{
+    if constexpr (poly_mul_algo<T, U> == 0) {
+        return false;
+    } else if constexpr (::std::is_same_v<Policy, polynomials::mul_auto_t>) {
+        return true;
+    } else if constexpr (::std::is_same_v<Policy, polynomials::mul_heap_t>) {
+        using ret_t = poly_mul_ret_t<T, U>;
+
+        // NOTE: the size measurability requirements
+        // are needed to set up the segmentation of the
+        // return value.
+        return detail::same_packed_monomial_v<series_key_t<ret_t>, series_key_t<ret_t>>
+               && is_size_measurable_v<const series_key_t<ret_t> &>
+               && is_size_measurable_v<const series_cf_t<ret_t> &>;
+    } else if constexpr (::std::is_same_v<Policy, polynomials::mul_crt_t>) {
+        using ret_t = poly_mul_ret_t<T, U>;
+
+        // NOTE: the multiplication of the modular images is
+        // run with the automatic policy, which requires only that
+        // the key type supports multiplication.
+        return ::obake::detail::is_mppp_integer_v<series_cf_t<T>> && ::std::is_same_v<series_cf_t<T>, series_cf_t<U>>
+               && ::std::is_same_v<series_cf_t<T>, series_cf_t<ret_t>>
+               && ::std::is_same_v<series_key_t<T>, series_key_t<ret_t>>;
+    } else {
+        return false;
+    }
+}
+
+template <typename T, typename U, typename Policy>
+inline constexpr bool poly_mul_policy_enabled = detail::poly_mul_policy_enabled_impl<T, U, Policy>();
+
+// Detect if T and U are multiplication operands
+// with at least one prepared operand.
+template <typename T, typename U>
+constexpr bool poly_mul_prepared_ops_impl()
+{
+    if constexpr (is_prepared_operand_v<T> || is_prepared_operand_v<U>) {
+        using s1_t = poly_mul_op_series_t<T>;
+        using s2_t = poly_mul_op_series_t<U>;
+
+        if constexpr (is_polynomial_v<s1_t> && is_polynomial_v<s2_t>) {
+            return ::std::is_same_v<series_key_t<s1_t>, series_key_t<s2_t>>;
+        } else {
+            return false;
+        }
+    } else {
+        return false;
+    }
+}
+
+template <typename T, typename U>
+inline constexpr bool poly_mul_prepared_ops = detail::poly_mul_prepared_ops_impl<T, U>();
+
+// The type of the exponent limits of a prepared operand
+// with key type K. The exponent limits are available only
+// for packed monomials, otherwise an empty placeholder is used.
+template <typename K>
+constexpr auto prepared_exp_limits_type()
+{
+    if constexpr (same_packed_monomial_v<K, K>) {
+        return ::obake::detail::type_c<pm_exponent_limits_t<typename K::value_type>>{};
     } else {
-        return detail::poly_mul_impl(y, x, args...);
+        return ::obake::detail::type_c<::std::tuple<>>{};
     }
 }
 
+template <typename K>
+using prepared_exp_limits_t = typename decltype(detail::prepared_exp_limits_type<K>())::type;
+
 } // namespace detail
 
+// A polynomial prepared for repeated multiplications.
+//
+// Before performing the term-by-term multiplications, the multithreaded
+// multiplication algorithm needs to copy the terms of the operands into
+// vectors, sort them according to the segmentation of the product, compute
+// the segmentation ranges and, in truncated multiplications, compute and sort
+// the degrees of the terms. A prepared operand stores the terms of a
+// polynomial in a single vector, and it caches the sorting permutation and the
+// segmentation ranges (which depend on the number of segments and on the
+// type of truncation) the first time they are computed, so that they can
+// be re-used in subsequent multiplications. The cache holds at most
+// detail::prepared_operand_max_cache_size entries, and it can be
+// emptied explicitly via clear_cache().
+//
+// For packed monomial keys, the bounds on the keys of the polynomial
+// (see series::_get_key_bounds()) are computed at construction, so that
+// the monomial overflow check in the multiplication can be performed
+// without scanning the terms (copies of a prepared operand recompute
+// the bounds on first use).
+//
+// Prepared operands can be used in place of polynomials in operator*(),
+// series_mul() and truncated_mul().
+// NOTE: copies of a prepared operand share the same cache,
+// which is protected by a mutex.
+template <typename K, typename C>
+class prepared_operand
+{
+public:
+    using poly_t = polynomial<K, C>;
+    using term_vector_t = ::std::vector<::std::pair<K, C>>;
+    using mul_data_t = detail::poly_mul_prep_data<typename term_vector_t::size_type, typename poly_t::s_size_type>;
+
+private:
+    struct cache_t {
+        ::std::mutex m_mutex;
+        ::std::map<detail::poly_mul_cache_key_t, ::std::shared_ptr<const mul_data_t>> m_map;
+    };
+
+public:
+    explicit prepared_operand(poly_t p)
+        : m_poly(::std::move(p)),
+          m_terms(detail::poly_mul_impl_make_term_vector(m_poly)),
+          m_cache(::std::make_shared<cache_t>())
+    {
+        if constexpr (detail::same_packed_monomial_v<K, K>) {
+            // NOTE: the bounds are cached in m_poly,
+            // which is never modified.
+            m_poly._get_key_bounds();
+        }
+    }
+
+    const poly_t &get_poly() const
+    {
+        return m_poly;
+    }
+
+    // Remove all the entries from the cache.
+    // NOTE: the cache is shared with the copies
+    // of this prepared operand.
+    void clear_cache() const
+    {
+        if (!m_cache) {
+            return;
+        }
+
+        ::std::lock_guard lock{m_cache->m_mutex};
+
+        m_cache->m_map.clear();
+    }
+
+    // Internal accessors used in the multiplication functions.
+    const term_vector_t &_get_terms() const
+    {
+        return m_terms;
+    }
+    detail::prepared_exp_limits_t<K> _get_exp_limits() const
+    {
+        if constexpr (detail::same_packed_monomial_v<K, K>) {
+            if (const auto *b = m_poly._get_key_bounds()) {
+                return b->exps;
+            }
+        }
+
+        return {};
+    }
+    ::std::shared_ptr<const mul_data_t> _get_mul_data(const detail::poly_mul_cache_key_t &key) const
+    {
+        // NOTE: m_cache can be null only in a moved-from object.
+        if (!m_cache) {
+            return nullptr;
+        }
+
+        ::std::lock_guard lock{m_cache->m_mutex};
+
+        const auto it = m_cache->m_map.find(key);
+        return it == m_cache->m_map.end() ? nullptr : it->second;
+    }
+    void _set_mul_data(const detail::poly_mul_cache_key_t &key, ::std::shared_ptr<const mul_data_t> ptr) const
+    {
+        if (!m_cache) {
+            return;
+        }
+
+        ::std::lock_guard lock{m_cache->m_mutex};
+
+        // NOTE: the entries are held via shared pointers, thus
+        // clearing the cache does not invalidate the data
+        // in use by concurrent multiplications.
+        if (m_cache->m_map.size() >= detail::prepared_operand_max_cache_size
+            && m_cache->m_map.find(key) == m_cache->m_map.end()) {
+            m_cache->m_map.clear();
+        }
+
+        m_cache->m_map.emplace(key, ::std::move(ptr));
+    }
+    ::std::size_t _get_cache_size() const
+    {
+        if (!m_cache) {
+            return 0;
+        }
+
+        ::std::lock_guard lock{m_cache->m_mutex};
+
+        return m_cache->m_map.size();
+    }
+
+private:
+    poly_t m_poly;
+    term_vector_t m_terms;
+    ::std::shared_ptr<cache_t> m_cache;
+};
+
+template <typename K, typename C0, typename C1>
+    requires(detail::poly_mul_algo<polynomial<K, C0>, polynomial<K, C1>> != 0)
+inline detail::poly_mul_ret_t<polynomial<K, C0>, polynomial<K, C1>> series_mul(const polynomial<K, C0> &x,
+                                                                               const polynomial<K, C1> &y)
+{
+    return detail::poly_mul_impl_switch(x, y);
+}
+
+// Multiplication involving prepared operands.
+template <typename T, typename U>
+    requires detail::poly_mul_prepared_ops<T, U>
+             && (detail::poly_mul_algo<detail::poly_mul_op_series_t<T>, detail::poly_mul_op_series_t<U>> != 0)
+inline detail::poly_mul_ret_t<detail::poly_mul_op_series_t<T>, detail::poly_mul_op_series_t<U>>
+series_mul(const T &x, const U &y)
+{
+    return detail::poly_mul_impl_switch(x, y);
+}
+
+// NOTE: the multiplication operator for series is enabled only
+// if at least one operand is a series, thus we need to provide
+// an overload for the multiplication of two prepared operands.
 template <typename K, typename C0, typename C1>
     requires(detail::poly_mul_algo<polynomial<K, C0>, polynomial<K, C1>> != 0)
-inline detail::poly_mul_ret_t<polynomial<K, C0>, polynomial<K, C1>> series_mul(const polynomial<K, C0> &x,
-                                                                               const polynomial<K, C1> &y)
+inline detail::poly_mul_ret_t<polynomial<K, C0>, polynomial<K, C1>> operator*(const prepared_operand<K, C0> &x,
+                                                                              const prepared_operand<K, C1> &y)
 {
     return detail::poly_mul_impl_switch(x, y);
 }
 
+// Multiplication with an explicit policy.
+template <typename K, typename C0, typename C1, typename Policy>
+    requires detail::poly_mul_policy_enabled<polynomial<K, C0>, polynomial<K, C1>, Policy>
+inline detail::poly_mul_ret_t<polynomial<K, C0>, polynomial<K, C1>> series_mul(const polynomial<K, C0> &x,
+                                                                               const polynomial<K, C1> &y, Policy)
+{
+    return detail::poly_mul_impl_switch<Policy>(x, y);
+}
+
 namespace detail
 {
 
@@ -2105,6 +6366,34 @@ template <typename T, typename U, typename V>
 inline constexpr auto poly_mul_truncated_p_degree_algo
     = detail::poly_mul_truncated_degree_algorithm_impl<T, U, V, false>();
 
+// Metaprogramming to establish if we can perform truncated
+// weighted degree multiplication on the polynomial operands T and U
+// with degree limit of type V. The weighted degree is computed
+// from the partial degrees of the keys (which must be integral), and
+// its type is mppp::integer<1>.
+template <typename T, typename U, typename V>
+constexpr int poly_mul_truncated_w_degree_algorithm_impl()
+{
+    if constexpr (poly_mul_algo<T, U> == 0) {
+        return 0;
+    } else {
+        using d_impl = customisation::internal::series_default_p_degree_impl;
+
+        // NOTE: algo == 3 means that only the key is with degree.
+        if constexpr (d_impl::template algo<T> == 3 && d_impl::template algo<U> == 3) {
+            return static_cast<int>(is_integral_v<typename d_impl::template ret_t<T>>
+                                    && is_integral_v<typename d_impl::template ret_t<U>>
+                                    && is_less_than_comparable_v<const V &, ::mppp::integer<1>>);
+        } else {
+            return 0;
+        }
+    }
+}
+
+template <typename T, typename U, typename V>
+inline constexpr auto poly_mul_truncated_w_degree_algo
+    = detail::poly_mul_truncated_w_degree_algorithm_impl<T, U, V>();
+
 } // namespace detail
 
 // Truncated multiplication.
@@ -2126,13 +6415,596 @@ truncated_mul(const polynomial<K, C0> &x, const polynomial<K, C1> &y, const V &m
     return detail::poly_mul_impl_switch(x, y, max_degree, s);
 }
 
+// Weighted degree truncated multiplication: the term-by-term
+// products whose weighted degree (as defined by w) is greater
+// than max_degree are skipped.
+template <typename K, typename C0, typename C1, typename V>
+    requires(detail::poly_mul_truncated_w_degree_algo<polynomial<K, C0>, polynomial<K, C1>, V> != 0)
+inline detail::poly_mul_ret_t<polynomial<K, C0>, polynomial<K, C1>>
+truncated_mul(const polynomial<K, C0> &x, const polynomial<K, C1> &y, const V &max_degree,
+              const polynomials::deg_weights &w)
+{
+    return detail::poly_mul_impl_switch(x, y, max_degree, w);
+}
+
+// Truncated multiplication involving prepared operands.
+template <typename T, typename U, typename V>
+    requires detail::poly_mul_prepared_ops<T, U>
+             && (detail::poly_mul_truncated_degree_algo<detail::poly_mul_op_series_t<T>,
+                                                        detail::poly_mul_op_series_t<U>, V>
+                 != 0)
+inline detail::poly_mul_ret_t<detail::poly_mul_op_series_t<T>, detail::poly_mul_op_series_t<U>>
+truncated_mul(const T &x, const U &y, const V &max_degree)
+{
+    return detail::poly_mul_impl_switch(x, y, max_degree);
+}
+
+template <typename T, typename U, typename V>
+    requires detail::poly_mul_prepared_ops<T, U>
+             && (detail::poly_mul_truncated_p_degree_algo<detail::poly_mul_op_series_t<T>,
+                                                          detail::poly_mul_op_series_t<U>, V>
+                 != 0)
+inline detail::poly_mul_ret_t<detail::poly_mul_op_series_t<T>, detail::poly_mul_op_series_t<U>>
+truncated_mul(const T &x, const U &y, const V &max_degree, const symbol_set &s)
+{
+    return detail::poly_mul_impl_switch(x, y, max_degree, s);
+}
+
+template <typename T, typename U, typename V>
+    requires detail::poly_mul_prepared_ops<T, U>
+             && (detail::poly_mul_truncated_w_degree_algo<detail::poly_mul_op_series_t<T>,
+                                                          detail::poly_mul_op_series_t<U>, V>
+                 != 0)
+inline detail::poly_mul_ret_t<detail::poly_mul_op_series_t<T>, detail::poly_mul_op_series_t<U>>
+truncated_mul(const T &x, const U &y, const V &max_degree, const polynomials::deg_weights &w)
+{
+    return detail::poly_mul_impl_switch(x, y, max_degree, w);
+}
+
 namespace detail
 {
 
-// Implementation of the specialised pow() implementation
-// for polynomials.
+// Detect if the polynomials T and U can be multiplied
+// in pruned mode: the coefficient types of T, U and
+// of the product must be floating-point types.
+template <typename T, typename U>
+constexpr bool poly_mul_pruned_enabled_impl()
+{
+    if constexpr (poly_mul_algo<T, U> == 0) {
+        return false;
+    } else {
+        return ::std::is_floating_point_v<series_cf_t<T>> && ::std::is_floating_point_v<series_cf_t<U>>
+               && ::std::is_floating_point_v<series_cf_t<poly_mul_ret_t<T, U>>>;
+    }
+}
+
+template <typename T, typename U>
+inline constexpr bool poly_mul_pruned_enabled = detail::poly_mul_pruned_enabled_impl<T, U>();
+
+// Check the validity of a coefficient threshold.
+inline void poly_mul_check_cf_threshold(const polynomials::cf_threshold &thr)
+{
+    if (obake_unlikely(!::std::isfinite(thr.value) || thr.value < 0)) {
+        obake_throw(::std::invalid_argument, "A coefficient threshold must be a finite non-negative value, but the "
+                                             "value "
+                                                 + ::obake::detail::to_string(thr.value) + " was provided instead");
+    }
+}
+
+} // namespace detail
+
+// Pruned multiplication.
+//
+// The term-by-term products whose coefficients are smaller (in
+// absolute value) than the threshold thr are skipped, and the terms
+// of the product whose coefficients are smaller than the threshold are
+// discarded. The terms of the operands are sorted in descending order
+// of the magnitude of the coefficients, so that, for each term of
+// the shorter operand, the products below the threshold form a tail
+// of the longer operand that is never visited. The coefficients
+// of the operands must be finite. If the threshold is zero,
+// nothing is pruned and the result is the untruncated product.
+// NOTE: the discarded term-by-term products could in principle add up
+// to a coefficient above the threshold: the result of a pruned
+// multiplication is thus an approximation of the truncated product.
+template <typename K, typename C0, typename C1>
+    requires detail::poly_mul_pruned_enabled<polynomial<K, C0>, polynomial<K, C1>>
+inline detail::poly_mul_ret_t<polynomial<K, C0>, polynomial<K, C1>>
+pruned_mul(const polynomial<K, C0> &x, const polynomial<K, C1> &y, const polynomials::cf_threshold &thr)
+{
+    detail::poly_mul_check_cf_threshold(thr);
+
+    return detail::poly_mul_impl_switch(x, y, thr);
+}
+
+namespace detail
+{
+
+// Metaprogramming to establish the return type of promoting_mul():
+// a variant of the product types along the promotion
+// chain of the key type K, for which multiplication is available.
+template <typename K, typename C0, typename C1, typename... Ps>
+constexpr auto poly_promoting_mul_ret_impl()
+{
+    using ret_t = poly_mul_ret_t<polynomial<K, C0>, polynomial<K, C1>>;
+
+    if constexpr (is_promotable_monomial_v<K>) {
+        using next_t = monomial_promotion_t<K>;
+
+        if constexpr (poly_mul_algo<polynomial<next_t, C0>, polynomial<next_t, C1>> != 0) {
+            return detail::poly_promoting_mul_ret_impl<next_t, C0, C1, Ps..., ret_t>();
+        } else {
+            return ::obake::detail::type_c<::std::variant<Ps..., ret_t>>{};
+        }
+    } else {
+        return ::obake::detail::type_c<::std::variant<Ps..., ret_t>>{};
+    }
+}
+
+template <typename K, typename C0, typename C1>
+using poly_promoting_mul_ret_t = typename decltype(detail::poly_promoting_mul_ret_impl<K, C0, C1>())::type;
+
+// Convert the polynomial p into a polynomial whose key
+// type is the promotion of the key type of p.
+template <typename K, typename C>
+inline polynomial<monomial_promotion_t<K>, C> poly_promote(const polynomial<K, C> &p)
+{
+    polynomial<monomial_promotion_t<K>, C> retval;
+    retval.set_symbol_set_fw(p.get_symbol_set_fw());
+    retval.set_n_segments(p.get_s_size());
+    retval.reserve(::obake::safe_cast<decltype(retval.size())>(p.size()));
+
+    const auto &ss = p.get_symbol_set();
+
+    // Buffer for the exponents.
+    ::std::vector<typename K::value_type> tmp;
+
+    for (const auto &t : p._get_s_table()) {
+        for (const auto &[k, c] : t) {
+            // NOTE: the promotion preserves the compatibility
+            // and the uniqueness of the keys. The table size check
+            // is needed because the promoted key may end up
+            // in a different table.
+            ::obake::detail::series_add_term<true, ::obake::detail::sat_check_zero::off,
+                                             ::obake::detail::sat_check_compat_key::off,
+                                             ::obake::detail::sat_check_table_size::on,
+                                             ::obake::detail::sat_assume_unique::on>(
+                retval, ::obake::monomial_promote(k, ss, tmp), c);
+        }
+    }
+
+    return retval;
+}
+
+// Implementation of promoting_mul() with identical symbol sets.
+// I is the position of the current key type in the promotion chain.
+template <typename Ret, ::std::size_t I, typename K, typename C0, typename C1>
+inline Ret poly_promoting_mul_impl(const polynomial<K, C0> &x, const polynomial<K, C1> &y)
+{
+    if (detail::poly_mul_monomial_overflow_check(x, y)) {
+        // No overflow with the current key type,
+        // run the multiplication.
+        // NOTE: the overflow check has just been
+        // performed, skip it in the multiplication.
+        return Ret(::std::in_place_index<I>, detail::poly_mul_impl_switch<polynomials::mul_auto_t, false>(x, y));
+    }
+
+    if constexpr (I + 1u < ::std::variant_size_v<Ret>) {
+        // Promote the operands and try again.
+        return detail::poly_promoting_mul_impl<Ret, I + 1u>(detail::poly_promote(x), detail::poly_promote(y));
+    } else {
+        obake_throw(::std::overflow_error, "An overflow in the monomial exponents was detected while "
+                                           "attempting to multiply two polynomials, and no wider monomial "
+                                           "type is available in the promotion chain");
+    }
+}
+
+} // namespace detail
+
+// Multiplication with automatic promotion of the monomial type.
+//
+// If the exponents of the product of x and y cannot be represented
+// by the key type K, the operands are converted into polynomials
+// whose key type is the next type in the promotion chain of K (see
+// monomial_promotion_t), until either the product can be computed
+// or the chain is exhausted (in which case an overflow error is raised).
+// The product is returned as a variant of the product types along
+// the promotion chain, whose active member corresponds to the
+// representation in which the product was computed.
+template <typename K, typename C0, typename C1>
+    requires(detail::poly_mul_algo<polynomial<K, C0>, polynomial<K, C1>> != 0)
+inline detail::poly_promoting_mul_ret_t<K, C0, C1> promoting_mul(const polynomial<K, C0> &x,
+                                                                 const polynomial<K, C1> &y)
+{
+    using ret_t = detail::poly_promoting_mul_ret_t<K, C0, C1>;
+
+    if (x.get_symbol_set_fw() == y.get_symbol_set_fw()) {
+        return detail::poly_promoting_mul_impl<ret_t, 0>(x, y);
+    }
+
+    // Merge the symbol sets.
+    const auto &[merged_ss, ins_map_x, ins_map_y]
+        = ::obake::detail::merge_symbol_sets(x.get_symbol_set(), y.get_symbol_set());
+
+    // Helper to extend the symbol set of an operand.
+    auto extend = [&ms = merged_ss](const auto &p, const auto &ins_map) {
+        remove_cvref_t<decltype(p)> ret;
+        ret.set_symbol_set(ms);
+        ::obake::detail::series_sym_extender(ret, p, ins_map);
+
+        return ret;
+    };
+
+    // NOTE: the insertion maps cannot be both empty, as we
+    // already handled the identical symbol sets case above. An
+    // operand with an empty insertion map is used as it is.
+    assert(!ins_map_x.empty() || !ins_map_y.empty());
+
+    if (ins_map_x.empty()) {
+        return detail::poly_promoting_mul_impl<ret_t, 0>(x, extend(y, ins_map_y));
+    }
+
+    if (ins_map_y.empty()) {
+        return detail::poly_promoting_mul_impl<ret_t, 0>(extend(x, ins_map_x), y);
+    }
+
+    return detail::poly_promoting_mul_impl<ret_t, 0>(extend(x, ins_map_x), extend(y, ins_map_y));
+}
+
+// Estimate the cost of a polynomial multiplication.
+template <typename K, typename C0, typename C1>
+    requires detail::poly_mul_estimate_enabled<polynomial<K, C0>, polynomial<K, C1>>
+inline polynomials::mul_estimate estimate_mul(const polynomial<K, C0> &x, const polynomial<K, C1> &y)
+{
+    return detail::poly_mul_estimate_switch(x, y);
+}
+
+// Estimate the cost of a polynomial multiplication
+// involving prepared operands.
+template <typename T, typename U>
+    requires detail::poly_mul_prepared_ops<T, U>
+             && detail::poly_mul_estimate_enabled<detail::poly_mul_op_series_t<T>, detail::poly_mul_op_series_t<U>>
+inline polynomials::mul_estimate estimate_mul(const T &x, const U &y)
+{
+    return detail::poly_mul_estimate_switch(x, y);
+}
+
+// Estimate the cost of a truncated polynomial multiplication.
+template <typename K, typename C0, typename C1, typename V>
+    requires detail::poly_mul_estimate_enabled<polynomial<K, C0>, polynomial<K, C1>>
+             && (detail::poly_mul_truncated_degree_algo<polynomial<K, C0>, polynomial<K, C1>, V> != 0)
+inline polynomials::mul_estimate estimate_truncated_mul(const polynomial<K, C0> &x, const polynomial<K, C1> &y,
+                                                        const V &max_degree)
+{
+    return detail::poly_mul_estimate_switch(x, y, max_degree);
+}
+
+template <typename K, typename C0, typename C1, typename V>
+    requires detail::poly_mul_estimate_enabled<polynomial<K, C0>, polynomial<K, C1>>
+             && (detail::poly_mul_truncated_p_degree_algo<polynomial<K, C0>, polynomial<K, C1>, V> != 0)
+inline polynomials::mul_estimate estimate_truncated_mul(const polynomial<K, C0> &x, const polynomial<K, C1> &y,
+                                                        const V &max_degree, const symbol_set &s)
+{
+    return detail::poly_mul_estimate_switch(x, y, max_degree, s);
+}
+
+template <typename K, typename C0, typename C1, typename V>
+    requires detail::poly_mul_estimate_enabled<polynomial<K, C0>, polynomial<K, C1>>
+             && (detail::poly_mul_truncated_w_degree_algo<polynomial<K, C0>, polynomial<K, C1>, V> != 0)
+inline polynomials::mul_estimate estimate_truncated_mul(const polynomial<K, C0> &x, const polynomial<K, C1> &y,
+                                                        const V &max_degree, const polynomials::deg_weights &w)
+{
+    return detail::poly_mul_estimate_switch(x, y, max_degree, w);
+}
+
+namespace detail
+{
+
+// Exponent starting from which the exponentiation of multi-term
+// polynomials is performed via binary exponentiation, rather than
+// via the series pow cache (which computes and stores all the powers
+// up to the requested one).
+inline constexpr unsigned pow_poly_binexp_min_exp = 16;
+
+// Detect if the polynomial T can be raised to the power U
+// via repeated multiplications. The requirements are the same
+// as in the series pow cache: U must be safely convertible to unsigned,
+// T * T must be defined and return T, and the return type
+// of the exponentiation must be T.
 template <typename T, typename U>
-inline auto pow_poly_impl(T &&x, U &&y)
+inline constexpr bool pow_poly_rm_enabled = ::std::conjunction_v<
+    is_safely_convertible<const U &, unsigned &>,
+    ::std::is_same<T, detected_t<::obake::detail::mul_t, const T &, const T &>>,
+    ::std::is_same<T, customisation::internal::series_default_pow_ret_t<const T &, const U &>>>;
+
+// Detect if T is an exact coefficient ring suitable for
+// Miller's recurrence: the divisions by k * c0 in the recurrence
+// must be exact. This excludes floating-point types (for which the
+// recurrence is numerically unstable when c0 is small) and
+// C++ integral types (whose overflow or wrap-around would disrupt
+// the divisions).
+template <typename>
+struct pow_poly_miller_exact_cf : ::std::false_type {
+};
+
+template <::std::size_t SSize>
+struct pow_poly_miller_exact_cf<::mppp::integer<SSize>> : ::std::true_type {
+};
+
+template <::std::size_t SSize>
+struct pow_poly_miller_exact_cf<::mppp::rational<SSize>> : ::std::true_type {
+};
+
+// Detect if the polynomial T can be raised to the power U
+// via Miller's recurrence. Args are the optional truncation
+// arguments (degree limit and, for partial degree
+// truncation, the list of symbols). We need:
+// - exponentiation via repeated multiplications,
+// - a key with integral (partial) degree,
+// - an exact coefficient ring (see pow_poly_miller_exact_cf),
+// - the possibility of multiplying and dividing T by the
+//   coefficient type, and of adding T in-place.
+template <typename T, typename U, typename... Args>
+constexpr bool pow_poly_miller_enabled_impl()
+{
+    using cf_t = series_cf_t<T>;
+    using key_t = series_key_t<T>;
+
+    if constexpr (!pow_poly_rm_enabled<T, U> || !pow_poly_miller_exact_cf<cf_t>::value
+                  || poly_mul_is_w_truncated<Args...> || poly_mul_is_pruned<Args...>) {
+        // NOTE: weighted degree truncation and coefficient
+        // threshold truncation are not supported in the recurrence.
+        return false;
+    } else {
+        constexpr auto deg_ok = []() {
+            if constexpr (sizeof...(Args) == 2u) {
+                if constexpr (is_key_with_p_degree_v<const key_t &>) {
+                    return is_integral_v<decltype(::obake::key_p_degree(::std::declval<const key_t &>(),
+                                                                         ::std::declval<const symbol_idx_set &>(),
+                                                                         ::std::declval<const symbol_set &>()))>;
+                } else {
+                    return false;
+                }
+            } else {
+                if constexpr (is_key_with_degree_v<const key_t &>) {
+                    return is_integral_v<decltype(::obake::key_degree(::std::declval<const key_t &>(),
+                                                                       ::std::declval<const symbol_set &>()))>;
+                } else {
+                    return false;
+                }
+            }
+        }();
+
+        return deg_ok
+               && ::std::conjunction_v<
+                   ::std::is_constructible<cf_t, int>, is_in_place_multipliable<cf_t &, const cf_t &>,
+                   is_in_place_addable<T &, T>, ::std::is_same<T, detected_t<::obake::detail::mul_t, T, cf_t>>,
+                   ::std::is_same<T, detected_t<::obake::detail::div_t, T, const cf_t &>>>;
+    }
+}
+
+template <typename T, typename U, typename... Args>
+inline constexpr bool pow_poly_miller_enabled = detail::pow_poly_miller_enabled_impl<T, U, Args...>();
+
+// Exponentiation via binary exponentiation (i.e., repeated squaring).
+// Requires n >= 1.
+template <typename T>
+inline T pow_poly_binexp(const T &x, unsigned n)
+{
+    assert(n >= 1u);
+
+    T retval, base(x);
+    bool init = false;
+
+    while (true) {
+        if (n % 2u == 1u) {
+            if (init) {
+                retval = retval * base;
+            } else {
+                retval = base;
+                init = true;
+            }
+        }
+
+        n /= 2u;
+        if (n == 0u) {
+            break;
+        }
+
+        // NOTE: this will run the squaring kernel
+        // of the multiplication engines.
+        base = base * base;
+    }
+
+    return retval;
+}
+
+// Exponentiation via J.C.P. Miller's recurrence.
+//
+// Let P = P_0 + P_1 + ... + P_d be the decomposition of x into
+// components which are homogeneous with respect to the (partial)
+// degree, and let P_0 = c be a nonzero constant. From the identity
+// P * E(P**n) = n * P**n * E(P), where E is the Euler operator (which
+// multiplies a homogeneous component by its degree), it follows that
+// the homogeneous components A_k of P**n satisfy A_0 = c**n and
+//
+// A_k = 1 / (k * c) * sum_{j=1}^{min(k, d)} ((n + 1) * j - k) * P_j * A_{k-j}.
+//
+// The cost of computing P**n in this way is roughly that of a single
+// multiplication of P by P**n, which for dense multi-term bases is
+// much less than the cost of repeated multiplications. If a truncation
+// limit is provided in args, the recurrence is stopped at the limit.
+//
+// The return value will be written into retval. If the recurrence
+// cannot be used (e.g., because x has no constant term),
+// false will be returned and retval will not be modified.
+template <typename T, typename U, typename... Args>
+inline bool pow_poly_miller(T &retval, const T &x, const U &y, unsigned n, const Args &...args)
+{
+    static_assert(sizeof...(Args) <= 2u);
+
+    assert(x.size() > 1u);
+    assert(n >= 2u);
+
+    using cf_t = series_cf_t<T>;
+
+    const auto &ss = x.get_symbol_set();
+
+    // The indices of the symbols with respect to which
+    // the partial degree is computed (only in partial degree
+    // truncation).
+    const auto si = [&ss, &args...]() {
+        if constexpr (sizeof...(Args) == 2u) {
+            return ::obake::detail::ss_intersect_idx(::std::get<1>(::std::forward_as_tuple(args...)), ss);
+        } else {
+            ::obake::detail::ignore(ss, args...);
+
+            return symbol_idx_set{};
+        }
+    }();
+
+    // Decompose x into homogeneous components
+    // and locate its constant term.
+    const series_term_t<T> *t0 = nullptr;
+    ::std::map<unsigned, T> comps;
+    for (const auto &t : x) {
+        unsigned g;
+        const auto ret = [&]() {
+            if constexpr (sizeof...(Args) == 2u) {
+                return ::obake::safe_convert(g, ::obake::key_p_degree(t.first, si, ss));
+            } else {
+                return ::obake::safe_convert(g, ::obake::key_degree(t.first, ss));
+            }
+        }();
+        if (!ret) {
+            // The degree is negative or too large.
+            return false;
+        }
+
+        if (g == 0u) {
+            // NOTE: the component with zero degree
+            // must consist of a constant.
+            if (!::obake::key_is_one(t.first, ss)) {
+                return false;
+            }
+
+            t0 = &t;
+        } else {
+            auto [it, new_comp] = comps.try_emplace(g);
+            if (new_comp) {
+                it->second.set_symbol_set_fw(x.get_symbol_set_fw());
+            }
+            it->second.add_term(t.first, t.second);
+        }
+    }
+
+    if (t0 == nullptr) {
+        return false;
+    }
+
+    // NOTE: x has more than 1 term, thus comps
+    // cannot be empty.
+    assert(!comps.empty());
+
+    // The maximum degree of the components.
+    const auto d = comps.rbegin()->first;
+
+    // Make sure that the integral factors in the
+    // recurrence can be represented as int.
+    if (static_cast<unsigned long long>(n + 1ull) * d
+        > static_cast<unsigned long long>(::obake::detail::limits_max<int>)) {
+        return false;
+    }
+
+    // Determine the degree of the last component
+    // of the result that we need to compute.
+    auto k_max = n * d;
+    if constexpr (sizeof...(Args) > 0u) {
+        const auto &lim = ::std::get<0>(::std::forward_as_tuple(args...));
+
+        // NOTE: skip the check for unsigned integral limits,
+        // which can never be negative.
+        using lim_t = remove_cvref_t<decltype(lim)>;
+        if constexpr (!is_integral_v<lim_t> || is_signed_v<lim_t>) {
+            if (lim < 0) {
+                // Negative truncation limit, the result is empty.
+                T tmp;
+                tmp.set_symbol_set_fw(x.get_symbol_set_fw());
+                retval = ::std::move(tmp);
+
+                return true;
+            }
+        }
+
+        unsigned ulim;
+        if (::obake::safe_convert(ulim, lim)) {
+            k_max = ::std::min(k_max, ulim);
+        }
+    }
+
+    const auto &c0 = t0->second;
+
+    // The homogeneous components of the result.
+    ::std::vector<T> A;
+    A.reserve(::obake::safe_cast<decltype(A.size())>(k_max + 1ull));
+
+    // A_0 = c**n.
+    // NOTE: we checked in the default implementation that coefficient
+    // exponentiation is supported via const lvalue refs.
+    A.emplace_back();
+    A.back().set_symbol_set_fw(x.get_symbol_set_fw());
+    A.back().add_term(t0->first, ::obake::pow(c0, y));
+
+    for (unsigned k = 1; k <= k_max; ++k) {
+        T acc;
+        acc.set_symbol_set_fw(x.get_symbol_set_fw());
+
+        for (const auto &[j, p_j] : comps) {
+            if (j > k) {
+                break;
+            }
+
+            const auto &a = A[k - j];
+            if (a.empty()) {
+                continue;
+            }
+
+            // NOTE: we checked above that the factor
+            // can be represented as an int.
+            const auto f = static_cast<int>(static_cast<long long>(n + 1ull) * j - static_cast<long long>(k));
+            if (f == 0) {
+                continue;
+            }
+
+            acc += p_j * a * cf_t(f);
+        }
+
+        // Divide by k * c.
+        // NOTE: in exact arithmetic, the division is exact.
+        cf_t den(static_cast<int>(k));
+        den *= c0;
+        A.push_back(::std::move(acc) / ::std::as_const(den));
+    }
+
+    // Assemble the result.
+    T tmp(::std::move(A[0]));
+    for (decltype(A.size()) k = 1; k < A.size(); ++k) {
+        tmp += ::std::move(A[k]);
+    }
+    retval = ::std::move(tmp);
+
+    return true;
+}
+
+// Implementation of the specialised pow() implementation
+// for polynomials. args are the optional truncation arguments
+// (degree limit and, for partial degree truncation, the list of symbols,
+// or, for weighted degree truncation, the weights, or a coefficient threshold),
+// which are used only in the exponentiation via Miller's recurrence (the
+// truncation of the result is the responsibility of the caller). Weighted
+// degree truncation and a coefficient threshold disable Miller's recurrence.
+template <typename T, typename U, typename... Args>
+inline auto pow_poly_impl(T &&x, U &&y, const Args &...args)
 {
     using ret_t = customisation::internal::series_default_pow_ret_t<T &&, U &&>;
 
@@ -2158,18 +7030,61 @@ inline auto pow_poly_impl(T &&x, U &&y)
                             ::obake::pow(it->second, ::std::as_const(y)));
 
             return retval;
-        } else {
-            // The polynomial is empty or it has more than 1 term, perfect forward to
-            // the series implementation.
-            return customisation::internal::pow(customisation::internal::pow_t{}, ::std::forward<T>(x),
-                                                ::std::forward<U>(y));
         }
-    } else {
-        // Cannot do monomial exponentiation, perfect forward to
-        // the series implementation.
-        return customisation::internal::pow(customisation::internal::pow_t{}, ::std::forward<T>(x),
-                                            ::std::forward<U>(y));
     }
+
+    if constexpr (pow_poly_rm_enabled<rT, rU>) {
+        // Multi-term polynomial raised to an integral
+        // power greater than 1: try first Miller's recurrence,
+        // then binary exponentiation for large exponents.
+        unsigned n;
+        if (x.size() > 1u && ::obake::safe_convert(n, ::std::as_const(y)) && n >= 2u) {
+            // NOTE: the results of both algorithms are looked up in
+            // and stored into the series pow cache (if possible), so that
+            // repeated exponentiations do not recompute the result.
+            // The result of Miller's recurrence is the same as the
+            // result of repeated multiplications, as the truncation
+            // limits in args come from the tag of x (see the power
+            // series exponentiation).
+            constexpr auto use_cache = is_equality_comparable_v<const series_cf_t<rT> &>;
+
+            if constexpr (use_cache) {
+                if (auto cached = customisation::internal::series_pow_cache_lookup(x, n)) {
+                    return ret_t(::std::move(*cached));
+                }
+            }
+
+            auto store = [&x, n](const ret_t &r) {
+                if constexpr (use_cache) {
+                    customisation::internal::series_pow_cache_store(x, n, r);
+                } else {
+                    ::obake::detail::ignore(x, n, r);
+                }
+            };
+
+            if constexpr (pow_poly_miller_enabled<rT, rU, Args...>) {
+                ret_t retval;
+                if (detail::pow_poly_miller(retval, ::std::as_const(x), ::std::as_const(y), n, args...)) {
+                    store(retval);
+
+                    return retval;
+                }
+            }
+
+            if (n >= pow_poly_binexp_min_exp) {
+                auto retval = detail::pow_poly_binexp(::std::as_const(x), n);
+                store(retval);
+
+                return retval;
+            }
+        }
+    }
+
+    // In all the other cases, perfect forward to
+    // the series implementation.
+    ::obake::detail::ignore(args...);
+
+    return customisation::internal::pow(customisation::internal::pow_t{}, ::std::forward<T>(x), ::std::forward<U>(y));
 }
 
 } // namespace detail
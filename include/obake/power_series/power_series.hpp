@@ -9,6 +9,7 @@
 #ifndef OBAKE_POWER_SERIES_POWER_SERIES_HPP
 #define OBAKE_POWER_SERIES_POWER_SERIES_HPP
 
+#include <algorithm>
 #include <cstddef>
 #include <ostream>
 #include <sstream>
@@ -27,7 +28,10 @@
 
 #include <fmt/core.h>
 
+#include <mp++/integer.hpp>
+
 #include <obake/detail/fw_utils.hpp>
+#include <obake/detail/ignore.hpp>
 #include <obake/detail/it_diff_check.hpp>
 #include <obake/detail/make_array.hpp>
 #include <obake/detail/ss_func_forward.hpp>
@@ -71,9 +75,12 @@ inline bool operator!=(const no_truncation &, const no_truncation &)
     return false;
 }
 
-// The truncation state.
+// The truncation state: no truncation, total degree
+// truncation, partial degree truncation, coefficient
+// threshold truncation or weighted degree truncation.
 template <typename T>
-using trunc_t = ::std::variant<no_truncation, T, ::std::pair<T, symbol_set>>;
+using trunc_t = ::std::variant<no_truncation, T, ::std::pair<T, symbol_set>, polynomials::cf_threshold,
+                               ::std::pair<T, polynomials::deg_weights>>;
 
 } // namespace detail
 
@@ -148,6 +155,24 @@ inline void load(Archive &ar, ::obake::power_series::detail::trunc_t<T> &t, unsi
 
             break;
         }
+        case 3u: {
+            // NOTE: object tracking is disabled
+            // for cf_threshold.
+            ::obake::polynomials::cf_threshold thr;
+            ar >> thr;
+            t = thr;
+
+            break;
+        }
+        case 4u: {
+            ::std::pair<T, ::obake::polynomials::deg_weights> p;
+            ar >> p;
+            t = ::std::move(p);
+
+            ar.reset_object_address(&::std::get<4>(t), &p);
+
+            break;
+        }
         // LCOV_EXCL_START
         default: {
             obake_throw(::std::invalid_argument, fmt::format("The deserialisation of a truncation limit for a power"
@@ -196,6 +221,11 @@ struct trunc_t_hasher {
                     return 0;
                 } else if constexpr (::std::is_same_v<type, T>) {
                     return ::obake::hash(v);
+                } else if constexpr (::std::is_same_v<type, polynomials::cf_threshold>) {
+                    return polynomials::hash(v);
+                } else if constexpr (::std::is_same_v<type, ::std::pair<T, polynomials::deg_weights>>) {
+                    // NOTE: mix the hashes of degree and weights.
+                    return ::obake::hash(v.first) + polynomials::hash(v.second);
                 } else {
                     // NOTE: mix the hashes of degree and symbol set.
                     return ::obake::hash(v.first) + ::obake::detail::ss_fw_hasher{}(v.second);
@@ -328,6 +358,12 @@ inline ::std::ostream &operator<<(::std::ostream &os, const tag<T> &t)
                              if constexpr (::std::is_same_v<type, T>) {
                                  oss << v;
                                  return "Truncation degree: " + oss.str();
+                             } else if constexpr (::std::is_same_v<type, polynomials::cf_threshold>) {
+                                 oss << v;
+                                 return "Truncation coefficient threshold: " + oss.str();
+                             } else if constexpr (::std::is_same_v<type, ::std::pair<T, polynomials::deg_weights>>) {
+                                 oss << v.first << ", " << v.second;
+                                 return "Weighted truncation degree: " + oss.str();
                              } else {
                                  oss << v.first;
                                  return "Partial truncation degree: " + oss.str() + ", "
@@ -454,6 +490,40 @@ inline void truncate_p_degree(p_series<K, C> &ps, const T &d, const symbol_set &
     });
 }
 
+// Implementation of weighted degree truncation for power series:
+// the terms whose weighted degree (as defined by w) is greater
+// than d are removed. The weighted degree is computed from the
+// partial degrees of the keys, which must be integral.
+template <typename K, typename C, typename T>
+    requires is_integral_v<::obake::detail::psk_deg_t<K>> && LessThanComparable<const T &, ::mppp::integer<1>>
+inline void truncate_w_degree(p_series<K, C> &ps, const T &d, const polynomials::deg_weights &w)
+{
+    const auto &ss = ps.get_symbol_set();
+    const auto groups = polynomials::detail::poly_w_degree_groups(w, ss);
+
+    // Implement on top of filter().
+    ::obake::filter(ps, [deg_ext = polynomials::detail::poly_w_degree_extractor{&groups, &ss}, &d](const auto &t) {
+        return !(d < deg_ext(t));
+    });
+}
+
+// Implementation of coefficient threshold truncation for power series:
+// the terms whose coefficients are smaller (in absolute value) than
+// the threshold are removed. A relative threshold is relative to
+// the largest coefficient (in absolute value) of ps (see the
+// documentation of cf_threshold).
+template <typename K, typename C>
+    requires ::std::is_floating_point_v<C>
+inline void truncate_cf(p_series<K, C> &ps, const polynomials::cf_threshold &thr)
+{
+    const auto abs_thr = polynomials::detail::poly_abs_cf_threshold(thr, ps);
+
+    // Implement on top of filter().
+    ::obake::filter(ps, [abs_thr](const auto &t) {
+        return !(polynomials::detail::poly_mul_cf_mag(t.second) < abs_thr);
+    });
+}
+
 } // namespace power_series
 
 namespace detail
@@ -525,6 +595,57 @@ inline p_series<K, C> &set_truncation_impl(p_series<K, C> &ps, const T &d, symbo
     return ps;
 }
 
+// Set weighted degree truncation.
+template <typename K, typename C, typename T>
+    requires SafelyCastable<const T &, detail::psk_deg_t<K>> && is_integral_v<detail::psk_deg_t<K>>
+inline p_series<K, C> &set_truncation_impl(p_series<K, C> &ps, const T &d, polynomials::deg_weights w)
+{
+    // Convert safely d to the degree type.
+    const auto deg = ::obake::safe_cast<detail::psk_deg_t<K>>(d);
+
+    try {
+        // Proceed with the truncation.
+        power_series::truncate_w_degree(ps, deg, w);
+
+        // Set the truncation policy/level in ps.
+        ps.tag().trunc = power_series::detail::trunc_t<detail::psk_deg_t<K>>(::std::pair{deg, ::std::move(w)});
+
+        // LCOV_EXCL_START
+    } catch (...) {
+        ps.clear();
+
+        throw;
+    }
+    // LCOV_EXCL_STOP
+
+    return ps;
+}
+
+// Set coefficient threshold truncation.
+template <typename K, typename C>
+    requires ::std::is_floating_point_v<C>
+inline p_series<K, C> &set_truncation_impl(p_series<K, C> &ps, const polynomials::cf_threshold &thr)
+{
+    polynomials::detail::poly_mul_check_cf_threshold(thr);
+
+    try {
+        // Proceed with the truncation.
+        power_series::truncate_cf(ps, thr);
+
+        // Set the truncation policy/level in ps.
+        ps.tag().trunc = power_series::detail::trunc_t<detail::psk_deg_t<K>>(thr);
+
+        // LCOV_EXCL_START
+    } catch (...) {
+        ps.clear();
+
+        throw;
+    }
+    // LCOV_EXCL_STOP
+
+    return ps;
+}
+
 } // namespace detail
 
 // Set truncation.
@@ -553,6 +674,20 @@ inline constexpr auto truncate = []<typename K, typename C>(p_series<K, C> &ps)
             if constexpr (::std::is_same_v<type, power_series::detail::no_truncation>) {
             } else if constexpr (::std::is_same_v<type, detail::psk_deg_t<K>>) {
                 power_series::truncate_degree(ps, v);
+            } else if constexpr (::std::is_same_v<type, polynomials::cf_threshold>) {
+                if constexpr (::std::is_floating_point_v<C>) {
+                    power_series::truncate_cf(ps, v);
+                } else {
+                    obake_throw(::std::invalid_argument, "Coefficient threshold truncation is available only for "
+                                                         "power series with floating-point coefficients");
+                }
+            } else if constexpr (::std::is_same_v<type, ::std::pair<detail::psk_deg_t<K>, polynomials::deg_weights>>) {
+                if constexpr (is_integral_v<detail::psk_deg_t<K>>) {
+                    power_series::truncate_w_degree(ps, v.first, v.second);
+                } else {
+                    obake_throw(::std::invalid_argument, "Weighted degree truncation is available only for "
+                                                         "power series with integral degree");
+                }
             } else {
                 power_series::truncate_p_degree(ps, v.first, v.second);
             }
@@ -906,7 +1041,10 @@ inline void tex_stream_insert(::std::ostream &os, const p_series<K, C> &ps)
         [&os](const auto &v) -> ::std::string {
             using type = remove_cvref_t<decltype(v)>;
 
-            if constexpr (::std::is_same_v<type, detail::no_truncation>) {
+            if constexpr (::std::is_same_v<type, detail::no_truncation>
+                          // NOTE: the coefficient threshold is not
+                          // displayed in TeX mode.
+                          || ::std::is_same_v<type, polynomials::cf_threshold>) {
                 return "";
             } else if constexpr (tex_stream_insertable<const deg_t &>) {
                 ::std::ostringstream oss(" + \\mathcal{O}\\left( ");
@@ -919,6 +1057,19 @@ inline void tex_stream_insert(::std::ostream &os, const p_series<K, C> &ps)
 
                 if constexpr (::std::is_same_v<type, deg_t>) {
                     ::obake::tex_stream_insert(oss, v);
+                } else if constexpr (::std::is_same_v<type, ::std::pair<deg_t, polynomials::deg_weights>>) {
+                    ::obake::tex_stream_insert(oss, v.first);
+                    oss << " ; ";
+
+                    // NOTE: display the weights as name:weight pairs.
+                    const auto &w = v.second.weights;
+                    for (auto it = w.begin(); it != w.end();) {
+                        oss << it->first << ':' << it->second;
+
+                        if (++it != w.end()) {
+                            oss << ", ";
+                        }
+                    }
                 } else {
                     ::obake::tex_stream_insert(oss, v.first);
                     oss << " ; ";
@@ -1276,6 +1427,36 @@ constexpr bool ps_mul_algo()
     }
 }
 
+// Multiplication of two power series with
+// coefficient threshold truncation.
+template <typename Ret, typename T, typename U>
+inline Ret ps_pruned_mul(const T &ps0, const U &ps1, const polynomials::cf_threshold &thr)
+{
+    if constexpr (polynomials::detail::poly_mul_pruned_enabled<T, U>) {
+        return polynomials::detail::poly_mul_impl_switch(ps0, ps1, thr);
+    } else {
+        ::obake::detail::ignore(ps0, ps1, thr);
+
+        obake_throw(::std::invalid_argument, "Coefficient threshold truncation is available only for "
+                                             "power series with floating-point coefficients");
+    }
+}
+
+// Multiplication of two power series with
+// weighted degree truncation.
+template <typename Ret, typename T, typename U, typename V>
+inline Ret ps_w_mul(const T &ps0, const U &ps1, const ::std::pair<V, polynomials::deg_weights> &p)
+{
+    if constexpr (polynomials::detail::poly_mul_truncated_w_degree_algo<T, U, V> != 0) {
+        return polynomials::detail::poly_mul_impl_switch(ps0, ps1, p.first, p.second);
+    } else {
+        ::obake::detail::ignore(ps0, ps1, p);
+
+        obake_throw(::std::invalid_argument, "Weighted degree truncation is available only for "
+                                             "power series with integral degree");
+    }
+}
+
 } // namespace detail
 
 // Multiplication between two power series with the same rank via (truncated) polynomial multiplication.
@@ -1319,6 +1500,16 @@ inline ::obake::polynomials::detail::poly_mul_ret_t<p_series<K, C0>, p_series<K,
                         auto ret = polynomials::detail::poly_mul_impl_switch(ps0, ps1, v0);
                         ret.tag() = ::std::move(orig_tag);
                         return ret;
+                    } else if constexpr (::std::is_same_v<type0, polynomials::cf_threshold>) {
+                        // Coefficient threshold truncation.
+                        auto ret = detail::ps_pruned_mul<ret_t>(ps0, ps1, v0);
+                        ret.tag() = ::std::move(orig_tag);
+                        return ret;
+                    } else if constexpr (::std::is_same_v<type0, ::std::pair<deg_t, polynomials::deg_weights>>) {
+                        // Weighted degree truncation.
+                        auto ret = detail::ps_w_mul<ret_t>(ps0, ps1, v0);
+                        ret.tag() = ::std::move(orig_tag);
+                        return ret;
                     } else {
                         // Partial degree truncation.
                         auto ret = polynomials::detail::poly_mul_impl_switch(ps0, ps1, v0.first, v0.second);
@@ -1336,6 +1527,16 @@ inline ::obake::polynomials::detail::poly_mul_ret_t<p_series<K, C0>, p_series<K,
                     auto ret = polynomials::detail::poly_mul_impl_switch(ps0, ps1, v1);
                     ret.tag() = ::std::move(orig_tag);
                     return ret;
+                } else if constexpr (::std::is_same_v<type1, polynomials::cf_threshold>) {
+                    // Coefficient threshold truncation.
+                    auto ret = detail::ps_pruned_mul<ret_t>(ps0, ps1, v1);
+                    ret.tag() = ::std::move(orig_tag);
+                    return ret;
+                } else if constexpr (::std::is_same_v<type1, ::std::pair<deg_t, polynomials::deg_weights>>) {
+                    // Weighted degree truncation.
+                    auto ret = detail::ps_w_mul<ret_t>(ps0, ps1, v1);
+                    ret.tag() = ::std::move(orig_tag);
+                    return ret;
                 } else {
                     // Partial degree truncation.
                     auto ret = polynomials::detail::poly_mul_impl_switch(ps0, ps1, v1.first, v1.second);
@@ -1352,6 +1553,16 @@ inline ::obake::polynomials::detail::poly_mul_ret_t<p_series<K, C0>, p_series<K,
                     auto ret = polynomials::detail::poly_mul_impl_switch(ps0, ps1, v0);
                     ret.tag() = ::std::move(orig_tag);
                     return ret;
+                } else if constexpr (::std::is_same_v<type0, polynomials::cf_threshold>) {
+                    // Coefficient threshold truncation.
+                    auto ret = detail::ps_pruned_mul<ret_t>(ps0, ps1, v0);
+                    ret.tag() = ::std::move(orig_tag);
+                    return ret;
+                } else if constexpr (::std::is_same_v<type0, ::std::pair<deg_t, polynomials::deg_weights>>) {
+                    // Weighted degree truncation.
+                    auto ret = detail::ps_w_mul<ret_t>(ps0, ps1, v0);
+                    ret.tag() = ::std::move(orig_tag);
+                    return ret;
                 } else {
                     // Partial degree truncation.
                     auto ret = polynomials::detail::poly_mul_impl_switch(ps0, ps1, v0.first, v0.second);
@@ -1367,16 +1578,54 @@ inline ::obake::polynomials::detail::poly_mul_ret_t<p_series<K, C0>, p_series<K,
 }
 
 // Exponentiation: we re-use the poly implementation, ensuring
-// that the output is properly truncated.
+// that the output is properly truncated. The truncation
+// settings are passed to the poly implementation, so that
+// the computation can be stopped at the truncation limit
+// where possible.
 template <typename T, typename U>
     requires any_p_series<remove_cvref_t<T>> && (customisation::internal::series_default_pow_algo<T &&, U &&> != 0)
 inline customisation::internal::series_default_pow_ret_t<T &&, U &&> pow(T &&x, U &&y)
 {
+    // Fetch the (partial) degree type.
+    using deg_t = decltype(::obake::degree(::std::as_const(x)));
+
     // Store x's tag.
     auto orig_tag = x.tag();
 
     // Perform the operation.
-    auto ret = polynomials::detail::pow_poly_impl(::std::forward<T>(x), ::std::forward<U>(y));
+    // NOTE: visit the truncation stored in orig_tag, as x might
+    // be moved-from in the poly implementation.
+    auto ret = ::std::visit(
+        [&x, &y](const auto &v) {
+            using type = remove_cvref_t<decltype(v)>;
+
+            if constexpr (::std::is_same_v<type, detail::no_truncation>) {
+                return polynomials::detail::pow_poly_impl(::std::forward<T>(x), ::std::forward<U>(y));
+            } else if constexpr (::std::is_same_v<type, deg_t>) {
+                // Total degree truncation.
+                return polynomials::detail::pow_poly_impl(::std::forward<T>(x), ::std::forward<U>(y), v);
+            } else if constexpr (::std::is_same_v<type, polynomials::cf_threshold>) {
+                // Coefficient threshold truncation: the threshold
+                // is applied in the final truncation below. It is
+                // passed to the poly implementation only in order
+                // to disable Miller's recurrence, which would
+                // ignore it in the intermediate steps.
+                return polynomials::detail::pow_poly_impl(::std::forward<T>(x), ::std::forward<U>(y), v);
+            } else if constexpr (::std::is_same_v<type, ::std::pair<deg_t, polynomials::deg_weights>>) {
+                // Weighted degree truncation: the weighted degree
+                // is applied in the final truncation below. It is
+                // passed to the poly implementation only in order
+                // to disable Miller's recurrence, which would compute
+                // the untruncated result.
+                return polynomials::detail::pow_poly_impl(::std::forward<T>(x), ::std::forward<U>(y), v.first,
+                                                          v.second);
+            } else {
+                // Partial degree truncation.
+                return polynomials::detail::pow_poly_impl(::std::forward<T>(x), ::std::forward<U>(y), v.first,
+                                                          v.second);
+            }
+        },
+        ::std::as_const(orig_tag).trunc.get());
 
     // Re-assign the tag and truncate.
     ret.tag() = ::std::move(orig_tag);
@@ -11,13 +11,16 @@
 
 #include <algorithm>
 #include <any>
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <iterator>
+#include <memory>
 #include <mutex>
 #include <numeric>
+#include <optional>
 #include <ostream>
 #include <sstream>
 #include <stdexcept>
@@ -51,6 +54,7 @@
 #include <obake/cf/cf_stream_insert.hpp>
 #include <obake/cf/cf_tex_stream_insert.hpp>
 #include <obake/config.hpp>
+#include <obake/detail/default_init_allocator.hpp>
 #include <obake/detail/fcast.hpp>
 #include <obake/detail/fmt_compat.hpp>
 #include <obake/detail/ignore.hpp>
@@ -624,6 +628,112 @@ inline void series_sym_extender(To &to, From &&from, const symbol_idx_map<symbol
     }
 }
 
+// The type of the bounds on the keys of a series with
+// key type K (e.g., the exponent limits of monomials).
+// The bounds are available if the key type provides the
+// following ADL hooks:
+// - series_key_bounds_init(const K &, const symbol_set &), which
+//   returns the bounds of a single key,
+// - series_key_bounds_update(B &, const K &, const symbol_set &), which
+//   updates the bounds b with a key,
+// - series_key_bounds_merge(B &, const B &), which merges
+//   two bounds.
+// Otherwise, the type is nonesuch.
+template <typename K>
+using series_key_bounds_init_t
+    = decltype(series_key_bounds_init(::std::declval<const K &>(), ::std::declval<const symbol_set &>()));
+
+template <typename K>
+using series_key_bounds_t = detected_t<series_key_bounds_init_t, K>;
+
+template <typename K>
+inline constexpr bool series_has_key_bounds = is_detected_v<series_key_bounds_init_t, K>;
+
+// Holder for the bounds on the keys of a series (see
+// series::_get_key_bounds()). The bounds are computed lazily
+// by const member functions of the series, thus they are published
+// via an atomic pointer. Copies of the holder do not carry the
+// bounds (which will be recomputed if needed), so that copying
+// a series does not allocate.
+template <typename B>
+class series_key_bounds_cache
+{
+public:
+    series_key_bounds_cache() = default;
+    series_key_bounds_cache(const series_key_bounds_cache &) noexcept {}
+    series_key_bounds_cache(series_key_bounds_cache &&other) noexcept : m_ptr(other.release().release()) {}
+    series_key_bounds_cache &operator=(const series_key_bounds_cache &) noexcept
+    {
+        reset();
+
+        return *this;
+    }
+    series_key_bounds_cache &operator=(series_key_bounds_cache &&other) noexcept
+    {
+        if (this != &other) {
+            reset(other.release());
+        }
+
+        return *this;
+    }
+    ~series_key_bounds_cache()
+    {
+        reset();
+    }
+
+    const B *get() const noexcept
+    {
+        return m_ptr.load(::std::memory_order_acquire);
+    }
+    // Publish the bounds b, unless other bounds were
+    // published in the meantime by another thread. The
+    // published bounds are returned.
+    const B *publish(::std::unique_ptr<B> b) const noexcept
+    {
+        B *expected = nullptr;
+        if (m_ptr.compare_exchange_strong(expected, b.get(), ::std::memory_order_acq_rel,
+                                          ::std::memory_order_acquire)) {
+            return b.release();
+        }
+
+        return expected;
+    }
+    ::std::unique_ptr<B> release() noexcept
+    {
+        return ::std::unique_ptr<B>(m_ptr.exchange(nullptr, ::std::memory_order_acq_rel));
+    }
+    void reset(::std::unique_ptr<B> b = nullptr) noexcept
+    {
+        // NOTE: the holder is reset on every mutation of the series,
+        // thus avoid the atomic exchange if there is nothing to do.
+        // This is safe because mutations cannot be concurrent with
+        // other accesses to the series.
+        if (!b && m_ptr.load(::std::memory_order_relaxed) == nullptr) {
+            return;
+        }
+
+        delete m_ptr.exchange(b.release(), ::std::memory_order_acq_rel);
+    }
+    void swap(series_key_bounds_cache &other) noexcept
+    {
+        auto tmp = release();
+        reset(other.release());
+        other.reset(::std::move(tmp));
+    }
+
+private:
+    mutable ::std::atomic<B *> m_ptr{nullptr};
+};
+
+// Placeholder for keys without bounds.
+template <>
+class series_key_bounds_cache<nonesuch>
+{
+public:
+    void reset() noexcept {}
+    void swap(series_key_bounds_cache &) noexcept {}
+};
+
 } // namespace detail
 
 // NOTE: document that moved-from series are destructible and assignable.
@@ -660,7 +770,8 @@ public:
     series(const series &) = default;
     series(series &&other) noexcept
         : m_s_table(::std::move(other.m_s_table)), m_log2_size(::std::move(other.m_log2_size)),
-          m_tag(::std::move(other.m_tag)), m_symbol_set(::std::move(other.m_symbol_set))
+          m_tag(::std::move(other.m_tag)), m_symbol_set(::std::move(other.m_symbol_set)),
+          m_key_bounds(::std::move(other.m_key_bounds))
     {
 #if !defined(NDEBUG)
         // In debug mode, clear the other segmented table
@@ -821,6 +932,7 @@ public:
         m_log2_size = ::std::move(other.m_log2_size);
         m_tag = ::std::move(other.m_tag);
         m_symbol_set = ::std::move(other.m_symbol_set);
+        m_key_bounds = ::std::move(other.m_key_bounds);
 
 #if !defined(NDEBUG)
         // NOTE: see above.
@@ -930,6 +1042,7 @@ public:
         swap(m_log2_size, other.m_log2_size);
         swap(m_tag, other.m_tag);
         swap(m_symbol_set, other.m_symbol_set);
+        m_key_bounds.swap(other.m_key_bounds);
     }
 
     bool empty() const noexcept
@@ -1241,6 +1354,7 @@ public:
         }
 
         m_symbol_set = s;
+        m_key_bounds.reset();
     }
 
     const detail::ss_fw &get_symbol_set_fw() const
@@ -1255,11 +1369,17 @@ public:
         }
 
         m_symbol_set = s;
+        m_key_bounds.reset();
     }
 
     // Extract a reference to the internal segmented table.
+    // NOTE: the mutable variant resets the cached
+    // bounds on the keys, as the table may be modified
+    // via the returned reference.
     auto &_get_s_table()
     {
+        m_key_bounds.reset();
+
         return m_s_table;
     }
     const auto &_get_s_table() const
@@ -1284,6 +1404,10 @@ public:
         requires Constructible<C, Args...>
     void add_term(T &&key, Args &&...args)
     {
+        // NOTE: the bounds on the keys are recomputed
+        // lazily when needed (see _get_key_bounds()).
+        m_key_bounds.reset();
+
         // NOTE: all checks enabled, don't assume uniqueness.
         detail::series_add_term<Sign, detail::sat_check_zero::on, detail::sat_check_compat_key::on,
                                 detail::sat_check_table_size::on, detail::sat_assume_unique::off>(
@@ -1302,6 +1426,7 @@ public:
         // NOTE: construct + move assign for exception safety.
         m_s_table = s_table_type(s_size_type(1) << l);
         m_log2_size = l;
+        m_key_bounds.reset();
     }
 
     // Remove all the terms in the series.
@@ -1312,6 +1437,85 @@ public:
         for (auto &t : m_s_table) {
             t.clear();
         }
+        m_key_bounds.reset();
+    }
+
+    // Fetch the bounds on the keys of the series
+    // (see detail::series_key_bounds_t). The bounds are
+    // computed on the first invocation, and then cached
+    // in the series until it is modified.
+    // A null pointer is returned if the series is empty.
+    // NOTE: the returned pointer is invalidated by any
+    // subsequent mutation of the series (including
+    // add_term(), non-const access to the segmented table,
+    // assignment and swapping).
+    // NOTE: the returned bounds enclose the keys of the
+    // series, but they are not guaranteed to be tight
+    // (e.g., if they were set via _set_key_bounds()).
+    const detail::series_key_bounds_t<K> *_get_key_bounds() const
+        requires detail::series_has_key_bounds<K>
+    {
+        using b_t = detail::series_key_bounds_t<K>;
+
+        if (empty()) {
+            return nullptr;
+        }
+
+        if (const auto *ptr = m_key_bounds.get()) {
+            return ptr;
+        }
+
+        const auto &ss = m_symbol_set.get();
+
+        // Helper to update the bounds b with the keys
+        // in the tables in the range [it_b, it_e).
+        auto update = [&ss](auto it_b, auto it_e, ::std::optional<b_t> &b) {
+            for (; it_b != it_e; ++it_b) {
+                for (const auto &t : *it_b) {
+                    if (b) {
+                        series_key_bounds_update(*b, t.first, ss);
+                    } else {
+                        b.emplace(series_key_bounds_init(t.first, ss));
+                    }
+                }
+            }
+        };
+
+        ::std::optional<b_t> b;
+        if (m_s_table.size() > 1u) {
+            // Compute the bounds of the tables in parallel.
+            b = ::tbb::parallel_reduce(
+                ::tbb::blocked_range(m_s_table.begin(), m_s_table.end()), ::std::optional<b_t>{},
+                [&update](const auto &range, ::std::optional<b_t> cur) {
+                    update(range.begin(), range.end(), cur);
+
+                    return cur;
+                },
+                [](::std::optional<b_t> b1, const ::std::optional<b_t> &b2) {
+                    if (!b1) {
+                        return b2;
+                    }
+
+                    if (b2) {
+                        series_key_bounds_merge(*b1, *b2);
+                    }
+
+                    return b1;
+                });
+        } else {
+            update(m_s_table.begin(), m_s_table.end(), b);
+        }
+
+        assert(b);
+
+        return m_key_bounds.publish(::std::make_unique<b_t>(::std::move(*b)));
+    }
+    // Set the bounds on the keys of the series.
+    // NOTE: the bounds must enclose the keys of the series.
+    void _set_key_bounds(const detail::series_key_bounds_t<K> &b)
+        requires detail::series_has_key_bounds<K>
+    {
+        m_key_bounds.reset(::std::make_unique<detail::series_key_bounds_t<K>>(b));
     }
 
     // Clear the series.
@@ -1517,6 +1721,7 @@ private:
     unsigned m_log2_size;
     Tag m_tag;
     detail::ss_fw m_symbol_set;
+    [[no_unique_address]] detail::series_key_bounds_cache<detail::series_key_bounds_t<K>> m_key_bounds;
 };
 
 } // namespace obake
@@ -1620,16 +1825,17 @@ OBAKE_DLL_PUBLIC ::std::tuple<series_pow_map_t &, ::std::mutex &> get_series_pow
 // Function to clear the global series pow cache.
 OBAKE_DLL_PUBLIC void clear_series_pow_map();
 
-// Fetch the n-th natural power of the input
-// series 'base' from the global cache. If the
-// power is not present in the cache already,
-// it will be computed on the fly.
+// Fetch from the series pow cache map the vector of
+// the natural powers of the input series 'base'. If 'base'
+// is not in the cache yet, it will be added to it.
+// The vector of powers is guaranteed to contain at least
+// base**0. A power which has not been computed yet is
+// represented by an empty std::any.
+// NOTE: the mutex associated to map must be locked
+// before invoking this function.
 template <typename Base>
-inline Base series_pow_from_cache(const Base &base, unsigned n)
+inline ::std::vector<::std::any> &series_pow_cache_powers(series_pow_map_t &map, const Base &base)
 {
-    // Fetch the global data.
-    auto [map, mutex] = internal::get_series_pow_map();
-
     // Turn the type into a type_index.
     ::std::type_index t_idx(typeid(Base));
 
@@ -1681,18 +1887,10 @@ inline Base series_pow_from_cache(const Base &base, unsigned n)
         }
     };
 
-    // Lock down before accessing the cache.
-    ::std::lock_guard lock(mutex);
-
     // Try first to locate the series_te_pow_map_t for the current type,
     // then, in that map, try to locate 'base'. Use try_emplace() so that
     // table elements are created as needed.
-    auto it = map.try_emplace(t_idx, 0, hasher{}, comparer{}).first->second.try_emplace(base).first;
-
-    // Fetch a reference to the base and the corresponding
-    // exponentiation vector.
-    const auto &b = ::std::any_cast<const Base &>(it->first);
-    auto &v = it->second;
+    auto &v = map.try_emplace(t_idx, 0, hasher{}, comparer{}).first->second.try_emplace(base).first->second;
 
     // If the exponentiation vector is empty, init it with
     // base**0 = 1.
@@ -1704,9 +1902,111 @@ inline Base series_pow_from_cache(const Base &base, unsigned n)
         v.emplace_back(Base(1));
     }
 
+    return v;
+}
+
+// Look up the n-th natural power of the input series 'base'
+// in the global cache. If the power is not present in the
+// cache, an empty optional will be returned.
+template <typename Base>
+inline ::std::optional<Base> series_pow_cache_lookup(const Base &base, unsigned n)
+{
+    // Fetch the global data.
+    auto [map, mutex] = internal::get_series_pow_map();
+
+    // Lock down before accessing the cache.
+    ::std::lock_guard lock(mutex);
+
+    const auto &v = internal::series_pow_cache_powers(map, base);
+
+    if (n < v.size() && v[n].has_value()) {
+        return ::std::any_cast<const Base &>(v[n]);
+    }
+
+    return {};
+}
+
+// Store the n-th natural power of the input series 'base'
+// into the global cache. If the power is already present
+// in the cache, the cache will not be modified.
+template <typename Base>
+inline void series_pow_cache_store(const Base &base, unsigned n, const Base &pow)
+{
+    // Fetch the global data.
+    auto [map, mutex] = internal::get_series_pow_map();
+
+    // Lock down before accessing the cache.
+    ::std::lock_guard lock(mutex);
+
+    auto &v = internal::series_pow_cache_powers(map, base);
+
+    if (n >= v.size()) {
+        // NOTE: the powers between the current size
+        // and n are marked as not computed yet.
+        v.resize(static_cast<decltype(v.size())>(n) + 1u);
+    }
+
+    if (!v[n].has_value()) {
+        v[n] = pow;
+    }
+}
+
+// Fetch the n-th natural power of the input
+// series 'base' from the global cache. If the
+// power is not present in the cache already,
+// it will be computed on the fly.
+template <typename Base>
+inline Base series_pow_from_cache(const Base &base, unsigned n)
+{
+    // Fetch the global data.
+    auto [map, mutex] = internal::get_series_pow_map();
+
+    // Lock down before accessing the cache.
+    ::std::lock_guard lock(mutex);
+
+    // Fetch a reference to the exponentiation vector.
+    auto &v = internal::series_pow_cache_powers(map, base);
+
+    if (n < v.size() && v[n].has_value()) {
+        return ::std::any_cast<const Base &>(v[n]);
+    }
+
+    if (n >= v.size()) {
+        v.resize(static_cast<decltype(v.size())>(n) + 1u);
+    }
+
     // Fill in the missing powers as needed.
-    while (v.size() <= n) {
-        v.emplace_back(::std::any_cast<const Base &>(v.back()) * b);
+    // NOTE: the powers are computed via the recurrence
+    // b**k = b**(k-1) * b. For even k, b**k can also be computed
+    // by squaring b**(k/2), which lets the series multiplication
+    // use specialised squaring algorithms. However, squaring
+    // multiplies two large intermediate series together, which,
+    // for dense multi-term bases, is much more expensive than
+    // multiplying by the (small) base. Thus, we square only
+    // if the estimated number of term-by-term products
+    // (taking into account the symmetry of the squaring) is lower.
+    // NOTE: some powers might have been computed already
+    // via other algorithms (see series_pow_cache_store()).
+    for (decltype(v.size()) k = 1; k <= n; ++k) {
+        if (v[k].has_value()) {
+            continue;
+        }
+
+        const auto &prev = ::std::any_cast<const Base &>(v[k - 1u]);
+
+        if (k % 2u == 0u) {
+            const auto &h = ::std::any_cast<const Base &>(v[k / 2u]);
+
+            // NOTE: do the computation in floating-point
+            // in order to avoid overflows.
+            const auto h_size = static_cast<double>(h.size());
+            if (h_size * h_size / 2. < static_cast<double>(prev.size()) * static_cast<double>(base.size())) {
+                v[k] = h * h;
+                continue;
+            }
+        }
+
+        v[k] = prev * base;
     }
 
     // Return a copy of the desired power.
@@ -3766,7 +4066,9 @@ inline auto make_degree_vector(It begin, It end, const symbol_set &ss, bool para
     const auto d_ex = d_impl::d_extractor<T>{&ss};
 
     if (parallel) {
-        ::std::vector<deg_t> retval;
+        // NOTE: use a default-initialising allocator, as all
+        // the elements will be overwritten below.
+        ::obake::detail::dinit_vector<deg_t> retval;
         // NOTE: we require deg_t to be a semi-regular type,
         // thus it is def-constructible.
         retval.resize(::obake::safe_cast<decltype(retval.size())>(end - begin));
@@ -3779,8 +4081,8 @@ inline auto make_degree_vector(It begin, It end, const symbol_set &ss, bool para
 
         return retval;
     } else {
-        return ::std::vector<deg_t>(::boost::make_transform_iterator(begin, d_ex),
-                                    ::boost::make_transform_iterator(end, d_ex));
+        return ::obake::detail::dinit_vector<deg_t>(::boost::make_transform_iterator(begin, d_ex),
+                                                     ::boost::make_transform_iterator(end, d_ex));
     }
 }
 
@@ -3924,7 +4226,9 @@ inline auto make_p_degree_vector(It begin, It end, const symbol_set &ss, const s
     const auto d_ex = d_impl::d_extractor<T>{&s, &si, &ss};
 
     if (parallel) {
-        ::std::vector<deg_t> retval;
+        // NOTE: use a default-initialising allocator, as all
+        // the elements will be overwritten below.
+        ::obake::detail::dinit_vector<deg_t> retval;
         // NOTE: we require deg_t to be a semi-regular type,
         // thus it is def-constructible.
         retval.resize(::obake::safe_cast<decltype(retval.size())>(end - begin));
@@ -3937,8 +4241,8 @@ inline auto make_p_degree_vector(It begin, It end, const symbol_set &ss, const s
 
         return retval;
     } else {
-        return ::std::vector<deg_t>(::boost::make_transform_iterator(begin, d_ex),
-                                    ::boost::make_transform_iterator(end, d_ex));
+        return ::obake::detail::dinit_vector<deg_t>(::boost::make_transform_iterator(begin, d_ex),
+                                                     ::boost::make_transform_iterator(end, d_ex));
     }
 }
 
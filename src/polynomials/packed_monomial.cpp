@@ -6,6 +6,7 @@
 // Public License v. 2.0. If a copy of the MPL was not distributed
 // with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
+#include <array>
 #include <cassert>
 #include <cstdint>
 #include <ostream>
@@ -21,6 +22,7 @@
 #include <obake/config.hpp>
 #include <obake/detail/ignore.hpp>
 #include <obake/detail/limits.hpp>
+#include <obake/detail/to_string.hpp>
 #include <obake/exceptions.hpp>
 #include <obake/kpack.hpp>
 #include <obake/math/safe_cast.hpp>
@@ -50,11 +52,12 @@ void packed_monomial_stream_insert(::std::ostream &os, const packed_monomial<T>
     // NOTE: we know s is not too large from the assert.
     const auto s_size = static_cast<unsigned>(s.size());
     bool wrote_something = false;
-    kunpacker<T> ku(m.get_value(), s_size);
-    T tmp;
+    ::std::array<T, ::obake::detail::kpack_max_size<T>()> exps;
+    kunpack_batch(&m.get_value(), 1, s_size, exps.data());
+    auto e_it = exps.cbegin();
 
     for (const auto &var : s) {
-        ku >> tmp;
+        const auto &tmp = *e_it++;
         if (tmp != T(0)) {
             // The exponent of the current variable
             // is nonzero.
@@ -72,7 +75,13 @@ void packed_monomial_stream_insert(::std::ostream &os, const packed_monomial<T>
             if (tmp != T(1)) {
                 // The exponent is not unitary,
                 // print it.
-                os << "**" << tmp;
+                // NOTE: the standard streams do not
+                // support 128-bit integers.
+                if constexpr (sizeof(T) > sizeof(::std::uint64_t)) {
+                    os << "**" << ::obake::detail::to_string(tmp);
+                } else {
+                    os << "**" << tmp;
+                }
             }
         }
     }
@@ -114,6 +123,20 @@ void key_stream_insert(::std::ostream &os, const packed_monomial<::std::uint64_t
 
 #endif
 
+#if defined(OBAKE_PACKABLE_INT128)
+
+void key_stream_insert(::std::ostream &os, const packed_monomial<__int128_t> &m, const symbol_set &s)
+{
+    detail::packed_monomial_stream_insert(os, m, s);
+}
+
+void key_stream_insert(::std::ostream &os, const packed_monomial<__uint128_t> &m, const symbol_set &s)
+{
+    detail::packed_monomial_stream_insert(os, m, s);
+}
+
+#endif
+
 namespace detail
 {
 
@@ -223,6 +246,20 @@ void key_tex_stream_insert(::std::ostream &os, const packed_monomial<::std::uint
 
 #endif
 
+#if defined(OBAKE_PACKABLE_INT128)
+
+void key_tex_stream_insert(::std::ostream &os, const packed_monomial<__int128_t> &m, const symbol_set &s)
+{
+    detail::packed_monomial_tex_stream_insert(os, m, s);
+}
+
+void key_tex_stream_insert(::std::ostream &os, const packed_monomial<__uint128_t> &m, const symbol_set &s)
+{
+    detail::packed_monomial_tex_stream_insert(os, m, s);
+}
+
+#endif
+
 namespace detail
 {
 
@@ -323,6 +360,22 @@ packed_monomial<::std::uint64_t> key_merge_symbols(const packed_monomial<::std::
 
 #endif
 
+#if defined(OBAKE_PACKABLE_INT128)
+
+packed_monomial<__int128_t> key_merge_symbols(const packed_monomial<__int128_t> &m,
+                                              const symbol_idx_map<symbol_set> &ins_map, const symbol_set &s)
+{
+    return detail::packed_monomial_merge_symbols(m, ins_map, s);
+}
+
+packed_monomial<__uint128_t> key_merge_symbols(const packed_monomial<__uint128_t> &m,
+                                               const symbol_idx_map<symbol_set> &ins_map, const symbol_set &s)
+{
+    return detail::packed_monomial_merge_symbols(m, ins_map, s);
+}
+
+#endif
+
 namespace detail
 {
 
@@ -339,11 +392,12 @@ T packed_monomial_key_degree(const packed_monomial<T> &p, const symbol_set &ss)
     // NOTE: because we assume compatibility, the static cast is safe.
     const auto s_size = static_cast<unsigned>(ss.size());
 
-    T retval(0), tmp;
-    kunpacker<T> ku(p.get_value(), s_size);
+    ::std::array<T, ::obake::detail::kpack_max_size<T>()> exps;
+    kunpack_batch(&p.get_value(), 1, s_size, exps.data());
+
+    T retval(0);
     for (auto i = 0u; i < s_size; ++i) {
-        ku >> tmp;
-        retval += tmp;
+        retval += exps[i];
     }
 
     return retval;
@@ -377,6 +431,20 @@ T packed_monomial_key_degree(const packed_monomial<T> &p, const symbol_set &ss)
 
 #endif
 
+#if defined(OBAKE_PACKABLE_INT128)
+
+__int128_t key_degree(const packed_monomial<__int128_t> &p, const symbol_set &ss)
+{
+    return detail::packed_monomial_key_degree(p, ss);
+}
+
+__uint128_t key_degree(const packed_monomial<__uint128_t> &p, const symbol_set &ss)
+{
+    return detail::packed_monomial_key_degree(p, ss);
+}
+
+#endif
+
 namespace detail
 {
 
@@ -439,6 +507,20 @@ T packed_monomial_key_p_degree(const packed_monomial<T> &p, const symbol_idx_set
 
 #endif
 
+#if defined(OBAKE_PACKABLE_INT128)
+
+__int128_t key_p_degree(const packed_monomial<__int128_t> &p, const symbol_idx_set &si, const symbol_set &ss)
+{
+    return detail::packed_monomial_key_p_degree(p, si, ss);
+}
+
+__uint128_t key_p_degree(const packed_monomial<__uint128_t> &p, const symbol_idx_set &si, const symbol_set &ss)
+{
+    return detail::packed_monomial_key_p_degree(p, si, ss);
+}
+
+#endif
+
 namespace detail
 {
 
@@ -498,6 +580,20 @@ void key_trim_identify(::std::vector<int> &v, const packed_monomial<::std::uint6
 
 #endif
 
+#if defined(OBAKE_PACKABLE_INT128)
+
+void key_trim_identify(::std::vector<int> &v, const packed_monomial<__int128_t> &p, const symbol_set &ss)
+{
+    return detail::packed_monomial_key_trim_identify(v, p, ss);
+}
+
+void key_trim_identify(::std::vector<int> &v, const packed_monomial<__uint128_t> &p, const symbol_set &ss)
+{
+    return detail::packed_monomial_key_trim_identify(v, p, ss);
+}
+
+#endif
+
 namespace detail
 {
 
@@ -573,6 +669,22 @@ packed_monomial<::std::uint64_t> key_trim(const packed_monomial<::std::uint64_t>
 
 #endif
 
+#if defined(OBAKE_PACKABLE_INT128)
+
+packed_monomial<__int128_t> key_trim(const packed_monomial<__int128_t> &p, const symbol_idx_set &si,
+                                     const symbol_set &ss)
+{
+    return detail::packed_monomial_key_trim(p, si, ss);
+}
+
+packed_monomial<__uint128_t> key_trim(const packed_monomial<__uint128_t> &p, const symbol_idx_set &si,
+                                      const symbol_set &ss)
+{
+    return detail::packed_monomial_key_trim(p, si, ss);
+}
+
+#endif
+
 namespace detail
 {
 
@@ -649,6 +761,22 @@ monomial_diff(const packed_monomial<::std::uint64_t> &p, const symbol_idx &idx,
 
 #endif
 
+#if defined(OBAKE_PACKABLE_INT128)
+
+::std::pair<__int128_t, packed_monomial<__int128_t>> monomial_diff(const packed_monomial<__int128_t> &p,
+                                                                   const symbol_idx &idx, const symbol_set &ss)
+{
+    return detail::packed_monomial_monomial_diff(p, idx, ss);
+}
+
+::std::pair<__uint128_t, packed_monomial<__uint128_t>>
+monomial_diff(const packed_monomial<__uint128_t> &p, const symbol_idx &idx, const symbol_set &ss)
+{
+    return detail::packed_monomial_monomial_diff(p, idx, ss);
+}
+
+#endif
+
 namespace detail
 {
 
@@ -734,6 +862,22 @@ monomial_integrate(const packed_monomial<::std::uint64_t> &p, const symbol_idx &
 
 #endif
 
+#if defined(OBAKE_PACKABLE_INT128)
+
+::std::pair<__int128_t, packed_monomial<__int128_t>>
+monomial_integrate(const packed_monomial<__int128_t> &p, const symbol_idx &idx, const symbol_set &ss)
+{
+    return detail::packed_monomial_monomial_integrate(p, idx, ss);
+}
+
+::std::pair<__uint128_t, packed_monomial<__uint128_t>>
+monomial_integrate(const packed_monomial<__uint128_t> &p, const symbol_idx &idx, const symbol_set &ss)
+{
+    return detail::packed_monomial_monomial_integrate(p, idx, ss);
+}
+
+#endif
+
 } // namespace polynomials
 
 } // namespace obake
@@ -0,0 +1,53 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <atomic>
+#include <cstddef>
+
+#include <obake/polynomials/polynomial.hpp>
+
+namespace obake::polynomials
+{
+
+namespace detail
+{
+
+namespace
+{
+
+// The memory ceiling for polynomial multiplications.
+::std::atomic<::std::size_t> mul_mem_limit(0);
+
+// The flag for the splitting of hot segments.
+::std::atomic<bool> mul_split_hot_segments(true);
+
+} // namespace
+
+} // namespace detail
+
+void set_mul_mem_limit(::std::size_t limit)
+{
+    detail::mul_mem_limit.store(limit, ::std::memory_order_relaxed);
+}
+
+::std::size_t get_mul_mem_limit()
+{
+    return detail::mul_mem_limit.load(::std::memory_order_relaxed);
+}
+
+void set_mul_split_hot_segments(bool flag)
+{
+    detail::mul_split_hot_segments.store(flag, ::std::memory_order_relaxed);
+}
+
+bool get_mul_split_hot_segments()
+{
+    return detail::mul_split_hot_segments.load(::std::memory_order_relaxed);
+}
+
+} // namespace obake::polynomials
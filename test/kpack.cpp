@@ -15,6 +15,7 @@
 #include <vector>
 
 #include <obake/config.hpp>
+#include <obake/detail/limits.hpp>
 #include <obake/detail/to_string.hpp>
 #include <obake/detail/tuple_for_each.hpp>
 #include <obake/kpack.hpp>
@@ -26,7 +27,7 @@
 
 using namespace obake;
 
-using int_types = std::tuple<std::int32_t, std::uint32_t
+using int_types = std::tuple<std::int16_t, std::uint16_t, std::int32_t, std::uint32_t
 #if defined(OBAKE_PACKABLE_INT64)
                              ,
                              std::int64_t, std::uint64_t
@@ -235,3 +236,252 @@ TEST_CASE("k_packer_unpacker")
                 + "': the number of values already pushed to the packer is equal to the packer's size (3)");
     });
 }
+
+TEST_CASE("kunpack_batch")
+{
+    obake_test::disable_slow_stack_traces();
+
+    detail::tuple_for_each(int_types{}, [](const auto &n) {
+        using int_t = remove_cvref_t<decltype(n)>;
+
+        // Zero size.
+        std::vector<int_t> codes(3), out;
+        kunpack_batch(codes.data(), codes.size(), 0, out.data());
+        codes[1] = 42;
+        OBAKE_REQUIRES_THROWS_CONTAINS(kunpack_batch(codes.data(), codes.size(), 0, out.data()),
+                                       std::invalid_argument,
+                                       "Only a value of zero can be used in a Kronecker unpacker with a size of zero, "
+                                       "but a value of 42 was provided instead");
+
+        // Empty batch.
+        kunpack_batch(codes.data(), 0, 3, out.data());
+
+        OBAKE_REQUIRES_THROWS_CONTAINS(
+            kunpack_batch(codes.data(), codes.size(), detail::kpack_max_size<int_t>() + 1u, out.data()),
+            std::overflow_error, "Invalid size specified in a batch Kronecker unpacking for the type '");
+
+        // Random testing against kunpacker.
+        for (auto size = 1u; size <= detail::kpack_max_size<int_t>(); ++size) {
+            const auto [lim_min, lim_max] = detail::kpack_get_lims<int_t>(size);
+            std::uniform_int_distribution<int_t> idist(lim_min, lim_max);
+
+            const auto nc = static_cast<std::size_t>(size * 7u);
+            codes.resize(nc);
+            out.resize(nc * size);
+
+            for (auto &c : codes) {
+                kpacker<int_t> kp(size);
+                for (auto j = 0u; j < size; ++j) {
+                    kp << idist(rng);
+                }
+                c = kp.get();
+            }
+            // Include the limits.
+            codes[0] = detail::kpack_get_klims<int_t>(size).first;
+            codes[1] = detail::kpack_get_klims<int_t>(size).second;
+
+            kunpack_batch(codes.data(), nc, size, out.data());
+
+            int_t tmp;
+            for (std::size_t i = 0; i < nc; ++i) {
+                kunpacker<int_t> ku(codes[i], size);
+                for (auto j = 0u; j < size; ++j) {
+                    ku >> tmp;
+                    REQUIRE(out[j * nc + i] == tmp);
+                }
+            }
+
+            // Out of range values.
+            if constexpr (is_signed_v<int_t>) {
+                codes[2] = detail::kpack_get_klims<int_t>(size).first - int_t(1);
+            } else {
+                codes[2] = detail::kpack_get_klims<int_t>(size).second + int_t(1);
+            }
+            OBAKE_REQUIRES_THROWS_CONTAINS(kunpack_batch(codes.data(), nc, size, out.data()), std::overflow_error,
+                                           "The value " + detail::to_string(codes[2])
+                                               + " passed to a Kronecker unpacker for the type '" + type_name<int_t>()
+                                               + "' is outside the allowed range");
+        }
+    });
+}
+
+TEST_CASE("kpack_data")
+{
+    // The 16-bit data.
+    REQUIRE(detail::kpack_max_size<std::int16_t>() == 5u);
+    REQUIRE(detail::kpack_data<std::int16_t>::deltas == std::array<std::int16_t, 5>{32767, 179, 31, 11, 7});
+    REQUIRE(detail::kpack_data<std::int16_t>::lims == std::array<std::int16_t, 5>{16383, 89, 15, 5, 3});
+    REQUIRE(detail::kpack_max_size<std::uint16_t>() == 5u);
+    REQUIRE(detail::kpack_data<std::uint16_t>::deltas == std::array<std::uint16_t, 5>{65535u, 251u, 37u, 13u, 7u});
+    REQUIRE(detail::kpack_data<std::uint16_t>::klims
+            == std::array<std::uint16_t, 5>{65534u, 63000u, 50652u, 28560u, 16806u});
+
+    // Check the division data against the native division.
+    detail::tuple_for_each(int_types{}, [](const auto &n) {
+        using int_t = remove_cvref_t<decltype(n)>;
+        using uint_t = make_unsigned_t<int_t>;
+
+        std::uniform_int_distribution<uint_t> udist;
+
+        for (auto size = 1u; size <= detail::kpack_max_size<int_t>(); ++size) {
+            const auto delta = static_cast<uint_t>(detail::kpack_get_delta<int_t>(size));
+
+            uint_t d = 1;
+            for (auto j = 0u; j <= size; ++j) {
+                const auto [mp, sh1, sh2] = detail::kpack_data<int_t>::divcnst[size - 1u][j];
+
+                for (const auto x : {uint_t(0), uint_t(d - 1u), d, detail::limits_max<uint_t>}) {
+                    REQUIRE(detail::kpack_divcnst(x, mp, sh1, sh2) == static_cast<uint_t>(x / d));
+                }
+                for (auto k = 0; k < 100; ++k) {
+                    const auto x = udist(rng);
+                    REQUIRE(detail::kpack_divcnst(x, mp, sh1, sh2) == static_cast<uint_t>(x / d));
+                }
+
+                if (j < size) {
+                    d = static_cast<uint_t>(d * delta);
+                }
+            }
+        }
+    });
+}
+
+TEST_CASE("kunpack_fixed_size")
+{
+    obake_test::disable_slow_stack_traces();
+
+    detail::tuple_for_each(int_types{}, [](const auto &n) {
+        using int_t = remove_cvref_t<decltype(n)>;
+
+        auto check = []<unsigned Size>() {
+            const auto [lim_min, lim_max] = detail::kpack_get_lims<int_t>(Size);
+            const auto [klim_min, klim_max] = detail::kpack_get_klims<int_t>(Size);
+            std::uniform_int_distribution<int_t> idist(lim_min, lim_max);
+
+            std::array<int_t, Size> out;
+            int_t tmp;
+
+            auto cmp = [&out, &tmp](const int_t &c) {
+                kunpack<Size>(c, out.data());
+                kunpacker<int_t> ku(c, Size);
+                for (const auto &x : out) {
+                    ku >> tmp;
+                    REQUIRE(x == tmp);
+                }
+            };
+
+            for (auto k = 0; k < ntrials / 10; ++k) {
+                kpacker<int_t> kp(Size);
+                for (auto j = 0u; j < Size; ++j) {
+                    kp << idist(rng);
+                }
+                cmp(kp.get());
+            }
+            cmp(int_t(0));
+            cmp(klim_min);
+            cmp(klim_max);
+
+            if constexpr (is_signed_v<int_t>) {
+                OBAKE_REQUIRES_THROWS_CONTAINS(kunpack<Size>(int_t(klim_min - int_t(1)), out.data()),
+                                               std::overflow_error,
+                                               "The value " + detail::to_string(klim_min - int_t(1))
+                                                   + " passed to a Kronecker unpacker for the type '"
+                                                   + type_name<int_t>() + "' is outside the allowed range");
+            } else {
+                OBAKE_REQUIRES_THROWS_CONTAINS(kunpack<Size>(int_t(klim_max + int_t(1)), out.data()),
+                                               std::overflow_error,
+                                               "The value " + detail::to_string(klim_max + int_t(1))
+                                                   + " passed to a Kronecker unpacker for the type '"
+                                                   + type_name<int_t>() + "' is outside the allowed range");
+            }
+        };
+
+        [&check]<unsigned... S>(std::integer_sequence<unsigned, S...>) {
+            (check.template operator()<S + 1u>(), ...);
+        }(std::make_integer_sequence<unsigned, detail::kpack_max_size<int_t>()>{});
+    });
+}
+
+#if defined(OBAKE_PACKABLE_INT128)
+
+TEST_CASE("k_packer_unpacker_int128")
+{
+    obake_test::disable_slow_stack_traces();
+
+    // NOTE: std::uniform_int_distribution does not support
+    // 128-bit integers, draw random 128-bit values instead
+    // and reduce them into the components' range.
+    std::mt19937_64 rng64;
+    auto rand128 = [&rng64]() { return (__uint128_t(rng64()) << 64) + rng64(); };
+
+    detail::tuple_for_each(std::tuple<__int128_t, __uint128_t>{}, [&rand128](const auto &n) {
+        using int_t = remove_cvref_t<decltype(n)>;
+        using kp_t = kpacker<int_t>;
+        using ku_t = kunpacker<int_t>;
+
+        REQUIRE(is_kpackable_v<int_t>);
+        REQUIRE(detail::kpack_max_size<int_t>() == 42u);
+
+        int_t out;
+
+        for (auto size = 1u; size <= detail::kpack_max_size<int_t>(); ++size) {
+            const auto [lim_min, lim_max] = detail::kpack_get_lims<int_t>(size);
+            const auto span = static_cast<__uint128_t>(lim_max - lim_min) + 1u;
+
+            std::vector<int_t> v(size);
+
+            for (auto k = 0; k < ntrials / 10; ++k) {
+                kp_t kp(size);
+                for (auto &x : v) {
+                    x = static_cast<int_t>(lim_min + static_cast<int_t>(rand128() % span));
+                    kp << x;
+                }
+                ku_t ku(kp.get(), size);
+                for (const auto &x : v) {
+                    ku >> out;
+                    REQUIRE(out == x);
+                }
+            }
+
+            // Test maximal/minimal packing.
+            for (const auto lim : {lim_min, lim_max}) {
+                kp_t kp(size);
+                for (auto j = 0u; j < size; ++j) {
+                    kp << lim;
+                }
+                ku_t ku(kp.get(), size);
+                for (auto j = 0u; j < size; ++j) {
+                    ku >> out;
+                    REQUIRE(out == lim);
+                }
+            }
+
+            // Check out of range packing.
+            kp_t kp(size);
+            OBAKE_REQUIRES_THROWS_CONTAINS(kp << (lim_max + int_t(1)), std::overflow_error,
+                                           "Cannot push the value " + detail::to_string(lim_max + int_t(1))
+                                               + " to this Kronecker packer for the type '" + type_name<int_t>()
+                                               + "': the value is outside the allowed range");
+        }
+
+        // Fixed-size unpacking.
+        {
+            const auto [lim_min, lim_max] = detail::kpack_get_lims<int_t>(42);
+            const auto span = static_cast<__uint128_t>(lim_max - lim_min) + 1u;
+
+            std::array<int_t, 42> v, fout;
+
+            for (auto k = 0; k < ntrials / 10; ++k) {
+                kp_t kp(42);
+                for (auto &x : v) {
+                    x = static_cast<int_t>(lim_min + static_cast<int_t>(rand128() % span));
+                    kp << x;
+                }
+                kunpack<42>(kp.get(), fout.data());
+                REQUIRE(fout == v);
+            }
+        }
+    });
+}
+
+#endif
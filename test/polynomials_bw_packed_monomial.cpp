@@ -0,0 +1,264 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <mp++/integer.hpp>
+
+#include <obake/config.hpp>
+#include <obake/detail/tuple_for_each.hpp>
+#include <obake/hash.hpp>
+#include <obake/key/key_degree.hpp>
+#include <obake/key/key_is_compatible.hpp>
+#include <obake/key/key_is_one.hpp>
+#include <obake/key/key_merge_symbols.hpp>
+#include <obake/key/key_p_degree.hpp>
+#include <obake/key/key_stream_insert.hpp>
+#include <obake/key/key_tex_stream_insert.hpp>
+#include <obake/key/key_trim.hpp>
+#include <obake/math/degree.hpp>
+#include <obake/math/diff.hpp>
+#include <obake/math/integrate.hpp>
+#include <obake/math/pow.hpp>
+#include <obake/polynomials/bw_packed_monomial.hpp>
+#include <obake/polynomials/monomial_homomorphic_hash.hpp>
+#include <obake/polynomials/monomial_mul.hpp>
+#include <obake/polynomials/monomial_pow.hpp>
+#include <obake/polynomials/monomial_range_overflow_check.hpp>
+#include <obake/polynomials/packed_monomial.hpp>
+#include <obake/polynomials/polynomial.hpp>
+#include <obake/series.hpp>
+#include <obake/symbols.hpp>
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+using namespace obake;
+
+using int_types = std::tuple<std::int32_t, std::uint32_t
+#if defined(OBAKE_PACKABLE_INT64)
+                             ,
+                             std::int64_t, std::uint64_t
+#endif
+                             >;
+
+// Mixed ranges: a high-order variable
+// and low-order ones.
+struct bw_test_layout {
+    static unsigned exponent_bits(const std::string &name)
+    {
+        if (name == "bw_x") {
+            return 18;
+        }
+        if (name == "bw_y" || name == "bw_z") {
+            return 6;
+        }
+        if (name == "bw_a") {
+            return 2;
+        }
+        if (name == "bw_big") {
+            return 40;
+        }
+
+        return 0;
+    }
+};
+
+TEST_CASE("bw_packed_monomial_layout_test")
+{
+    REQUIRE(polynomials::BwLayout<bw_test_layout>);
+    REQUIRE(!polynomials::BwLayout<int>);
+
+    // Layouts are available only when all the symbols are supported.
+    REQUIRE(!polynomials::detail::bw_make_layout<bw_test_layout>(symbol_set{"bw_x", "bw_unsupported"}));
+    // Layouts cannot exceed 64 bits.
+    REQUIRE(!polynomials::detail::bw_make_layout<bw_test_layout>(symbol_set{"bw_big", "bw_x", "bw_y", "bw_z"}));
+    REQUIRE(polynomials::detail::bw_make_layout<bw_test_layout>(symbol_set{"bw_big", "bw_x", "bw_y"}));
+
+    const auto l = polynomials::detail::bw_make_layout<bw_test_layout>(symbol_set{"bw_a", "bw_x", "bw_y"});
+    REQUIRE(l);
+    REQUIRE(l->size == 3u);
+    REQUIRE(l->widths[0] == 2u);
+    REQUIRE(l->widths[1] == 18u);
+    REQUIRE(l->widths[2] == 6u);
+    REQUIRE(l->nbits == 26u);
+
+    // The cached layouts.
+    for (const auto &ss : {symbol_set{"bw_a", "bw_x", "bw_y"}, symbol_set{"bw_a", "bw_x", "bw_y"}, symbol_set{"bw_x"},
+                           symbol_set{"bw_x", "bw_unsupported"}, symbol_set{"bw_a", "bw_x", "bw_y"}, symbol_set{}}) {
+        const auto l0 = polynomials::detail::bw_make_layout<bw_test_layout>(ss);
+        const auto l1 = polynomials::detail::bw_fetch_layout<bw_test_layout>(ss);
+
+        REQUIRE(static_cast<bool>(l0) == static_cast<bool>(l1));
+        if (l0) {
+            REQUIRE(l0->size == l1->size);
+            REQUIRE(l0->nbits == l1->nbits);
+            REQUIRE(std::equal(l0->widths.begin(), l0->widths.begin() + l0->size, l1->widths.begin()));
+        }
+    }
+
+    // The cached layouts for flyweight symbol sets,
+    // alternated with equal and different plain symbol sets.
+    {
+        const detail::ss_fw fw1(symbol_set{"bw_a", "bw_x", "bw_y"}), fw2(symbol_set{"bw_x", "bw_z"});
+
+        for (const auto *ss : {&fw1.get(), &fw1.get(), &fw2.get(), &fw1.get()}) {
+            const auto l1 = polynomials::detail::bw_fetch_layout<bw_test_layout>(*ss);
+            REQUIRE(l1);
+            REQUIRE(l1->size == ss->size());
+
+            const auto l2 = polynomials::detail::bw_fetch_layout<bw_test_layout>(symbol_set(*ss));
+            REQUIRE(l2);
+            REQUIRE(l2->nbits == l1->nbits);
+
+            REQUIRE(!polynomials::detail::bw_fetch_layout<bw_test_layout>(symbol_set{"bw_x", "bw_unsupported"}));
+            REQUIRE(polynomials::detail::bw_fetch_layout<bw_test_layout>(*ss)->nbits == l1->nbits);
+        }
+
+        REQUIRE(polynomials::detail::bw_fetch_layout<bw_test_layout>(fw1.get())->nbits == 26u);
+        REQUIRE(polynomials::detail::bw_fetch_layout<bw_test_layout>(fw2.get())->nbits == 24u);
+    }
+}
+
+TEST_CASE("bw_packed_monomial_basic_test")
+{
+    detail::tuple_for_each(int_types{}, [](const auto &n) {
+        using int_t = remove_cvref_t<decltype(n)>;
+        using bpm_t = bw_packed_monomial<int_t, bw_test_layout>;
+
+        REQUIRE(is_key_v<bpm_t>);
+        REQUIRE(is_homomorphically_hashable_monomial_v<bpm_t>);
+        REQUIRE(std::is_same_v<typename bpm_t::value_type, int_t>);
+        REQUIRE(std::is_same_v<typename bpm_t::layout_type, bw_test_layout>);
+
+        const symbol_set ss{"bw_x", "bw_y", "bw_z"};
+
+        // Construction.
+        REQUIRE(bpm_t{}.get_value() == 0);
+        REQUIRE(bpm_t{ss}.get_value() == 0);
+        REQUIRE(key_is_one(bpm_t{}, ss));
+
+        const bpm_t m({100000, 2, 3}, ss);
+        REQUIRE(m.get_value() == int_t(100000 + (2 << 18) + (3 << 24)));
+        REQUIRE(m == bpm_t(std::vector<int>{100000, 2, 3}, ss));
+        REQUIRE(!key_is_one(m, ss));
+        REQUIRE(key_is_compatible(m, ss));
+        REQUIRE(key_is_compatible(bpm_t{}, symbol_set{}));
+        REQUIRE(!key_is_compatible(m, symbol_set{}));
+        REQUIRE(!key_is_compatible(m, symbol_set{"bw_x", "bw_y", "bw_unsupported"}));
+
+        OBAKE_REQUIRES_THROWS_CONTAINS(bpm_t({1, 2}, ss), std::invalid_argument,
+                                       "was used to pack only 2 values");
+        OBAKE_REQUIRES_THROWS_CONTAINS(bpm_t({1, 64, 3}, ss), std::overflow_error, "is outside the allowed range");
+        OBAKE_REQUIRES_THROWS_CONTAINS(bpm_t({1, 2}, symbol_set{"bw_x", "bw_unsupported"}),
+                                       std::invalid_argument, "some symbols are not supported by the layout");
+
+        // Degree.
+        REQUIRE(key_degree(m, ss) == 100005);
+        REQUIRE(key_p_degree(m, symbol_idx_set{1, 2}, ss) == 5);
+
+        // Multiplication.
+        bpm_t out;
+        monomial_mul(out, m, bpm_t({4, 0, 1}, ss), ss);
+        REQUIRE(out == bpm_t({100004, 2, 4}, ss));
+        REQUIRE(hash(out) == hash(m) + hash(bpm_t({4, 0, 1}, ss)));
+
+        // Overflow checking.
+        const std::vector<bpm_t> v1{bpm_t({1, 30, 0}, ss)}, v2{bpm_t({1, 1, 0}, ss)}, v3{bpm_t({1, 2, 0}, ss)};
+        if constexpr (is_signed_v<int_t>) {
+            REQUIRE(monomial_range_overflow_check(v1, v2, ss));
+            REQUIRE(!monomial_range_overflow_check(v1, v3, ss));
+        } else {
+            REQUIRE(monomial_range_overflow_check(v1, v1, ss));
+            REQUIRE(!monomial_range_overflow_check(v1, std::vector<bpm_t>{bpm_t({0, 34, 0}, ss)}, ss));
+        }
+
+        // Stream insertion.
+        std::ostringstream oss;
+        key_stream_insert(oss, m, ss);
+        REQUIRE(oss.str() == "bw_x**100000*bw_y**2*bw_z**3");
+        oss.str("");
+        key_stream_insert(oss, bpm_t{}, ss);
+        REQUIRE(oss.str() == "1");
+        oss.str("");
+        key_tex_stream_insert(oss, bpm_t({1, 0, 2}, ss), ss);
+        REQUIRE(oss.str() == "{bw_x}{bw_z}^{2}");
+
+        // Symbol merging and trimming.
+        const auto mm = key_merge_symbols(m, symbol_idx_map<symbol_set>{{0, {"bw_a"}}}, ss);
+        REQUIRE(mm == bpm_t({0, 100000, 2, 3}, symbol_set{"bw_a", "bw_x", "bw_y", "bw_z"}));
+        OBAKE_REQUIRES_THROWS_CONTAINS(
+            key_merge_symbols(m, symbol_idx_map<symbol_set>{{3, {"bw_zz_unsupported"}}}, ss), std::invalid_argument,
+            "the symbol is not supported by the layout");
+        OBAKE_REQUIRES_THROWS_CONTAINS(key_merge_symbols(m, symbol_idx_map<symbol_set>{{0, {"bw_big"}}}, ss),
+                                       std::overflow_error, "is larger than the bit width of the type");
+        REQUIRE(key_trim(m, symbol_idx_set{1}, ss) == bpm_t({100000, 3}, symbol_set{"bw_x", "bw_z"}));
+
+        // Exponentiation.
+        REQUIRE(monomial_pow(bpm_t({1, 2, 3}, ss), 2, ss) == bpm_t({2, 4, 6}, ss));
+        OBAKE_REQUIRES_THROWS_CONTAINS(monomial_pow(bpm_t({1, 2, 3}, ss), 30, ss), std::overflow_error,
+                                       "is outside the allowed range");
+    });
+
+    // Laurent monomials.
+    using bpm_t = bw_packed_monomial<std::int32_t, bw_test_layout>;
+    const symbol_set ss{"bw_x", "bw_y", "bw_z"};
+
+    const bpm_t m({-1, -31, 31}, ss);
+    REQUIRE(key_is_compatible(m, ss));
+    REQUIRE(key_degree(m, ss) == -1);
+
+    bpm_t out;
+    monomial_mul(out, m, bpm_t({1, 31, -31}, ss), ss);
+    REQUIRE(out == bpm_t{});
+
+    std::ostringstream oss;
+    key_tex_stream_insert(oss, bpm_t({1, -2, 0}, ss), ss);
+    REQUIRE(oss.str() == "\\frac{{bw_x}}{{bw_y}^{2}}");
+}
+
+TEST_CASE("bw_packed_monomial_polynomial_test")
+{
+    using bpm_t = bw_packed_monomial<std::int32_t, bw_test_layout>;
+    using poly_t = polynomial<bpm_t, mppp::integer<1>>;
+
+    auto [x, y, z] = make_polynomials<poly_t>("bw_x", "bw_y", "bw_z");
+
+    REQUIRE((x + y) * (x - y) == x * x - y * y);
+    REQUIRE(degree(x * x * y + z) == 3);
+    REQUIRE(diff(x * x * y + z, "bw_x") == 2 * x * y);
+    REQUIRE(integrate(2 * x * y, "bw_y") == x * y * y);
+
+    // A high power in x, with low powers in y and z,
+    // fits in a single 32-bit word.
+    const auto f = obake::pow(x, 100000) * (y + z + 1);
+    REQUIRE(f * (y + z) == obake::pow(x, 100000) * (y * y + 2 * y * z + z * z + y + z));
+
+    // Overflow of a low-order variable.
+    OBAKE_REQUIRES_THROWS_CONTAINS(obake::pow(y, 20) * obake::pow(y, 20), std::overflow_error,
+                                   "An overflow in the monomial exponents was detected");
+
+    // Multithreaded multiplication.
+    auto g = x + y + z + 1, tmp_g(g);
+    for (int i = 1; i < 10; ++i) {
+        g *= tmp_g;
+    }
+
+    poly_t r;
+    r.set_symbol_set(g.get_symbol_set());
+    polynomials::detail::poly_mul_impl_mt_hm(r, g, g);
+    REQUIRE(r == g * g);
+}
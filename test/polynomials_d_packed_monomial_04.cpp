@@ -0,0 +1,136 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstdint>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <mp++/integer.hpp>
+
+#include <obake/byte_size.hpp>
+#include <obake/config.hpp>
+#include <obake/detail/tuple_for_each.hpp>
+#include <obake/hash.hpp>
+#include <obake/key/key_degree.hpp>
+#include <obake/key/key_is_compatible.hpp>
+#include <obake/key/key_merge_symbols.hpp>
+#include <obake/key/key_p_degree.hpp>
+#include <obake/math/degree.hpp>
+#include <obake/math/pow.hpp>
+#include <obake/polynomials/d_packed_monomial.hpp>
+#include <obake/polynomials/monomial_homomorphic_hash.hpp>
+#include <obake/polynomials/monomial_mul.hpp>
+#include <obake/polynomials/monomial_pow.hpp>
+#include <obake/polynomials/monomial_range_overflow_check.hpp>
+#include <obake/polynomials/polynomial.hpp>
+#include <obake/symbols.hpp>
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+using namespace obake;
+
+using int_types = std::tuple<std::int32_t, std::uint32_t
+#if defined(OBAKE_PACKABLE_INT64)
+                             ,
+                             std::int64_t, std::uint64_t
+#endif
+                             >;
+
+TEST_CASE("fixed_capacity_basic_test")
+{
+    obake_test::disable_slow_stack_traces();
+
+    detail::tuple_for_each(int_types{}, [](const auto &n) {
+        using int_t = remove_cvref_t<decltype(n)>;
+        using pm_t = d_packed_monomial<int_t, 2, 2>;
+
+        REQUIRE(is_key_v<pm_t>);
+        REQUIRE(is_homomorphically_hashable_monomial_v<pm_t>);
+        REQUIRE(pm_t::npacks == 2u);
+        REQUIRE(d_packed_monomial<int_t, 2>::npacks == 0u);
+
+        // The storage is inline.
+        REQUIRE(byte_size(pm_t{}) == sizeof(pm_t));
+        REQUIRE(byte_size(pm_t{1, 2, 3, 4}) == sizeof(pm_t));
+
+        // Construction.
+        REQUIRE(pm_t{}._container().empty());
+        REQUIRE(pm_t(symbol_set{"x", "y", "z"})._container().size() == 2u);
+        const std::vector<int> v{1, 2, 3};
+        REQUIRE(pm_t{1, 2, 3} == pm_t(v));
+        REQUIRE(pm_t{1, 2, 3} == pm_t(v.begin(), v.end()));
+        REQUIRE(pm_t{1, 2, 3} != pm_t{1, 2, 4});
+
+        OBAKE_REQUIRES_THROWS_CONTAINS(pm_t(symbol_set{"a", "b", "c", "d", "e"}), std::overflow_error,
+                                       "the capacity of the monomial is limited to 2 packs");
+        OBAKE_REQUIRES_THROWS_CONTAINS((pm_t{1, 2, 3, 4, 5}), std::overflow_error,
+                                       "the capacity of the monomial is limited to 2 packs");
+
+        // Compatibility.
+        REQUIRE(key_is_compatible(pm_t{1, 2, 3}, symbol_set{"x", "y", "z"}));
+        REQUIRE(!key_is_compatible(pm_t{1, 2, 3}, symbol_set{"x"}));
+
+        // Degree.
+        REQUIRE(key_degree(pm_t{1, 2, 3}, symbol_set{"x", "y", "z"}) == 6);
+        REQUIRE(key_p_degree(pm_t{1, 2, 3}, symbol_idx_set{0, 2}, symbol_set{"x", "y", "z"}) == 4);
+
+        // Multiplication.
+        pm_t a{0, 0, 0};
+        monomial_mul(a, pm_t{1, 2, 3}, pm_t{4, 5, 6}, symbol_set{"x", "y", "z"});
+        REQUIRE(a == pm_t{5, 7, 9});
+        REQUIRE(hash(a) == hash(pm_t{1, 2, 3}) + hash(pm_t{4, 5, 6}));
+        REQUIRE(monomial_range_overflow_check(std::vector<pm_t>{pm_t{1, 2, 3}}, std::vector<pm_t>{pm_t{4, 5, 6}},
+                                              symbol_set{"x", "y", "z"}));
+
+        // Exponentiation.
+        REQUIRE(monomial_pow(pm_t{1, 2, 3}, 2, symbol_set{"x", "y", "z"}) == pm_t{2, 4, 6});
+
+        // Symbol merging.
+        REQUIRE(key_merge_symbols(pm_t{1, 2, 3}, symbol_idx_map<symbol_set>{{1, {"a"}}}, symbol_set{"x", "y", "z"})
+                == pm_t{1, 0, 2, 3});
+        OBAKE_REQUIRES_THROWS_CONTAINS(key_merge_symbols(pm_t{1, 2, 3}, symbol_idx_map<symbol_set>{{1, {"a", "b"}}},
+                                                         symbol_set{"x", "y", "z"}),
+                                       std::overflow_error, "the capacity of the monomial is limited to 2 packs");
+    });
+}
+
+TEST_CASE("fixed_capacity_polynomial_test")
+{
+    using pm_t = d_packed_monomial<std::int32_t, 2, 2>;
+    using poly_t = polynomial<pm_t, mppp::integer<1>>;
+
+    auto [x, y, z] = make_polynomials<poly_t>("x", "y", "z");
+
+    REQUIRE((x + y) * (x - y) == x * x - y * y);
+    REQUIRE(degree(x * x * y + z) == 3);
+
+    auto f = x + y + z + 1, tmp_f(f);
+    for (int i = 1; i < 10; ++i) {
+        f *= tmp_f;
+    }
+
+    // Compare with the default (dynamically-sized) monomial.
+    using poly_d_t = polynomial<d_packed_monomial<std::int32_t, 2>, mppp::integer<1>>;
+    auto [xd, yd, zd] = make_polynomials<poly_d_t>("x", "y", "z");
+    auto fd = xd + yd + zd + 1, tmp_fd(fd);
+    for (int i = 1; i < 10; ++i) {
+        fd *= tmp_fd;
+    }
+
+    const auto g = f * f;
+    const auto gd = fd * fd;
+    REQUIRE(g.size() == gd.size());
+    REQUIRE(degree(g) == degree(gd));
+
+    // Too many symbols for the capacity of the monomial.
+    OBAKE_REQUIRES_THROWS_CONTAINS(make_polynomials<poly_t>(symbol_set{"a", "b", "c", "d", "e"}, "a"),
+                                   std::overflow_error, "the capacity of the monomial is limited to 2 packs");
+}
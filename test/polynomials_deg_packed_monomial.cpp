@@ -0,0 +1,183 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cstdint>
+#include <sstream>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <mp++/integer.hpp>
+
+#include <obake/config.hpp>
+#include <obake/detail/tuple_for_each.hpp>
+#include <obake/hash.hpp>
+#include <obake/key/key_degree.hpp>
+#include <obake/key/key_is_compatible.hpp>
+#include <obake/key/key_is_one.hpp>
+#include <obake/key/key_merge_symbols.hpp>
+#include <obake/key/key_p_degree.hpp>
+#include <obake/key/key_stream_insert.hpp>
+#include <obake/key/key_trim.hpp>
+#include <obake/kpack.hpp>
+#include <obake/math/degree.hpp>
+#include <obake/math/diff.hpp>
+#include <obake/math/truncate_degree.hpp>
+#include <obake/polynomials/deg_packed_monomial.hpp>
+#include <obake/polynomials/monomial_homomorphic_hash.hpp>
+#include <obake/polynomials/monomial_mul.hpp>
+#include <obake/polynomials/monomial_range_overflow_check.hpp>
+#include <obake/polynomials/packed_monomial.hpp>
+#include <obake/polynomials/polynomial.hpp>
+#include <obake/series.hpp>
+#include <obake/symbols.hpp>
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+using namespace obake;
+
+using int_types = std::tuple<std::int32_t, std::uint32_t>;
+
+TEST_CASE("deg_packed_monomial_basic_test")
+{
+    detail::tuple_for_each(int_types{}, [](const auto &n) {
+        using int_t = remove_cvref_t<decltype(n)>;
+        using dpm_t = deg_packed_monomial<int_t>;
+        using pm_t = packed_monomial<int_t>;
+
+        REQUIRE(is_key_v<dpm_t>);
+        REQUIRE(is_homomorphically_hashable_monomial_v<dpm_t>);
+        REQUIRE(std::is_same_v<typename dpm_t::value_type, int_t>);
+
+        const symbol_set ss{"x", "y", "z"};
+
+        // Construction.
+        REQUIRE(dpm_t{}.get_value() == 0);
+        REQUIRE(dpm_t{ss}.get_value() == 0);
+        REQUIRE(key_is_one(dpm_t{}, ss));
+
+        const dpm_t m{1, 2, 3};
+        REQUIRE(m.get_degree() == 6);
+        REQUIRE(m.to_packed() == pm_t{1, 2, 3});
+        REQUIRE(m == dpm_t(pm_t{1, 2, 3}, ss));
+        REQUIRE(m == dpm_t::from_code(pm_t{1, 2, 3}.get_value(), 6));
+        REQUIRE(m == dpm_t(std::vector<int>{1, 2, 3}));
+        REQUIRE(!key_is_one(m, ss));
+        REQUIRE(key_is_compatible(m, ss));
+        REQUIRE(!key_is_compatible(dpm_t::from_code(pm_t{1, 2, 3}.get_value(), 5), ss));
+        REQUIRE(!key_is_compatible(m, symbol_set{}));
+        REQUIRE(key_is_compatible(dpm_t{}, symbol_set{}));
+
+        // Degree.
+        REQUIRE(key_degree(m, ss) == 6);
+        REQUIRE(key_p_degree(m, symbol_idx_set{0, 2}, ss) == 4);
+
+        // Multiplication: the values are homomorphic,
+        // and the degrees add up.
+        dpm_t out;
+        monomial_mul(out, m, dpm_t{4, 0, 1}, ss);
+        REQUIRE(out == dpm_t{5, 2, 4});
+        REQUIRE(out.get_degree() == 11);
+        REQUIRE(hash(out) == hash(m) + hash(dpm_t{4, 0, 1}));
+
+        // The ordering of the values is consistent with the degree.
+        REQUIRE(dpm_t{0, 0, 1}.get_value() < dpm_t{1, 1, 0}.get_value());
+        REQUIRE(dpm_t{2, 0, 0}.get_value() < dpm_t{0, 0, 3}.get_value());
+
+        // Stream insertion.
+        std::ostringstream oss1, oss2;
+        key_stream_insert(oss1, m, ss);
+        key_stream_insert(oss2, pm_t{1, 2, 3}, ss);
+        REQUIRE(oss1.str() == oss2.str());
+
+        // Symbol merging and trimming.
+        const auto mm = key_merge_symbols(m, symbol_idx_map<symbol_set>{{1, {"a"}}}, ss);
+        REQUIRE(mm == dpm_t{1, 0, 2, 3});
+        REQUIRE(mm.get_degree() == 6);
+        const auto mt = key_trim(m, symbol_idx_set{1}, ss);
+        REQUIRE(mt == dpm_t{1, 3});
+        REQUIRE(mt.get_degree() == 4);
+
+        // Overflow checking.
+        const auto lim = detail::kpack_get_lims<int_t>(3).second;
+        const std::vector<dpm_t> v1{dpm_t{lim, int_t(0), int_t(0)}}, v2{dpm_t{1, 0, 0}}, v3{dpm_t{0, 1, 0}};
+        REQUIRE(!monomial_range_overflow_check(v1, v2, ss));
+        REQUIRE(monomial_range_overflow_check(v1, v3, ss));
+    });
+
+    // Laurent monomials.
+    using dpm_t = deg_packed_monomial<std::int32_t>;
+    const symbol_set ss{"x", "y", "z"};
+
+    const dpm_t m{-1, -2, 1};
+    REQUIRE(m.get_degree() == -2);
+    REQUIRE(key_is_compatible(m, ss));
+    REQUIRE(dpm_t{-3, 0, 0}.get_value() < m.get_value());
+    REQUIRE(m.get_value() < dpm_t{0, 0, -1}.get_value());
+}
+
+TEST_CASE("deg_packed_monomial_polynomial_test")
+{
+    using dpm_t = deg_packed_monomial<std::int32_t>;
+    using pm_t = packed_monomial<std::int32_t>;
+    using poly_t = polynomial<dpm_t, mppp::integer<1>>;
+    using ppoly_t = polynomial<pm_t, mppp::integer<1>>;
+
+    auto [x, y, z, t] = make_polynomials<poly_t>("x", "y", "z", "t");
+    auto [px, py, pz, pt] = make_polynomials<ppoly_t>("x", "y", "z", "t");
+
+    // Helper to compare a polynomial with degree-augmented
+    // monomials to a polynomial with packed monomials.
+    auto same = [](const poly_t &a, const ppoly_t &b) {
+        if (a.size() != b.size() || a.get_symbol_set() != b.get_symbol_set()) {
+            return false;
+        }
+
+        for (const auto &[k, c] : a) {
+            const auto it = b.find(k.to_packed());
+
+            if (it == b.end() || it->second != c) {
+                return false;
+            }
+        }
+
+        return true;
+    };
+
+    REQUIRE(same((x + y) * (x - y), (px + py) * (px - py)));
+    REQUIRE(degree(x * x * y + z) == 3);
+    auto tmp = x * x * y + z;
+    truncate_degree(tmp, 2);
+    REQUIRE(tmp == z);
+    REQUIRE(diff(x * x * y + z, "x") == 2 * x * y);
+    REQUIRE(diff(x * x * y + z, "x").begin()->first.get_degree() == 2);
+
+    // Multithreaded multiplication, with and without truncation.
+    auto f = x + y + z + t + 1, tmp_f(f);
+    auto pf = px + py + pz + pt + 1, tmp_pf(pf);
+    for (int i = 1; i < 10; ++i) {
+        f *= tmp_f;
+        pf *= tmp_pf;
+    }
+    const auto g = f + 1;
+    const auto pg = pf + 1;
+
+    poly_t r;
+    r.set_symbol_set(f.get_symbol_set());
+    polynomials::detail::poly_mul_impl_mt_hm(r, f, g);
+    REQUIRE(same(r, pf * pg));
+
+    for (auto d : {0, 1, 5, 10, 15, 20}) {
+        r = poly_t{};
+        r.set_symbol_set(f.get_symbol_set());
+        polynomials::detail::poly_mul_impl_mt_hm(r, f, g, d);
+        REQUIRE(same(r, truncated_mul(pf, pg, d)));
+        REQUIRE(truncated_mul(f, g, d) == r);
+    }
+}
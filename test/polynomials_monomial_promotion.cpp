@@ -0,0 +1,199 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <obake/config.hpp>
+
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include <mp++/integer.hpp>
+
+#include <obake/detail/type_c.hpp>
+#include <obake/kpack.hpp>
+#include <obake/polynomials/d_packed_monomial.hpp>
+#include <obake/polynomials/monomial_promotion.hpp>
+#include <obake/polynomials/packed_monomial.hpp>
+#include <obake/polynomials/polynomial.hpp>
+#include <obake/symbols.hpp>
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+using namespace obake;
+
+struct prom0 {
+};
+
+struct prom1 {
+};
+
+struct prom2 {
+};
+
+namespace obake
+{
+
+template <>
+inline constexpr auto monomial_promotion<prom0> = detail::type_c<packed_monomial<std::int32_t>>{};
+
+// Wrong specialisation here, correct one in the
+// customisation namespace.
+template <>
+inline constexpr auto monomial_promotion<prom1> = 42;
+
+// Wrong specialisation.
+template <>
+inline constexpr auto monomial_promotion<prom2> = 42;
+
+namespace customisation
+{
+
+template <>
+inline constexpr auto monomial_promotion<prom1> = obake::detail::type_c<prom0>{};
+
+} // namespace customisation
+
+} // namespace obake
+
+TEST_CASE("monomial_promotion_test")
+{
+    // The chains for the builtin monomials.
+#if defined(OBAKE_PACKABLE_INT64)
+    REQUIRE(std::is_same_v<monomial_promotion_t<packed_monomial<std::int32_t>>, packed_monomial<std::int64_t>>);
+    REQUIRE(std::is_same_v<monomial_promotion_t<packed_monomial<std::uint32_t>>, packed_monomial<std::uint64_t>>);
+    REQUIRE(std::is_same_v<monomial_promotion_t<packed_monomial<std::int64_t>>,
+                           polynomials::d_packed_monomial<std::int64_t, 1>>);
+    REQUIRE(std::is_same_v<monomial_promotion_t<polynomials::d_packed_monomial<std::int64_t, 8>>,
+                           polynomials::d_packed_monomial<std::int64_t, 4>>);
+    REQUIRE(std::is_same_v<monomial_promotion_t<polynomials::d_packed_monomial<std::int32_t, 1>>,
+                           polynomials::d_packed_monomial<std::int64_t, 1>>);
+    REQUIRE(std::is_void_v<monomial_promotion_t<polynomials::d_packed_monomial<std::int64_t, 1>>>);
+    REQUIRE(!is_promotable_monomial_v<polynomials::d_packed_monomial<std::int64_t, 1>>);
+#else
+    REQUIRE(std::is_same_v<monomial_promotion_t<packed_monomial<std::int32_t>>,
+                           polynomials::d_packed_monomial<std::int32_t, 1>>);
+    REQUIRE(std::is_void_v<monomial_promotion_t<polynomials::d_packed_monomial<std::int32_t, 1>>>);
+#endif
+    REQUIRE(std::is_same_v<monomial_promotion_t<polynomials::d_packed_monomial<std::int32_t, 4>>,
+                           polynomials::d_packed_monomial<std::int32_t, 2>>);
+    REQUIRE(is_promotable_monomial_v<packed_monomial<std::int32_t>>);
+    REQUIRE(is_promotable_monomial_v<polynomials::d_packed_monomial<std::int32_t, 4>>);
+
+    // Customisation.
+    REQUIRE(std::is_void_v<monomial_promotion_t<int>>);
+    REQUIRE(std::is_same_v<monomial_promotion_t<prom0>, packed_monomial<std::int32_t>>);
+    REQUIRE(std::is_same_v<monomial_promotion_t<prom1>, prom0>);
+    REQUIRE(std::is_void_v<monomial_promotion_t<prom2>>);
+    // NOTE: the conversion is not available for prom0/prom1.
+    REQUIRE(!is_promotable_monomial_v<prom0>);
+    REQUIRE(!is_promotable_monomial_v<prom1>);
+    REQUIRE(!is_promotable_monomial_v<prom2>);
+
+    // Conversion.
+    std::vector<std::int32_t> tmp;
+    const symbol_set ss{"x", "y", "z"};
+    const auto p0 = monomial_promote(packed_monomial<std::int32_t>{1, -2, 3}, ss, tmp);
+    REQUIRE(p0 == monomial_promotion_t<packed_monomial<std::int32_t>>{1, -2, 3});
+    const auto p1 = monomial_promote(polynomials::d_packed_monomial<std::int32_t, 2>{1, -2, 3}, ss, tmp);
+    REQUIRE(p1 == polynomials::d_packed_monomial<std::int32_t, 1>{1, -2, 3});
+    REQUIRE(monomial_promote(packed_monomial<std::int32_t>{}, symbol_set{}, tmp)
+            == monomial_promotion_t<packed_monomial<std::int32_t>>{});
+}
+
+TEST_CASE("promoting_mul_test")
+{
+    using pm_t = packed_monomial<std::int32_t>;
+    using poly_t = polynomial<pm_t, mppp::integer<1>>;
+
+    auto [x, y] = make_polynomials<poly_t>("x", "y");
+
+    // No overflow: the product is computed with
+    // the original key type.
+    auto res = promoting_mul(x + y, x - y);
+    REQUIRE(res.index() == 0u);
+    REQUIRE(std::get<0>(res) == x * x - y * y);
+
+    // An overflowing example.
+    const auto lim = detail::kpack_get_lims<std::int32_t>(2).second;
+    poly_t a, b;
+    a.set_symbol_set(symbol_set{"x", "y"});
+    b.set_symbol_set(symbol_set{"x", "y"});
+    a.add_term(pm_t{lim, 1}, 1);
+    a.add_term(pm_t{0, 1}, 2);
+    b.add_term(pm_t{lim, 0}, 3);
+
+    OBAKE_REQUIRES_THROWS_CONTAINS(
+        a * b, std::overflow_error,
+        "An overflow in the monomial exponents was detected while attempting to multiply two polynomials");
+
+#if defined(OBAKE_PACKABLE_INT64)
+    using pm1_t = packed_monomial<std::int64_t>;
+    constexpr auto idx = 1u;
+#else
+    using pm1_t = polynomials::d_packed_monomial<std::int32_t, 1>;
+    constexpr auto idx = 1u;
+#endif
+    using poly1_t = polynomial<pm1_t, mppp::integer<1>>;
+
+    poly1_t cmp;
+    cmp.set_symbol_set(symbol_set{"x", "y"});
+    cmp.add_term(pm1_t{std::int64_t(lim) * 2, std::int64_t(1)}, 3);
+    cmp.add_term(pm1_t{lim, 1}, 6);
+
+    res = promoting_mul(a, b);
+    REQUIRE(res.index() == idx);
+    REQUIRE(std::get<idx>(res) == cmp);
+
+    // Different symbol sets.
+    poly_t c;
+    c.set_symbol_set(symbol_set{"x"});
+    c.add_term(pm_t{lim}, 3);
+
+    res = promoting_mul(a, c);
+    REQUIRE(res.index() == idx);
+    REQUIRE(std::get<idx>(res) == cmp);
+
+#if defined(OBAKE_PACKABLE_INT64)
+    // A single-symbol packed_monomial<std::int64_t>: the promotion
+    // must not narrow the exponent range.
+    {
+        using pm2_t = packed_monomial<std::int64_t>;
+        using poly2_t = polynomial<pm2_t, mppp::integer<1>>;
+        using dpm2_t = polynomials::d_packed_monomial<std::int64_t, 1>;
+
+        const auto lim2 = detail::kpack_get_lims<std::int64_t>(1).second;
+
+        poly2_t d, e;
+        d.set_symbol_set(symbol_set{"x"});
+        e.set_symbol_set(symbol_set{"x"});
+        d.add_term(pm2_t{lim2 - 1}, 2);
+        e.add_term(pm2_t{1}, 3);
+
+        // No overflow.
+        auto res2 = promoting_mul(d, e);
+        REQUIRE(res2.index() == 0u);
+        REQUIRE(std::get<0>(res2).size() == 1u);
+        REQUIRE(std::get<0>(res2).begin()->first == pm2_t{lim2});
+        REQUIRE(std::get<0>(res2).begin()->second == 6);
+
+        // The promoted monomial type can represent the exponents
+        // of the operands.
+        std::vector<std::int64_t> tmp2;
+        REQUIRE(monomial_promote(pm2_t{lim2}, symbol_set{"x"}, tmp2) == dpm2_t{lim2});
+
+        // Past the limit: the product overflows also
+        // with the promoted monomial type.
+        d.add_term(pm2_t{lim2}, 1);
+        OBAKE_REQUIRES_THROWS_CONTAINS(promoting_mul(d, e), std::overflow_error,
+                                       "no wider monomial type is available in the promotion chain");
+    }
+#endif
+}
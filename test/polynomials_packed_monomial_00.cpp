@@ -36,11 +36,14 @@
 #include <obake/key/key_p_degree.hpp>
 #include <obake/key/key_stream_insert.hpp>
 #include <obake/kpack.hpp>
+#include <obake/polynomials/d_packed_monomial.hpp>
 #include <obake/polynomials/monomial_homomorphic_hash.hpp>
 #include <obake/polynomials/monomial_mul.hpp>
 #include <obake/polynomials/monomial_pow.hpp>
 #include <obake/polynomials/monomial_range_overflow_check.hpp>
 #include <obake/polynomials/packed_monomial.hpp>
+#include <obake/polynomials/polynomial.hpp>
+#include <obake/series.hpp>
 #include <obake/symbols.hpp>
 #include <obake/type_name.hpp>
 #include <obake/type_traits.hpp>
@@ -777,3 +780,130 @@ TEST_CASE("monomial_pow_test")
 #pragma warning(pop)
 
 #endif
+
+#if defined(OBAKE_PACKABLE_INT128)
+
+TEST_CASE("int128_test")
+{
+    detail::tuple_for_each(std::tuple<__int128_t, __uint128_t>{}, [](const auto &n) {
+        using int_t = remove_cvref_t<decltype(n)>;
+        using pm_t = packed_monomial<int_t>;
+
+        REQUIRE(is_kpackable_v<int_t>);
+        REQUIRE(is_key_v<pm_t>);
+        REQUIRE(is_homomorphically_hashable_monomial_v<pm_t>);
+        REQUIRE(detail::kpack_max_size<int_t>() == 42u);
+
+        // Mid-size problems fit in a single key.
+        symbol_set ss;
+        std::vector<int_t> v1, v2, v3;
+        int_t deg(0);
+        for (auto i = 0; i < 40; ++i) {
+            ss.insert("x_" + std::to_string(i));
+            v1.push_back(int_t(i % 3));
+            v2.push_back(int_t((i + 1) % 2));
+            v3.push_back(v1.back() + v2.back());
+            deg += v1.back();
+        }
+
+        const pm_t a(v1), b(v2);
+        REQUIRE(key_is_compatible(a, ss));
+        REQUIRE(key_is_compatible(b, ss));
+        REQUIRE(key_degree(a, ss) == deg);
+
+        pm_t out;
+        monomial_mul(out, a, b, ss);
+        REQUIRE(out == pm_t(v3));
+        REQUIRE(hash(out) == static_cast<std::size_t>(hash(a) + hash(b)));
+
+        // Overflow checking.
+        const auto lims = detail::kpack_get_lims<int_t>(40);
+        REQUIRE(monomial_range_overflow_check(std::vector<pm_t>{a}, std::vector<pm_t>{b}, ss));
+        REQUIRE(!monomial_range_overflow_check(std::vector<pm_t>{pm_t(std::vector<int_t>(40, lims.second))},
+                                               std::vector<pm_t>{b}, ss));
+
+        // Stream insertion of exponents larger than 64 bits.
+        const auto big = int_t(1) << 100;
+        std::ostringstream oss;
+        key_stream_insert(oss, pm_t{big}, symbol_set{"x"});
+        REQUIRE(oss.str() == "x**1267650600228229401496703205376");
+        oss.str("");
+        key_stream_insert(oss, pm_t{int_t(1), int_t(2)}, symbol_set{"x", "y"});
+        REQUIRE(oss.str() == "x*y**2");
+
+        // Polynomial multiplication with 30 symbols,
+        // compared to d_packed_monomial.
+        using poly_t = polynomial<pm_t, mppp::integer<1>>;
+        using dpm_t = polynomials::d_packed_monomial<std::int64_t, 8>;
+        using dpoly_t = polynomial<dpm_t, mppp::integer<1>>;
+
+        constexpr auto nsyms = 30u;
+
+        symbol_set pss;
+        for (auto i = 0u; i < nsyms; ++i) {
+            pss.insert("y_" + std::to_string(i));
+        }
+
+        // Build the polynomial 1 + sum_i (i % 3 + 1) * y_i**e
+        // for both monomial types.
+        auto make_poly = [&pss](auto p, auto e) {
+            using p_t = decltype(p);
+            using k_t = series_key_t<p_t>;
+            using exp_t = typename decltype(e)::value_type;
+
+            p.set_symbol_set(pss);
+            p.add_term(k_t(std::vector<exp_t>(nsyms, exp_t(0))), 1);
+            for (auto i = 0u; i < nsyms; ++i) {
+                std::vector<exp_t> exps(nsyms, exp_t(0));
+                exps[i] = e[0];
+                p.add_term(k_t(exps), static_cast<int>(i % 3u + 1u));
+            }
+
+            return p;
+        };
+
+        const auto f = make_poly(poly_t{}, std::vector<int_t>{int_t(1)});
+        const auto g = make_poly(poly_t{}, std::vector<int_t>{int_t(2)});
+        const auto df = make_poly(dpoly_t{}, std::vector<std::int64_t>{1});
+        const auto dg = make_poly(dpoly_t{}, std::vector<std::int64_t>{2});
+
+        // Check that p and dp contain the same terms.
+        auto same = [&pss](const poly_t &p, const dpoly_t &dp) {
+            if (p.size() != dp.size()) {
+                return false;
+            }
+
+            std::vector<std::int64_t> exps;
+            for (const auto &[k, c] : p) {
+                exps.clear();
+                kunpacker<int_t> ku(k.get_value(), nsyms);
+                for (auto i = 0u; i < nsyms; ++i) {
+                    int_t e;
+                    ku >> e;
+                    exps.push_back(static_cast<std::int64_t>(e));
+                }
+
+                const auto it = dp.find(dpm_t(exps));
+                if (it == dp.end() || it->second != c) {
+                    return false;
+                }
+            }
+
+            return true;
+        };
+
+        const auto h = f * g;
+        const auto dh = df * dg;
+        REQUIRE(h.size() > 400u);
+        REQUIRE(same(h, dh));
+        REQUIRE(same(h * f, dh * df));
+        REQUIRE(same(truncated_mul(h, f, 3), truncated_mul(dh, df, 3)));
+
+        poly_t r;
+        r.set_symbol_set(pss);
+        polynomials::detail::poly_mul_impl_mt_hm(r, f, h);
+        REQUIRE(same(r, df * dh));
+    });
+}
+
+#endif
@@ -8,18 +8,26 @@
 
 #include <obake/config.hpp>
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <initializer_list>
+#include <limits>
+#include <random>
 #include <stdexcept>
 #include <string>
 #include <string_view>
 #include <tuple>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <mp++/integer.hpp>
 
 #include <obake/detail/tuple_for_each.hpp>
 #include <obake/kpack.hpp>
+#include <obake/math/fma3.hpp>
+#include <obake/math/pow.hpp>
 #include <obake/polynomials/packed_monomial.hpp>
 #include <obake/polynomials/polynomial.hpp>
 #include <obake/symbols.hpp>
@@ -422,3 +430,572 @@ TEST_CASE("polynomial_mul_larger_mt_hm_test")
         REQUIRE(ret.size() == 2096600ull);
     });
 }
+
+TEST_CASE("polynomial_mul_mt_kbox_test")
+{
+    using cf_types = std::tuple<double, mppp::integer<1>>;
+    using exp_types = std::tuple<exp_t, std::make_unsigned_t<exp_t>>;
+
+    detail::tuple_for_each(exp_types{}, [](auto es) {
+        using pm_t = packed_monomial<decltype(es)>;
+
+        detail::tuple_for_each(cf_types{}, [](auto xs) {
+            using cf_t = decltype(xs);
+            using poly_t = polynomial<pm_t, cf_t>;
+
+            // Helper to run the dense Kronecker engine directly.
+            auto run_kbox = [](poly_t &ret, const poly_t &a, const poly_t &b) {
+                const auto &ss = a.get_symbol_set();
+
+                std::vector<std::pair<pm_t, cf_t>> v1(a.begin(), a.end()), v2(b.begin(), b.end());
+                std::vector<pm_t> k1, k2;
+                for (const auto &p : v1) {
+                    k1.push_back(p.first);
+                }
+                for (const auto &p : v2) {
+                    k2.push_back(p.first);
+                }
+
+                const auto [l1, l2] = polynomials::detail::pm_range_exponent_limits(k1, k2, ss);
+
+                ret.set_symbol_set(ss);
+                ret.set_n_segments(2);
+
+                return polynomials::detail::poly_mul_impl_mt_kbox(ret, v1, v2, l1, l2, ss);
+            };
+
+            // Helper to compare the engines.
+            auto check = [&run_kbox](const poly_t &a0, const poly_t &b0, bool kbox) {
+                // NOTE: the shorter series must be the first operand.
+                const auto &a = a0.size() <= b0.size() ? a0 : b0;
+                const auto &b = a0.size() <= b0.size() ? b0 : a0;
+
+                poly_t r0, r1, r2;
+                r0.set_symbol_set(a.get_symbol_set());
+                polynomials::detail::poly_mul_impl_simple(r0, a, b);
+
+                r1.set_symbol_set(a.get_symbol_set());
+                polynomials::detail::poly_mul_impl_mt_hm(r1, a, b);
+                REQUIRE(r0 == r1);
+
+                REQUIRE(run_kbox(r2, a, b) == kbox);
+                if (kbox) {
+                    REQUIRE(r0 == r2);
+                    REQUIRE(r2.get_s_size() == 2u);
+                }
+            };
+
+            auto [x, y, z] = make_polynomials<poly_t>("x", "y", "z");
+
+            // Dense operands.
+            auto f = x + y + z + 1, tmp_f(f);
+            for (int i = 1; i < 8; ++i) {
+                f *= tmp_f;
+            }
+            check(f, f + 1, true);
+            check(f, f * (x - y), true);
+
+            // Cancellations.
+            check(f * (x + y), f * (x - y) + 2, true);
+
+            // A product whose exponents do not fit in a small box.
+            auto g = obake::pow(x, 200) + y + z;
+            check(f, f * g, false);
+
+            if constexpr (is_signed_v<typename pm_t::value_type>) {
+                // Negative exponents.
+                poly_t xi;
+                xi.set_symbol_set(symbol_set{"x", "y", "z"});
+                xi.add_term(pm_t{-1, 0, 0}, 1);
+
+                auto h = x + xi + y + z + 1, tmp_h(h);
+                for (int i = 1; i < 8; ++i) {
+                    h *= tmp_h;
+                }
+                check(h, h - 1, true);
+                check(h, h * (xi - y), true);
+            }
+        });
+    });
+}
+
+TEST_CASE("polynomial_mul_kbox_axpy_test")
+{
+    using pm_t = packed_monomial<exp_t>;
+    using cf_types = std::tuple<float, double>;
+
+    detail::tuple_for_each(cf_types{}, [](auto xs) {
+        using cf_t = decltype(xs);
+        using poly_t = polynomial<pm_t, cf_t>;
+
+        static_assert(polynomials::detail::poly_mul_kbox_axpy_enabled<cf_t, cf_t, cf_t>);
+
+        // Check the kernel against the scalar loop,
+        // for lengths covering the vectorised loops
+        // and their remainders.
+        for (std::size_t n = 0; n < 70u; ++n) {
+            std::vector<cf_t> out(n), out_s(n), x(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                out[i] = out_s[i] = static_cast<cf_t>(i % 7u) - 3;
+                x[i] = static_cast<cf_t>(i % 5u) - 2;
+            }
+
+            polynomials::detail::poly_mul_kbox_axpy(out.data(), cf_t(3), x.data(), n);
+            for (std::size_t i = 0; i < n; ++i) {
+                if constexpr (is_mult_addable_v<cf_t &, const cf_t &, const cf_t &>) {
+                    obake::fma3(out_s[i], cf_t(3), x[i]);
+                } else {
+                    out_s[i] += cf_t(3) * x[i];
+                }
+            }
+            REQUIRE(out == out_s);
+        }
+
+        // Run the dense Kronecker engine directly.
+        auto run_kbox = [](poly_t &ret, const poly_t &a, const poly_t &b) {
+            const auto &ss = a.get_symbol_set();
+
+            std::vector<std::pair<pm_t, cf_t>> v1(a.begin(), a.end()), v2(b.begin(), b.end());
+            std::vector<pm_t> k1, k2;
+            for (const auto &p : v1) {
+                k1.push_back(p.first);
+            }
+            for (const auto &p : v2) {
+                k2.push_back(p.first);
+            }
+
+            const auto [l1, l2] = polynomials::detail::pm_range_exponent_limits(k1, k2, ss);
+
+            ret.set_symbol_set(ss);
+            ret.set_n_segments(2);
+
+            return polynomials::detail::poly_mul_impl_mt_kbox(ret, v1, v2, l1, l2, ss);
+        };
+
+        auto check = [&run_kbox](const poly_t &a0, const poly_t &b0) {
+            // NOTE: the shorter series must be the first operand.
+            const auto &a = a0.size() <= b0.size() ? a0 : b0;
+            const auto &b = a0.size() <= b0.size() ? b0 : a0;
+
+            poly_t r0, r1;
+            r0.set_symbol_set(a.get_symbol_set());
+            polynomials::detail::poly_mul_impl_simple(r0, a, b);
+
+            REQUIRE(run_kbox(r1, a, b));
+            REQUIRE(r0 == r1);
+        };
+
+        auto [x, y, z] = make_polynomials<poly_t>("x", "y", "z");
+
+        // Long runs of consecutive exponents of x, spread
+        // over a box large enough to be split into several
+        // chunks. NOTE: keep the coefficients small, so that
+        // the computations are exact also for float.
+        poly_t p;
+        p.set_symbol_set(symbol_set{"x", "y", "z"});
+        for (int i = 0; i <= 40; ++i) {
+            p += obake::pow(x, i);
+        }
+
+        auto f = p * obake::pow(1 + y + z, 3), g = p * obake::pow(1 - y + 2 * z, 3);
+
+        check(f, g);
+        check(f, f);
+        check(f * (x + 2), g);
+
+        // Cancellations.
+        check(f * (x + y), f * (x - y));
+    });
+}
+
+TEST_CASE("polynomial_mul_ks_test")
+{
+    using int_t = mppp::integer<1>;
+
+    std::mt19937 rng;
+    std::uniform_int_distribution<long> cdist(-1000, 1000);
+    std::uniform_int_distribution<unsigned> sdist(0, 200);
+
+    // Schoolbook multiplication, for comparison.
+    auto school = [](const std::vector<int_t> &a, const std::vector<int_t> &b) {
+        std::vector<int_t> ret(a.size() + b.size() - 1u);
+        for (decltype(a.size()) i = 0; i < a.size(); ++i) {
+            for (decltype(b.size()) j = 0; j < b.size(); ++j) {
+                ret[i + j] += a[i] * b[j];
+            }
+        }
+        return ret;
+    };
+
+    // Random coefficients spanning multiple limbs, possibly with many zeroes.
+    auto make_rand = [&](unsigned n, bool zeroes) {
+        std::vector<int_t> ret;
+        for (auto i = 0u; i < n; ++i) {
+            if (zeroes && cdist(rng) > 0) {
+                ret.emplace_back();
+            } else {
+                ret.push_back(int_t{cdist(rng)} << sdist(rng));
+            }
+        }
+        return ret;
+    };
+
+    for (auto na : {1u, 2u, 7u, 100u}) {
+        for (auto nb : {1u, 3u, 50u, 200u}) {
+            for (auto zeroes : {false, true}) {
+                const auto a = make_rand(na, zeroes), b = make_rand(nb, zeroes);
+
+                std::vector<int_t> ret(na + nb - 1u);
+                polynomials::detail::poly_ks_mul(ret.data(), a.data(), na, b.data(), nb);
+                REQUIRE(ret == school(a, b));
+            }
+        }
+    }
+
+    // Coefficients of maximal size, which maximise the carries.
+    for (auto sh : {1u, 63u, 64u, 65u, 128u}) {
+        for (auto sign : {1, -1}) {
+            const std::vector<int_t> a(37, ((int_t{1} << sh) - 1) * sign), b(41, (int_t{1} << sh) - 1);
+
+            std::vector<int_t> ret(a.size() + b.size() - 1u);
+            polynomials::detail::poly_ks_mul(ret.data(), a.data(), a.size(), b.data(), b.size());
+            REQUIRE(ret == school(a, b));
+        }
+    }
+
+    // Zero operands.
+    {
+        const std::vector<int_t> a(10), b{int_t{1}, int_t{2}};
+        std::vector<int_t> ret(11);
+        polynomials::detail::poly_ks_mul(ret.data(), a.data(), a.size(), b.data(), b.size());
+        REQUIRE(ret == std::vector<int_t>(11));
+    }
+
+    // Dense products via the multithreaded multiplication.
+    using pm_t = packed_monomial<exp_t>;
+    using poly_t = polynomial<pm_t, int_t>;
+
+    auto check = [](const poly_t &a, const poly_t &b) {
+        poly_t r0, r1;
+        r0.set_symbol_set(a.get_symbol_set());
+        polynomials::detail::poly_mul_impl_simple(r0, a, b);
+
+        r1.set_symbol_set(a.get_symbol_set());
+        polynomials::detail::poly_mul_impl_mt_hm(r1, a, b);
+        REQUIRE(r0 == r1);
+    };
+
+    auto [x, y, z] = make_polynomials<poly_t>("x", "y", "z");
+
+    check(obake::pow(x - y + z + 1, 20), obake::pow(x + y - z - 3, 20) + 1);
+    check(obake::pow(x + 2 * y - 1, 60), obake::pow(x - y * 3 + 5, 60));
+}
+
+TEST_CASE("polynomial_mul_sq_test")
+{
+    using pm_t = packed_monomial<exp_t>;
+
+    using cf_types = std::tuple<double, mppp::integer<1>>;
+
+    detail::tuple_for_each(cf_types{}, [](auto xs) {
+        using poly_t = polynomial<pm_t, decltype(xs)>;
+
+        auto [x, y, z, t] = make_polynomials<poly_t>("x", "y", "z", "t");
+
+        // Compare the squaring of a with the product of a by a copy of itself,
+        // using both the simple and the multithreaded implementations.
+        auto check = [](const poly_t &a, const auto &...args) {
+            const auto a_copy(a);
+
+            poly_t r0, r1, r2;
+            r0.set_symbol_set(a.get_symbol_set());
+            polynomials::detail::poly_mul_impl_simple(r0, a, a_copy, args...);
+
+            r1.set_symbol_set(a.get_symbol_set());
+            polynomials::detail::poly_mul_impl_simple(r1, a, a, args...);
+            REQUIRE(r0 == r1);
+
+            r2.set_symbol_set(a.get_symbol_set());
+            polynomials::detail::poly_mul_impl_mt_hm(r2, a, a, args...);
+            REQUIRE(r0 == r2);
+        };
+
+        check(x);
+        check(x + y);
+        check(x - y, 1);
+        check(x - y + 1, 1);
+        check(x - y + 1, 1, symbol_set{"x"});
+        check(x * y - 2 * z + 3, 2);
+
+        // Sparse operands, so that the multithreaded multiplication does
+        // not switch to the dense Kronecker engine.
+        auto f = x + obake::pow(y, 10) - obake::pow(z, 100) + obake::pow(t, 1000) + 1, tmp_f(f);
+        for (int i = 1; i < 6; ++i) {
+            f *= tmp_f;
+        }
+
+        check(f);
+        check(f, 20);
+        check(f, 1000);
+        check(f, 8, symbol_set{"x", "z"});
+        check(f, 7, symbol_set{"y"});
+        check(f, -1);
+
+        // Squaring via the public API.
+        const auto f_copy(f);
+        REQUIRE(f * f == f * f_copy);
+        REQUIRE(truncated_mul(f, f, 30) == truncated_mul(f, f_copy, 30));
+        REQUIRE(truncated_mul(f, f, 30, symbol_set{"t"}) == truncated_mul(f, f_copy, 30, symbol_set{"t"}));
+
+        // pow() squares the intermediate powers.
+        const auto g = x - 2 * y + z * t - 3;
+        REQUIRE(obake::pow(g, 4) == g * (g * (g * g)));
+        REQUIRE(obake::pow(g, 7) == g * g * g * g * g * g * g);
+    });
+
+    // The squaring kernel is not used if doubling
+    // the integral coefficients would overflow.
+    using poly_ll_t = polynomial<pm_t, long long>;
+    auto [x, y] = make_polynomials<poly_ll_t>("x", "y");
+    const auto p1 = x + y, p2 = x + std::numeric_limits<long long>::max() * y,
+               p3 = x + std::numeric_limits<long long>::min() * y;
+    REQUIRE(polynomials::detail::poly_mul_impl_is_square(p1, p1));
+    REQUIRE(!polynomials::detail::poly_mul_impl_is_square(p1, poly_ll_t(p1)));
+    REQUIRE(!polynomials::detail::poly_mul_impl_is_square(p2, p2));
+    REQUIRE(!polynomials::detail::poly_mul_impl_is_square(p3, p3));
+}
+
+#if defined(OBAKE_PACKABLE_INT64)
+
+TEST_CASE("polynomial_mul_wacc_test")
+{
+    using pm_t = packed_monomial<exp_t>;
+
+    // Wide accumulation with mppp::integer<1>: the intermediate
+    // sums do not fit in a single limb.
+    {
+        using poly_t = polynomial<pm_t, mppp::integer<1>>;
+
+        static_assert(polynomials::detail::poly_mul_wacc_enabled<mppp::integer<1>, mppp::integer<1>, mppp::integer<1>>);
+        static_assert(!polynomials::detail::poly_mul_wacc_enabled<double, double, double>);
+
+        auto [x, y] = make_polynomials<poly_t>("x", "y");
+
+        const auto c = mppp::integer<1>{1} << 62;
+
+        auto check = [](const poly_t &a0, const poly_t &b0) {
+            // NOTE: the implementations require the
+            // first operand not to be larger than the second.
+            const auto &a = a0.size() <= b0.size() ? a0 : b0;
+            const auto &b = a0.size() <= b0.size() ? b0 : a0;
+
+            poly_t r0, r1;
+            r0.set_symbol_set(a.get_symbol_set());
+            polynomials::detail::poly_mul_impl_simple(r0, a, b);
+
+            r1.set_symbol_set(a.get_symbol_set());
+            polynomials::detail::poly_mul_impl_mt_hm(r1, a, b);
+            REQUIRE(r0 == r1);
+
+            return r1;
+        };
+
+        REQUIRE(check(c * x + c * y, c * x - c * y) == c * c * x * x - c * c * y * y);
+        REQUIRE(check(c * x + c * y + 1, c * x + c * y - 1) == obake::pow(c * x + c * y, 2) - 1);
+        REQUIRE(check(c * x + c * y, c * x + c * y) == obake::pow(c * x + c * y, 2));
+
+        // The accumulated sums do not fit in 2 limbs.
+        auto [z, t] = make_polynomials<poly_t>(symbol_set{"x", "y", "z", "t"}, "z", "t");
+        const auto c2 = mppp::integer<1>{1} << 63;
+        const auto xyzt = (x * y * z * t).begin()->first;
+        const auto e3 = y * z * t + x * z * t + x * y * t + x * y * z;
+        auto r = check(c2 * (x + y + z + t), c2 * e3);
+        REQUIRE(r.size() == 13u);
+        REQUIRE(r.find(xyzt) != r.end());
+        REQUIRE(r.find(xyzt)->second == 4 * c2 * c2);
+        r = check(c2 * (x + y - z - t), c2 * e3);
+        REQUIRE(r.size() == 12u);
+        REQUIRE(r.find(xyzt) == r.end());
+    }
+
+#if defined(OBAKE_HAVE_GCC_INT128)
+
+    // Wide accumulation with a C++ integral type: the
+    // intermediate sums overflow, the final result does not.
+    {
+        using poly_t = polynomial<pm_t, long long>;
+
+        static_assert(polynomials::detail::poly_mul_wacc_enabled<long long, long long, long long>);
+
+        auto [x, y] = make_polynomials<poly_t>("x", "y");
+
+        const auto c = 1ll << 62;
+
+        poly_t retval;
+        retval.set_symbol_set(symbol_set{"x", "y"});
+        polynomials::detail::poly_mul_impl_mt_hm(retval, c * x + c * y - c * x * y, x + y + 1);
+        REQUIRE(retval
+                == c * x * x + c * y * y + c * x + c * y + c * x * y - c * x * x * y - c * x * y * y);
+
+        // The final result overflows.
+        retval.clear();
+        retval.set_symbol_set(symbol_set{"x", "y"});
+        OBAKE_REQUIRES_THROWS_CONTAINS(polynomials::detail::poly_mul_impl_mt_hm(retval, c * x + c * y, x + y),
+                                       std::overflow_error,
+                                       "Overflow detected in the accumulation of the coefficients "
+                                       "during a polynomial multiplication");
+        REQUIRE(retval.empty());
+    }
+
+    // Same with int.
+    {
+        using poly_t = polynomial<pm_t, int>;
+
+        static_assert(polynomials::detail::poly_mul_wacc_enabled<int, int, int>);
+
+        auto [x, y] = make_polynomials<poly_t>("x", "y");
+
+        const auto c = 1 << 30;
+
+        poly_t retval;
+        retval.set_symbol_set(symbol_set{"x", "y"});
+        polynomials::detail::poly_mul_impl_mt_hm(retval, c * x + c * y - c * x * y, x + y + 1);
+        REQUIRE(retval
+                == c * x * x + c * y * y + c * x + c * y + c * x * y - c * x * x * y - c * x * y * y);
+
+        retval.clear();
+        retval.set_symbol_set(symbol_set{"x", "y"});
+        OBAKE_REQUIRES_THROWS_CONTAINS(polynomials::detail::poly_mul_impl_mt_hm(retval, c * x + c * y, x + y),
+                                       std::overflow_error,
+                                       "Overflow detected in the accumulation of the coefficients "
+                                       "during a polynomial multiplication");
+        REQUIRE(retval.empty());
+
+        // The number of accumulators does not fit in the coefficient type.
+        int n = 0;
+        polynomials::detail::poly_mul_wacc_set_idx(n, static_cast<std::size_t>(std::numeric_limits<int>::max()));
+        REQUIRE(n == std::numeric_limits<int>::max());
+        OBAKE_REQUIRES_THROWS_CONTAINS(polynomials::detail::poly_mul_wacc_set_idx(
+                                           n, static_cast<std::size_t>(std::numeric_limits<int>::max()) + 1u),
+                                       std::overflow_error,
+                                       "Overflow detected in the number of wide accumulators "
+                                       "used in a polynomial multiplication");
+    }
+
+#endif
+
+    // Short integral coefficients do not use wide
+    // accumulation, thus the number of terms in the result
+    // is not limited by the range of the coefficient type.
+    {
+        static_assert(!polynomials::detail::poly_mul_wacc_enabled<short, short, short>);
+        static_assert(!polynomials::detail::poly_mul_wacc_enabled<signed char, signed char, signed char>);
+
+        using poly_t = polynomial<pm_t, short>;
+
+        auto [x, y] = make_polynomials<poly_t>(symbol_set{"x", "y"}, "x", "y");
+
+        poly_t f, g, xi{1}, yi{1};
+        for (int i = 0; i < 200; ++i) {
+            f += xi;
+            g += yi;
+            xi *= x;
+            yi *= y;
+        }
+
+        poly_t r0, r1;
+        r0.set_symbol_set(f.get_symbol_set());
+        polynomials::detail::poly_mul_impl_simple(r0, f, g);
+
+        r1.set_symbol_set(f.get_symbol_set());
+        polynomials::detail::poly_mul_impl_mt_hm(r1, f, g);
+
+        REQUIRE(r1.size() == 40000u);
+        REQUIRE(r1.size() > static_cast<unsigned>(std::numeric_limits<short>::max()));
+        REQUIRE(r0 == r1);
+        REQUIRE(std::all_of(r1.begin(), r1.end(), [](const auto &p) { return p.second == 1; }));
+    }
+}
+
+#endif
+
+TEST_CASE("polynomial_mul_mt_generic_test")
+{
+    using pm_t = packed_monomial<exp_t>;
+
+    using cf_types = std::tuple<double, mppp::integer<1>>;
+
+    detail::tuple_for_each(cf_types{}, [](auto xs) {
+        using poly_t = polynomial<pm_t, decltype(xs)>;
+
+        // NOTE: the MT generic implementation
+        // segments the return value, use a new
+        // one for each test.
+
+        // A few simple tests.
+        {
+            poly_t retval;
+            polynomials::detail::poly_mul_impl_mt_generic(retval, poly_t{3}, poly_t{4});
+            REQUIRE(retval == 12);
+        }
+
+        // Examples with cancellations.
+        auto [a, b] = make_polynomials<poly_t>(symbol_set{"a", "b", "c"}, "a", "b");
+        {
+            poly_t retval;
+            retval.set_symbol_set(symbol_set{"a", "b", "c"});
+            polynomials::detail::poly_mul_impl_mt_generic(retval, a + b, a - b);
+            REQUIRE(retval == a * a - b * b);
+        }
+        {
+            poly_t retval;
+            retval.set_symbol_set(symbol_set{"a", "b", "c"});
+            polynomials::detail::poly_mul_impl_mt_generic(retval, a * a + b * b, (a + b) * (a - b));
+            REQUIRE(retval == a * a * a * a - b * b * b * b);
+        }
+
+        // An overflowing example.
+        poly_t retval;
+        retval.set_symbol_set(symbol_set{"a"});
+        a.clear();
+        a.set_symbol_set(symbol_set{"a"});
+        b.clear();
+        b.set_symbol_set(symbol_set{"a"});
+        a.add_term(pm_t{detail::kpack_get_lims<exp_t>(1).second}, 1);
+        b.add_term(pm_t{detail::kpack_get_lims<exp_t>(1).second}, 1);
+
+        OBAKE_REQUIRES_THROWS_CONTAINS(
+            polynomials::detail::poly_mul_impl_mt_generic(retval, a, b), std::overflow_error,
+            "An overflow in the monomial exponents was detected while attempting to multiply two polynomials");
+        REQUIRE(retval.empty());
+
+        // Compare with the simple implementation on larger
+        // operands, also in truncated mode.
+        auto [x, y, z, t] = make_polynomials<poly_t>("x", "y", "z", "t");
+
+        auto check = [](const poly_t &f, const poly_t &g, const auto &...args) {
+            poly_t r0, r1;
+            r0.set_symbol_set(f.get_symbol_set());
+            polynomials::detail::poly_mul_impl_simple(r0, f, g, args...);
+
+            r1.set_symbol_set(f.get_symbol_set());
+            polynomials::detail::poly_mul_impl_mt_generic(r1, f, g, args...);
+            REQUIRE(r0 == r1);
+        };
+
+        auto f = x + y + z + t + 1, tmp_f(f);
+        for (int i = 1; i < 6; ++i) {
+            f *= tmp_f;
+        }
+        auto g = x - y + 2 * z - t + 1, tmp_g(g);
+        for (int i = 1; i < 6; ++i) {
+            g *= tmp_g;
+        }
+
+        check(f, g);
+        check(f, f);
+        check(f, g, 4);
+        check(f, g, -1);
+        check(f, g, 3, symbol_set{"x", "z"});
+    });
+}
@@ -20,6 +20,7 @@
 #include <obake/math/pow.hpp>
 #include <obake/polynomials/packed_monomial.hpp>
 #include <obake/polynomials/polynomial.hpp>
+#include <obake/series.hpp>
 #include <obake/symbols.hpp>
 
 #include "catch.hpp"
@@ -364,4 +365,79 @@ TEST_CASE("polynomial_pow_test")
     OBAKE_REQUIRES_THROWS_CONTAINS(
         obake::pow(a * a * b * b, mppp::rational<1>{2, 3}), std::invalid_argument,
         "Invalid exponent for monomial exponentiation: the exponent cannot be converted into an integral value");
+
+    // Exponentiation of multi-term polynomials via Miller's
+    // recurrence and binary exponentiation.
+    // Helper to compute the powers via repeated multiplications.
+    auto rm = [](const auto &p, unsigned n) {
+        auto ret(p);
+        for (auto i = 1u; i < n; ++i) {
+            ret = ret * p;
+        }
+        return ret;
+    };
+
+    // Bases with a constant term (Miller's recurrence).
+    for (auto n : {2u, 3u, 7u, 20u}) {
+        REQUIRE(obake::pow(x + 2 * y / 3 - 5, n) == rm(x + 2 * y / 3 - 5, n));
+        REQUIRE(obake::pow(x * x * y - x / 7 + 1, n) == rm(x * x * y - x / 7 + 1, n));
+    }
+    REQUIRE(obake::pow(x + y + 1, mppp::rational<1>{4}) == rm(x + y + 1, 4));
+
+    {
+        using poly3_t = polynomial<pm_t, mppp::integer<1>>;
+
+        auto [u, v, w] = make_polynomials<poly3_t>("u", "v", "w");
+
+        for (auto n : {2u, 5u, 17u}) {
+            REQUIRE(obake::pow(u + 2 * v - 3 * w * w + 5, n) == rm(u + 2 * v - 3 * w * w + 5, n));
+            REQUIRE(obake::pow(-2 - u * v * w + u * u * u, n) == rm(-2 - u * v * w + u * u * u, n));
+        }
+
+        // Bases without a constant term.
+        REQUIRE(obake::pow(u + v * w, 3) == rm(u + v * w, 3));
+        REQUIRE(obake::pow(u + v * w, 20) == rm(u + v * w, 20));
+
+        // Direct tests of the implementation functions.
+        poly3_t r;
+        REQUIRE(!polynomials::detail::pow_poly_miller(r, u + v * w, 3, 3u));
+        REQUIRE(r.empty());
+        REQUIRE(polynomials::detail::pow_poly_miller(r, u + 1, 3, 3u));
+        REQUIRE(r == rm(u + 1, 3));
+        REQUIRE(polynomials::detail::pow_poly_binexp(u + v * w, 1) == u + v * w);
+        REQUIRE(polynomials::detail::pow_poly_binexp(u + v * w, 6) == rm(u + v * w, 6));
+
+        // Miller's recurrence is enabled only for exact coefficient rings.
+        REQUIRE(polynomials::detail::pow_poly_miller_enabled<poly3_t, int>);
+        REQUIRE(polynomials::detail::pow_poly_miller_enabled<poly_t, int>);
+        REQUIRE(!polynomials::detail::pow_poly_miller_enabled<poly2_t, int>);
+        REQUIRE(!polynomials::detail::pow_poly_miller_enabled<polynomial<pm_t, long long>, int>);
+
+        // Miller's recurrence does not support coefficient threshold truncation.
+        REQUIRE(!polynomials::detail::pow_poly_miller_enabled<poly3_t, int, polynomials::cf_threshold>);
+
+        // The results of Miller's recurrence and of binary
+        // exponentiation are stored in the series pow cache.
+        customisation::internal::clear_series_pow_map();
+        REQUIRE(!customisation::internal::series_pow_cache_lookup(u + 1, 5));
+        REQUIRE(!customisation::internal::series_pow_cache_lookup(u + v * w, 20));
+        const auto p1 = obake::pow(u + 1, 5), p2 = obake::pow(u + v * w, 20);
+        REQUIRE(customisation::internal::series_pow_cache_lookup(u + 1, 5) == p1);
+        REQUIRE(customisation::internal::series_pow_cache_lookup(u + v * w, 20) == p2);
+        REQUIRE(!customisation::internal::series_pow_cache_lookup(u + v * w, 19));
+        REQUIRE(obake::pow(u + 1, 5) == p1);
+        REQUIRE(obake::pow(u + v * w, 20) == p2);
+
+        // The missing powers are filled in by the
+        // repeated multiplications.
+        REQUIRE(customisation::internal::series_pow_from_cache(u + v * w, 21) == rm(u + v * w, 21));
+        REQUIRE(customisation::internal::series_pow_cache_lookup(u + v * w, 19) == rm(u + v * w, 19));
+        REQUIRE(customisation::internal::series_pow_cache_lookup(u + v * w, 20) == p2);
+        customisation::internal::clear_series_pow_map();
+    }
+
+    // Terms with negative degree.
+    REQUIRE(obake::pow(x + x_inv + 1, 3) == rm(x + x_inv + 1, 3));
+    REQUIRE(obake::pow(x + x_inv + 1, 16) == rm(x + x_inv + 1, 16));
+    REQUIRE(obake::pow(x * x_inv * y + y * x_inv + 2, 5) == rm(x * x_inv * y + y * x_inv + 2, 5));
 }
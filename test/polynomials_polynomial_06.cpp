@@ -0,0 +1,169 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <obake/config.hpp>
+
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+
+#include <mp++/integer.hpp>
+
+#include <obake/detail/tuple_for_each.hpp>
+#include <obake/kpack.hpp>
+#include <obake/math/pow.hpp>
+#include <obake/polynomials/d_packed_monomial.hpp>
+#include <obake/polynomials/packed_monomial.hpp>
+#include <obake/polynomials/polynomial.hpp>
+#include <obake/symbols.hpp>
+#include <obake/type_traits.hpp>
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+using namespace obake;
+
+using exp_t =
+#if defined(OBAKE_PACKABLE_INT64)
+    std::int64_t
+#else
+    std::int32_t
+#endif
+    ;
+
+template <typename T, typename U, typename P>
+concept heap_mul_available = requires(const T &x, const U &y, const P &p)
+{
+    polynomials::series_mul(x, y, p);
+};
+
+TEST_CASE("polynomial_mul_heap_policy")
+{
+    using pm_t = packed_monomial<exp_t>;
+    using poly_t = polynomial<pm_t, mppp::integer<1>>;
+    using d_poly_t = polynomial<d_packed_monomial<exp_t, 8>, mppp::integer<1>>;
+
+    REQUIRE(heap_mul_available<poly_t, poly_t, polynomials::mul_auto_t>);
+    REQUIRE(heap_mul_available<poly_t, poly_t, polynomials::mul_heap_t>);
+    REQUIRE(heap_mul_available<poly_t, polynomial<pm_t, double>, polynomials::mul_heap_t>);
+    REQUIRE(heap_mul_available<d_poly_t, d_poly_t, polynomials::mul_auto_t>);
+    // The heap policy requires packed monomials.
+    REQUIRE(!heap_mul_available<d_poly_t, d_poly_t, polynomials::mul_heap_t>);
+    REQUIRE(!heap_mul_available<poly_t, poly_t, int>);
+    REQUIRE(!heap_mul_available<poly_t, d_poly_t, polynomials::mul_heap_t>);
+
+    auto [x, y] = make_polynomials<poly_t>("x", "y");
+
+    REQUIRE(polynomials::series_mul(x + y, x - y, polynomials::mul_auto) == x * x - y * y);
+    REQUIRE(polynomials::series_mul(x + y, x - y, polynomials::mul_heap) == x * x - y * y);
+    REQUIRE(std::is_same_v<decltype(polynomials::series_mul(x, polynomial<pm_t, double>{}, polynomials::mul_heap)),
+                           polynomial<pm_t, double>>);
+}
+
+TEST_CASE("polynomial_mul_heap_test")
+{
+    using cf_types = std::tuple<double, mppp::integer<1>>;
+    using exp_types = std::tuple<exp_t, std::make_unsigned_t<exp_t>>;
+
+    detail::tuple_for_each(exp_types{}, [](auto es) {
+        using e_t = decltype(es);
+        using pm_t = packed_monomial<e_t>;
+
+        detail::tuple_for_each(cf_types{}, [](auto xs) {
+            using poly_t = polynomial<pm_t, decltype(xs)>;
+
+            // Helper to compare the heap-based multiplication
+            // to the default one, with an automatic number of parts
+            // and with a few explicit numbers of parts.
+            auto check = [](const poly_t &a, const poly_t &b) {
+                const auto cmp = a * b;
+
+                REQUIRE(polynomials::series_mul(a, b, polynomials::mul_heap) == cmp);
+                REQUIRE(polynomials::series_mul(b, a, polynomials::mul_heap) == cmp);
+
+                const auto &a0 = a.size() <= b.size() ? a : b;
+                const auto &b0 = a.size() <= b.size() ? b : a;
+                if (a0.empty() || a0.get_symbol_set() != b0.get_symbol_set()) {
+                    return;
+                }
+
+                for (auto nparts : {1u, 2u, 7u, 100u}) {
+                    poly_t ret;
+                    ret.set_symbol_set(a0.get_symbol_set());
+                    polynomials::detail::poly_mul_impl_heap(ret, a0, b0, nparts);
+                    REQUIRE(ret == cmp);
+                }
+            };
+
+            // Simple cases.
+            check(poly_t{}, poly_t{});
+            check(poly_t{3}, poly_t{});
+            check(poly_t{3}, poly_t{4});
+
+            auto [x, y, z] = make_polynomials<poly_t>("x", "y", "z");
+
+            check(x, y);
+            check(x + y, x - y);
+            check(x * x + y * y, (x + y) * (x - y));
+
+            // Different symbol sets.
+            auto [a, b] = make_polynomials<poly_t>("a", "b");
+            check(x + y, a - b);
+            check(x + a + 1, a * x - z);
+
+            // Dense operands.
+            auto f = x + y + z + 1, tmp_f(f);
+            for (int i = 1; i < 8; ++i) {
+                f *= tmp_f;
+            }
+            check(f, f + 1);
+            check(f, f * (x - y));
+
+            // Cancellations, including a product which
+            // is zero.
+            check(f * (x + y), f * (x - y) + 2);
+            check(f * (x + y), x - y);
+            REQUIRE(polynomials::series_mul(x - x + 1, poly_t{}, polynomials::mul_heap).empty());
+
+            // Sparse operands.
+            auto g = x + obake::pow(y, 3) + obake::pow(z, 7) + 1, tmp_g(g);
+            for (int i = 1; i < 6; ++i) {
+                g *= tmp_g;
+            }
+            check(g, g + obake::pow(x, 200));
+            check(g, g * (z - obake::pow(x, 100)));
+
+            if constexpr (is_signed_v<e_t>) {
+                // Negative exponents.
+                poly_t xi;
+                xi.set_symbol_set(symbol_set{"x", "y", "z"});
+                xi.add_term(pm_t{-1, 0, 0}, 1);
+
+                auto h = x + xi + y + z + 1, tmp_h(h);
+                for (int i = 1; i < 6; ++i) {
+                    h *= tmp_h;
+                }
+                check(h, h - 1);
+                check(h, h * (xi - y));
+            }
+
+            // An overflowing example.
+            poly_t c, d;
+            c.set_symbol_set(symbol_set{"a"});
+            d.set_symbol_set(symbol_set{"a"});
+            c.add_term(pm_t{detail::kpack_get_lims<e_t>(1).second}, 1);
+            d.add_term(pm_t{detail::kpack_get_lims<e_t>(1).second}, 1);
+
+            OBAKE_REQUIRES_THROWS_CONTAINS(
+                polynomials::series_mul(c, d, polynomials::mul_heap), std::overflow_error,
+                "An overflow in the monomial exponents was detected while attempting to multiply two polynomials");
+        });
+    });
+}
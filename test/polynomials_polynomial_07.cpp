@@ -0,0 +1,149 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <obake/config.hpp>
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <mp++/integer.hpp>
+
+#include <obake/detail/tuple_for_each.hpp>
+#include <obake/math/pow.hpp>
+#include <obake/polynomials/packed_monomial.hpp>
+#include <obake/polynomials/polynomial.hpp>
+#include <obake/symbols.hpp>
+
+#include "catch.hpp"
+
+using namespace obake;
+
+using exp_t =
+#if defined(OBAKE_PACKABLE_INT64)
+    std::int64_t
+#else
+    std::int32_t
+#endif
+    ;
+
+TEST_CASE("polynomial_prepared_operand_api")
+{
+    using pm_t = packed_monomial<exp_t>;
+    using poly_t = polynomial<pm_t, mppp::integer<1>>;
+    using dpoly_t = polynomial<pm_t, double>;
+    using prep_t = polynomials::prepared_operand<pm_t, mppp::integer<1>>;
+    using dprep_t = polynomials::prepared_operand<pm_t, double>;
+
+    auto [x, y, z] = make_polynomials<poly_t>("x", "y", "z");
+    auto [dx, dy] = make_polynomials<dpoly_t>("x", "y");
+
+    const prep_t px{x + y}, pe{poly_t{}};
+    REQUIRE(px.get_poly() == x + y);
+    REQUIRE(px._get_terms().size() == 2u);
+    REQUIRE(pe.get_poly().empty());
+
+    // Multiplication.
+    REQUIRE(std::is_same_v<decltype(px * x), poly_t>);
+    REQUIRE(std::is_same_v<decltype(x * px), poly_t>);
+    REQUIRE(std::is_same_v<decltype(px * px), poly_t>);
+    REQUIRE(std::is_same_v<decltype(px * dx), dpoly_t>);
+    REQUIRE(std::is_same_v<decltype(dprep_t{dx} * px), dpoly_t>);
+    REQUIRE(px * (x - y) == x * x - y * y);
+    REQUIRE((x - y) * px == x * x - y * y);
+    REQUIRE(px * px == (x + y) * (x + y));
+    REQUIRE(polynomials::series_mul(px, x - y) == x * x - y * y);
+    REQUIRE(px * dx == dx * dx + dx * dy);
+    REQUIRE((px * pe).empty());
+    REQUIRE((pe * x).empty());
+
+    // Different symbol sets.
+    REQUIRE(px * z == x * z + y * z);
+    REQUIRE(z * px == x * z + y * z);
+
+    // Truncated multiplication.
+    REQUIRE(truncated_mul(px, x - y + 1, 1) == x + y);
+    REQUIRE(truncated_mul(x - y + 1, px, 1) == x + y);
+    REQUIRE(truncated_mul(px, px, 1).empty());
+    REQUIRE(truncated_mul(px, x + 1, 1, symbol_set{"x"}) == x + y + x * y);
+    REQUIRE(truncated_mul(px, prep_t{x + 1}, 1, symbol_set{"x"}) == x + y + x * y);
+
+    // Copies share the cache.
+    auto px2(px);
+    REQUIRE(px2 * px == (x + y) * (x + y));
+    auto px3(std::move(px2));
+    REQUIRE(px3 * (x - y) == x * x - y * y);
+}
+
+TEST_CASE("polynomial_prepared_operand_mt_hm")
+{
+    using cf_types = std::tuple<double, mppp::integer<1>>;
+
+    detail::tuple_for_each(cf_types{}, [](auto xs) {
+        using pm_t = packed_monomial<exp_t>;
+        using cf_t = decltype(xs);
+        using poly_t = polynomial<pm_t, cf_t>;
+        using prep_t = polynomials::prepared_operand<pm_t, cf_t>;
+
+        auto [x, y, z, t] = make_polynomials<poly_t>("x", "y", "z", "t");
+
+        // Sparse operands, so that the multithreaded multiplication does
+        // not switch to the dense Kronecker engine.
+        auto f = x + obake::pow(y, 10) + obake::pow(z, 100) + obake::pow(t, 1000) + 1, tmp_f(f);
+        for (int i = 1; i < 6; ++i) {
+            f *= tmp_f;
+        }
+        const auto g = f + obake::pow(x, 3000);
+        const prep_t pf{f};
+
+        // Helper to run the multithreaded multiplication
+        // with a prepared operand and compare to the simple one.
+        auto check = [](const auto &a, const auto &b, const auto &...args) {
+            const auto &sa = polynomials::detail::poly_mul_op_series(a);
+            const auto &sb = polynomials::detail::poly_mul_op_series(b);
+
+            poly_t r0, r1;
+            r0.set_symbol_set(sa.get_symbol_set());
+            polynomials::detail::poly_mul_impl_simple(r0, sa, sb, args...);
+
+            r1.set_symbol_set(sa.get_symbol_set());
+            polynomials::detail::poly_mul_impl_mt_hm(r1, a, b, args...);
+            REQUIRE(r0 == r1);
+        };
+
+        // Run each multiplication twice, so that the
+        // second time the data is fetched from the cache.
+        for (int i = 0; i < 2; ++i) {
+            check(pf, g);
+            check(pf, pf);
+            check(f, prep_t{g});
+            check(pf, g, 20);
+            check(pf, pf, 20);
+            check(pf, g, 8, symbol_set{"x", "z"});
+            check(pf, g, 7, symbol_set{"y"});
+        }
+
+        // Explicit clearing of the cache.
+        REQUIRE(pf._get_cache_size() > 0u);
+        pf.clear_cache();
+        REQUIRE(pf._get_cache_size() == 0u);
+        check(pf, g, 20);
+        REQUIRE(pf._get_cache_size() == 1u);
+
+        // The cache is bounded.
+        for (auto i = 0u; i < polynomials::detail::prepared_operand_max_cache_size + 2u; ++i) {
+            check(pf, g, 8, symbol_set{"x", "s" + std::to_string(i)});
+            REQUIRE(pf._get_cache_size() > 0u);
+            REQUIRE(pf._get_cache_size() <= polynomials::detail::prepared_operand_max_cache_size);
+        }
+        check(pf, g, 20);
+    });
+}
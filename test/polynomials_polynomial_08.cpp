@@ -0,0 +1,259 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <obake/config.hpp>
+
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+
+#include <mp++/integer.hpp>
+
+#include <obake/math/fma3.hpp>
+#include <obake/math/is_zero.hpp>
+#include <obake/polynomials/d_packed_monomial.hpp>
+#include <obake/polynomials/mod_int.hpp>
+#include <obake/polynomials/packed_monomial.hpp>
+#include <obake/polynomials/polynomial.hpp>
+#include <obake/series.hpp>
+#include <obake/symbols.hpp>
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+using namespace obake;
+
+using exp_t =
+#if defined(OBAKE_PACKABLE_INT64)
+    std::int64_t
+#else
+    std::int32_t
+#endif
+    ;
+
+template <typename T, typename U, typename P>
+concept policy_mul_available = requires(const T &x, const U &y, const P &p)
+{
+    polynomials::series_mul(x, y, p);
+};
+
+TEST_CASE("mod_int_test")
+{
+    using mi_t = polynomials::mod_int<2147483647u>;
+    using mi7_t = polynomials::mod_int<7u>;
+
+    REQUIRE(is_cf_v<mi_t>);
+    REQUIRE(is_mult_addable_v<mi_t &, const mi_t &, const mi_t &>);
+
+    REQUIRE(mi_t{}.get_value() == 0u);
+    REQUIRE(obake::is_zero(mi_t{}));
+    REQUIRE(mi_t{5}.get_value() == 5u);
+    REQUIRE(mi_t{-1}.get_value() == 2147483646u);
+    REQUIRE(mi_t{2147483647u}.get_value() == 0u);
+    REQUIRE(mi_t{4294967296ull}.get_value() == 2u);
+    REQUIRE(mi_t{mppp::integer<1>{-3}}.get_value() == 2147483644u);
+    REQUIRE(mi_t{mppp::integer<1>{1} << 100} == mi_t{mppp::integer<2>{1} << 100});
+
+    REQUIRE(mi7_t{3} + mi7_t{5} == mi7_t{1});
+    REQUIRE(mi7_t{3} - mi7_t{5} == mi7_t{5});
+    REQUIRE(mi7_t{3} * mi7_t{5} == mi7_t{1});
+    REQUIRE(-mi7_t{3} == mi7_t{4});
+    REQUIRE(-mi7_t{} == mi7_t{});
+    REQUIRE(+mi7_t{3} == mi7_t{3});
+    REQUIRE(mi7_t{3} != mi7_t{4});
+
+    // Exhaustive check of the arithmetic for a small modulus.
+    for (auto i = 0; i < 7; ++i) {
+        for (auto j = 0; j < 7; ++j) {
+            REQUIRE((mi7_t{i} + mi7_t{j}).get_value() == static_cast<unsigned>((i + j) % 7));
+            REQUIRE((mi7_t{i} - mi7_t{j}).get_value() == static_cast<unsigned>((i - j + 7) % 7));
+            REQUIRE((mi7_t{i} * mi7_t{j}).get_value() == static_cast<unsigned>((i * j) % 7));
+
+            mi7_t tmp{1};
+            obake::fma3(tmp, mi7_t{i}, mi7_t{j});
+            REQUIRE(tmp.get_value() == static_cast<unsigned>((i * j + 1) % 7));
+        }
+    }
+
+    // Large values.
+    REQUIRE(mi_t{2147483646} * mi_t{2147483646} == mi_t{1});
+    REQUIRE(mi_t{1ll << 40} * mi_t{1ll << 40} == mi_t{mppp::integer<1>{1} << 80});
+
+    std::ostringstream oss;
+    oss << mi_t{-2};
+    REQUIRE(oss.str() == "2147483645");
+
+    // Polynomials with modular coefficients.
+    using pm_t = packed_monomial<exp_t>;
+    using poly_t = polynomial<pm_t, mi7_t>;
+
+    auto [x, y] = make_polynomials<poly_t>("x", "y");
+
+    REQUIRE((x + y) * (x - y) == x * x - y * y);
+    auto p7 = x + y;
+    for (auto i = 1; i < 7; ++i) {
+        p7 *= x + y;
+    }
+    REQUIRE(p7 == x * x * x * x * x * x * x + y * y * y * y * y * y * y);
+    REQUIRE((mi7_t{2} * x + y) * (mi7_t{4} * x - y) == x * x + mi7_t{2} * x * y - y * y);
+}
+
+TEST_CASE("rt_mod_int_test")
+{
+    using rt_t = polynomials::rt_mod_int;
+
+    REQUIRE(is_cf_v<rt_t>);
+    REQUIRE(is_mult_addable_v<rt_t &, const rt_t &, const rt_t &>);
+    REQUIRE(!std::is_constructible_v<rt_t, int>);
+
+    // Default construction: zero without a modulus.
+    REQUIRE(rt_t{}.get_value() == 0u);
+    REQUIRE(rt_t{}.get_modulus() == 0u);
+    REQUIRE(obake::is_zero(rt_t{}));
+    REQUIRE(rt_t{} == rt_t{0, 7u});
+
+    REQUIRE(rt_t{5, 2147483647u}.get_value() == 5u);
+    REQUIRE(rt_t{5, 2147483647u}.get_modulus() == 2147483647u);
+    REQUIRE(rt_t{-1, 2147483647u}.get_value() == 2147483646u);
+    REQUIRE(rt_t{4294967296ull, 2147483647u}.get_value() == 2u);
+    REQUIRE(rt_t{mppp::integer<1>{-3}, 2147483647u}.get_value() == 2147483644u);
+    REQUIRE(!obake::is_zero(rt_t{1, 7u}));
+    REQUIRE(obake::is_zero(rt_t{14, 7u}));
+
+    OBAKE_REQUIRES_THROWS_CONTAINS(rt_t(1, 8u), std::invalid_argument,
+                                   "The modulus of an rt_mod_int must be an odd integer greater than 1 and smaller "
+                                   "than 2**31, but a modulus of 8 was provided instead");
+    OBAKE_REQUIRES_THROWS_CONTAINS(rt_t(1, 1u), std::invalid_argument, "but a modulus of 1 was provided instead");
+    OBAKE_REQUIRES_THROWS_CONTAINS(rt_t(mppp::integer<1>{1}, 2147483649u), std::invalid_argument,
+                                   "but a modulus of 2147483649 was provided instead");
+
+    // A zero without a modulus adopts the modulus of the other operand.
+    rt_t acc;
+    acc += rt_t{3, 7u};
+    REQUIRE(acc.get_modulus() == 7u);
+    REQUIRE(acc.get_value() == 3u);
+    rt_t acc2;
+    acc2 -= rt_t{3, 7u};
+    REQUIRE(acc2.get_value() == 4u);
+    rt_t acc3;
+    obake::fma3(acc3, rt_t{3, 7u}, rt_t{5, 7u});
+    REQUIRE(acc3.get_modulus() == 7u);
+    REQUIRE(acc3.get_value() == 1u);
+    REQUIRE(obake::is_zero(rt_t{} * rt_t{3, 7u}));
+    REQUIRE(obake::is_zero(rt_t{3, 7u} * rt_t{}));
+
+    // Exhaustive check of the arithmetic for a small modulus,
+    // against the compile-time modulus implementation.
+    using mi7_t = polynomials::mod_int<7u>;
+    for (auto i = 0; i < 7; ++i) {
+        REQUIRE((-rt_t{i, 7u}).get_value() == (-mi7_t{i}).get_value());
+        for (auto j = 0; j < 7; ++j) {
+            REQUIRE((rt_t{i, 7u} + rt_t{j, 7u}).get_value() == (mi7_t{i} + mi7_t{j}).get_value());
+            REQUIRE((rt_t{i, 7u} - rt_t{j, 7u}).get_value() == (mi7_t{i} - mi7_t{j}).get_value());
+            REQUIRE((rt_t{i, 7u} * rt_t{j, 7u}).get_value() == (mi7_t{i} * mi7_t{j}).get_value());
+        }
+    }
+
+    // Large values.
+    REQUIRE(rt_t{2147483646, 2147483647u} * rt_t{2147483646, 2147483647u} == rt_t{1, 2147483647u});
+    REQUIRE((rt_t{1ll << 40, 2147483629u} * rt_t{1ll << 40, 2147483629u}).get_value()
+            == polynomials::mod_int<2147483629u>{mppp::integer<1>{1} << 80}.get_value());
+
+    std::ostringstream oss;
+    oss << rt_t{-2, 2147483647u};
+    REQUIRE(oss.str() == "2147483645");
+    oss.str("");
+    oss << rt_t{};
+    REQUIRE(oss.str() == "0");
+
+    // Polynomials with modular coefficients.
+    using pm_t = packed_monomial<exp_t>;
+    using poly_t = polynomial<pm_t, rt_t>;
+
+    poly_t x, y;
+    x.set_symbol_set(symbol_set{"x", "y"});
+    y.set_symbol_set(symbol_set{"x", "y"});
+    x.add_term(pm_t{1, 0}, 1, 7u);
+    y.add_term(pm_t{0, 1}, 1, 7u);
+
+    auto p7 = x + y;
+    for (auto i = 1; i < 7; ++i) {
+        p7 *= x + y;
+    }
+    REQUIRE(p7 == x * x * x * x * x * x * x + y * y * y * y * y * y * y);
+}
+
+TEST_CASE("polynomial_mul_crt_policy")
+{
+    using pm_t = packed_monomial<exp_t>;
+    using poly_t = polynomial<pm_t, mppp::integer<1>>;
+    using poly2_t = polynomial<pm_t, mppp::integer<2>>;
+    using d_poly_t = polynomial<d_packed_monomial<exp_t, 8>, mppp::integer<1>>;
+
+    REQUIRE(policy_mul_available<poly_t, poly_t, polynomials::mul_crt_t>);
+    REQUIRE(policy_mul_available<poly2_t, poly2_t, polynomials::mul_crt_t>);
+    REQUIRE(policy_mul_available<d_poly_t, d_poly_t, polynomials::mul_crt_t>);
+    // The multi-modular policy requires mp++ integer coefficients.
+    REQUIRE(!policy_mul_available<poly_t, polynomial<pm_t, double>, polynomials::mul_crt_t>);
+    REQUIRE(!policy_mul_available<polynomial<pm_t, double>, polynomial<pm_t, double>, polynomials::mul_crt_t>);
+    REQUIRE(!policy_mul_available<poly_t, poly2_t, polynomials::mul_crt_t>);
+
+    auto [x, y] = make_polynomials<poly_t>("x", "y");
+
+    REQUIRE(polynomials::series_mul(x + y, x - y, polynomials::mul_crt) == x * x - y * y);
+    REQUIRE(polynomials::series_mul(poly_t{}, x - y, polynomials::mul_crt).empty());
+}
+
+TEST_CASE("polynomial_mul_crt_test")
+{
+    using pm_t = packed_monomial<exp_t>;
+    using poly_t = polynomial<pm_t, mppp::integer<1>>;
+
+    auto check = [](const poly_t &a, const poly_t &b) {
+        const auto cmp = a * b;
+
+        REQUIRE(polynomials::series_mul(a, b, polynomials::mul_crt) == cmp);
+        REQUIRE(polynomials::series_mul(b, a, polynomials::mul_crt) == cmp);
+    };
+
+    auto [x, y, z, t] = make_polynomials<poly_t>("x", "y", "z", "t");
+
+    check(poly_t{3}, poly_t{-4});
+    check(x, y);
+    check(x + y, x - y);
+    check(x - 2 * y + 3, -5 * x * z + t - 1);
+
+    // Different symbol sets.
+    auto [a, b] = make_polynomials<poly_t>("a", "b");
+    check(x + y, a - b);
+
+    // Coefficients spanning several primes, with cancellations.
+    const auto c1 = mppp::integer<1>{1} << 100, c2 = mppp::integer<1>{3} << 57;
+    check(c1 * x + c2 * y, c1 * x - c2 * y);
+    check(-c1 * x + c2 * y - 1, c2 * x * z + c1 * t + c1 * c2);
+
+    // Coefficients too large for the available primes (fall back
+    // to the automatic algorithm).
+    const auto c3 = mppp::integer<1>{1} << 1000;
+    check(c3 * x + y, c3 * x - c3 * y + 1);
+
+    // Larger operands, so that the modular products are
+    // computed with the multithreaded algorithm and the
+    // result is segmented.
+    auto f = 1 + x + y + 2 * z * z + 3 * t * t * t, tmp_f(f);
+    auto g = 1 - x - 12345 * y - 2 * z * z + 3 * t * t * t, tmp_g(g);
+    for (auto i = 1; i < 8; ++i) {
+        f *= tmp_f;
+        g *= tmp_g;
+    }
+
+    check(f, g);
+    check(f * c1, g);
+    check(f, f);
+}
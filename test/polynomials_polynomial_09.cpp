@@ -0,0 +1,826 @@
+// Copyright 2019-2020 Francesco Biscani (bluescarni@gmail.com)
+//
+// This file is part of the obake library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <obake/config.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <numeric>
+#include <ostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+
+#include <mp++/integer.hpp>
+
+#include <obake/detail/default_init_allocator.hpp>
+#include <obake/detail/tuple_for_each.hpp>
+#include <obake/key/key_degree.hpp>
+#include <obake/kpack.hpp>
+#include <obake/math/pow.hpp>
+#include <obake/polynomials/ooc_mul.hpp>
+#include <obake/polynomials/packed_monomial.hpp>
+#include <obake/polynomials/polynomial.hpp>
+#include <obake/symbols.hpp>
+
+#include "catch.hpp"
+#include "test_utils.hpp"
+
+using namespace obake;
+
+using exp_t =
+#if defined(OBAKE_PACKABLE_INT64)
+    std::int64_t
+#else
+    std::int32_t
+#endif
+    ;
+
+// A coefficient type without serialisation support.
+struct no_s11n_cf {
+    no_s11n_cf() = default;
+    explicit no_s11n_cf(int n) : value(n) {}
+
+    friend no_s11n_cf operator-(const no_s11n_cf &a)
+    {
+        return no_s11n_cf(-a.value);
+    }
+    friend no_s11n_cf operator+(const no_s11n_cf &a, const no_s11n_cf &b)
+    {
+        return no_s11n_cf(a.value + b.value);
+    }
+    friend no_s11n_cf operator*(const no_s11n_cf &a, const no_s11n_cf &b)
+    {
+        return no_s11n_cf(a.value * b.value);
+    }
+    friend no_s11n_cf &operator+=(no_s11n_cf &a, const no_s11n_cf &b)
+    {
+        a.value += b.value;
+        return a;
+    }
+    friend no_s11n_cf &operator-=(no_s11n_cf &a, const no_s11n_cf &b)
+    {
+        a.value -= b.value;
+        return a;
+    }
+    friend bool operator==(const no_s11n_cf &a, const no_s11n_cf &b)
+    {
+        return a.value == b.value;
+    }
+    friend bool operator!=(const no_s11n_cf &a, const no_s11n_cf &b)
+    {
+        return a.value != b.value;
+    }
+    friend std::ostream &operator<<(std::ostream &os, const no_s11n_cf &a)
+    {
+        return os << a.value;
+    }
+
+    int value = 0;
+};
+
+TEST_CASE("polynomial_ooc_mul_test")
+{
+    using pm_t = packed_monomial<exp_t>;
+
+    using cf_types = std::tuple<double, mppp::integer<1>>;
+
+    // NOTE: spill into a unique subdirectory of the temporary
+    // directory, so that the checks on the scratch files
+    // are not affected by other files in the temporary directory.
+    std::random_device rd;
+    const auto dir = std::filesystem::temp_directory_path()
+                     / ("obake_ooc_test_" + std::to_string(rd()) + "_" + std::to_string(rd()));
+    REQUIRE(std::filesystem::create_directories(dir));
+
+    detail::tuple_for_each(cf_types{}, [&dir](auto xs) {
+        using poly_t = polynomial<pm_t, decltype(xs)>;
+
+        auto [x, y, z, t] = make_polynomials<poly_t>("x", "y", "z", "t");
+
+        auto f = x + y + z + t + 1, tmp_f(f);
+        for (int i = 1; i < 8; ++i) {
+            f *= tmp_f;
+        }
+        auto g = x - y + 2 * z - t + 1, tmp_g(g);
+        for (int i = 1; i < 6; ++i) {
+            g *= tmp_g;
+        }
+
+        const auto cmp = f * g;
+
+        // Check the product for several memory budgets, including
+        // one so small that the segments are spilled one at a time.
+        for (auto mem_budget : {std::size_t(0), std::size_t(1000), std::size_t(1) << 40}) {
+            std::vector<std::filesystem::path> files;
+
+            {
+                const auto prod = polynomials::ooc_mul(f, g, dir, mem_budget);
+
+                REQUIRE(prod.get_symbol_set() == f.get_symbol_set());
+                REQUIRE(prod.to_polynomial() == cmp);
+
+                // Reassemble the product from the individual segments.
+                poly_t acc;
+                acc.set_symbol_set(f.get_symbol_set());
+                for (std::size_t i = 0; i < (std::size_t(1) << prod.get_s_size()); ++i) {
+                    acc += prod.get_segment(i);
+                }
+                REQUIRE(acc == cmp);
+
+                OBAKE_REQUIRES_THROWS_CONTAINS(prod.get_segment(std::size_t(1) << prod.get_s_size()),
+                                               std::out_of_range, "Cannot load the segment at index");
+
+                for (const auto &e : std::filesystem::directory_iterator(dir)) {
+                    files.push_back(e.path());
+                }
+                REQUIRE(files.size() == (std::size_t(1) << prod.get_s_size()));
+            }
+
+            // The scratch files must have been removed.
+            for (const auto &p : files) {
+                REQUIRE(!std::filesystem::exists(p));
+            }
+            REQUIRE(std::filesystem::is_empty(dir));
+        }
+
+        // Different symbol sets.
+        auto [a] = make_polynomials<poly_t>("a");
+        REQUIRE(polynomials::ooc_mul(f, a + 1, dir, 1000).to_polynomial() == f * (a + 1));
+        REQUIRE(polynomials::ooc_mul(a - 2, g, dir, 1000).to_polynomial() == (a - 2) * g);
+
+        // Empty operands.
+        const auto prod = polynomials::ooc_mul(f, poly_t{}, dir, 1000);
+        REQUIRE(prod.get_s_size() == 0u);
+        REQUIRE(prod.to_polynomial().empty());
+        REQUIRE(prod.get_segment(0).empty());
+        REQUIRE(prod.get_symbol_set() == f.get_symbol_set());
+
+        // Non-existing directory.
+        OBAKE_REQUIRES_THROWS_CONTAINS(polynomials::ooc_mul(f, g, dir / "obake_nonexisting_dir" / "foo", 1000),
+                                       std::runtime_error, "Could not open the scratch file");
+        REQUIRE(std::filesystem::is_empty(dir));
+    });
+
+    std::filesystem::remove_all(dir);
+
+    // Serialisability requirements.
+    REQUIRE(polynomials::ooc_serialisable<double>);
+    REQUIRE(polynomials::ooc_serialisable<mppp::integer<1>>);
+    REQUIRE(polynomials::ooc_serialisable<pm_t>);
+    REQUIRE(polynomials::ooc_serialisable<polynomial<pm_t, double>>);
+    REQUIRE(polynomials::ooc_serialisable<polynomial<pm_t, polynomial<pm_t, mppp::integer<1>>>>);
+    REQUIRE(!polynomials::ooc_serialisable<std::string>);
+    REQUIRE(!polynomials::ooc_serialisable<polynomial<pm_t, no_s11n_cf>>);
+    REQUIRE(!polynomials::detail::poly_ooc_mul_enabled<polynomial<pm_t, no_s11n_cf>, polynomial<pm_t, no_s11n_cf>>);
+    REQUIRE(polynomials::detail::poly_ooc_mul_enabled<polynomial<pm_t, double>, polynomial<pm_t, double>>);
+}
+
+TEST_CASE("polynomial_estimate_mul_test")
+{
+    using pm_t = packed_monomial<exp_t>;
+
+    using cf_types = std::tuple<double, mppp::integer<1>>;
+
+    detail::tuple_for_each(cf_types{}, [](auto xs) {
+        using poly_t = polynomial<pm_t, decltype(xs)>;
+
+        auto [x, y, z, t] = make_polynomials<poly_t>("x", "y", "z", "t");
+
+        // Empty operands.
+        auto est = estimate_mul(x, poly_t{});
+        REQUIRE(est.n_terms == 0);
+        REQUIRE(est.n_bytes == 0);
+        REQUIRE(est.n_mults == 0);
+
+        auto f = x + y + z + t + 1, tmp_f(f);
+        for (int i = 1; i < 6; ++i) {
+            f *= tmp_f;
+        }
+        auto g = x - y + 2 * z - t + 1, tmp_g(g);
+        for (int i = 1; i < 4; ++i) {
+            g *= tmp_g;
+        }
+
+        est = estimate_mul(f, g);
+        REQUIRE(est.n_mults == mppp::integer<1>{f.size()} * g.size());
+        REQUIRE(est.n_terms > 0);
+        REQUIRE(est.n_bytes >= est.n_terms);
+        REQUIRE(estimate_mul(g, f).n_mults == est.n_mults);
+
+        // Truncated multiplication.
+        est = estimate_truncated_mul(f, g, 2);
+        REQUIRE(est.n_mults > 0);
+        REQUIRE(est.n_mults < mppp::integer<1>{f.size()} * g.size());
+        est = estimate_truncated_mul(f, g, -1);
+        REQUIRE(est.n_mults == 0);
+        est = estimate_truncated_mul(f, g, 1, symbol_set{"x", "y"});
+        REQUIRE(est.n_mults > 0);
+        REQUIRE(est.n_mults < mppp::integer<1>{f.size()} * g.size());
+
+        // Different symbol sets.
+        auto [a] = make_polynomials<poly_t>("a");
+        est = estimate_mul(f, a + 1);
+        REQUIRE(est.n_mults == mppp::integer<1>{f.size()} * 2);
+        REQUIRE(est.n_terms > 0);
+
+        // Prepared operands.
+        const polynomials::prepared_operand<pm_t, decltype(xs)> pf{f}, pg{g};
+        est = estimate_mul(f, g);
+        for (const auto &e : {estimate_mul(pf, g), estimate_mul(f, pg), estimate_mul(pf, pg), estimate_mul(pg, pf)}) {
+            REQUIRE(e.n_terms == est.n_terms);
+            REQUIRE(e.n_bytes == est.n_bytes);
+            REQUIRE(e.n_mults == est.n_mults);
+        }
+        REQUIRE(estimate_mul(pf, poly_t{}).n_terms == 0);
+        REQUIRE(estimate_mul(pf, a + 1).n_mults == mppp::integer<1>{f.size()} * 2);
+
+        // The memory ceiling.
+        REQUIRE(polynomials::get_mul_mem_limit() == 0u);
+        polynomials::set_mul_mem_limit(1);
+        REQUIRE(polynomials::get_mul_mem_limit() == 1u);
+
+        OBAKE_REQUIRES_THROWS_CONTAINS(f * g, polynomials::mul_mem_limit_error,
+                                       "exceeds the memory limit for polynomial multiplications");
+        OBAKE_REQUIRES_THROWS_CONTAINS(truncated_mul(f, g, 2), polynomials::mul_mem_limit_error,
+                                       "exceeds the memory limit for polynomial multiplications");
+        REQUIRE((f * poly_t{}).empty());
+
+        // A ceiling large enough.
+        polynomials::set_mul_mem_limit(std::size_t(1) << 40);
+        REQUIRE(f * g == g * f);
+
+        // Overflowing operands: the overflow is detected
+        // before the estimation.
+        poly_t big;
+        big.set_symbol_set(f.get_symbol_set());
+        big.add_term(pm_t{detail::kpack_get_lims<exp_t>(4).second, 0, 0, 0}, 1);
+        OBAKE_REQUIRES_THROWS_CONTAINS(big * (big + 1), std::overflow_error,
+                                       "An overflow in the monomial exponents was detected while "
+                                       "attempting to multiply two polynomials");
+
+        polynomials::set_mul_mem_limit(0);
+        REQUIRE(polynomials::get_mul_mem_limit() == 0u);
+
+        OBAKE_REQUIRES_THROWS_CONTAINS(estimate_mul(big, big + 1), std::overflow_error,
+                                       "An overflow in the monomial exponents was detected while attempting to "
+                                       "estimate the cost of the multiplication of two polynomials");
+        OBAKE_REQUIRES_THROWS_CONTAINS(estimate_truncated_mul(big, big + 1, 2), std::overflow_error,
+                                       "An overflow in the monomial exponents was detected while attempting to "
+                                       "estimate the cost of the multiplication of two polynomials");
+    });
+}
+
+TEST_CASE("polynomial_rect_estimate_test")
+{
+    using pm_t = packed_monomial<exp_t>;
+    using poly_t = polynomial<pm_t, mppp::integer<1>>;
+
+    auto [x, y, z, t] = make_polynomials<poly_t>("x", "y", "z", "t");
+
+    auto f = x + y + z + t + 1;
+    const auto g = obake::pow(f, 20);
+    REQUIRE(g.size() > 10000u);
+
+    // Parallel extraction of the terms of a segmented series.
+    poly_t h;
+    h.set_symbol_set(g.get_symbol_set());
+    h.set_n_segments(3);
+    for (const auto &term : g) {
+        h.add_term(term.first, term.second);
+    }
+
+    const auto tv = polynomials::detail::poly_mul_impl_make_term_vector(h);
+    REQUIRE(tv.size() == h.size());
+    auto it = h.begin();
+    for (const auto &p : tv) {
+        REQUIRE(p.first == it->first);
+        REQUIRE(p.second == it->second);
+        ++it;
+    }
+
+    // References to the terms of a segmented series.
+    const auto trv = polynomials::detail::poly_mul_impl_make_term_ref_vector(h);
+    REQUIRE(trv.size() == h.size());
+    it = h.begin();
+    for (const auto &p : trv) {
+        REQUIRE(&p.first == &it->first);
+        REQUIRE(&p.second == &it->second);
+        ++it;
+    }
+
+    // Estimation of the product size in rectangular multiplications.
+    auto check_est = [](const mppp::integer<1> &est, std::size_t actual) {
+        REQUIRE(est * 4 >= mppp::integer<1>{actual} * 3);
+        REQUIRE(est * 3 <= mppp::integer<1>{actual} * 4);
+    };
+
+    for (const auto &s : {x + y + 1, x - y * z + t * t - 2, x * x * y + 3 * z * t - x * y * z * t + y - 1}) {
+        check_est(estimate_mul(s, h).n_terms, (s * h).size());
+        check_est(estimate_truncated_mul(s, h, 15).n_terms, truncated_mul(s, h, 15).size());
+        check_est(estimate_truncated_mul(s, h, 10, symbol_set{"x", "z"}).n_terms,
+                  truncated_mul(s, h, 10, symbol_set{"x", "z"}).size());
+    }
+
+    // In pruned mode, only the term-by-term multiplications
+    // above the threshold are taken into account.
+    using dpoly_t = polynomial<pm_t, double>;
+
+    auto [a, b, c, d] = make_polynomials<dpoly_t>("x", "y", "z", "t");
+
+    const auto dh = obake::pow(1. + a / 2. + b / 3. + c / 5. + d / 7., 20);
+    const auto dtv = polynomials::detail::poly_mul_impl_make_term_vector(dh);
+    const auto &ss = dh.get_symbol_set();
+
+    // NOTE: the operands must have the same symbol set.
+    auto ext_ss = [&ss](const dpoly_t &p) {
+        dpoly_t ret;
+        ret.set_symbol_set(ss);
+
+        return ret + p;
+    };
+
+    // NOTE: use operands whose coefficients span several orders of magnitude,
+    // so that the products of the different terms of s are pruned
+    // to different extents.
+    for (const auto &s : {ext_ss(a + b / 2. + 1.), ext_ss(1. + 1E-3 * a + 1E-3 * b + 1E-6 * a * b),
+                          ext_ss(1. + 1E-4 * a + 1E-2 * c + 1E-3 * d + 1E-5 * a * d)}) {
+        const auto thr = polynomials::cf_threshold{1E-5};
+
+        const auto stv = polynomials::detail::poly_mul_impl_make_term_vector(s);
+        const auto dd = std::make_tuple(
+            polynomials::detail::poly_mul_impl_make_degree_vector<dpoly_t>(stv.cbegin(), stv.cend(), ss, false, thr),
+            polynomials::detail::poly_mul_impl_make_degree_vector<dpoly_t>(dtv.cbegin(), dtv.cend(), ss, false, thr));
+        const auto est = std::get<0>(
+            polynomials::detail::poly_mul_estimate_product_size_dd<dpoly_t, dpoly_t>(stv, dtv, ss, dd, thr));
+
+        dpoly_t r;
+        r.set_symbol_set(ss);
+        polynomials::detail::poly_mul_impl_simple(r, s, dh, thr);
+        REQUIRE(r.size() < (s * dh).size());
+
+        REQUIRE(est * 20 >= mppp::integer<1>{r.size()} * 19);
+        REQUIRE(est * 20 <= mppp::integer<1>{r.size()} * 21);
+    }
+}
+
+TEST_CASE("polynomial_pruned_mul_test")
+{
+    using pm_t = packed_monomial<exp_t>;
+    using poly_t = polynomial<pm_t, double>;
+
+    auto [x, y, z, t] = make_polynomials<poly_t>("x", "y", "z", "t");
+
+    // NOTE: positive coefficients, so that the pruned
+    // coefficients cannot be larger than the exact ones.
+    const auto f = obake::pow(1. + x / 2. + y / 3. + z / 5. + t / 7., 10);
+    const auto g = obake::pow(1. + x / 3. + y / 5. + z / 7. + t / 11., 10);
+    REQUIRE(f.size() * g.size() >= 1000000u);
+
+    // A zero threshold does not prune anything.
+    REQUIRE(pruned_mul(f, g, polynomials::cf_threshold{}) == f * g);
+
+    // Check the pruned product of a and b against the exact one.
+    auto check = [](const poly_t &a, const poly_t &b, double thr) {
+        const auto exact = a * b;
+        const auto ret = pruned_mul(a, b, polynomials::cf_threshold{thr});
+
+        REQUIRE(ret.size() < exact.size());
+
+        const auto n = static_cast<double>(std::min(a.size(), b.size()));
+
+        for (const auto &p : ret) {
+            REQUIRE(p.second >= thr);
+
+            const auto it = exact.find(p.first);
+            REQUIRE(it != exact.end());
+            REQUIRE(p.second <= it->second * (1 + 1E-12));
+        }
+
+        for (const auto &p : exact) {
+            if (p.second >= thr * (n + 1)) {
+                const auto it = ret.find(p.first);
+                REQUIRE(it != ret.end());
+                REQUIRE(it->second >= p.second - thr * n);
+            }
+        }
+    };
+
+    // Small and large (multithreaded) multiplications, squaring.
+    check(x + y / 2. + z / 1000., 1. + x / 100. + t / 1000., 1E-4);
+    check(f, g, 1E-6);
+    check(f, f, 1E-6);
+
+    // Relative threshold.
+    double max_f = 0, max_g = 0;
+    for (const auto &p : f) {
+        max_f = std::max(max_f, p.second);
+    }
+    for (const auto &p : g) {
+        max_g = std::max(max_g, p.second);
+    }
+    REQUIRE(pruned_mul(f, g, polynomials::cf_threshold{1E-8, true})
+            == pruned_mul(f, g, polynomials::cf_threshold{1E-8 * max_f * max_g}));
+
+    // The homomorphic multithreaded engine prunes the same
+    // term-by-term products as the simple one.
+    for (const auto &[a, b] : {std::pair{f, g}, std::pair{f, f}}) {
+        const auto thr = polynomials::cf_threshold{1E-6};
+        poly_t r1, r2;
+        r1.set_symbol_set(a.get_symbol_set());
+        r2.set_symbol_set(a.get_symbol_set());
+        polynomials::detail::poly_mul_impl_simple(r1, a, b, thr);
+        polynomials::detail::poly_mul_impl_mt_hm(r2, a, b, thr);
+        REQUIRE(r1.size() == r2.size());
+        for (const auto &p : r1) {
+            const auto it = r2.find(p.first);
+            REQUIRE(it != r2.end());
+            REQUIRE(std::abs(it->second - p.second) <= p.second * 1E-12);
+        }
+    }
+
+    // Different symbol sets and empty operands.
+    auto [a] = make_polynomials<poly_t>("a");
+    REQUIRE(pruned_mul(f, a + 1., polynomials::cf_threshold{}) == f * (a + 1.));
+    REQUIRE(pruned_mul(f, poly_t{}, polynomials::cf_threshold{1.}).empty());
+
+    // Invalid thresholds.
+    OBAKE_REQUIRES_THROWS_CONTAINS(pruned_mul(f, g, polynomials::cf_threshold{-1.}), std::invalid_argument,
+                                   "A coefficient threshold must be a finite non-negative value");
+    OBAKE_REQUIRES_THROWS_CONTAINS(
+        pruned_mul(f, g, polynomials::cf_threshold{std::numeric_limits<double>::infinity()}), std::invalid_argument,
+        "A coefficient threshold must be a finite non-negative value");
+
+    // Non-finite coefficients.
+    for (auto v : {std::numeric_limits<double>::quiet_NaN(), std::numeric_limits<double>::infinity()}) {
+        OBAKE_REQUIRES_THROWS_CONTAINS(pruned_mul(f, g + v * x, polynomials::cf_threshold{1E-6}),
+                                       std::invalid_argument,
+                                       "The pruned multiplication of polynomials requires finite coefficients");
+        OBAKE_REQUIRES_THROWS_CONTAINS(pruned_mul(-v * y + f, g, polynomials::cf_threshold{}), std::invalid_argument,
+                                       "The pruned multiplication of polynomials requires finite coefficients");
+    }
+
+    // Pruned multiplication is not available for non-floating-point coefficients.
+    REQUIRE(!polynomials::detail::poly_mul_pruned_enabled<polynomial<pm_t, mppp::integer<1>>, poly_t>);
+}
+
+TEST_CASE("polynomial_w_truncated_mul_test")
+{
+    using pm_t = packed_monomial<exp_t>;
+
+    using cf_types = std::tuple<double, mppp::integer<1>>;
+
+    detail::tuple_for_each(cf_types{}, [](auto xs) {
+        using poly_t = polynomial<pm_t, decltype(xs)>;
+
+        auto [x, y, z, t] = make_polynomials<poly_t>("x", "y", "z", "t");
+
+        const auto w = polynomials::deg_weights{{{"x", 3}, {"y", 1}, {"t", -1}, {"a", 5}}};
+
+        // Compute the product of a and b, and remove the terms
+        // whose weighted degree is greater than d.
+        auto cmp_mul = [&w](const poly_t &a, const poly_t &b, int d) {
+            auto ret = a * b;
+
+            const auto &ss = ret.get_symbol_set();
+            const auto groups = polynomials::detail::poly_w_degree_groups(w, ss);
+            obake::filter(ret, [d_ex = polynomials::detail::poly_w_degree_extractor{&groups, &ss}, d](const auto &p) {
+                return d_ex(p) <= d;
+            });
+
+            return ret;
+        };
+
+        // Small and large (multithreaded) multiplications.
+        auto f = x + y + z + t + 1, tmp_f(f);
+        auto g = x - y + 2 * z - t + 1, tmp_g(g);
+        for (int i = 1; i < 8; ++i) {
+            f *= tmp_f;
+            g *= tmp_g;
+        }
+
+        for (int d : {-10, -1, 0, 3, 10, 30}) {
+            REQUIRE(truncated_mul(x + y, z - t, d, w) == cmp_mul(x + y, z - t, d));
+            REQUIRE(truncated_mul(tmp_f, tmp_g, d, w) == cmp_mul(tmp_f, tmp_g, d));
+            REQUIRE(truncated_mul(f, g, d, w) == cmp_mul(f, g, d));
+            REQUIRE(truncated_mul(f, f, d, w) == cmp_mul(f, f, d));
+        }
+
+        // Prepared operands.
+        const polynomials::prepared_operand<pm_t, decltype(xs)> pf{f};
+        REQUIRE(truncated_mul(pf, g, 10, w) == cmp_mul(f, g, 10));
+        REQUIRE(truncated_mul(pf, pf, 10, w) == cmp_mul(f, f, 10));
+
+        // No weights: only the total degree truncation limit matters.
+        REQUIRE(truncated_mul(f, g, 0, polynomials::deg_weights{}) == f * g);
+        REQUIRE(truncated_mul(f, g, -1, polynomials::deg_weights{}).empty());
+
+        // Different symbol sets.
+        auto [a] = make_polynomials<poly_t>("a");
+        REQUIRE(truncated_mul(f, a + 1, 10, w) == cmp_mul(f, a + 1, 10));
+
+        // Estimate.
+        const auto est = estimate_truncated_mul(f, g, 10, w);
+        REQUIRE(est.n_mults > 0);
+        REQUIRE(est.n_mults < mppp::integer<1>{f.size()} * g.size());
+    });
+}
+
+TEST_CASE("polynomial_mt_truncated_degree_data_test")
+{
+    // Parallel permutation helper.
+    obake::detail::dinit_vector<int> v;
+    v.resize(100000);
+    std::iota(v.begin(), v.end(), 0);
+    auto vidx = polynomials::detail::poly_mul_impl_par_make_idx_vector(v);
+    REQUIRE(vidx.size() == v.size());
+    std::reverse(vidx.begin(), vidx.end());
+    const auto pv = polynomials::detail::poly_mul_impl_par_permute<false>(v, vidx);
+    REQUIRE(pv.size() == v.size());
+    REQUIRE(std::equal(pv.begin(), pv.end(), v.rbegin()));
+
+    // Truncated multithreaded multiplication, checked against
+    // the truncation of the untruncated product.
+    using pm_t = packed_monomial<exp_t>;
+    using poly_t = polynomial<pm_t, mppp::integer<1>>;
+
+    auto [x, y, z, t] = make_polynomials<poly_t>("x", "y", "z", "t");
+
+    auto f = x + y + z + t + 1, tmp_f(f);
+    for (int i = 1; i < 10; ++i) {
+        f *= tmp_f;
+    }
+    const auto g = f + 2 * x * y * z * t;
+
+    const auto &ss = f.get_symbol_set();
+    auto trunc = [&ss](poly_t p, int d) {
+        obake::filter(p, [&ss, d](const auto &term) { return key_degree(term.first, ss) <= d; });
+
+        return p;
+    };
+
+    for (int d : {-1, 0, 3, 10, 15, 20}) {
+        REQUIRE(truncated_mul(f, g, d) == trunc(f * g, d));
+        // Squaring.
+        REQUIRE(truncated_mul(f, f, d) == trunc(f * f, d));
+    }
+}
+
+TEST_CASE("polynomial_mt_hot_segments_test")
+{
+    // Cost-balanced range splitting.
+    const std::vector<double> psum{0, 1, 101, 102, 103, 104, 105, 155, 156};
+    polynomials::detail::poly_mul_cost_range<unsigned> r(10, 12, 18, psum.data());
+    REQUIRE(!r.empty());
+    REQUIRE(r.is_divisible());
+    polynomials::detail::poly_mul_cost_range<unsigned> r2(r, tbb::split{});
+    REQUIRE(r.begin() == 12u);
+    REQUIRE(r.end() == 16u);
+    REQUIRE(r2.begin() == 16u);
+    REQUIRE(r2.end() == 18u);
+    polynomials::detail::poly_mul_cost_range<unsigned> r3(r2, tbb::split{});
+    REQUIRE(r2.end() == 17u);
+    REQUIRE(r3.begin() == 17u);
+    REQUIRE(!r3.is_divisible());
+
+    // Products with and without the splitting of hot segments.
+    using pm_t = packed_monomial<exp_t>;
+    using poly_t = polynomial<pm_t, mppp::integer<1>>;
+
+    REQUIRE(polynomials::get_mul_split_hot_segments());
+
+    auto [x, y, z, t] = make_polynomials<poly_t>("x", "y", "z", "t");
+
+    auto f = x + y + z + t + 1, tmp_f(f);
+    for (int i = 1; i < 10; ++i) {
+        f *= tmp_f;
+    }
+    // NOTE: add a few terms with large exponents
+    // in order to skew the distribution of the work.
+    const auto g = f + obake::pow(x, 20) * f + 2 * obake::pow(x * y * z * t, 5);
+
+    const auto p1 = f * g, p2 = f * f, p3 = truncated_mul(f, g, 15);
+
+    polynomials::set_mul_split_hot_segments(false);
+    REQUIRE(!polynomials::get_mul_split_hot_segments());
+
+    REQUIRE(f * g == p1);
+    REQUIRE(f * f == p2);
+    REQUIRE(truncated_mul(f, g, 15) == p3);
+
+    polynomials::set_mul_split_hot_segments(true);
+    REQUIRE(polynomials::get_mul_split_hot_segments());
+}
+
+TEST_CASE("polynomial_prepared_exp_limits_test")
+{
+    detail::tuple_for_each(std::tuple<double, mppp::integer<1>>{}, [](auto xs) {
+        using pm_t = packed_monomial<exp_t>;
+        using cf_t = decltype(xs);
+        using poly_t = polynomial<pm_t, cf_t>;
+        using prep_t = polynomials::prepared_operand<pm_t, cf_t>;
+        using limits_t = std::vector<std::pair<exp_t, exp_t>>;
+
+        auto [x, y] = make_polynomials<poly_t>("x", "y");
+
+        // The cached exponent limits.
+        REQUIRE(prep_t{poly_t{}}._get_exp_limits().empty());
+        REQUIRE(prep_t{poly_t{1}}._get_exp_limits().empty());
+        REQUIRE(prep_t{x * x - 3 * x * y + y}._get_exp_limits() == limits_t{{0, 2}, {0, 1}});
+        poly_t n;
+        n.set_symbol_set(symbol_set{"x", "y"});
+        n.add_term(pm_t{-2, 0}, 1);
+        n += x * y;
+        REQUIRE(prep_t{n}._get_exp_limits() == limits_t{{-2, 1}, {0, 1}});
+
+        // Overflow detection in the multithreaded multiplication
+        // via the cached exponent limits.
+        const auto lim = detail::kpack_get_lims<exp_t>(2).second;
+        poly_t a, b;
+        a.set_symbol_set(symbol_set{"x", "y"});
+        b.set_symbol_set(symbol_set{"x", "y"});
+        a.add_term(pm_t{lim, exp_t(1)}, 1);
+        a.add_term(pm_t{0, 1}, 2);
+        // NOTE: the operands must have the same size, as
+        // poly_mul_impl_mt_hm() requires the first operand
+        // not to be larger than the second one.
+        b.add_term(pm_t{lim, exp_t(0)}, 3);
+        b.add_term(pm_t{0, 0}, 4);
+        const prep_t pa{a}, pb{b};
+        REQUIRE(pa._get_exp_limits() == limits_t{{0, lim}, {1, 1}});
+
+        poly_t r;
+        r.set_symbol_set(symbol_set{"x", "y"});
+        OBAKE_REQUIRES_THROWS_CONTAINS(
+            polynomials::detail::poly_mul_impl_mt_hm(r, pa, b), std::overflow_error,
+            "An overflow in the monomial exponents was detected while attempting to multiply two polynomials");
+        OBAKE_REQUIRES_THROWS_CONTAINS(
+            polynomials::detail::poly_mul_impl_mt_hm(r, b, pa), std::overflow_error,
+            "An overflow in the monomial exponents was detected while attempting to multiply two polynomials");
+        OBAKE_REQUIRES_THROWS_CONTAINS(
+            polynomials::detail::poly_mul_impl_mt_hm(r, pa, pb), std::overflow_error,
+            "An overflow in the monomial exponents was detected while attempting to multiply two polynomials");
+        OBAKE_REQUIRES_THROWS_CONTAINS(
+            polynomials::detail::poly_mul_impl_mt_hm(r, pa, pa), std::overflow_error,
+            "An overflow in the monomial exponents was detected while attempting to multiply two polynomials");
+
+        // No overflow.
+        poly_t c;
+        c.set_symbol_set(symbol_set{"x", "y"});
+        c.add_term(pm_t{0, 1}, 1);
+        c.add_term(pm_t{0, 0}, -1);
+        const prep_t pc{c};
+        r = poly_t{};
+        r.set_symbol_set(symbol_set{"x", "y"});
+        polynomials::detail::poly_mul_impl_mt_hm(r, pa, pc);
+        REQUIRE(r == a * c);
+
+        // The limits of two ranges of keys are the same whether
+        // they are computed serially or in parallel.
+        const symbol_set ss{"x", "y"};
+        for (auto [n1, n2] : {std::pair{10, 20}, std::pair{10, 20000}, std::pair{20000, 30000}}) {
+            std::vector<pm_t> k1, k2;
+            for (exp_t i = 0; i < n1; ++i) {
+                k1.push_back(pm_t{i % 37, -(i % 11)});
+            }
+            for (exp_t i = 0; i < n2; ++i) {
+                k2.push_back(pm_t{-(i % 13), i % 53});
+            }
+
+            const auto [l1, l2] = polynomials::detail::pm_range_exponent_limits(k1, k2, ss);
+            REQUIRE(l1 == polynomials::detail::pm_range_exponent_limits_impl(k1, ss, false));
+            REQUIRE(l2 == polynomials::detail::pm_range_exponent_limits_impl(k2, ss, false));
+            REQUIRE(l2 == polynomials::detail::pm_range_exponent_limits_impl(k2, ss, true));
+            REQUIRE(l2 == limits_t{{-std::min(exp_t(n2 - 1), exp_t(12)), 0}, {0, std::min(exp_t(n2 - 1), exp_t(52))}});
+        }
+    });
+}
+
+TEST_CASE("polynomial_key_bounds_test")
+{
+    using pm_t = packed_monomial<exp_t>;
+    using poly_t = polynomial<pm_t, mppp::integer<1>>;
+    using limits_t = std::vector<std::pair<exp_t, exp_t>>;
+
+    // No bounds for an empty series.
+    REQUIRE(poly_t{}._get_key_bounds() == nullptr);
+
+    // No variables.
+    REQUIRE(poly_t{1}._get_key_bounds()->exps.empty());
+    REQUIRE(poly_t{1}._get_key_bounds()->min_deg == 0);
+    REQUIRE(poly_t{1}._get_key_bounds()->max_deg == 0);
+
+    // The bounds are computed lazily, cached, and
+    // recomputed after add_term().
+    poly_t a;
+    a.set_symbol_set(symbol_set{"x", "y"});
+    a.add_term(pm_t{1, 2}, 1);
+    REQUIRE(a._get_key_bounds()->exps == limits_t{{1, 1}, {2, 2}});
+    a.add_term(pm_t{-1, 3}, 2);
+    a.add_term(pm_t{0, 0}, 3);
+    const auto *b = a._get_key_bounds();
+    REQUIRE(a._get_key_bounds() == b);
+    REQUIRE(b->exps == limits_t{{-1, 1}, {0, 3}});
+    REQUIRE(b->min_deg == 0);
+    REQUIRE(b->max_deg == 3);
+
+    // Copies recompute the bounds, moves carry them.
+    auto a2(a);
+    REQUIRE(a2._get_key_bounds() != b);
+    REQUIRE(a2._get_key_bounds()->exps == b->exps);
+    b = a2._get_key_bounds();
+    auto a3(std::move(a2));
+    REQUIRE(a3._get_key_bounds() == b);
+    REQUIRE(a3._get_key_bounds()->exps == limits_t{{-1, 1}, {0, 3}});
+
+    // Mutable access invalidates the bounds.
+    obake::filter(a3, [](const auto &t) { return t.first != pm_t{-1, 3}; });
+    REQUIRE(a3._get_key_bounds()->exps == limits_t{{0, 1}, {0, 2}});
+    REQUIRE(a3._get_key_bounds()->min_deg == 0);
+    REQUIRE(a3._get_key_bounds()->max_deg == 3);
+    a3.clear_terms();
+    REQUIRE(a3._get_key_bounds() == nullptr);
+
+    // The bounds of a segmented series.
+    auto [x, y, z] = make_polynomials<poly_t>("x", "y", "z");
+    auto f = x - 2 * y + z + 1, tmp_f(f);
+    for (int i = 1; i < 10; ++i) {
+        f *= tmp_f;
+    }
+    poly_t fs;
+    fs.set_symbol_set(f.get_symbol_set());
+    fs.set_n_segments(4);
+    for (const auto &t : f) {
+        fs.add_term(t.first, t.second);
+    }
+    REQUIRE(fs._get_key_bounds()->exps == limits_t{{0, 10}, {0, 10}, {0, 10}});
+    REQUIRE(fs._get_key_bounds()->min_deg == 0);
+    REQUIRE(fs._get_key_bounds()->max_deg == 10);
+
+    // The bounds of a product are computed from the
+    // bounds of the factors.
+    const auto g = (x * y * y - z) * (x * z + 1);
+    REQUIRE(g._get_key_bounds()->exps == limits_t{{0, 2}, {0, 2}, {0, 2}});
+    REQUIRE(g._get_key_bounds()->min_deg == 1);
+    REQUIRE(g._get_key_bounds()->max_deg == 5);
+
+    // Non-tight bounds (e.g., the bounds of a product
+    // with cancellations).
+    const auto lim = detail::kpack_get_lims<exp_t>(2).second;
+    poly_t c, d;
+    c.set_symbol_set(symbol_set{"x", "y"});
+    d.set_symbol_set(symbol_set{"x", "y"});
+    c.add_term(pm_t{0, 1}, 2);
+    c._set_key_bounds(polynomials::detail::pm_key_bounds<exp_t>{limits_t{{0, lim}, {0, 1}}, 0, lim});
+    REQUIRE(c._get_key_bounds()->exps == limits_t{{0, lim}, {0, 1}});
+    d.add_term(pm_t{lim, exp_t(0)}, 3);
+    d.add_term(pm_t{0, 0}, 4);
+
+    // The product does not overflow: the overflow
+    // check falls back to the keys.
+    poly_t cd;
+    cd.set_symbol_set(symbol_set{"x", "y"});
+    cd.add_term(pm_t{lim, exp_t(1)}, 6);
+    cd.add_term(pm_t{0, 1}, 8);
+    REQUIRE(c * d == cd);
+    REQUIRE(d * c == cd);
+    const auto res = promoting_mul(c, d);
+    REQUIRE(res.index() == 0u);
+    REQUIRE(std::get<0>(res) == cd);
+
+    // Overflow detection.
+    c.add_term(pm_t{1, 0}, 1);
+    OBAKE_REQUIRES_THROWS_CONTAINS(
+        c * d, std::overflow_error,
+        "An overflow in the monomial exponents was detected while attempting to multiply two polynomials");
+
+    // Total degree truncation via the degree bounds.
+    const auto &ss = f.get_symbol_set();
+    auto trunc = [&ss](poly_t p, int deg) {
+        obake::filter(p, [&ss, deg](const auto &term) { return key_degree(term.first, ss) <= deg; });
+
+        return p;
+    };
+    const auto h = x * y * f, k = z * f;
+    for (int deg : {-1, 0, 2, 3, 10, 22, 23, 100}) {
+        REQUIRE(truncated_mul(h, k, deg) == trunc(h * k, deg));
+        REQUIRE(truncated_mul(k, h, deg) == trunc(h * k, deg));
+    }
+    REQUIRE(truncated_mul(h, k, 2).empty());
+    REQUIRE(truncated_mul(h, k, 23) == h * k);
+}
@@ -7,19 +7,25 @@
 // with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
 #include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <sstream>
 #include <stdexcept>
+#include <string>
 #include <type_traits>
 #include <utility>
 #include <variant>
 
 #include <fmt/core.h>
 
+#include <mp++/integer.hpp>
+#include <mp++/rational.hpp>
+
 #include <obake/cf/cf_tex_stream_insert.hpp>
 #include <obake/math/degree.hpp>
 #include <obake/math/diff.hpp>
 #include <obake/math/integrate.hpp>
+#include <obake/key/key_p_degree.hpp>
 #include <obake/math/p_degree.hpp>
 #include <obake/math/pow.hpp>
 #include <obake/math/subs.hpp>
@@ -1045,6 +1051,53 @@ TEST_CASE("pow")
         REQUIRE(obake::pow(xt + yt, 5).empty());
         REQUIRE(!obake::pow(xt2 + yt2, 5).empty());
     }
+
+    // Miller's recurrence and binary exponentiation
+    // with truncation.
+    // NOTE: Miller's recurrence requires an exact
+    // coefficient ring.
+    using ps_q_t = p_series<pm_t, mppp::rational<1>>;
+    {
+        auto [x, y] = make_p_series_t<ps_q_t>(7, "x", "y");
+
+        const auto p = 1 + x - 2 * y + x * y;
+        auto ret = obake::pow(p, 5);
+        REQUIRE(ret == p * p * p * p * p);
+        REQUIRE(obake::get_truncation(ret).index() == 1u);
+        REQUIRE(std::get<1>(obake::get_truncation(ret)) == 7);
+        REQUIRE(obake::degree(ret) == 7);
+
+        ret = obake::pow(x + y * y, 16);
+        REQUIRE(ret.empty());
+        REQUIRE(obake::get_truncation(ret).index() == 1u);
+    }
+    {
+        auto [x, y] = make_p_series_t<ps_q_t>(40, "x", "y");
+
+        const auto p = x - y * y;
+        auto ret = obake::pow(p, 16);
+        auto cmp = p;
+        for (int i = 1; i < 16; ++i) {
+            cmp *= p;
+        }
+        REQUIRE(ret == cmp);
+        REQUIRE(!ret.empty());
+        REQUIRE(obake::get_truncation(ret).index() == 1u);
+    }
+    {
+        auto [x, y] = make_p_series_p<ps_q_t>(3, symbol_set{"x"}, "x", "y");
+
+        const auto p = 2 + x + x * y;
+        auto ret = obake::pow(p, 4);
+        REQUIRE(ret == p * p * p * p);
+        REQUIRE(obake::get_truncation(ret).index() == 2u);
+        REQUIRE(obake::p_degree(ret, symbol_set{"x"}) == 3);
+
+        // The component with zero partial degree
+        // is not a constant.
+        const auto q = 2 + x + y * y;
+        REQUIRE(obake::pow(q, 4) == q * q * q * q);
+    }
 }
 
 // Check that trimming preserves the tag.
@@ -1257,3 +1310,127 @@ TEST_CASE("fmt")
 
     REQUIRE(oss.str() == fmt::format(fmt::runtime("{}"), s));
 }
+
+TEST_CASE("coefficient threshold")
+{
+    using pm_t = packed_monomial<std::int32_t>;
+    using ps_t = p_series<pm_t, double>;
+
+    auto [x, y, z] = make_p_series<ps_t>("x", "y", "z");
+
+    auto s = 1. + x / 10. + y / 100. + z / 1000.;
+    set_truncation(s, polynomials::cf_threshold{1E-4});
+    REQUIRE(get_truncation(s).index() == 3u);
+    REQUIRE(std::get<3>(get_truncation(s)) == polynomials::cf_threshold{1E-4});
+    REQUIRE(s.size() == 4u);
+
+    // Multiplication.
+    auto ret = s * s;
+    REQUIRE(get_truncation(ret).index() == 3u);
+    REQUIRE(!ret.empty());
+    for (const auto &p : ret) {
+        REQUIRE(std::abs(p.second) >= 1E-4);
+    }
+    REQUIRE(ret.size() < ((1. + x / 10. + y / 100. + z / 1000.) * (1. + x / 10. + y / 100. + z / 1000.)).size());
+
+    ret = s * x;
+    REQUIRE(get_truncation(ret).index() == 3u);
+    REQUIRE(ret.size() == 4u);
+
+    // Exponentiation.
+    ret = obake::pow(s, 3);
+    REQUIRE(get_truncation(ret).index() == 3u);
+    for (const auto &p : ret) {
+        REQUIRE(std::abs(p.second) >= 1E-4);
+    }
+
+    // Relative threshold.
+    auto s2 = 100. + x + y / 100.;
+    set_truncation(s2, polynomials::cf_threshold{1E-3, true});
+    REQUIRE(s2.size() == 2u);
+    REQUIRE(s2.find(pm_t{0, 1}) == s2.end());
+
+    // Explicit truncation after addition.
+    ret = s + 1E-6 * x * y;
+    REQUIRE(ret == s);
+
+    // Mismatched truncation policies.
+    auto [a] = make_p_series_t<ps_t>(2, "a");
+    OBAKE_REQUIRES_THROWS_CONTAINS(s * a, std::invalid_argument, "truncation policies do not match");
+    auto s3 = s;
+    set_truncation(s3, polynomials::cf_threshold{1E-2});
+    OBAKE_REQUIRES_THROWS_CONTAINS(s * s3, std::invalid_argument, "truncation levels do not match");
+
+    // Invalid threshold.
+    OBAKE_REQUIRES_THROWS_CONTAINS(set_truncation(s3, polynomials::cf_threshold{-1.}), std::invalid_argument,
+                                   "A coefficient threshold must be a finite non-negative value");
+
+    // Stream operator.
+    std::ostringstream oss;
+    oss << s;
+    REQUIRE(oss.str().find("Truncation coefficient threshold: ") != std::string::npos);
+
+    // Coefficient threshold truncation is available only for
+    // floating-point coefficients.
+    REQUIRE(!std::is_invocable_v<decltype(set_truncation), p_series<pm_t, std::int64_t> &, polynomials::cf_threshold>);
+}
+
+TEST_CASE("weighted degree truncation")
+{
+    using pm_t = packed_monomial<std::int32_t>;
+    using ps_t = p_series<pm_t, mppp::integer<1>>;
+
+    auto [x, y, z] = make_p_series<ps_t>("x", "y", "z");
+
+    const auto w = polynomials::deg_weights{{{"x", 2}, {"y", 1}}};
+
+    auto s = 1 + x + y + z;
+    set_truncation(s, 3, w);
+    REQUIRE(get_truncation(s).index() == 4u);
+    REQUIRE(std::get<4>(get_truncation(s)).first == 3);
+    REQUIRE(std::get<4>(get_truncation(s)).second == w);
+    REQUIRE(s.size() == 4u);
+
+    // Check that the weighted degree of the terms of a
+    // does not exceed 3.
+    auto check = [](const ps_t &a) {
+        for (const auto &p : a) {
+            const auto &ss = a.get_symbol_set();
+            REQUIRE(2 * key_p_degree(p.first, symbol_idx_set{0}, ss) + key_p_degree(p.first, symbol_idx_set{1}, ss)
+                    <= 3);
+        }
+    };
+
+    // Multiplication.
+    auto ret = s * s;
+    REQUIRE(get_truncation(ret).index() == 4u);
+    check(ret);
+    auto cmp = (1 + x + y + z) * (1 + x + y + z);
+    set_truncation(cmp, 3, w);
+    REQUIRE(ret == cmp);
+
+    ret = s * x;
+    REQUIRE(get_truncation(ret).index() == 4u);
+    check(ret);
+    REQUIRE(ret.size() == 3u);
+
+    // Exponentiation.
+    ret = obake::pow(s, 4);
+    REQUIRE(get_truncation(ret).index() == 4u);
+    check(ret);
+    REQUIRE(ret == s * s * s * s);
+
+    // Explicit truncation after addition.
+    ret = s + x * x;
+    REQUIRE(ret == s);
+
+    // Mismatched truncation levels.
+    auto s2 = 1 + x + y + z;
+    set_truncation(s2, 3, polynomials::deg_weights{{{"x", 1}, {"y", 1}}});
+    OBAKE_REQUIRES_THROWS_CONTAINS(s * s2, std::invalid_argument, "truncation levels do not match");
+
+    // Stream operator.
+    std::ostringstream oss;
+    oss << s;
+    REQUIRE(oss.str().find("Weighted truncation degree: 3, {'x': 2, 'y': 1}") != std::string::npos);
+}